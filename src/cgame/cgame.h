@@ -24,7 +24,7 @@
 
 #include "client/cl_types.h"
 
-#define CGAME_API_VERSION 1
+#define CGAME_API_VERSION 2
 
 // exposed to the client game by the engine
 typedef struct cg_import_s {
@@ -37,6 +37,11 @@ typedef struct cg_import_s {
 	// milliseconds since launch
 	uint32_t (*Time)(void);
 
+	// thread pool
+	thread_t *(*Thread)(const char *name, ThreadRunFunc run, void *data);
+	void (*Wait)(thread_t *thread);
+	uint16_t (*ThreadCount)(void);
+
 	// zone memory management
 	void *(*Malloc)(size_t size, mem_tag_t tag);
 	void *(*LinkMalloc)(size_t size, void *parent);
@@ -113,6 +118,7 @@ typedef struct cg_import_s {
 	*(*AddLinkedEntity)(const r_entity_t *parent, const r_model_t *model, const char *tag_name);
 	void (*AddLight)(const r_light_t *l);
 	void (*AddParticle)(const r_particle_t *p);
+	void (*AddParticles)(const r_particle_t *particles, const uint32_t count);
 	void (*AddSustainedLight)(const r_sustained_light_t *s);
 
 	// 2D drawing facilities
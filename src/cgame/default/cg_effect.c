@@ -24,14 +24,18 @@
 // weather emitters are bound to downward-facing sky surfaces
 typedef struct cg_weather_emit_s {
 	const r_bsp_leaf_t *leaf;
+	vec3_t mins, maxs; // the bounds of the origins
 	uint16_t num_origins; // the number of origins
 	vec_t *origins; // the origins for particle spawns
 	vec_t *end_z; // the "floors" where particles are freed
-	struct cg_weather_emit_s *next;
 } cg_weather_emit_t;
 
+#define WEATHER_RADIUS 1024.0 // weather is spawned within this horizontal distance of the view
+#define WEATHER_LOD_NEAR 384.0 // and at its full density within this distance
+
 typedef struct {
-	cg_weather_emit_t *emits;
+	cg_weather_emit_t *emits; // sorted by cluster
+	uint16_t num_emits;
 	uint32_t time;
 } cg_weather_state_t;
 
@@ -80,12 +84,11 @@ void Cg_ResolveWeather(const char *weather) {
  * @brief Creates an emitter for the given surface. The number of origins for the
  * emitter depends on the area of the surface.
  */
-static void Cg_LoadWeather_(const r_bsp_model_t *bsp, const r_bsp_surface_t *s) {
+static void Cg_LoadWeather_(const r_bsp_model_t *bsp, const r_bsp_surface_t *s,
+		cg_weather_emit_t *e) {
 	vec3_t delta;
 	uint16_t i;
 
-	cg_weather_emit_t *e = cgi.Malloc(sizeof(cg_weather_emit_t), MEM_TAG_CGAME_LEVEL);
-
 	// resolve the leaf for the point just in front of the surface
 	VectorMA(s->center, 1.0, s->normal, delta);
 	e->leaf = cgi.LeafForPoint(delta, bsp);
@@ -98,6 +101,8 @@ static void Cg_LoadWeather_(const r_bsp_model_t *bsp, const r_bsp_surface_t *s)
 	e->origins = cgi.Malloc(sizeof(vec3_t) * e->num_origins, MEM_TAG_CGAME_LEVEL);
 	e->end_z = cgi.Malloc(sizeof(vec_t) * e->num_origins, MEM_TAG_CGAME_LEVEL);
 
+	ClearBounds(e->mins, e->maxs);
+
 	// resolve the origins and end_z
 	for (i = 0; i < e->num_origins; i++) {
 		vec_t *org = &e->origins[i * 3];
@@ -115,23 +120,40 @@ static void Cg_LoadWeather_(const r_bsp_model_t *bsp, const r_bsp_surface_t *s)
 
 		c_trace_t trace = cgi.Trace(org, end, NULL, NULL, 0, MASK_SHOT);
 		e->end_z[i] = trace.end[2];
-	}
 
-	// push on to the linked list
-	e->next = cg_weather_state.emits;
-	cg_weather_state.emits = e;
+		AddPointToBounds(org, e->mins, e->maxs);
+	}
 
 	cgi.Debug("%s: %d origins\n", vtos(s->center), e->num_origins);
 }
 
+/*
+ * @brief Returns true if the specified surface should emit weather.
+ */
+static _Bool Cg_IsWeatherSurface(const r_bsp_surface_t *s) {
+	return (s->texinfo->flags & SURF_SKY) && s->normal[2] < -0.1;
+}
+
+/*
+ * @brief qsort comparator for Cg_LoadWeather, ordering emitters by cluster.
+ */
+static int32_t Cg_LoadWeather_Compare(const void *a, const void *b) {
+	const int16_t ca = ((const cg_weather_emit_t *) a)->leaf->cluster;
+	const int16_t cb = ((const cg_weather_emit_t *) b)->leaf->cluster;
+
+	return ca - cb;
+}
+
 /*
  * @brief Iterates the world surfaces, generating weather emitters from sky brushes.
- * Valid weather origins and z-depths are resolved and cached.
+ * Valid weather origins and z-depths are resolved and cached. The emitters are
+ * sorted by cluster, so that the visibility of each cluster is resolved once.
  */
 void Cg_LoadWeather(void) {
 	uint16_t i, j;
 
 	cg_weather_state.emits = NULL;
+	cg_weather_state.num_emits = 0;
 	cg_weather_state.time = 0;
 
 	Cg_ResolveWeather(cgi.ConfigString(CS_WEATHER));
@@ -142,17 +164,28 @@ void Cg_LoadWeather(void) {
 	const r_bsp_model_t *bsp = cgi.WorldModel()->bsp;
 	const r_bsp_surface_t *s = bsp->surfaces;
 
-	// iterate the world surfaces, testing sky surfaces
+	// count the downward facing sky surfaces
 	for (i = j = 0; i < bsp->num_surfaces; i++, s++) {
-
-		// for downward facing sky brushes, create an emitter
-		if ((s->texinfo->flags & SURF_SKY) && s->normal[2] < -0.1) {
-			Cg_LoadWeather_(bsp, s);
+		if (Cg_IsWeatherSurface(s))
 			j++;
+	}
+
+	if (!j)
+		return;
+
+	cg_weather_state.emits = cgi.Malloc(j * sizeof(cg_weather_emit_t), MEM_TAG_CGAME_LEVEL);
+
+	// and create an emitter for each of them
+	for (i = 0, s = bsp->surfaces; i < bsp->num_surfaces; i++, s++) {
+		if (Cg_IsWeatherSurface(s)) {
+			Cg_LoadWeather_(bsp, s, &cg_weather_state.emits[cg_weather_state.num_emits++]);
 		}
 	}
 
-	cgi.Debug("%d emits\n", j);
+	qsort(cg_weather_state.emits, cg_weather_state.num_emits, sizeof(cg_weather_emit_t),
+			Cg_LoadWeather_Compare);
+
+	cgi.Debug("%d emits\n", cg_weather_state.num_emits);
 }
 
 /*
@@ -162,9 +195,27 @@ void Cg_LoadEffects(void) {
 	Cg_LoadWeather();
 }
 
+/*
+ * @brief Returns true if the specified emitter intersects the weather volume,
+ * a column about the view.
+ */
+static _Bool Cg_WeatherVolume(const cg_weather_emit_t *e) {
+	const vec_t *view = cgi.view->origin;
+
+	if (e->mins[0] > view[0] + WEATHER_RADIUS || e->maxs[0] < view[0] - WEATHER_RADIUS)
+		return false;
+
+	if (e->mins[1] > view[1] + WEATHER_RADIUS || e->maxs[1] < view[1] - WEATHER_RADIUS)
+		return false;
+
+	return true;
+}
+
 /*
  * @brief Adds weather particles for the specified emitter. The number of particles
  * added is dependent on the size of the surface associated with the emitter.
+ * Only origins within the weather volume spawn particles, and their density
+ * falls off toward its edge.
  */
 static void Cg_AddWeather_(const cg_weather_emit_t *e) {
 	int32_t i;
@@ -174,13 +225,26 @@ static void Cg_AddWeather_(const cg_weather_emit_t *e) {
 		cg_particle_t *p;
 		int32_t j;
 
+		const vec_t *org = &e->origins[i * 3];
+
+		const vec_t dx = org[0] - cgi.view->origin[0];
+		const vec_t dy = org[1] - cgi.view->origin[1];
+
+		const vec_t dist = sqrt(dx * dx + dy * dy);
+
+		if (dist > WEATHER_RADIUS)
+			continue;
+
+		if (dist > WEATHER_LOD_NEAR) {
+			if (Randomf() * (WEATHER_RADIUS - WEATHER_LOD_NEAR) < dist - WEATHER_LOD_NEAR)
+				continue;
+		}
+
 		ps = cgi.view->weather & WEATHER_RAIN ? cg_particles_rain : cg_particles_snow;
 
 		if (!(p = Cg_AllocParticle(PARTICLE_WEATHER, ps)))
 			break;
 
-		const vec_t *org = &e->origins[i * 3];
-
 		// setup the origin and end_z
 		for (j = 0; j < 3; j++) {
 			p->part.org[j] = org[j] + Randomc() * 16.0;
@@ -224,6 +288,7 @@ static void Cg_AddWeather_(const cg_weather_emit_t *e) {
  * @brief Adds particles and issues ambient loop sounds for weather effects.
  */
 static void Cg_AddWeather(void) {
+	uint16_t i;
 
 	if (!cg_add_weather->value)
 		return;
@@ -246,13 +311,20 @@ static void Cg_AddWeather(void) {
 
 	cg_weather_state.time = cgi.client->time;
 
+	int16_t cluster = -2;
+	_Bool pvs = false;
+
 	const cg_weather_emit_t *e = cg_weather_state.emits;
+	for (i = 0; i < cg_weather_state.num_emits; i++, e++) {
+
+		if (e->leaf->cluster != cluster) { // resolve the visibility of the next cluster
+			cluster = e->leaf->cluster;
+			pvs = cgi.LeafInPvs(e->leaf);
+		}
 
-	while (e) {
-		if (cgi.LeafInPhs(e->leaf)) {
+		if (pvs && Cg_WeatherVolume(e)) {
 			Cg_AddWeather_(e);
 		}
-		e = e->next;
 	}
 }
 
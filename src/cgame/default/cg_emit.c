@@ -24,7 +24,8 @@
 /*
  * Emits are client-sided entities for emitting lights, particles, coronas,
  * ambient sounds, etc. They are run once per frame, and culled by both
- * PHS and PVS, depending on their flags.
+ * PHS and PVS, depending on their flags. Emits are sorted by cluster, so that
+ * the visibility of each cluster is resolved once for all of its emits.
  */
 
 #define EMIT_LIGHT		0x1
@@ -38,6 +39,12 @@
 // these emits are ONLY visible; they have no hearable component
 #define EMIT_VISIBLE (EMIT_LIGHT | EMIT_CORONA | EMIT_MODEL)
 
+// these emits spawn particles, which are only spawned in the PVS
+#define EMIT_PARTICLES (EMIT_SPARKS | EMIT_STEAM | EMIT_FLAME)
+
+#define EMIT_LOD_NEAR 512.0 // particle emits fire at their full rate within this distance
+#define EMIT_LOD_FAR 2048.0 // and at a quarter of it beyond this distance
+
 typedef struct cl_emit_s {
 	int32_t flags;
 	vec3_t org;
@@ -65,6 +72,16 @@ typedef struct cl_emit_s {
 static cg_emit_t cg_emits[MAX_EMITS];
 static uint16_t cg_num_emits;
 
+/*
+ * @brief qsort comparator for Cg_LoadEmits, ordering emits by cluster.
+ */
+static int32_t Cg_LoadEmits_Compare(const void *a, const void *b) {
+	const int16_t ca = ((const cg_emit_t *) a)->leaf->cluster;
+	const int16_t cb = ((const cg_emit_t *) b)->leaf->cluster;
+
+	return ca - cb;
+}
+
 /*
  * @brief Parse misc_emits from the bsp after it has been loaded. This must
  * be called after Cm_LoadMap, once per pre-cache routine.
@@ -305,6 +322,8 @@ void Cg_LoadEmits(void) {
 			continue;
 		}
 	}
+
+	qsort(cg_emits, cg_num_emits, sizeof(cg_emit_t), Cg_LoadEmits_Compare);
 }
 
 /*
@@ -321,23 +340,38 @@ static r_light_t *Cg_EmitLight(cg_emit_t *e) {
 }
 
 /*
- * @brief Perform PVS and PHS filtering, returning a copy of the specified emit with
- * the correct flags stripped away for this frame.
+ * @brief Returns the fraction of its rate at which the specified particle emit
+ * should fire, given its distance from the view.
+ */
+static vec_t Cg_EmitLod(const cg_emit_t *e) {
+	vec3_t delta;
+
+	VectorSubtract(e->org, cgi.view->origin, delta);
+
+	const vec_t frac = (VectorLength(delta) - EMIT_LOD_NEAR) / (EMIT_LOD_FAR - EMIT_LOD_NEAR);
+
+	return 1.0 - 0.75 * Clamp(frac, 0.0, 1.0);
+}
+
+/*
+ * @brief Returns a copy of the specified emit with the correct flags stripped
+ * away for this frame, given whether its cluster is in the PVS. Emits whose
+ * cluster is not in the PHS are not updated at all.
  */
-cg_emit_t *Cg_UpdateEmit(cg_emit_t *e) {
+static cg_emit_t *Cg_UpdateEmit(cg_emit_t *e, const _Bool pvs) {
 	static cg_emit_t em;
 
 	em = *e;
 
-	if (!cgi.LeafInPhs(e->leaf))
-		em.flags = 0;
-	else if (!cgi.LeafInPvs(e->leaf)) {
-		em.flags &= ~EMIT_VISIBLE;
+	if (!pvs) {
+		em.flags &= ~(EMIT_VISIBLE | EMIT_PARTICLES);
 	}
 
 	if (em.flags && em.hz && em.time < cgi.client->time) { // update the time stamp
+		const vec_t hz = (em.flags & EMIT_PARTICLES) ? e->hz * Cg_EmitLod(e) : e->hz;
 		const vec_t drift = e->drift * Randomf() * 1000.0;
-		e->time = cgi.client->time + (1000.0 / e->hz) + drift;
+
+		e->time = cgi.client->time + (1000.0 / hz) + drift;
 	}
 
 	return &em;
@@ -355,9 +389,22 @@ void Cg_AddEmits(void) {
 
 	memset(&ent, 0, sizeof(ent));
 
+	int16_t cluster = -2;
+	_Bool phs = false, pvs = false;
+
 	for (i = 0; i < cg_num_emits; i++) {
 
-		cg_emit_t *e = Cg_UpdateEmit(&cg_emits[i]);
+		if (cg_emits[i].leaf->cluster != cluster) { // resolve the visibility of the next cluster
+			cluster = cg_emits[i].leaf->cluster;
+
+			phs = cgi.LeafInPhs(cg_emits[i].leaf);
+			pvs = phs && cgi.LeafInPvs(cg_emits[i].leaf);
+		}
+
+		if (!phs)
+			continue;
+
+		cg_emit_t *e = Cg_UpdateEmit(&cg_emits[i], pvs);
 
 		// first add emits which fire every frame
 
@@ -119,6 +119,8 @@ static void Cg_Shutdown(void) {
 
 	cgi.Print("  Client game shutdown...\n");
 
+	Cg_FreeParticles();
+
 	cgi.FreeTag(MEM_TAG_CGAME_LEVEL);
 	cgi.FreeTag(MEM_TAG_CGAME);
 }
@@ -76,6 +76,8 @@ void Cg_UpdateMedia(void) {
 	cgi.FreeTag(MEM_TAG_CGAME);
 	cgi.FreeTag(MEM_TAG_CGAME_LEVEL);
 
+	Cg_InitParticles();
+
 	cg_sample_blaster_fire = cgi.LoadSample("weapons/blaster/fire");
 	cg_sample_blaster_hit = cgi.LoadSample("weapons/blaster/hit");
 	cg_sample_shotgun_fire = cgi.LoadSample("weapons/shotgun/fire");
@@ -19,138 +19,379 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
  */
 
-#include "cg_local.h"
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 
-static cg_particle_t *cg_free_particles; // list of free particles
-static cg_particles_t *cg_active_particles; // list of active particles, by image
+#include "cg_local.h"
 
-static cg_particle_t cg_particles[MAX_PARTICLES];
+#define MAX_PARTICLE_SPAWNS 0x4000 // particles which may be spawned in one frame
 
 /*
- * @brief Pushes the particle onto the head of specified list.
+ * @brief The live particles, as a structure of arrays, so that they are
+ * integrated by loops over contiguous memory. The render attributes of each
+ * particle are kept alongside, and are handed to the renderer in bulk. Freed
+ * particles are replaced with the last one. The arrays are sized to the view's
+ * particles when media is loaded.
  */
-static void Cg_PushParticle(cg_particle_t *p, cg_particle_t **list) {
-
-	p->prev = NULL;
-
-	if (*list) {
-		(*list)->prev = p;
-	}
-
-	p->next = *list;
-	*list = p;
-}
+typedef struct {
+	vec_t *alpha;
+	vec_t *alpha_vel;
+	vec_t *scale;
+	vec_t *scale_vel;
+	vec_t *org[3];
+	vec_t *end[3];
+	vec_t *vel[3];
+	vec_t *accel[3];
+	vec_t *end_z;
+	byte *weather;
+	byte *dead;
+
+	r_particle_t *part;
+	uint32_t count;
+	uint32_t size;
+
+	cg_particle_t spawns[MAX_PARTICLE_SPAWNS];
+	uint32_t num_spawns;
+} cg_particle_pool_t;
+
+static cg_particle_pool_t cg_particle_pool;
 
 /*
- * @brief Pops the particle from the specified list, repairing the list if it
- * becomes broken.
+ * @brief A contiguous chunk of the particle pool, integrated by one thread.
  */
-static void Cg_PopParticle(cg_particle_t *p, cg_particle_t **list) {
+typedef struct {
+	uint32_t first;
+	uint32_t count;
+	thread_t *thread;
+} cg_particle_chunk_t;
 
-	if (p->prev) {
-		p->prev->next = p->next;
-	}
+#define PARTICLE_CHUNK_MIN 4096
 
-	if (p->next) {
-		p->next->prev = p->prev;
-	}
+static struct {
+	cg_particle_chunk_t chunks[MAX_THREADS + 1];
+	uint16_t num_chunks;
 
-	if (*list == p) {
-		*list = p->next;
-	}
-
-	p->prev = p->next = NULL;
-}
+	vec_t delta;
+	vec_t delta_squared;
+} cg_particle_update;
 
 /*
- * @brief Allocates a free particle with the specified type and image.
+ * @brief Allocates a particle with the specified type and image. It is added
+ * to the particle pool, and to the view, by the next Cg_AddParticles. Particles
+ * are spawned from several view population jobs at once, so the spawn record
+ * is reserved atomically. The pool only shrinks while they run.
  */
 cg_particle_t *Cg_AllocParticle(const uint16_t type, cg_particles_t *particles) {
+	cg_particle_pool_t *pool = &cg_particle_pool;
+	uint32_t i;
 
 	if (!cg_add_particles->integer)
 		return NULL;
 
-	if (!cg_free_particles) {
-		cgi.Debug("No free particles\n");
-		return NULL;
-	}
+	do {
+		i = pool->num_spawns;
+
+		if (i == MAX_PARTICLE_SPAWNS || pool->count + i >= pool->size) {
+			cgi.Debug("No free particles\n");
+			return NULL;
+		}
+	} while (!__sync_bool_compare_and_swap(&pool->num_spawns, i, i + 1));
 
-	cg_particle_t *p = cg_free_particles;
+	cg_particle_t *p = &pool->spawns[i];
 
-	Cg_PopParticle(p, &cg_free_particles);
+	memset(p, 0, sizeof(*p));
+
+	p->part.blend = GL_ONE;
+	p->part.alpha = 1.0;
+	p->part.scale = 1.0;
 
 	particles = particles ? particles : cg_particles_normal;
 
 	p->part.type = type;
 	p->part.image = particles->image;
 
-	Cg_PushParticle(p, &particles->particles);
+	return p;
+}
+
+/*
+ * @brief Allocates a particles handle for the specified image.
+ */
+cg_particles_t *Cg_AllocParticles(const r_image_t *image) {
+	cg_particles_t *particles;
 
-	p->time = cgi.client->time;
+	particles = cgi.Malloc(sizeof(*particles), MEM_TAG_CGAME);
+	particles->image = image;
 
-	return p;
+	return particles;
 }
 
 /*
- * @brief Frees the specified particle, returning the particle it was pointing
- * to as a convenience for continued iteration.
+ * @brief Allocates the particle pool, sized to the view's particles, so that
+ * its footprint follows r_max_particles. It is released with MEM_TAG_CGAME.
  */
-static cg_particle_t *Cg_FreeParticle(cg_particle_t *p, cg_particle_t **list) {
-	cg_particle_t *next = p->next;
+void Cg_InitParticles(void) {
+	cg_particle_pool_t *pool = &cg_particle_pool;
+	int32_t i;
 
-	if (list) {
-		Cg_PopParticle(p, list);
+	const uint32_t size = cgi.view->max_particles;
+
+	pool->alpha = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+	pool->alpha_vel = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+	pool->scale = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+	pool->scale_vel = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+
+	for (i = 0; i < 3; i++) {
+		pool->org[i] = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+		pool->end[i] = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+		pool->vel[i] = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+		pool->accel[i] = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
 	}
 
-	memset(p, 0, sizeof(cg_particle_t));
+	pool->end_z = cgi.Malloc(size * sizeof(vec_t), MEM_TAG_CGAME);
+	pool->weather = cgi.Malloc(size, MEM_TAG_CGAME);
+	pool->dead = cgi.Malloc(size, MEM_TAG_CGAME);
 
-	p->part.blend = GL_ONE;
-	p->part.alpha = 1.0;
-	p->part.scale = 1.0;
+	pool->part = cgi.Malloc(size * sizeof(r_particle_t), MEM_TAG_CGAME);
 
-	Cg_PushParticle(p, &cg_free_particles);
+	pool->size = size;
+}
 
-	return next;
+/*
+ * @brief Frees all particles, including those spawned this frame. The pool
+ * may no longer be used until Cg_InitParticles, as its memory is about to be
+ * released with MEM_TAG_CGAME.
+ */
+void Cg_FreeParticles(void) {
+
+	cg_particle_pool.count = 0;
+	cg_particle_pool.size = 0;
+
+	cg_particle_pool.num_spawns = 0;
 }
 
 /*
- * @brief Allocates a particles chain for the specified image.
+ * @brief Integrates a chunk of the particle pool, flagging those which fade
+ * or shrink beyond visibility, and weather particles which hit the ground.
+ * The results are written back to the render attributes of each particle.
+ * Where SSE is available, four particles are integrated per iteration, and
+ * the remainder by the scalar loops.
  */
-cg_particles_t *Cg_AllocParticles(const r_image_t *image) {
-	cg_particles_t *particles;
+static void Cg_UpdateParticles_(void *data) {
+	const cg_particle_chunk_t *chunk = (const cg_particle_chunk_t *) data;
+	cg_particle_pool_t *pool = &cg_particle_pool;
+	uint32_t i, j;
 
-	particles = cgi.Malloc(sizeof(*particles), MEM_TAG_CGAME);
-	particles->image = image;
+	const uint32_t first = chunk->first, count = chunk->count;
 
-	particles->next = cg_active_particles;
-	cg_active_particles = particles;
+	const vec_t delta = cg_particle_update.delta;
+	const vec_t delta_squared = cg_particle_update.delta_squared;
 
-	return particles;
+#if defined(__SSE__)
+	const __m128 delta4 = _mm_set1_ps(delta), delta_squared4 = _mm_set1_ps(delta_squared);
+#endif
+
+	vec_t *restrict alpha = pool->alpha + first;
+	vec_t *restrict scale = pool->scale + first;
+
+	const vec_t *restrict alpha_vel = pool->alpha_vel + first;
+	const vec_t *restrict scale_vel = pool->scale_vel + first;
+
+	i = 0;
+
+#if defined(__SSE__)
+	for (; i + 4 <= count; i += 4) {
+		const __m128 a = _mm_mul_ps(delta4, _mm_loadu_ps(alpha_vel + i));
+		const __m128 s = _mm_mul_ps(delta4, _mm_loadu_ps(scale_vel + i));
+
+		_mm_storeu_ps(alpha + i, _mm_add_ps(_mm_loadu_ps(alpha + i), a));
+		_mm_storeu_ps(scale + i, _mm_add_ps(_mm_loadu_ps(scale + i), s));
+	}
+#endif
+
+	for (; i < count; i++) {
+		alpha[i] += delta * alpha_vel[i];
+		scale[i] += delta * scale_vel[i];
+	}
+
+	for (j = 0; j < 3; j++) { // update origin, end, and velocity
+		vec_t *restrict org = pool->org[j] + first;
+		vec_t *restrict end = pool->end[j] + first;
+		vec_t *restrict vel = pool->vel[j] + first;
+
+		const vec_t *restrict accel = pool->accel[j] + first;
+
+		i = 0;
+
+#if defined(__SSE__)
+		for (; i + 4 <= count; i += 4) {
+			const __m128 v = _mm_loadu_ps(vel + i), a = _mm_loadu_ps(accel + i);
+
+			const __m128 d = _mm_add_ps(_mm_mul_ps(v, delta4), _mm_mul_ps(a, delta_squared4));
+
+			_mm_storeu_ps(org + i, _mm_add_ps(_mm_loadu_ps(org + i), d));
+			_mm_storeu_ps(end + i, _mm_add_ps(_mm_loadu_ps(end + i), d));
+
+			_mm_storeu_ps(vel + i, _mm_add_ps(v, _mm_mul_ps(a, delta4)));
+		}
+#endif
+
+		for (; i < count; i++) {
+			const vec_t d = vel[i] * delta + accel[i] * delta_squared;
+
+			org[i] += d;
+			end[i] += d;
+
+			vel[i] += accel[i] * delta;
+		}
+	}
+
+	const vec_t *restrict z = pool->org[2] + first;
+	const vec_t *restrict end_z = pool->end_z + first;
+	const byte *restrict weather = pool->weather + first;
+
+	byte *restrict dead = pool->dead + first;
+
+	i = 0;
+
+#if defined(__SSE__)
+	const __m128 zero = _mm_setzero_ps();
+
+	for (; i + 4 <= count; i += 4) {
+		const __m128 a = _mm_cmple_ps(_mm_loadu_ps(alpha + i), zero);
+		const __m128 s = _mm_cmple_ps(_mm_loadu_ps(scale + i), zero);
+		const __m128 g = _mm_cmple_ps(_mm_loadu_ps(z + i), _mm_loadu_ps(end_z + i));
+
+		const int32_t faded = _mm_movemask_ps(_mm_or_ps(a, s)), grounded = _mm_movemask_ps(g);
+
+		for (j = 0; j < 4; j++) {
+			dead[i + j] = ((faded >> j) & 1) | (weather[i + j] & ((grounded >> j) & 1));
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		dead[i] = (alpha[i] <= 0.0) | (scale[i] <= 0.0) | (weather[i] & (z[i] <= end_z[i]));
+	}
+
+	r_particle_t *p = pool->part + first;
+	for (i = 0; i < count; i++, p++) {
+		const uint32_t k = first + i;
+
+		p->alpha = alpha[i];
+		p->scale = scale[i];
+
+		for (j = 0; j < 3; j++) {
+			p->org[j] = pool->org[j][k];
+			p->end[j] = pool->end[j][k];
+		}
+	}
 }
 
 /*
- * @brief Frees all particles, returning them to the eligible list.
+ * @brief Dispatches the integration of the particle pool over the thread pool,
+ * and waits for it to complete.
  */
-void Cg_FreeParticles(void) {
+static void Cg_IntegrateParticles(void) {
+	const uint32_t count = cg_particle_pool.count;
 	uint32_t i;
 
-	cg_free_particles = NULL;
-	cg_active_particles = NULL;
+	if (!count)
+		return;
+
+	cg_particle_update.num_chunks = Clamp(count / PARTICLE_CHUNK_MIN, 1, cgi.ThreadCount() + 1);
+
+	const uint32_t size = (count + cg_particle_update.num_chunks - 1) / cg_particle_update.num_chunks;
+
+	cg_particle_chunk_t *chunk = cg_particle_update.chunks;
+	for (i = 0; i < cg_particle_update.num_chunks; i++, chunk++) {
 
-	memset(cg_particles, 0, sizeof(cg_particles));
+		const uint32_t offset = MIN(i * size, count);
 
-	for (i = 0; i < lengthof(cg_particles); i++) {
-		Cg_FreeParticle(&cg_particles[i], NULL);
+		chunk->first = offset;
+		chunk->count = MIN(size, count - offset);
+
+		chunk->thread = cgi.Thread("Cg_UpdateParticles_", Cg_UpdateParticles_, chunk);
+	}
+
+	for (i = 0; i < cg_particle_update.num_chunks; i++) {
+		cgi.Wait(cg_particle_update.chunks[i].thread);
 	}
 }
 
 /*
- * @brief Adds all particles that are active for this frame to the view.
- * Particles that fade or shrink beyond visibility are freed.
+ * @brief Frees the specified particle by moving the last particle into its slot.
  */
-void Cg_AddParticles(void) {
+static void Cg_FreeParticle(const uint32_t i) {
+	cg_particle_pool_t *pool = &cg_particle_pool;
+	uint32_t j;
+
+	const uint32_t last = --pool->count;
+
+	if (i == last)
+		return;
+
+	pool->alpha[i] = pool->alpha[last];
+	pool->alpha_vel[i] = pool->alpha_vel[last];
+	pool->scale[i] = pool->scale[last];
+	pool->scale_vel[i] = pool->scale_vel[last];
+
+	for (j = 0; j < 3; j++) {
+		pool->org[j][i] = pool->org[j][last];
+		pool->end[j][i] = pool->end[j][last];
+		pool->vel[j][i] = pool->vel[j][last];
+		pool->accel[j][i] = pool->accel[j][last];
+	}
+
+	pool->end_z[i] = pool->end_z[last];
+	pool->weather[i] = pool->weather[last];
+	pool->dead[i] = pool->dead[last];
+
+	pool->part[i] = pool->part[last];
+}
+
+/*
+ * @brief Moves the particles spawned since the last frame into the pool.
+ */
+static void Cg_SpawnParticles(void) {
+	cg_particle_pool_t *pool = &cg_particle_pool;
+	uint32_t i, j;
+
+	const cg_particle_t *p = pool->spawns;
+	for (i = 0; i < pool->num_spawns; i++, p++) {
+		const uint32_t k = pool->count++;
+
+		pool->alpha[k] = p->part.alpha;
+		pool->alpha_vel[k] = p->alpha_vel;
+		pool->scale[k] = p->part.scale;
+		pool->scale_vel[k] = p->scale_vel;
+
+		for (j = 0; j < 3; j++) {
+			pool->org[j][k] = p->part.org[j];
+			pool->end[j][k] = p->part.end[j];
+			pool->vel[j][k] = p->vel[j];
+			pool->accel[j][k] = p->accel[j];
+		}
+
+		pool->end_z[k] = p->end_z;
+		pool->weather[k] = p->part.type == PARTICLE_WEATHER;
+		pool->dead[k] = false;
+
+		pool->part[k] = p->part;
+	}
+
+	pool->num_spawns = 0;
+}
+
+/*
+ * @brief Updates the particles spawned in previous frames, freeing those that
+ * fade or shrink beyond visibility. This runs alongside the other view
+ * population jobs, which may only spawn particles.
+ */
+void Cg_UpdateParticles(void) {
 	static uint32_t last_particle_time;
-	int32_t i;
+	cg_particle_pool_t *pool = &cg_particle_pool;
+	uint32_t i;
 
 	if (!cg_add_particles->value)
 		return;
@@ -158,46 +399,35 @@ void Cg_AddParticles(void) {
 	if (last_particle_time > cgi.client->time)
 		last_particle_time = 0;
 
-	const vec_t delta = (cgi.client->time - last_particle_time) * 0.001;
-	const vec_t delta_squared = delta * delta;
+	cg_particle_update.delta = (cgi.client->time - last_particle_time) * 0.001;
+	cg_particle_update.delta_squared = cg_particle_update.delta * cg_particle_update.delta;
 
 	last_particle_time = cgi.client->time;
 
-	cg_particles_t *ps = cg_active_particles;
-	while (ps) {
-
-		cg_particle_t *p = ps->particles;
-		while (p) {
-			// update any particles allocated in previous frames
-			if (p->time != cgi.client->time) {
+	Cg_IntegrateParticles();
 
-				p->part.alpha += delta * p->alpha_vel;
-				p->part.scale += delta * p->scale_vel;
-
-				// free up particles that have disappeared
-				if (p->part.alpha <= 0.0 || p->part.scale <= 0.0) {
-					p = Cg_FreeParticle(p, &ps->particles);
-					continue;
-				}
-
-				for (i = 0; i < 3; i++) { // update origin, end, and acceleration
-					p->part.org[i] += p->vel[i] * delta + p->accel[i] * delta_squared;
-					p->part.end[i] += p->vel[i] * delta + p->accel[i] * delta_squared;
+	// free up particles that have disappeared
+	for (i = 0; i < pool->count;) {
+		if (pool->dead[i]) {
+			Cg_FreeParticle(i);
+		} else {
+			i++;
+		}
+	}
+}
 
-					p->vel[i] += p->accel[i] * delta;
-				}
+/*
+ * @brief Adds all particles that are active for this frame to the view, once
+ * they have been updated. Particles spawned this frame are added as they were
+ * spawned.
+ */
+void Cg_AddParticles(void) {
+	cg_particle_pool_t *pool = &cg_particle_pool;
 
-				// free up weather particles that have hit the ground
-				if (p->part.type == PARTICLE_WEATHER && (p->part.org[2] <= p->end_z)) {
-					p = Cg_FreeParticle(p, &ps->particles);
-					continue;
-				}
-			}
+	if (!cg_add_particles->value)
+		return;
 
-			cgi.AddParticle(&p->part);
-			p = p->next;
-		}
+	Cg_SpawnParticles();
 
-		ps = ps->next;
-	}
+	cgi.AddParticles(pool->part, pool->count);
 }
@@ -28,7 +28,9 @@
 
 cg_particle_t *Cg_AllocParticle(const uint16_t type, cg_particles_t *particles);
 cg_particles_t *Cg_AllocParticles(const r_image_t *image);
+void Cg_InitParticles(void);
 void Cg_FreeParticles(void);
+void Cg_UpdateParticles(void);
 void Cg_AddParticles(void);
 #endif /* __CG_LOCAL_H__ */
 
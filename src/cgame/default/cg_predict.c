@@ -40,16 +40,26 @@ static void Cg_PredictMovement_Debug(const char *msg) {
 /*
  * @brief Run recent movement commands through the player movement code
  * locally, storing the resulting origin and angles so that they may be
- * interpolated to by Cl_UpdateView.
+ * interpolated to by Cl_UpdateView. Simulation resumes from the cached result
+ * of the command preceding the first command in the list, and the result of
+ * each command is cached in turn.
  */
 void Cg_PredictMovement(const GList *cmds) {
 	pm_move_t pm;
 
-	// copy current state to into the move
+	if (!cmds)
+		return;
+
+	cl_predicted_state_t *state = &cgi.client->predicted_state;
+
+	const cl_cmd_t *first = (cl_cmd_t *) cmds->data;
+	const uint32_t from = ((intptr_t) (first - cgi.client->cmds) - 1) & CMD_MASK;
+
+	// resume from the cached state
 	memset(&pm, 0, sizeof(pm));
-	pm.s = cgi.client->frame.ps.pm_state;
+	pm.s = state->moves[from].pm_state;
 
-	pm.ground_entity = cgi.client->predicted_state.ground_entity;
+	pm.ground_entity = state->moves[from].ground_entity;
 
 	pm.PointContents = cgi.PointContents;
 	pm.Trace = Cg_PredictMovement_Trace;
@@ -69,25 +79,26 @@ void Cg_PredictMovement(const GList *cmds) {
 
 			// for each movement, check for stair interaction and interpolate
 			if (pm.s.flags & PMF_ON_STAIRS) {
-				cgi.client->predicted_state.step_time = cmd->time;
-				cgi.client->predicted_state.step_interval = 120 * (fabs(pm.step) / 16.0);
-				cgi.client->predicted_state.step = pm.step;
+				state->step_time = cmd->time;
+				state->step_interval = 120 * (fabs(pm.step) / 16.0);
+				state->step = pm.step;
 			}
-
-			// save for debug checking
-			const uint32_t frame = (intptr_t) (cmd - cgi.client->cmds);
-			VectorCopy(pm.s.origin, cgi.client->predicted_state.origins[frame]);
 		}
 
+		// cache the result for subsequent frames and error checking
+		const uint32_t frame = (intptr_t) (cmd - cgi.client->cmds);
+
+		state->moves[frame].pm_state = pm.s;
+		state->moves[frame].ground_entity = pm.ground_entity;
+
 		e = e->next;
 	}
 
 	// copy results out for rendering
-	UnpackVector(pm.s.origin, cgi.client->predicted_state.origin);
+	UnpackVector(pm.s.origin, state->origin);
 
-	UnpackVector(pm.s.view_offset, cgi.client->predicted_state.view_offset);
-	UnpackAngles(pm.cmd.angles, cgi.client->predicted_state.view_angles);
+	UnpackVector(pm.s.view_offset, state->view_offset);
+	UnpackAngles(pm.cmd.angles, state->view_angles);
 
-	cgi.client->predicted_state.ground_entity = pm.ground_entity;
+	state->ground_entity = pm.ground_entity;
 }
-
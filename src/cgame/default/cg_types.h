@@ -27,6 +27,10 @@
 
 #ifdef __CG_LOCAL_H__
 
+/*
+ * @brief A particle spawned this frame. Effects fill these in, and they are
+ * moved into the particle pool when particles are next added to the view.
+ */
 typedef struct cg_particle_s {
 	r_particle_t part; // the r_particle_t to add to the view
 	vec3_t vel;
@@ -34,16 +38,11 @@ typedef struct cg_particle_s {
 	vec_t alpha_vel;
 	vec_t scale_vel;
 	vec_t end_z; // weather particles are freed at this Z
-	uint32_t time; // client time when allocated
-	struct cg_particle_s *prev; // previous particle in the chain
-	struct cg_particle_s *next; // next particle in chain
 } cg_particle_t;
 
-// particles are chained by image
+// particles are allocated by image
 typedef struct cg_particles_s {
 	const r_image_t *image;
-	cg_particle_t *particles;
-	struct cg_particles_s *next;
 } cg_particles_t;
 
 #endif /* __CG_LOCAL_H__ */
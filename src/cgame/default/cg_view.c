@@ -155,21 +155,57 @@ void Cg_UpdateView(const cl_frame_t *frame) {
 	Cg_UpdateBob(&frame->ps);
 }
 
+/*
+ * @brief Thread entry point for adding the entities of the frame.
+ */
+static void Cg_AddEntities_(void *data) {
+	Cg_AddEntities((const cl_frame_t *) data);
+}
+
+/*
+ * @brief Thread entry point for adding client side emits.
+ */
+static void Cg_AddEmits_(void *data __attribute__((unused))) {
+	Cg_AddEmits();
+}
+
+/*
+ * @brief Thread entry point for adding client side effects.
+ */
+static void Cg_AddEffects_(void *data __attribute__((unused))) {
+	Cg_AddEffects();
+}
+
+/*
+ * @brief Thread entry point for updating particles spawned in previous frames.
+ */
+static void Cg_UpdateParticles_(void *data __attribute__((unused))) {
+	Cg_UpdateParticles();
+}
+
 /*
  * @brief Processes all entities, particles, emits, etc.. adding them to the view.
  * This is called once per frame by the engine, after Cg_UpdateView, and is run
  * in a separate thread while the renderer begins drawing the world.
+ *
+ * The entities, emits, effects and the update of existing particles are
+ * independent of one another, and are dispatched over the thread pool. They
+ * may spawn particles, which are added to the view once all have completed.
  */
 void Cg_PopulateView(const cl_frame_t *frame) {
 
-	// add entities
-	Cg_AddEntities(frame);
+	thread_t *particles = cgi.Thread("Cg_UpdateParticles_", Cg_UpdateParticles_, NULL);
 
-	// and client side emits
-	Cg_AddEmits();
+	thread_t *entities = cgi.Thread("Cg_AddEntities_", Cg_AddEntities_, (void *) frame);
 
-	// and client side effects
-	Cg_AddEffects();
+	thread_t *emits = cgi.Thread("Cg_AddEmits_", Cg_AddEmits_, NULL);
+
+	// add client side effects on this thread
+	Cg_AddEffects_(NULL);
+
+	cgi.Wait(emits);
+	cgi.Wait(entities);
+	cgi.Wait(particles);
 
 	// and finally particles
 	Cg_AddParticles();
@@ -129,6 +129,10 @@ void Cl_InitCgame(void) {
 
 	import.Time = Sys_Milliseconds;
 
+	import.Thread = Thread_Create_;
+	import.Wait = Thread_Wait;
+	import.ThreadCount = Thread_Count;
+
 	import.Malloc = Mem_TagMalloc;
 	import.LinkMalloc = Mem_LinkMalloc;
 	import.Free = Mem_Free;
@@ -188,6 +192,7 @@ void Cl_InitCgame(void) {
 	import.AddLinkedEntity = R_AddLinkedEntity;
 	import.AddLight = R_AddLight;
 	import.AddParticle = R_AddParticle;
+	import.AddParticles = R_AddParticles;
 	import.AddSustainedLight = R_AddSustainedLight;
 
 	import.DrawImage = R_DrawImage;
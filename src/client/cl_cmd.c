@@ -79,6 +79,23 @@ static void Cl_FinalizeCmd(void) {
 	//Com_Debug("%3dms: %4d forward %4d right %4d up\n", cmd->cmd.msec, cmd->cmd.forward, cmd->cmd.right, cmd->cmd.up);
 }
 
+/*
+ * @brief Selectively acknowledges the chunks of a PROTOCOL download received
+ * since the last packet. The server slides its window up to the contiguous
+ * offset, and retransmits only those chunks missing from the mask.
+ */
+static void Cl_WriteDownloadAck(mem_buf_t *buf) {
+
+	if (!cls.download.udp || !cls.download.ack)
+		return;
+
+	Net_WriteByte(buf, CL_CMD_STRING);
+	Net_WriteString(buf, va("dlack %d %d %u", cls.download.id, cls.download.offset,
+			cls.download.received >> 1));
+
+	cls.download.ack = false;
+}
+
 /*
  * @brief Pumps the command cycle, sending the most recently gathered movement
  * to the server.
@@ -91,9 +108,14 @@ void Cl_SendCmd(void) {
 		return;
 
 	if (cls.state == CL_CONNECTED) {
+		Mem_InitBuffer(&buf, data, sizeof(data));
+
+		// acknowledge any download chunks we've received
+		Cl_WriteDownloadAck(&buf);
+
 		// send any reliable messages and / or don't timeout
-		if (cls.net_chan.message.size || cls.real_time - cls.net_chan.last_sent > 1000)
-			Netchan_Transmit(&cls.net_chan, NULL, 0);
+		if (buf.size || cls.net_chan.message.size || cls.real_time - cls.net_chan.last_sent > 1000)
+			Netchan_Transmit(&cls.net_chan, buf.data, buf.size);
 		return;
 	}
 
@@ -115,11 +137,15 @@ void Cl_SendCmd(void) {
 
 	// let the server know what the last frame we got was, so the next
 	// message can be delta compressed
-	if (!cl.frame.valid || (cls.demo_file && Fs_Tell(cls.demo_file) == 0))
+	if (!cl.frame.valid || Cl_RequestDemoKeyframe())
 		Net_WriteLong(&buf, -1); // no compression
 	else
 		Net_WriteLong(&buf, cl.frame.frame_num);
 
+	// and which baselines we've folded, so that the server may start using them
+	if (cl.protocol == PROTOCOL)
+		Net_WriteLong(&buf, cl.pending_baseline.frame_num);
+
 	// send this and the previous two cmds in the message, so
 	// if the last packet was dropped, it can be recovered
 	static user_cmd_t null_cmd;
@@ -135,6 +161,9 @@ void Cl_SendCmd(void) {
 	cmd = &cl.cmds[(cls.net_chan.outgoing_sequence) & CMD_MASK];
 	Net_WriteDeltaUserCmd(&buf, old_cmd, &cmd->cmd);
 
+	// acknowledge any download chunks we've received
+	Cl_WriteDownloadAck(&buf);
+
 	// deliver the message
 	Netchan_Transmit(&cls.net_chan, buf.data, buf.size);
 
@@ -21,6 +21,35 @@
 
 #include "cl_local.h"
 
+/*
+ * @brief Writes the specified message to the demo file, clearing it.
+ */
+static void Cl_WriteDemoBuffer(mem_buf_t *msg) {
+
+	Demo_WriteMessage(cls.demo_file, cl.frame.frame_num, msg->data, msg->size);
+
+	Mem_ClearBuffer(msg);
+}
+
+/*
+ * @brief Writes all config_strings, flushing the message as it fills.
+ */
+static void Cl_WriteDemoConfigStrings(mem_buf_t *msg) {
+	int32_t i;
+
+	for (i = 0; i < MAX_CONFIG_STRINGS; i++) {
+		if (*cl.config_strings[i] != '\0') {
+			if (msg->size + strlen(cl.config_strings[i]) + 32 > msg->max_size) { // write it out
+				Cl_WriteDemoBuffer(msg);
+			}
+
+			Net_WriteByte(msg, SV_CMD_CONFIG_STRING);
+			Net_WriteShort(msg, i);
+			Net_WriteString(msg, cl.config_strings[i]);
+		}
+	}
+}
+
 /*
  * @brief Writes server_data, config_strings, and baselines once a non-delta
  * compressed frame arrives from the server.
@@ -29,7 +58,6 @@ static void Cl_WriteDemoHeader(void) {
 	byte buffer[MAX_MSG_SIZE];
 	mem_buf_t msg;
 	int32_t i;
-	int32_t len;
 	entity_state_t null_state;
 
 	// write out messages to hold the startup information
@@ -37,7 +65,7 @@ static void Cl_WriteDemoHeader(void) {
 
 	// write the server data
 	Net_WriteByte(&msg, SV_CMD_SERVER_DATA);
-	Net_WriteLong(&msg, PROTOCOL);
+	Net_WriteLong(&msg, cl.protocol);
 	Net_WriteLong(&msg, cl.server_count);
 	Net_WriteLong(&msg, cl.server_hz);
 	Net_WriteByte(&msg, 1); // demo_server byte
@@ -46,81 +74,124 @@ static void Cl_WriteDemoHeader(void) {
 	Net_WriteString(&msg, cl.config_strings[CS_NAME]);
 
 	// and config_strings
-	for (i = 0; i < MAX_CONFIG_STRINGS; i++) {
-		if (*cl.config_strings[i] != '\0') {
-			if (msg.size + strlen(cl.config_strings[i]) + 32 > msg.max_size) { // write it out
-				len = LittleLong(msg.size);
-				Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-				Fs_Write(cls.demo_file, msg.data, msg.size, 1);
-				msg.size = 0;
-			}
-
-			Net_WriteByte(&msg, SV_CMD_CONFIG_STRING);
-			Net_WriteShort(&msg, i);
-			Net_WriteString(&msg, cl.config_strings[i]);
-		}
-	}
+	Cl_WriteDemoConfigStrings(&msg);
 
 	// and baselines
 	for (i = 0; i < MAX_EDICTS; i++) {
-		entity_state_t *ent = &cl.entities[i].baseline;
+		entity_state_t *ent = &cl.baselines[i];
 		if (!ent->number)
 			continue;
 
 		if (msg.size + 64 > msg.max_size) { // write it out
-			len = LittleLong(msg.size);
-			Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-			Fs_Write(cls.demo_file, msg.data, msg.size, 1);
-			msg.size = 0;
+			Cl_WriteDemoBuffer(&msg);
 		}
 
 		memset(&null_state, 0, sizeof(null_state));
 
 		Net_WriteByte(&msg, SV_CMD_BASELINE);
-		Net_WriteDeltaEntity(&msg, &null_state, &cl.entities[i].baseline, true, true);
+		Net_WriteDeltaEntity(&msg, &null_state, &cl.baselines[i], true, true);
 	}
 
 	Net_WriteByte(&msg, SV_CMD_CBUF_TEXT);
 	Net_WriteString(&msg, "precache 0\n");
 
 	// write it to the demo file
-
-	len = LittleLong(msg.size);
-	Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-	Fs_Write(cls.demo_file, msg.data, msg.size, 1);
+	Cl_WriteDemoBuffer(&msg);
 
 	Com_Debug("Demo started\n");
 	// the rest of the demo file will be individual frames
 }
 
 /*
- * @brief Dumps the current net message, prefixed by the length.
+ * @brief Begins a new block of the demo file at the current frame, which must
+ * be uncompressed. The config_strings are written again so that playback may
+ * seek here.
+ */
+static void Cl_WriteDemoKeyframe(void) {
+	byte buffer[MAX_MSG_SIZE];
+	mem_buf_t msg;
+
+	Demo_BeginKeyframe(cls.demo_file, cl.frame.frame_num);
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	Cl_WriteDemoConfigStrings(&msg);
+
+	if (msg.size) {
+		Cl_WriteDemoBuffer(&msg);
+	}
+
+	cls.demo_keyframe = cl.frame.frame_num;
+	cls.demo_keyframe_sequence = 0;
+
+	Com_Debug("Keyframe %d\n", cls.demo_keyframe);
+}
+
+/*
+ * @brief Returns true if the demo being recorded needs a keyframe, in which
+ * case the server is asked for an uncompressed frame. The server reverts to
+ * the map baselines when asked, so the following frames will not depend on
+ * anything before it.
+ */
+_Bool Cl_RequestDemoKeyframe(void) {
+
+	if (!cls.demo_file)
+		return false;
+
+	if (cls.demo_keyframe != -1) {
+
+		if (cl_demo_keyframe->value <= 0.0)
+			return false;
+
+		const int32_t interval = cl_demo_keyframe->value * cl.server_hz;
+
+		if (cl.frame.frame_num - cls.demo_keyframe < interval)
+			return false;
+	}
+
+	if (!cls.demo_keyframe_sequence) {
+		cls.demo_keyframe_sequence = cls.net_chan.outgoing_sequence;
+	}
+
+	return true;
+}
+
+/*
+ * @brief Dumps the current net message, beginning a keyframe when one is due.
  */
 void Cl_WriteDemoMessage(void) {
 
 	if (!cls.demo_file)
 		return;
 
-	if (!Fs_Tell(cls.demo_file)) {
-		if (cl.frame.delta_frame_num < 0) {
-			Com_Debug("Received uncompressed frame, writing demo header..\n");
-			Cl_WriteDemoHeader();
-		} else {
-			return; // wait for an uncompressed packet
+	// an uncompressed frame sent after the server received our request for it
+	if (cls.demo_keyframe_sequence && cls.net_chan.incoming_acknowledged
+			>= cls.demo_keyframe_sequence) {
+
+		if (cl.frame.valid && cl.frame.frame_num != cls.demo_file->frame_num
+				&& cl.frame.delta_frame_num <= 0 && !cl.baseline.frame_num) {
+
+			if (cls.demo_keyframe == -1) {
+				Com_Debug("Received uncompressed frame, writing demo header..\n");
+				Cl_WriteDemoHeader();
+			}
+
+			Cl_WriteDemoKeyframe();
 		}
 	}
 
+	if (cls.demo_keyframe == -1)
+		return; // wait for an uncompressed packet
+
 	// the first eight bytes are just packet sequencing stuff
-	int32_t len = LittleLong(net_message.size - 8);
-	Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-	Fs_Write(cls.demo_file, net_message.data + 8, len, 1);
+	Demo_WriteMessage(cls.demo_file, cl.frame.frame_num, net_message.data + 8,
+			net_message.size - 8);
 }
 
 /*
  * @brief Stop recording a demo
  */
 void Cl_Stop_f(void) {
-	int32_t len = -1;
 
 	if (!cls.demo_file) {
 		Com_Print("Not recording a demo\n");
@@ -128,8 +199,7 @@ void Cl_Stop_f(void) {
 	}
 
 	// finish up
-	Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-	Fs_Close(cls.demo_file);
+	Demo_Close(cls.demo_file);
 
 	cls.demo_file = NULL;
 	Com_Print("Stopped demo\n");
@@ -159,12 +229,17 @@ void Cl_Record_f(void) {
 
 	g_snprintf(cls.demo_filename, sizeof(cls.demo_filename), "demos/%s.dem", Cmd_Argv(1));
 
+	const uint32_t flags = cl_demo_compress->value ? DEMO_COMPRESS : 0;
+
 	// open the demo file
-	if (!(cls.demo_file = Fs_OpenWrite(cls.demo_filename))) {
+	if (!(cls.demo_file = Demo_OpenWrite(cls.demo_filename, cl.server_hz, flags))) {
 		Com_Warn("Couldn't open %s\n", cls.demo_filename);
 		return;
 	}
 
+	cls.demo_keyframe = -1;
+	cls.demo_keyframe_sequence = 0;
+
 	Com_Print("Recording to %s\n", cls.demo_filename);
 }
 
@@ -198,3 +273,24 @@ void Cl_FastForward_f(void) {
 void Cl_SlowMotion_f(void) {
 	Cl_AdjustDemoPlayback(-DEMO_PLAYBACK_STEP);
 }
+
+/*
+ * @brief seek <[+|-]seconds>
+ *
+ * Asks the demo server to seek to the keyframe nearest the specified time.
+ */
+void Cl_Seek_f(void) {
+
+	if (Cmd_Argc() != 2) {
+		Com_Print("Usage: %s <[+|-]seconds>\n", Cmd_Argv(0));
+		return;
+	}
+
+	if (!cl.demo_server) {
+		Com_Print("Not viewing a demo\n");
+		return;
+	}
+
+	Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
+	Net_WriteString(&cls.net_chan.message, va("seek %s", Cmd_Argv(1)));
+}
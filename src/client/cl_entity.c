@@ -22,172 +22,65 @@
 #include "cl_local.h"
 
 /*
- * @brief Parses deltas from the given base and adds the resulting entity
- * to the current frame.
+ * @brief Resolves the entity states of the specified frame.
  */
-static void Cl_ParseDeltaEntity(cl_frame_t *frame, entity_state_t *from, uint16_t number,
-		uint16_t bits) {
+static void Cl_FrameEntities(const cl_frame_t *frame, net_entities_t *entities) {
 
-	cl_entity_t *ent = &cl.entities[number];
-
-	entity_state_t *to = &cl.entity_states[cl.entity_state & ENTITY_STATE_MASK];
-	cl.entity_state++;
-
-	frame->num_entities++;
-
-	Net_ReadDeltaEntity(&net_message, from, to, number, bits);
-
-	// some changes will force no interpolation
-	if (from->model1 != to->model1
-			|| from->model2 != to->model2
-			|| from->model3 != to->model3
-			|| from->model4 != to->model4
-			|| fabs(from->origin[0] - to->origin[0]) > 256.0
-			|| fabs(from->origin[1] - to->origin[1]) > 256.0
-			|| fabs(from->origin[2] - to->origin[2]) > 256.0) {
-		ent->frame_num = -1;
-	}
-
-	if (ent->frame_num != cl.frame.frame_num - 1) {
-		// wasn't in last update, so initialize some things
-		// duplicate the current state so interpolation works
-		ent->prev = *to;
-		VectorCopy(to->old_origin, ent->prev.origin);
-		ent->animation1.time = ent->animation2.time = 0;
-	} else { // shuffle the last state to previous
-		ent->prev = ent->current;
-	}
-
-	// finally set the current frame number and entity state
-	ent->frame_num = cl.frame.frame_num;
-	ent->current = *to;
+	entities->states = cl.entity_states;
+	entities->num_states = ENTITY_STATE_BACKUP;
+	entities->first = frame->entity_state;
+	entities->num_entities = frame->num_entities;
 }
 
 /*
- * @brief An svc_packetentities has just been parsed, deal with the rest of the data stream.
+ * @brief Promotes or folds our baselines as the server instructs. The server
+ * promotes its pending baselines only once we've acknowledged folding them.
  */
-static void Cl_ParseEntities(const cl_frame_t *delta_frame, cl_frame_t *frame) {
-	entity_state_t *old_state = NULL;
-	uint32_t old_index;
-	uint16_t old_number;
+static void Cl_ParseBaselines(void) {
+	net_entities_t entities;
 
-	frame->entity_state = cl.entity_state;
-	frame->num_entities = 0;
-
-	// delta from the entities present in old_frame
-	old_index = 0;
-
-	if (!delta_frame)
-		old_number = 0xffff;
-	else {
-		if (old_index >= delta_frame->num_entities)
-			old_number = 0xffff;
-		else {
-			old_state = &cl.entity_states[(delta_frame->entity_state + old_index)
-					& ENTITY_STATE_MASK];
-			old_number = old_state->number;
-		}
-	}
-
-	while (true) {
-		const uint16_t number = Net_ReadShort(&net_message);
-
-		if (number >= MAX_EDICTS)
-			Com_Error(ERR_DROP, "Bad number: %i\n", number);
-
-		if (net_message.read > net_message.size)
-			Com_Error(ERR_DROP, "End of message\n");
+	const int32_t pending = Net_ReadBaselines(&net_message, &cl.baseline, &cl.pending_baseline);
 
-		if (!number)
-			break;
+	if (pending == 0)
+		return;
 
-		const uint16_t bits = Net_ReadShort(&net_message);
+	const cl_frame_t *frame = &cl.frames[pending & PACKET_MASK];
 
-		while (old_number < number) { // one or more entities from old_frame are unchanged
+	if (!frame->valid || frame->frame_num != pending)
+		return; // we no longer have it, so we won't acknowledge it
 
-			if (cl_show_net_messages->integer == 3)
-				Com_Print("   unchanged: %i\n", old_number);
-
-			Cl_ParseDeltaEntity(frame, old_state, old_number, 0);
-
-			old_index++;
-
-			if (old_index >= delta_frame->num_entities)
-				old_number = 0xffff;
-			else {
-				old_state = &cl.entity_states[(delta_frame->entity_state + old_index)
-						& ENTITY_STATE_MASK];
-				old_number = old_state->number;
-			}
-		}
+	Cl_FrameEntities(frame, &entities);
 
-		if (bits & U_REMOVE) { // the entity present in the old_frame, and is not in the current frame
+	if (!Net_FoldBaseline(&cl.pending_baseline, &cl.baseline, cl.baselines, &entities,
+			cl.entity_state, &frame->ps, pending))
+		return;
 
-			if (cl_show_net_messages->integer == 3)
-				Com_Print("   remove: %i\n", number);
-
-			if (old_number != number)
-				Com_Warn("U_REMOVE: %u != %u\n", old_number, number);
-
-			old_index++;
-
-			if (old_index >= delta_frame->num_entities)
-				old_number = 0xffff;
-			else {
-				old_state = &cl.entity_states[(delta_frame->entity_state + old_index)
-						& ENTITY_STATE_MASK];
-				old_number = old_state->number;
-			}
-			continue;
-		}
-
-		if (old_number == number) { // delta from previous state
-
-			if (cl_show_net_messages->integer == 3)
-				Com_Print("   delta: %i\n", number);
-
-			Cl_ParseDeltaEntity(frame, old_state, number, bits);
-
-			old_index++;
-
-			if (old_index >= delta_frame->num_entities)
-				old_number = 0xffff;
-			else {
-				old_state = &cl.entity_states[(delta_frame->entity_state + old_index)
-						& ENTITY_STATE_MASK];
-				old_number = old_state->number;
-			}
-			continue;
-		}
-
-		if (old_number > number) { // delta from baseline
+	if (cl_show_net_messages->integer == 3)
+		Com_Print("   baseline: %i\n", pending);
+}
 
-			if (cl_show_net_messages->integer == 3)
-				Com_Print("   baseline: %i\n", number);
+/*
+ * @brief Parses the entities of the frame, delta compressed from the delta
+ * frame and our baselines. The client entities are updated once the frame is
+ * applied.
+ */
+static void Cl_ParseEntities(const cl_frame_t *delta_frame, cl_frame_t *frame) {
+	net_entities_t from, to;
 
-			Cl_ParseDeltaEntity(frame, &cl.entities[number].baseline, number, bits);
-			continue;
-		}
+	if (delta_frame) {
+		Cl_FrameEntities(delta_frame, &from);
 	}
 
-	// any remaining entities in the old frame are copied over
-	while (old_number != 0xffff) { // one or more entities from the old packet are unchanged
-
-		if (cl_show_net_messages->integer == 3)
-			Com_Print("   unchanged: %i\n", old_number);
+	frame->entity_state = cl.entity_state;
+	Cl_FrameEntities(frame, &to);
 
-		Cl_ParseDeltaEntity(frame, old_state, old_number, 0);
+	const entity_state_t *baselines = Net_Baselines(&cl.baseline, cl.baselines);
 
-		old_index++;
+	Net_ReadEntities(&net_message, delta_frame ? &from : NULL, &to, baselines, cl.protocol,
+			cl_show_net_messages->integer == 3);
 
-		if (old_index >= delta_frame->num_entities)
-			old_number = 0xffff;
-		else {
-			old_state = &cl.entity_states[(delta_frame->entity_state + old_index)
-					& ENTITY_STATE_MASK];
-			old_number = old_state->number;
-		}
-	}
+	frame->num_entities = to.num_entities;
+	cl.entity_state += to.num_entities;
 }
 
 /*
@@ -195,83 +88,43 @@ static void Cl_ParseEntities(const cl_frame_t *delta_frame, cl_frame_t *frame) {
  * compression for all fields where possible.
  */
 static void Cl_ParsePlayerstate(const cl_frame_t *delta_frame, cl_frame_t *frame) {
-	player_state_t *ps;
-	uint16_t pm_state_bits;
-	int32_t i;
-	uint32_t stat_bits;
-
-	ps = &frame->ps;
-
-	// copy old value before delta parsing
-	if (delta_frame)
-		*ps = delta_frame->ps;
-	else
-		// or start clean
-		memset(ps, 0, sizeof(*ps));
-
-	pm_state_bits = Net_ReadShort(&net_message);
-
-	// parse the pm_state_t
-
-	if (pm_state_bits & PS_PM_TYPE)
-		ps->pm_state.type = Net_ReadByte(&net_message);
-
-	if (cl.demo_server)
-		ps->pm_state.type = PM_FREEZE;
-
-	if (pm_state_bits & PS_PM_ORIGIN) {
-		ps->pm_state.origin[0] = Net_ReadShort(&net_message);
-		ps->pm_state.origin[1] = Net_ReadShort(&net_message);
-		ps->pm_state.origin[2] = Net_ReadShort(&net_message);
+	player_state_t dummy;
+
+	if (delta_frame) {
+		Net_ReadDeltaPlayerState(&net_message, &delta_frame->ps, &frame->ps);
+	} else if (cl.baseline.frame_num) {
+		Net_ReadDeltaPlayerState(&net_message, &cl.baseline.ps, &frame->ps);
+	} else { // or start clean
+		memset(&dummy, 0, sizeof(dummy));
+		Net_ReadDeltaPlayerState(&net_message, &dummy, &frame->ps);
 	}
 
-	if (pm_state_bits & PS_PM_VELOCITY) {
-		ps->pm_state.velocity[0] = Net_ReadShort(&net_message);
-		ps->pm_state.velocity[1] = Net_ReadShort(&net_message);
-		ps->pm_state.velocity[2] = Net_ReadShort(&net_message);
-	}
-
-	if (pm_state_bits & PS_PM_FLAGS)
-		ps->pm_state.flags = Net_ReadShort(&net_message);
-
-	if (pm_state_bits & PS_PM_TIME)
-		ps->pm_state.time = Net_ReadShort(&net_message);
+	if (cl.demo_server)
+		frame->ps.pm_state.type = PM_FREEZE;
+}
 
-	if (pm_state_bits & PS_PM_GRAVITY)
-		ps->pm_state.gravity = Net_ReadShort(&net_message);
+/*
+ * @brief Measures the deviation of the arrival of the current frame from the
+ * server's frame interval, and derives the interpolation delay from it.
+ */
+static void Cl_MeasureJitter(void) {
+	cl_snapshots_t *s = &cl.snapshots;
 
-	if (pm_state_bits & PS_PM_VIEW_OFFSET) {
-		ps->pm_state.view_offset[0] = Net_ReadShort(&net_message);
-		ps->pm_state.view_offset[1] = Net_ReadShort(&net_message);
-		ps->pm_state.view_offset[2] = Net_ReadShort(&net_message);
-	}
+	const uint32_t interval = 1000 / cl.server_hz;
 
-	if (pm_state_bits & PS_PM_VIEW_ANGLES) {
-		ps->pm_state.view_angles[0] = Net_ReadShort(&net_message);
-		ps->pm_state.view_angles[1] = Net_ReadShort(&net_message);
-		ps->pm_state.view_angles[2] = Net_ReadShort(&net_message);
-	}
+	if (s->arrival && cl.frame.frame_num > s->latest) {
+		const int32_t expected = (cl.frame.frame_num - s->latest) * interval;
+		const int32_t elapsed = (cls.real_time - s->arrival) * time_scale->value;
 
-	if (pm_state_bits & PS_PM_KICK_ANGLES) {
-		ps->pm_state.kick_angles[0] = Net_ReadShort(&net_message);
-		ps->pm_state.kick_angles[1] = Net_ReadShort(&net_message);
-		ps->pm_state.kick_angles[2] = Net_ReadShort(&net_message);
-	}
+		const vec_t deviation = MIN(abs(elapsed - expected), SNAPSHOT_MAX_DELAY);
 
-	if (pm_state_bits & PS_PM_DELTA_ANGLES) {
-		ps->pm_state.delta_angles[0] = Net_ReadShort(&net_message);
-		ps->pm_state.delta_angles[1] = Net_ReadShort(&net_message);
-		ps->pm_state.delta_angles[2] = Net_ReadShort(&net_message);
+		s->jitter += (deviation - s->jitter) / 16.0;
 	}
 
-	// parse stats
+	s->latest = cl.frame.frame_num;
+	s->arrival = cls.real_time;
 
-	stat_bits = Net_ReadLong(&net_message);
-
-	for (i = 0; i < MAX_STATS; i++) {
-		if (stat_bits & (1 << i))
-			ps->stats[i] = Net_ReadShort(&net_message);
-	}
+	s->delay = Clamp(interval + (uint32_t) (2.0 * s->jitter), interval, SNAPSHOT_MAX_DELAY);
 }
 
 /*
@@ -284,6 +137,9 @@ void Cl_ParseFrame(void) {
 
 	cl.frame.delta_frame_num = Net_ReadLong(&net_message);
 
+	if (cl.protocol == PROTOCOL)
+		Cl_ParseBaselines();
+
 	cl.surpress_count = Net_ReadByte(&net_message);
 
 	if (cl_show_net_messages->integer == 3)
@@ -331,10 +187,62 @@ void Cl_ParseFrame(void) {
 			UnpackAngles(cl.frame.ps.pm_state.view_angles, cl.predicted_state.view_angles);
 		}
 
+		Cl_MeasureJitter();
+
 		Cl_CheckPredictionError();
 	}
 }
 
+/*
+ * @brief Applies the specified frame to the client entities, shuffling their
+ * current states to previous so that they may be interpolated. Events which
+ * the client game has not yet processed are carried over.
+ */
+void Cl_ApplyFrame(const cl_frame_t *frame) {
+	uint16_t i;
+
+	for (i = 0; i < frame->num_entities; i++) {
+
+		const int32_t snum = (frame->entity_state + i) & ENTITY_STATE_MASK;
+		const entity_state_t *to = &cl.entity_states[snum];
+
+		cl_entity_t *ent = &cl.entities[to->number];
+		const entity_state_t *from = &ent->current;
+
+		// some changes will force no interpolation
+		if (from->model1 != to->model1
+				|| from->model2 != to->model2
+				|| from->model3 != to->model3
+				|| from->model4 != to->model4
+				|| fabs(from->origin[0] - to->origin[0]) > 256.0
+				|| fabs(from->origin[1] - to->origin[1]) > 256.0
+				|| fabs(from->origin[2] - to->origin[2]) > 256.0) {
+			ent->frame_num = -1;
+		}
+
+		uint8_t event = 0;
+
+		if (!cl.snapshots.to || ent->frame_num != cl.snapshots.to) {
+			// wasn't in last applied frame, so initialize some things
+			// duplicate the current state so interpolation works
+			ent->prev = *to;
+			VectorCopy(to->old_origin, ent->prev.origin);
+			ent->animation1.time = ent->animation2.time = 0;
+		} else { // shuffle the last state to previous
+			ent->prev = ent->current;
+			event = ent->current.event;
+		}
+
+		// finally set the current frame number and entity state
+		ent->frame_num = frame->frame_num;
+		ent->current = *to;
+
+		if (!ent->current.event) {
+			ent->current.event = event;
+		}
+	}
+}
+
 /*
  * @brief Invalidate lighting caches on media load.
  */
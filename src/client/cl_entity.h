@@ -26,6 +26,7 @@
 
 #ifdef __CL_LOCAL_H__
 void Cl_ParseFrame(void);
+void Cl_ApplyFrame(const cl_frame_t *frame);
 void Cl_UpdateEntities(void);
 #endif /* __CL_LOCAL_H__ */
 
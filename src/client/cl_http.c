@@ -87,10 +87,8 @@ void Cl_HttpDownload_Complete() {
 		Com_Print("Failed to download %s via HTTP: %s.\n"
 			"Trying UDP...\n", cls.download.name, c);
 
-		// try legacy UDP download
-
-		Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
-		Net_WriteString(&cls.net_chan.message, va("download %s", cls.download.name));
+		// try UDP download
+		Cl_UdpDownload(0);
 
 		Fs_Unlink(cls.download.name); // delete partial file
 	}
@@ -24,9 +24,12 @@
 
 cvar_t *cl_async;
 cvar_t *cl_chat_sound;
+cvar_t *cl_demo_compress;
+cvar_t *cl_demo_keyframe;
 cvar_t *cl_draw_counters;
 cvar_t *cl_draw_net_graph;
 cvar_t *cl_ignore;
+cvar_t *cl_max_extrapolate;
 cvar_t *cl_max_fps;
 cvar_t *cl_max_pps;
 cvar_t *cl_predict;
@@ -34,6 +37,7 @@ cvar_t *cl_show_net_messages;
 cvar_t *cl_show_renderer_stats;
 cvar_t *cl_show_sound_stats;
 cvar_t *cl_team_chat_sound;
+cvar_t *cl_time_demo_quit;
 cvar_t *cl_timeout;
 cvar_t *cl_view_size;
 
@@ -71,7 +75,7 @@ static void Cl_SendConnect(void) {
 
 	const uint8_t qport = (uint8_t) Cvar_GetValue("net_qport"); // has been set by netchan
 
-	Netchan_OutOfBandPrint(NS_UDP_CLIENT, &addr, "connect %i %i %i \"%s\"\n", PROTOCOL, qport,
+	Netchan_OutOfBandPrint(NS_UDP_CLIENT, &addr, "connect %i %i %i \"%s\"\n", cls.protocol, qport,
 			cls.challenge, Cvar_UserInfo());
 
 	cvar_user_info_modified = false;
@@ -277,15 +281,7 @@ void Cl_Disconnect(void) {
 	if (cls.state <= CL_DISCONNECTED)
 		return;
 
-	if (time_demo->value) { // summarize time_demo results
-
-		const vec_t s = (cls.real_time - cl.time_demo_start) / 1000.0;
-
-		Com_Print("%i frames, %3.2f seconds: %4.2ffps\n", cl.time_demo_frames, s,
-				cl.time_demo_frames / s);
-
-		cl.time_demo_frames = cl.time_demo_start = 0;
-	}
+	Cl_TimeDemoResults(); // summarize time_demo results
 
 	Cl_SendDisconnect(); // tell the server to deallocate us
 
@@ -299,12 +295,14 @@ void Cl_Disconnect(void) {
 		if (cls.download.http) // clean up http downloads
 			Cl_HttpDownload_Complete();
 		else
-			// or just stop legacy ones
+			// or just stop UDP ones
 			Fs_Close(cls.download.file);
 
 		cls.download.file = NULL;
 	}
 
+	cls.download.udp = false;
+
 	memset(cls.server_name, 0, sizeof(cls.server_name));
 
 	cls.key_state.dest = KEY_UI;
@@ -420,6 +418,13 @@ static void Cl_ConnectionlessPacket(void) {
 			return;
 		}
 		cls.challenge = atoi(Cmd_Argv(1));
+
+		// older servers do not advertise their protocol, and only speak the legacy one
+		if (atoi(Cmd_Argv(2)) == PROTOCOL)
+			cls.protocol = PROTOCOL;
+		else
+			cls.protocol = PROTOCOL_LEGACY;
+
 		Cl_SendConnect();
 		return;
 	}
@@ -492,11 +497,16 @@ static const char *Cl_Username(void) {
 static void Cl_InitLocal(void) {
 
 	// register our variables
-	cl_async = Cvar_Get("cl_async", "0", CVAR_ARCHIVE, NULL);
+	cl_async = Cvar_Get("cl_async", "0", CVAR_ARCHIVE,
+			"Sample input at cl_max_pps, independently of the render frame rate");
 	cl_chat_sound = Cvar_Get("cl_chat_sound", "misc/chat", 0, NULL);
+	cl_demo_compress = Cvar_Get("cl_demo_compress", "1", CVAR_ARCHIVE, "Compress recorded demos");
+	cl_demo_keyframe = Cvar_Get("cl_demo_keyframe", "10", CVAR_ARCHIVE, "Seconds between demo keyframes");
 	cl_draw_counters = Cvar_Get("cl_draw_counters", "1", CVAR_ARCHIVE, NULL);
 	cl_draw_net_graph = Cvar_Get("cl_draw_net_graph", "1", CVAR_ARCHIVE, NULL);
 	cl_ignore = Cvar_Get("cl_ignore", "", 0, NULL);
+	cl_max_extrapolate = Cvar_Get("cl_max_extrapolate", "50", CVAR_ARCHIVE,
+			"Milliseconds the view may extrapolate beyond the latest frame");
 	cl_max_fps = Cvar_Get("cl_max_fps", "0", CVAR_ARCHIVE, NULL);
 	cl_max_pps = Cvar_Get("cl_max_pps", "0", CVAR_ARCHIVE, NULL);
 	cl_predict = Cvar_Get("cl_predict", "1", 0, "Use client-side prediction to update local view");
@@ -504,6 +514,8 @@ static void Cl_InitLocal(void) {
 	cl_show_renderer_stats = Cvar_Get("cl_show_renderer_stats", "0", CVAR_LO_ONLY, NULL);
 	cl_show_sound_stats = Cvar_Get("cl_show_sound_stats", "0", CVAR_LO_ONLY, NULL);
 	cl_team_chat_sound = Cvar_Get("cl_team_chat_sound", "misc/teamchat", 0, NULL);
+	cl_time_demo_quit = Cvar_Get("cl_time_demo_quit", "0", 0,
+			"Quit once a timed demo has completed");
 	cl_timeout = Cvar_Get("cl_timeout", "15.0", 0, NULL);
 	cl_view_size = Cvar_Get("cl_view_size", "100.0", CVAR_ARCHIVE, NULL);
 
@@ -526,6 +538,7 @@ static void Cl_InitLocal(void) {
 	Cmd_Add("fast_forward", Cl_FastForward_f, CMD_CLIENT, NULL);
 	Cmd_Add("servers_list", Cl_Servers_List_f, CMD_CLIENT, NULL);
 	Cmd_Add("slow_motion", Cl_SlowMotion_f, CMD_CLIENT, NULL);
+	Cmd_Add("seek", Cl_Seek_f, CMD_CLIENT, NULL);
 	Cmd_Add("stop", Cl_Stop_f, CMD_CLIENT, NULL);
 	Cmd_Add("connect", Cl_Connect_f, CMD_CLIENT, NULL);
 	Cmd_Add("reconnect", Cl_Reconnect_f, CMD_CLIENT, NULL);
@@ -593,13 +606,7 @@ void Cl_Frame(const uint32_t msec) {
 		cl_max_pps->modified = false;
 	}
 
-	if (time_demo->value) { // accumulate timed demo statistics
-
-		if (!cl.time_demo_start)
-			cl.time_demo_start = cls.real_time;
-
-		cl.time_demo_frames++;
-	} else { // check frame rate cap conditions
+	if (!time_demo->value) { // check frame rate cap conditions
 
 		if (cl_max_fps->value > 0.0) { // cap render frame rate
 			ms = 1000.0 * time_scale->value / cl_max_fps->value;
@@ -619,7 +626,7 @@ void Cl_Frame(const uint32_t msec) {
 	if (!cl_async->value) // run synchronous
 		packet_frame = render_frame;
 
-	if (!render_frame || cls.packet_delta < 8)
+	if (cls.packet_delta < 8)
 		packet_frame = false; // enforce a soft cap of 120pps
 
 	if (cls.state == CL_CONNECTED && cls.packet_delta < 16)
@@ -630,11 +637,17 @@ void Cl_Frame(const uint32_t msec) {
 	}
 
 	if (render_frame) {
+		Cl_TimeDemoBegin(CL_TIME_DEMO_FRAME);
+
 		// update any stale media references
 		Cl_UpdateMedia();
+	}
+
+	// fetch updates from server, so that their arrival is measured precisely
+	Cl_ReadPackets();
 
-		// fetch updates from server
-		Cl_ReadPackets();
+	// when running asynchronously, input is sampled at the packet rate
+	if (cl_async->value ? packet_frame : render_frame) {
 
 		// fetch input from user
 		Cl_HandleEvents();
@@ -644,13 +657,24 @@ void Cl_Frame(const uint32_t msec) {
 
 		// predict all unacknowledged movements
 		Cl_PredictMovement();
+	}
+
+	if (render_frame) {
 
 		// update the screen
 		Cl_UpdateScreen();
 
 		// update audio
+		Cl_TimeDemoBegin(CL_TIME_DEMO_SOUND);
+
 		S_Frame();
 
+		Cl_TimeDemoEnd(CL_TIME_DEMO_SOUND);
+
+		Cl_TimeDemoEnd(CL_TIME_DEMO_FRAME);
+
+		Cl_TimeDemoFrame();
+
 		cls.render_delta = 0;
 	}
 
@@ -680,6 +704,11 @@ void Cl_Init(void) {
 
 	cls.state = CL_DISCONNECTED;
 
+	// the null renderer needs no display, unless one is specified
+	if (Cvar_GetValue("r_null")) {
+		g_setenv("SDL_VIDEODRIVER", "dummy", false);
+	}
+
 	// initialize SDL
 	if (SDL_WasInit(SDL_INIT_AUDIO | SDL_INIT_VIDEO) == 0) {
 		if (SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO) < 0) {
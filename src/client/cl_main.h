@@ -27,8 +27,11 @@
 // settings and preferences
 extern cvar_t *cl_async;
 extern cvar_t *cl_chat_sound;
+extern cvar_t *cl_demo_compress;
+extern cvar_t *cl_demo_keyframe;
 extern cvar_t *cl_draw_counters;
 extern cvar_t *cl_ignore;
+extern cvar_t *cl_max_extrapolate;
 extern cvar_t *cl_max_fps;
 extern cvar_t *cl_max_pps;
 extern cvar_t *cl_draw_net_graph;
@@ -56,6 +59,7 @@ void Cl_Shutdown(void);
 extern cvar_t *cl_show_net_messages;
 extern cvar_t *cl_show_renderer_stats;
 extern cvar_t *cl_show_sound_stats;
+extern cvar_t *cl_time_demo_quit;
 
 extern cvar_t *rcon_password;
 extern cvar_t *rcon_address;
@@ -34,12 +34,35 @@ static char *sv_cmd_names[256] = {
 		"SV_CMD_SERVER_DATA",
 		"SV_CMD_SOUND" };
 
+/*
+ * @brief Requests the current download from the server over UDP, resuming it
+ * from the specified offset if it is non-zero.
+ */
+void Cl_UdpDownload(const int32_t offset) {
+	char cmd[MAX_STRING_CHARS];
+
+	if (offset)
+		g_snprintf(cmd, sizeof(cmd), "download %s %d", cls.download.name, offset);
+	else
+		g_snprintf(cmd, sizeof(cmd), "download %s", cls.download.name);
+
+	Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
+	Net_WriteString(&cls.net_chan.message, cmd);
+
+	if (cl.protocol == PROTOCOL) { // await the server's announcement
+		cls.download.udp = true;
+		cls.download.id = -1;
+		cls.download.start = cls.download.offset = offset;
+		cls.download.received = 0;
+		cls.download.ack = false;
+	}
+}
+
 /*
  * @brief Returns true if the file exists, otherwise it attempts to start a download
  * from the server.
  */
 _Bool Cl_CheckOrDownloadFile(const char *filename) {
-	char cmd[MAX_STRING_CHARS];
 
 	if (cls.state == CL_DISCONNECTED) {
 		Com_Print("Not connected\n");
@@ -81,10 +104,7 @@ _Bool Cl_CheckOrDownloadFile(const char *filename) {
 				// give the server the offset to start the download
 				Com_Debug("Resuming %s...\n", cls.download.name);
 
-				g_snprintf(cmd, sizeof(cmd), "download %s %u", cls.download.name, (uint32_t) len);
-				Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
-				Net_WriteString(&cls.net_chan.message, cmd);
-
+				Cl_UdpDownload((int32_t) len);
 				return false;
 			}
 		}
@@ -93,10 +113,7 @@ _Bool Cl_CheckOrDownloadFile(const char *filename) {
 	// or start if from the beginning
 	Com_Debug("Downloading %s...\n", cls.download.name);
 
-	g_snprintf(cmd, sizeof(cmd), "download %s", cls.download.name);
-	Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
-	Net_WriteString(&cls.net_chan.message, cmd);
-
+	Cl_UdpDownload(0);
 	return false;
 }
 
@@ -140,7 +157,7 @@ static void Cl_ParseBaseline(void) {
 	const uint16_t number = Net_ReadShort(&net_message);
 	const uint16_t bits = Net_ReadShort(&net_message);
 
-	entity_state_t *state = &cl.entities[number].baseline;
+	entity_state_t *state = &cl.baselines[number];
 
 	Net_ReadDeltaEntity(&net_message, &null_state, state, number, bits);
 }
@@ -181,9 +198,32 @@ void Cl_ParseConfigString(void) {
 }
 
 /*
- * @brief A download message has been received from the server.
+ * @brief Closes the completed download, adding it to the search path if it is
+ * an archive, and requests the next one.
  */
-static void Cl_ParseDownload(void) {
+static void Cl_FinishDownload(void) {
+
+	Fs_Close(cls.download.file);
+	cls.download.file = NULL;
+
+	// add new archives to the search path
+	if (Fs_Rename(cls.download.tempname, cls.download.name)) {
+		if (strstr(cls.download.name, ".zip")) {
+			Fs_AddToSearchPath(cls.download.name);
+		}
+	} else {
+		Com_Error(ERR_DROP, "Failed to rename %s\n", cls.download.name);
+	}
+
+	// get another file if needed
+	Cl_RequestNextDownload();
+}
+
+/*
+ * @brief A PROTOCOL_LEGACY download message has been received from the server.
+ * Each chunk must be requested in turn.
+ */
+static void Cl_ParseLegacyDownload(void) {
 	int32_t size, percent;
 
 	// read the data
@@ -219,21 +259,144 @@ static void Cl_ParseDownload(void) {
 		Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
 		Net_WriteString(&cls.net_chan.message, "nextdl");
 	} else {
-		Fs_Close(cls.download.file);
-		cls.download.file = NULL;
+		Cl_FinishDownload();
+	}
+}
+
+/*
+ * @brief Writes the buffered chunks which have become contiguous to the file,
+ * finishing the download if it is complete.
+ */
+static void Cl_WriteDownloadChunks(void) {
+	cl_download_t *download = &cls.download;
+
+	while (download->received & 1) {
+		const int32_t chunk = (download->offset - download->start) / DOWNLOAD_CHUNK_SIZE;
+		const int32_t len = MIN(DOWNLOAD_CHUNK_SIZE, download->size - download->offset);
+
+		Fs_Write(download->file, download->chunks[chunk % DOWNLOAD_WINDOW], 1, len);
+
+		download->offset += len;
+		download->received >>= 1;
+	}
+
+	if (download->offset < download->size)
+		return;
+
+	// acknowledge completion reliably, so that the server releases the file
+	Net_WriteByte(&cls.net_chan.message, CL_CMD_STRING);
+	Net_WriteString(&cls.net_chan.message, va("dlack %d %d 0", download->id, download->offset));
+
+	download->udp = download->ack = false;
+
+	Cl_FinishDownload();
+}
+
+/*
+ * @brief A PROTOCOL download message has been received from the server. The
+ * download is announced reliably, after which its chunks are streamed, and
+ * are acknowledged by Cl_SendCmd.
+ */
+static void Cl_ParseDownloadChunk(void) {
+	cl_download_t *download = &cls.download;
+
+	const int32_t id = Net_ReadByte(&net_message);
+	const int32_t size = Net_ReadLong(&net_message);
+	const int32_t offset = Net_ReadLong(&net_message);
+	const int32_t len = Net_ReadShort(&net_message);
+
+	if (len < 0 || net_message.read + len > net_message.size) {
+		Com_Error(ERR_DROP, "Bad download chunk length %d\n", len);
+	}
+
+	const byte *data = net_message.data + net_message.read;
+	net_message.read += len;
+
+	if (!download->udp)
+		return; // a chunk of a completed or aborted download
 
-		// add new archives to the search path
-		if (Fs_Rename(cls.download.tempname, cls.download.name)) {
-			if (strstr(cls.download.name, ".zip")) {
-				Fs_AddToSearchPath(cls.download.name);
+	if (download->id == -1) { // awaiting the announcement of our download
+
+		if (len)
+			return; // a chunk of a previous download
+
+		if (size == -1) {
+			Com_Debug("Server does not have this file\n");
+			if (download->file) {
+				// if here, we tried to resume a file but the server said no
+				Fs_Close(download->file);
+				download->file = NULL;
 			}
-		} else {
-			Com_Error(ERR_DROP, "Failed to rename %s\n", cls.download.name);
+			download->udp = false;
+			Cl_RequestNextDownload();
+			return;
 		}
 
-		// get another file if needed
-		Cl_RequestNextDownload();
+		if (offset != download->offset) { // our partial file is larger than theirs
+			Com_Warn("Discarding %s, which does not match the server's copy\n",
+					download->tempname);
+			if (download->file) {
+				Fs_Close(download->file);
+				download->file = NULL;
+			}
+			Fs_Unlink(download->tempname);
+			download->udp = false;
+			Cl_RequestNextDownload();
+			return;
+		}
+
+		// open the file if not opened yet
+		if (!download->file) {
+
+			if (!(download->file = Fs_OpenWrite(download->tempname))) {
+				Com_Warn("Failed to open %s\n", download->tempname);
+				download->udp = false;
+				Cl_RequestNextDownload();
+				return;
+			}
+		}
+
+		download->id = id;
+		download->size = size;
+
+		Cl_WriteDownloadChunks(); // the file may already be complete
+		return;
+	}
+
+	if (id != download->id)
+		return; // a chunk of a previous download
+
+	if (len <= 0 || len > DOWNLOAD_CHUNK_SIZE || (offset - download->start) % DOWNLOAD_CHUNK_SIZE) {
+		Com_Warn("Invalid chunk (%d, %d)\n", offset, len);
+		return;
 	}
+
+	download->ack = true; // acknowledge even duplicates, in case our acks were lost
+
+	if (offset < download->offset)
+		return; // a duplicate
+
+	const int32_t position = (offset - download->offset) / DOWNLOAD_CHUNK_SIZE;
+	if (position >= DOWNLOAD_WINDOW)
+		return;
+
+	const int32_t chunk = (offset - download->start) / DOWNLOAD_CHUNK_SIZE;
+	memcpy(download->chunks[chunk % DOWNLOAD_WINDOW], data, len);
+
+	download->received |= (1u << position);
+
+	Cl_WriteDownloadChunks();
+}
+
+/*
+ * @brief A download message has been received from the server.
+ */
+static void Cl_ParseDownload(void) {
+
+	if (cl.protocol == PROTOCOL)
+		Cl_ParseDownloadChunk();
+	else
+		Cl_ParseLegacyDownload();
 }
 
 /*
@@ -252,11 +415,13 @@ static void Cl_ParseServerData(void) {
 	// parse protocol version number
 	i = Net_ReadLong(&net_message);
 
-	// ensure protocol matches
-	if (i != PROTOCOL) {
+	// ensure protocol is one we speak
+	if (i != PROTOCOL && i != PROTOCOL_LEGACY) {
 		Com_Error(ERR_DROP, "Server is using unknown protocol %d\n", i);
 	}
 
+	cl.protocol = i;
+
 	// retrieve spawn count and packet rate
 	cl.server_count = Net_ReadLong(&net_message);
 	cl.server_hz = Net_ReadLong(&net_message);
@@ -410,7 +575,9 @@ void Cl_ParseServerMessage(void) {
 				break;
 
 			case SV_CMD_FRAME:
+				Cl_TimeDemoBegin(CL_TIME_DEMO_PARSE_FRAME);
 				Cl_ParseFrame();
+				Cl_TimeDemoEnd(CL_TIME_DEMO_PARSE_FRAME);
 				break;
 
 			case SV_CMD_PRINT:
@@ -25,6 +25,7 @@
 #include "cl_types.h"
 
 #ifdef __CL_LOCAL_H__
+void Cl_UdpDownload(const int32_t offset);
 _Bool Cl_CheckOrDownloadFile(const char *file_name);
 void Cl_ParseConfigString(void);
 void Cl_ParseServerMessage(void);
@@ -178,12 +178,73 @@ c_trace_t Cl_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, cons
 	return trace.trace;
 }
 
+/*
+ * @brief Returns true if the cached prediction result for the specified command
+ * is valid, meaning the command has not changed since it was last simulated.
+ */
+static _Bool Cl_ValidPredictedMove(const uint32_t sequence) {
+
+	const cl_predicted_move_t *move = &cl.predicted_state.moves[sequence & CMD_MASK];
+
+	if (move->sequence != sequence)
+		return false;
+
+	const user_cmd_t *cmd = &cl.cmds[sequence & CMD_MASK].cmd;
+
+	return memcmp(&move->cmd, cmd, sizeof(*cmd)) == 0;
+}
+
+/*
+ * @brief Accumulates the specified data into the given FNV-1a key.
+ */
+static uint32_t Cl_PredictionKey(uint32_t key, const void *data, size_t len) {
+	const byte *b = (const byte *) data;
+
+	while (len--) {
+		key ^= *b++;
+		key *= 16777619;
+	}
+
+	return key;
+}
+
+/*
+ * @brief Returns a key for the solid entities of the current frame, which the
+ * player movement is clipped against. The cached prediction results are only
+ * valid while it is unchanged.
+ */
+static uint32_t Cl_PredictionSolids(void) {
+	uint32_t key = 2166136261u;
+	int32_t i;
+
+	for (i = 0; i < cl.frame.num_entities; i++) {
+		const int32_t num = (cl.frame.entity_state + i) & ENTITY_STATE_MASK;
+		const entity_state_t *ent = &cl.entity_states[num];
+
+		if (ent->solid == SOLID_NOT || ent->number == cl.entity_num + 1)
+			continue;
+
+		key = Cl_PredictionKey(key, &ent->number, sizeof(ent->number));
+		key = Cl_PredictionKey(key, &ent->solid, sizeof(ent->solid));
+		key = Cl_PredictionKey(key, &ent->model1, sizeof(ent->model1));
+		key = Cl_PredictionKey(key, ent->origin, sizeof(ent->origin));
+		key = Cl_PredictionKey(key, ent->angles, sizeof(ent->angles));
+	}
+
+	return key;
+}
+
 /*
  * @brief Entry point for client-side prediction. For each server frame, run
  * the player movement code with the user commands we've sent to the server
  * but have not yet received acknowledgment for. Store the resulting move so
  * that it may be interpolated into by Cl_UpdateView.
  *
+ * The result of each command is cached, so that only commands which have not
+ * yet been simulated, or which have changed, are run. Should the solid entities
+ * of the frame change, all unacknowledged commands are run again. The pending
+ * command is still accumulating input, and is always simulated.
+ *
  * Most of the work is passed off to the client game, which is responsible for
  * the implementation Pm_Move.
  */
@@ -191,7 +252,7 @@ void Cl_PredictMovement(void) {
 
 	if (Cl_UsePrediction()) {
 		const uint32_t current = cls.net_chan.outgoing_sequence;
-		uint32_t ack = cls.net_chan.incoming_acknowledged;
+		const uint32_t ack = cls.net_chan.incoming_acknowledged;
 
 		// if we are too far out of date, just freeze in place
 		if (current - ack >= CMD_BACKUP) {
@@ -199,10 +260,36 @@ void Cl_PredictMovement(void) {
 			return;
 		}
 
+		cl_predicted_move_t *from = &cl.predicted_state.moves[ack & CMD_MASK];
+		uint32_t seq = ack;
+
+		const uint32_t solids = Cl_PredictionSolids();
+
+		if (from->sequence == ack) { // resume from the last valid cached result
+			if (solids == cl.predicted_state.solids) {
+				while (seq + 1 < current && Cl_ValidPredictedMove(seq + 1)) {
+					seq++;
+				}
+			}
+		} else { // or start over from the server's state
+			from->sequence = ack;
+			from->cmd = cl.cmds[ack & CMD_MASK].cmd;
+			from->pm_state = cl.frame.ps.pm_state;
+			from->ground_entity = cl.predicted_state.ground_entity;
+		}
+
+		cl.predicted_state.solids = solids;
+
 		GList *cmds = NULL;
 
-		while (++ack <= current) {
-			cmds = g_list_append(cmds, &cl.cmds[ack & CMD_MASK]);
+		while (++seq <= current) {
+			cl_predicted_move_t *move = &cl.predicted_state.moves[seq & CMD_MASK];
+
+			// key the cached result, the client game will populate it
+			move->sequence = seq;
+			move->cmd = cl.cmds[seq & CMD_MASK].cmd;
+
+			cmds = g_list_append(cmds, &cl.cmds[seq & CMD_MASK]);
 		}
 
 		cls.cgame->PredictMovement(cmds);
@@ -211,9 +298,42 @@ void Cl_PredictMovement(void) {
 	}
 }
 
+/*
+ * @brief Returns true if the specified movement states are identical.
+ */
+static _Bool Cl_ComparePmState(const pm_state_t *a, const pm_state_t *b) {
+
+	if (a->type != b->type || a->flags != b->flags || a->time != b->time)
+		return false;
+
+	if (a->gravity != b->gravity)
+		return false;
+
+	if (memcmp(a->origin, b->origin, sizeof(a->origin)))
+		return false;
+
+	if (memcmp(a->velocity, b->velocity, sizeof(a->velocity)))
+		return false;
+
+	if (memcmp(a->view_offset, b->view_offset, sizeof(a->view_offset)))
+		return false;
+
+	if (memcmp(a->view_angles, b->view_angles, sizeof(a->view_angles)))
+		return false;
+
+	if (memcmp(a->kick_angles, b->kick_angles, sizeof(a->kick_angles)))
+		return false;
+
+	if (memcmp(a->delta_angles, b->delta_angles, sizeof(a->delta_angles)))
+		return false;
+
+	return true;
+}
+
 /*
  * @brief Checks for client side prediction errors. Problems here mean that
- * Pm_Move or the protocol are not functioning correctly.
+ * Pm_Move or the protocol are not functioning correctly. Any disagreement
+ * with the server invalidates the cached prediction results.
  */
 void Cl_CheckPredictionError(void) {
 	int16_t d[3];
@@ -223,10 +343,11 @@ void Cl_CheckPredictionError(void) {
 		return;
 
 	// calculate the last user_cmd_t we sent that the server has processed
-	const uint32_t frame = (cls.net_chan.incoming_acknowledged & CMD_MASK);
+	const uint32_t ack = cls.net_chan.incoming_acknowledged;
+	cl_predicted_move_t *move = &cl.predicted_state.moves[ack & CMD_MASK];
 
 	// compare what the server returned with what we had predicted it to be
-	VectorSubtract(cl.frame.ps.pm_state.origin, cl.predicted_state.origins[frame], d);
+	VectorSubtract(cl.frame.ps.pm_state.origin, move->pm_state.origin, d);
 	UnpackVector(d, delta); // convert back to floating point
 
 	const vec_t error = VectorLength(delta);
@@ -240,6 +361,11 @@ void Cl_CheckPredictionError(void) {
 			Com_Debug("%s\n", vtos(delta));
 		}
 	}
+
+	// re-simulate from the server's state if it differs from our own
+	if (move->sequence != ack || !Cl_ComparePmState(&cl.frame.ps.pm_state, &move->pm_state)) {
+		move->sequence = 0;
+	}
 }
 
 /*
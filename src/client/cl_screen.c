@@ -154,6 +154,9 @@ static void Cl_DrawRendererStats(void) {
 	R_DrawString(0, y, va("%d surfaces", r_view.num_bsp_surfaces), CON_COLOR_YELLOW);
 	y += ch;
 
+	R_DrawString(0, y, va("%d draws", r_view.num_bsp_draws), CON_COLOR_YELLOW);
+	y += ch;
+
 	y += ch;
 	R_DrawString(0, y, "Mesh:", CON_COLOR_CYAN);
 	y += ch;
@@ -174,7 +177,7 @@ static void Cl_DrawRendererStats(void) {
 	R_DrawString(0, y, va("%d coronas", r_view.num_coronas), CON_COLOR_WHITE);
 	y += ch;
 
-	R_DrawString(0, y, va("%d particles", r_view.num_particles), CON_COLOR_WHITE);
+	R_DrawString(0, y, va("%u particles", r_view.num_particles), CON_COLOR_WHITE);
 
 	R_BindFont(NULL, NULL, NULL);
 }
@@ -0,0 +1,168 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "cl_local.h"
+
+static const char *cl_time_demo_phase_names[] = {
+	"frame",
+	"Cl_ParseFrame",
+	"PopulateView",
+	"R_MarkBspSurfaces",
+	"R_CullEntities",
+	"R_SortElements",
+	"R_DrawView",
+	"S_Frame",
+	"S_SpatializeChannels"
+};
+
+/*
+ * @brief Opens the specified phase of the current frame, if sampling.
+ */
+void Cl_TimeDemoBegin(const uint32_t phase) {
+
+	if (!cls.time_demo.frames)
+		return;
+
+	cls.time_demo.begin[phase] = Sys_Microseconds();
+}
+
+/*
+ * @brief Closes the specified phase, accumulating its time for this frame.
+ */
+void Cl_TimeDemoEnd(const uint32_t phase) {
+
+	if (!cls.time_demo.begin[phase])
+		return;
+
+	cls.time_demo.frame.phases[phase] += Sys_Microseconds() - cls.time_demo.begin[phase];
+	cls.time_demo.begin[phase] = 0;
+}
+
+/*
+ * @brief Samples the frame that has just completed. Sampling begins with the
+ * first frame rendered in time_demo mode after loading has completed.
+ */
+void Cl_TimeDemoFrame(void) {
+	cl_time_demo_t *td = &cls.time_demo;
+
+	if (td->frames) {
+		td->frame.bsp_draws = r_view.num_bsp_draws;
+		td->frame.sound_traces = s_env.num_traces;
+		td->frame.particles = r_view.num_particles;
+		g_array_append_val(td->frames, td->frame);
+	} else if (time_demo->value && cls.state == CL_ACTIVE && !cls.loading) {
+		td->frames = g_array_new(false, false, sizeof(cl_time_demo_frame_t));
+		td->start = cls.real_time;
+	}
+
+	memset(&td->frame, 0, sizeof(td->frame));
+}
+
+/*
+ * @brief qsort comparator for Cl_TimeDemoResults.
+ */
+static int32_t Cl_TimeDemoResults_Compare(const void *a, const void *b) {
+	const uint32_t ta = *(const uint32_t *) a;
+	const uint32_t tb = *(const uint32_t *) b;
+
+	return ta < tb ? -1 : ta > tb ? 1 : 0;
+}
+
+/*
+ * @brief Sorts and prints the average, minimum, 99th percentile and maximum of
+ * the specified samples, divided by scale.
+ */
+static void Cl_TimeDemoResults_Print(const char *name, uint32_t *samples, const uint32_t n,
+		const vec_t scale) {
+	uint64_t total = 0;
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		total += samples[i];
+	}
+
+	qsort(samples, n, sizeof(uint32_t), Cl_TimeDemoResults_Compare);
+
+	Com_Print("%-20s %8.3f %8.3f %8.3f %8.3f\n", name, total / (n * scale), samples[0] / scale,
+			samples[MIN(n * 99 / 100, n - 1)] / scale, samples[n - 1] / scale);
+}
+
+/*
+ * @brief Prints the average, minimum, 99th percentile and maximum time of each
+ * phase over the sampled frames, the world draw calls, the sound occlusion
+ * traces and the particles, and stops sampling.
+ */
+void Cl_TimeDemoResults(void) {
+	cl_time_demo_t *td = &cls.time_demo;
+	uint32_t i, j;
+
+	if (!td->frames)
+		return;
+
+	const uint32_t n = td->frames->len;
+
+	if (n) {
+		const vec_t s = (cls.real_time - td->start) / 1000.0;
+
+		Com_Print("%i frames, %3.2f seconds: %4.2ffps\n", n, s, n / s);
+
+		Com_Print("%-20s %8s %8s %8s %8s\n", "phase (ms)", "avg", "min", "p99", "max");
+
+		uint32_t *samples = Mem_TagMalloc(n * sizeof(uint32_t), MEM_TAG_CLIENT);
+
+		for (i = 0; i < CL_TIME_DEMO_PHASES; i++) {
+
+			for (j = 0; j < n; j++) {
+				samples[j] = g_array_index(td->frames, cl_time_demo_frame_t, j).phases[i];
+			}
+
+			Cl_TimeDemoResults_Print(cl_time_demo_phase_names[i], samples, n, 1000.0);
+		}
+
+		for (j = 0; j < n; j++) {
+			samples[j] = g_array_index(td->frames, cl_time_demo_frame_t, j).bsp_draws;
+		}
+
+		Cl_TimeDemoResults_Print("world draws", samples, n, 1.0);
+
+		for (j = 0; j < n; j++) {
+			samples[j] = g_array_index(td->frames, cl_time_demo_frame_t, j).sound_traces;
+		}
+
+		Cl_TimeDemoResults_Print("sound traces", samples, n, 1.0);
+
+		for (j = 0; j < n; j++) {
+			samples[j] = g_array_index(td->frames, cl_time_demo_frame_t, j).particles;
+		}
+
+		Cl_TimeDemoResults_Print("particles", samples, n, 1.0);
+
+		Mem_Free(samples);
+	}
+
+	g_array_free(td->frames, true);
+
+	memset(td, 0, sizeof(*td));
+
+	if (cl_time_demo_quit->value) {
+		Cbuf_AddText("quit\n");
+	}
+}
@@ -53,7 +53,6 @@ typedef struct {
 } cl_entity_animation_t;
 
 typedef struct {
-	entity_state_t baseline; // delta from this if not from a previous frame
 	entity_state_t current;
 	entity_state_t prev; // will always be valid, but might just be a copy of current
 
@@ -93,6 +92,18 @@ typedef struct {
 #define CMD_BACKUP 64
 #define CMD_MASK (CMD_BACKUP - 1)
 
+/*
+ * @brief The result of running a single user_cmd_t through the player movement
+ * code. These are cached so that each frame only needs to simulate the commands
+ * which have changed since the last frame.
+ */
+typedef struct {
+	uint32_t sequence; // the outgoing sequence of the command, 0 if invalid
+	user_cmd_t cmd; // the command which produced this state
+	pm_state_t pm_state; // the resulting movement state
+	struct g_edict_s *ground_entity; // the resulting ground entity
+} cl_predicted_move_t;
+
 /*
  * @brief Client side prediction output, produced by running sent but
  * unacknowledged user_cmd_t's through the player movement code locally.
@@ -111,7 +122,8 @@ typedef struct {
 	uint32_t step_interval; // interpolation interval for step
 	vec_t step; // step height (up or down)
 
-	int16_t origins[CMD_BACKUP][3]; // for debugging against the server
+	cl_predicted_move_t moves[CMD_BACKUP]; // cached results, for resuming and error checking
+	uint32_t solids; // key of the solid entities the cached results were simulated against
 } cl_predicted_state_t;
 
 /*
@@ -121,14 +133,40 @@ typedef struct {
 #define ENTITY_STATE_BACKUP (PACKET_BACKUP * MAX_PACKET_ENTITIES)
 #define ENTITY_STATE_MASK (ENTITY_STATE_BACKUP - 1)
 
+/*
+ * @brief Received frames are buffered, and the view is interpolated between two
+ * of them. The view trails the latest frame by a delay which adapts to the
+ * measured jitter of their arrival, so that the next frame has usually arrived
+ * by the time it is needed.
+ */
+#define SNAPSHOT_MAX_DELAY 250
+
+typedef struct {
+	int32_t from; // the applied frame we're interpolating from
+	int32_t to; // the applied frame we're interpolating to
+
+	int32_t latest; // the latest frame received
+	uint32_t arrival; // system time when the latest frame was received
+
+	vec_t jitter; // smoothed deviation of frame arrival from the server's interval
+	uint32_t delay; // the interpolation delay, in milliseconds
+} cl_snapshots_t;
+
+/*
+ * @brief The interpolated state with which the view was last populated.
+ */
+typedef struct {
+	uint32_t time;
+	int32_t frame_num;
+	vec3_t origin;
+	vec3_t angles;
+} cl_view_state_t;
+
 /*
  * @brief The client structure is cleared at each level load, and is exposed to
  * the client game module to provide access to media and other client state.
  */
 typedef struct {
-	uint32_t time_demo_frames;
-	uint32_t time_demo_start;
-
 	uint32_t frame_counter;
 	uint32_t packet_counter;
 	uint32_t byte_counter;
@@ -139,11 +177,18 @@ typedef struct {
 	cl_frame_t frame; // received from server
 	cl_frame_t frames[PACKET_BACKUP]; // for calculating delta compression
 
+	cl_snapshots_t snapshots; // the frames being interpolated
+	cl_view_state_t view_state; // the state the view was last populated with
+
 	cl_entity_t entities[MAX_EDICTS]; // client entities
+	entity_state_t baselines[MAX_EDICTS]; // the map baselines
 
 	entity_state_t entity_states[ENTITY_STATE_BACKUP]; // accumulated each frame
 	uint32_t entity_state; // index (not wrapped) into entity states
 
+	net_baseline_t baseline; // the server is delta'ing new entities from these
+	net_baseline_t pending_baseline; // folded at the server's request, awaiting acknowledgement
+
 	uint16_t entity_num; // our entity number
 
 	uint32_t surpress_count; // number of messages rate suppressed
@@ -161,6 +206,7 @@ typedef struct {
 
 	uint32_t server_count; // server identification for precache
 	uint16_t server_hz; // server frame rate (packets per second)
+	int32_t protocol; // the protocol of the server (or demo) we're parsing
 
 	_Bool demo_server; // we're viewing a demo
 	_Bool third_person; // we're using a 3rd person camera
@@ -244,8 +290,57 @@ typedef struct {
 	file_t *file;
 	char tempname[MAX_OSPATH];
 	char name[MAX_OSPATH];
+
+	// PROTOCOL downloads are streamed in chunks, which may arrive out of order
+	_Bool udp; // a streamed download is in progress
+	int32_t id; // from the server's announcement, or -1 until it arrives
+	int32_t size;
+	int32_t start; // the offset at which the download began or resumed
+	int32_t offset; // written to file
+	uint32_t received; // chunks buffered beyond offset, by window position
+	byte chunks[DOWNLOAD_WINDOW][DOWNLOAD_CHUNK_SIZE]; // by chunk number
+	_Bool ack; // chunks have been received since the last acknowledgement
 } cl_download_t;
 
+/*
+ * @brief The phases of the client frame which are timed by time_demo.
+ */
+typedef enum {
+	CL_TIME_DEMO_FRAME,
+	CL_TIME_DEMO_PARSE_FRAME,
+	CL_TIME_DEMO_POPULATE_VIEW,
+	CL_TIME_DEMO_MARK_BSP_SURFACES,
+	CL_TIME_DEMO_CULL_ENTITIES,
+	CL_TIME_DEMO_SORT_ELEMENTS,
+	CL_TIME_DEMO_DRAW,
+	CL_TIME_DEMO_SOUND,
+	CL_TIME_DEMO_SPATIALIZE,
+	CL_TIME_DEMO_PHASES
+} cl_time_demo_phase_t;
+
+/*
+ * @brief The time spent in each phase of a single frame, in microseconds, the
+ * number of draw calls issued for the world, of sound occlusion traces, and of
+ * particles added to the view.
+ */
+typedef struct {
+	uint32_t phases[CL_TIME_DEMO_PHASES];
+	uint32_t bsp_draws;
+	uint32_t sound_traces;
+	uint32_t particles;
+} cl_time_demo_frame_t;
+
+/*
+ * @brief Timed demo statistics. Phases may be timed from any thread, but each
+ * phase is only ever timed by one thread at a time.
+ */
+typedef struct {
+	uint32_t start; // real time of the first sampled frame
+	uint64_t begin[CL_TIME_DEMO_PHASES]; // the open phases
+	cl_time_demo_frame_t frame; // the current frame
+	GArray *frames; // of cl_time_demo_frame_t, while sampling
+} cl_time_demo_t;
+
 // server information, for finding network games
 typedef enum {
 	SERVER_SOURCE_INTERNET,
@@ -291,6 +386,7 @@ typedef struct {
 	net_chan_t net_chan; // network channel
 
 	uint32_t challenge; // from the server to use for connecting
+	int32_t protocol; // the protocol we will ask the server for
 	uint32_t spawn_count;
 
 	uint16_t loading; // loading percentage indicator
@@ -299,7 +395,11 @@ typedef struct {
 	cl_download_t download; // current download (udp or http)
 
 	char demo_filename[MAX_OSPATH];
-	file_t *demo_file;
+	demo_t *demo_file;
+	int32_t demo_keyframe; // the frame of the most recent keyframe
+	uint32_t demo_keyframe_sequence; // the first command asking for the next one
+
+	cl_time_demo_t time_demo;
 
 	GList *servers; // list of cl_server_info_t from all sources
 
@@ -29,12 +29,17 @@ static void Cl_ClearView(void) {
 	// reset entity, light, particle and corona counts
 	r_view.num_entities = r_view.num_lights = 0;
 	r_view.num_particles = r_view.num_coronas = 0;
+}
+
+/*
+ * @brief Resets the renderer counters for the current frame.
+ */
+static void Cl_ClearViewCounters(void) {
 
-	// reset counters
 	r_view.num_bind_texture = r_view.num_bind_lightmap = r_view.num_bind_deluxemap = 0;
 	r_view.num_bind_normalmap = r_view.num_bind_glossmap = 0;
 
-	r_view.num_bsp_surfaces = 0;
+	r_view.num_bsp_surfaces = r_view.num_bsp_draws = 0;
 
 	r_view.num_mesh_models = r_view.num_mesh_tris = 0;
 }
@@ -64,41 +69,85 @@ static void Cl_UpdateViewSize(void) {
 	cl_view_size->modified = false;
 }
 
+/*
+ * @brief Applies the buffered frames until the applied frame lies beyond the
+ * specified time, so that the view interpolates towards it. If no such frame
+ * has arrived, the latest frame remains applied and the view extrapolates. If
+ * the buffer is empty, or has fallen too far behind, the latest frame is
+ * applied instead.
+ */
+static void Cl_ApplyFrames(const uint32_t time) {
+	cl_snapshots_t *s = &cl.snapshots;
+
+	if (!s->to || s->to > cl.frame.frame_num || cl.frame.frame_num - s->to >= PACKET_BACKUP) {
+		Com_Debug("Resetting snapshots at %d\n", cl.frame.frame_num);
+
+		s->to = 0;
+		Cl_ApplyFrame(&cl.frame);
+		s->from = s->to = cl.frame.frame_num;
+		return;
+	}
+
+	int32_t frame_num;
+	for (frame_num = s->to + 1; frame_num <= cl.frame.frame_num; frame_num++) {
+		const cl_frame_t *frame = &cl.frames[frame_num & PACKET_MASK];
+
+		if (frame->frame_num != frame_num || !frame->valid)
+			continue; // dropped
+
+		if (cl.frames[s->to & PACKET_MASK].time > time)
+			break; // interpolating towards the applied frame
+
+		Cl_ApplyFrame(frame);
+
+		s->from = s->to;
+		s->to = frame_num;
+	}
+}
+
 /*
  * @brief Updates the interpolation fraction for the current client frame.
  * Because the client typically runs at a higher framerate than the server, we
- * use linear interpolation between the last 2 server frames. We aim to reach
- * the current server time just as a new packet arrives.
+ * interpolate between two buffered server frames. The client time is steered
+ * towards the latest frame's time, less the interpolation delay, so that the
+ * next frame has usually arrived by the time we reach it. When it has not, we
+ * extrapolate for at most cl_max_extrapolate milliseconds.
  */
-static void Cl_UpdateLerp(const cl_frame_t *from) {
+static void Cl_UpdateLerp(void) {
+	cl_snapshots_t *s = &cl.snapshots;
 
 	if (time_demo->value) {
 		cl.time = cl.frame.time;
+		Cl_ApplyFrames(cl.time);
 		cl.lerp = 1.0;
 		return;
 	}
 
-	if (cl.time > cl.frame.time) {
-		// Com_Debug("High clamp: %dms\n", cl.time - cl.frame.time);
-		cl.time = cl.frame.time;
-		cl.lerp = 1.0;
-	} else if (cl.time < from->time) {
-		// Com_Debug("Low clamp: %dms\n", from->time - cl.time);
-		cl.time = from->time;
-		cl.lerp = 0.0;
+	const int32_t elapsed = (cls.real_time - s->arrival) * time_scale->value;
+	const int32_t target = cl.frame.time + elapsed - s->delay;
+	const int32_t error = target - (int32_t) cl.time;
+
+	if (abs(error) > SNAPSHOT_MAX_DELAY) {
+		// Com_Debug("Resync: %dms\n", error);
+		cl.time = MAX(target, 0);
 	} else {
-		const uint32_t delta = cl.time - from->time;
-		const uint32_t interval = cl.frame.time - from->time;
-
-		if (interval == 0) {
-			Com_Debug("Bad clamp\n");
-			cl.time = cl.frame.time;
-			cl.lerp = 1.0;
-			return;
-		}
+		cl.time += error / 8;
+	}
 
-		cl.lerp = delta / (vec_t) interval;
+	Cl_ApplyFrames(cl.time);
+
+	const cl_frame_t *from = &cl.frames[s->from & PACKET_MASK];
+	const cl_frame_t *to = &cl.frames[s->to & PACKET_MASK];
+
+	if (from->frame_num != s->from || to->time <= from->time) {
+		cl.lerp = 1.0;
+		return;
 	}
+
+	const uint32_t max = to->time + MAX(cl_max_extrapolate->integer, 0);
+	const uint32_t time = Clamp(cl.time, from->time, max);
+
+	cl.lerp = (time - from->time) / (vec_t) (to->time - from->time);
 }
 
 /*
@@ -114,7 +163,7 @@ static void Cl_UpdateOrigin(const player_state_t *ps, const player_state_t *ops)
 		// use client sided prediction
 		for (i = 0; i < 3; i++) {
 			r_view.origin[i] = cl.predicted_state.origin[i] + cl.predicted_state.view_offset[i];
-			r_view.origin[i] -= (1.0 - cl.lerp) * cl.predicted_state.error[i];
+			r_view.origin[i] -= (1.0 - MIN(cl.lerp, 1.0)) * cl.predicted_state.error[i];
 		}
 
 		const uint32_t delta = cl.time - cl.predicted_state.step_time;
@@ -200,24 +249,62 @@ static void Cl_UpdateAngles(const player_state_t *ps, const player_state_t *ops)
 	AngleVectors(r_view.angles, r_view.forward, r_view.right, r_view.up);
 }
 
+/*
+ * @brief Thread entry point for the client game to populate the view.
+ */
+static void Cl_PopulateView(void *data) {
+
+	Cl_TimeDemoBegin(CL_TIME_DEMO_POPULATE_VIEW);
+
+	cls.cgame->PopulateView((const cl_frame_t *) data);
+
+	R_AddSustainedLights();
+
+	Cl_TimeDemoEnd(CL_TIME_DEMO_POPULATE_VIEW);
+}
+
+/*
+ * @brief Returns true if the interpolated state has changed since the view was
+ * last populated, in which case it is recorded. Otherwise, the scene from the
+ * previous frame may be drawn again as is.
+ */
+static _Bool Cl_UpdateViewState(const cl_frame_t *frame) {
+	cl_view_state_t *s = &cl.view_state;
+
+	if (!r_view.update && s->time == cl.time && s->frame_num == frame->frame_num) {
+		if (VectorCompare(s->origin, r_view.origin) && VectorCompare(s->angles, r_view.angles))
+			return false;
+	}
+
+	s->time = cl.time;
+	s->frame_num = frame->frame_num;
+
+	VectorCopy(r_view.origin, s->origin);
+	VectorCopy(r_view.angles, s->angles);
+
+	return true;
+}
+
 /*
  * @brief Updates the r_view_t for the renderer. Origin, angles, etc are calculated.
- * Scene population is then delegated to the client game.
+ * Scene population is then delegated to the client game, but only when the
+ * interpolated state has changed.
  */
 void Cl_UpdateView(void) {
 
 	if (!cl.frame.valid && !r_view.update)
 		return; // not a valid frame, and no forced update
 
-	// find the previous frame to interpolate from
-	cl_frame_t *prev = &cl.frames[(cl.frame.frame_num - 1) & PACKET_MASK];
+	Cl_UpdateLerp();
 
-	if (prev->frame_num != cl.frame.frame_num - 1 || !prev->valid)
-		prev = &cl.frame; // previous frame was dropped or invalid
+	// interpolate between the applied frames
+	cl_frame_t *frame = &cl.frames[cl.snapshots.to & PACKET_MASK];
+	const cl_frame_t *prev = &cl.frames[cl.snapshots.from & PACKET_MASK];
 
-	Cl_UpdateLerp(prev);
+	if (prev->frame_num != cl.snapshots.from)
+		prev = frame;
 
-	const player_state_t *ps = &cl.frame.ps;
+	const player_state_t *ps = &frame->ps;
 	const player_state_t *ops = &prev->ps;
 
 	if (ps != ops) { // see if we've teleported
@@ -233,7 +320,7 @@ void Cl_UpdateView(void) {
 		}
 	}
 
-	Cl_ClearView();
+	Cl_ClearViewCounters();
 
 	Cl_UpdateOrigin(ps, ops);
 
@@ -241,16 +328,23 @@ void Cl_UpdateView(void) {
 
 	Cl_UpdateViewSize();
 
-	cls.cgame->UpdateView(&cl.frame);
+	cls.cgame->UpdateView(frame);
+
+	if (!Cl_UpdateViewState(frame)) {
+		r_view.thread = NULL; // reuse the scene from the previous frame
+		return;
+	}
+
+	Cl_ClearView();
 
 	// set time
 	r_view.time = cl.time;
 
 	// set area bits to mark visible leafs
-	r_view.area_bits = cl.frame.area_bits;
+	r_view.area_bits = frame->area_bits;
 
 	// create the thread which populates the view
-	r_view.thread = Thread_Create((ThreadRunFunc) cls.cgame->PopulateView, &cl.frame);
+	r_view.thread = Thread_Create(Cl_PopulateView, frame);
 }
 
 /*
@@ -24,7 +24,9 @@
 
 #include "cmodel.h"
 #include "console.h"
+#include "demo.h"
 #include "net_chan.h"
+#include "net_frame.h"
 #include "filesystem.h"
 #include "thread.h"
 #include "cgame/cgame.h"
@@ -46,6 +48,7 @@
 #include "cl_predict.h"
 #include "cl_screen.h"
 #include "cl_server.h"
+#include "cl_time_demo.h"
 #include "cl_types.h"
 #include "cl_view.h"
 
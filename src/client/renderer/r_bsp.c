@@ -19,6 +19,10 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
  */
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #include "r_local.h"
 
 static vec3_t r_bsp_model_org; // relative to r_view.origin
@@ -41,6 +45,188 @@ _Bool R_CullBox(const vec3_t mins, const vec3_t maxs) {
 	return true;
 }
 
+/*
+ * @brief A contiguous chunk of the packed BSP bounds, culled by one thread.
+ */
+typedef struct {
+	uint32_t first;
+	uint32_t count;
+	thread_t *thread;
+} r_bsp_cull_chunk_t;
+
+#define BSP_CULL_CHUNK_MIN 512
+
+static struct {
+	r_bsp_cull_chunk_t chunks[MAX_THREADS + 1];
+	uint16_t num_chunks;
+} r_bsp_cull;
+
+#if defined(__SSE__)
+
+/*
+ * @brief Clears the culled flags of the four boxes whose bits in mask are not
+ * set. The flags are masked as one word, rather than a byte at a time.
+ */
+static inline void R_CullBspBounds_Mask(byte *culled, const int32_t mask) {
+	static const byte masks[16][4] = {
+		{ 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 1, 1, 0, 0 },
+		{ 0, 0, 1, 0 }, { 1, 0, 1, 0 }, { 0, 1, 1, 0 }, { 1, 1, 1, 0 },
+		{ 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 1, 1, 0, 1 },
+		{ 0, 0, 1, 1 }, { 1, 0, 1, 1 }, { 0, 1, 1, 1 }, { 1, 1, 1, 1 }
+	};
+	uint32_t c, m;
+
+	memcpy(&c, culled, sizeof(c));
+	memcpy(&m, masks[mask], sizeof(m));
+
+	c &= m;
+
+	memcpy(culled, &c, sizeof(c));
+}
+
+#endif
+
+/*
+ * @brief Frustum culls a chunk of the packed BSP bounds. For each plane, the
+ * component of each box nearest the plane's front side is selected up front,
+ * leaving a branch-free loop over contiguous arrays. Where SSE is available,
+ * four boxes are tested per iteration, and the remainder by the scalar loop.
+ * Axial planes are tested with SIDE_EPSILON, as BoxOnPlaneSide does, so that
+ * the result matches R_CullBox for every box.
+ */
+static void R_CullBspBounds_(void *data) {
+	const r_bsp_cull_chunk_t *chunk = (const r_bsp_cull_chunk_t *) data;
+	const r_bsp_bounds_t *bounds = &r_model_state.world->bsp->bounds;
+	uint32_t i, j;
+
+	byte *culled = bounds->culled + chunk->first;
+
+	if (!r_cull->value) {
+		memset(culled, 0, chunk->count);
+		return;
+	}
+
+	memset(culled, 1, chunk->count);
+
+	for (i = 0; i < 4; i++) {
+		const c_bsp_plane_t *p = &r_locals.frustum[i];
+
+		if (AXIAL(p)) {
+			const vec_t *mins = bounds->mins[p->type] + chunk->first;
+			const vec_t *maxs = bounds->maxs[p->type] + chunk->first;
+
+			const vec_t front = p->dist - SIDE_EPSILON, back = p->dist + SIDE_EPSILON;
+
+			j = 0;
+
+#if defined(__SSE__)
+			const __m128 front4 = _mm_set1_ps(front), back4 = _mm_set1_ps(back);
+
+			for (; j + 4 <= chunk->count; j += 4) {
+				const __m128 a = _mm_cmplt_ps(_mm_loadu_ps(mins + j), front4);
+				const __m128 b = _mm_cmple_ps(_mm_loadu_ps(maxs + j), back4);
+
+				R_CullBspBounds_Mask(culled + j, _mm_movemask_ps(_mm_and_ps(a, b)));
+			}
+#endif
+
+			for (; j < chunk->count; j++) {
+				culled[j] &= (mins[j] < front) & (maxs[j] <= back);
+			}
+
+			continue;
+		}
+
+		const vec_t *x = (p->normal[0] < 0.0 ? bounds->mins[0] : bounds->maxs[0]) + chunk->first;
+		const vec_t *y = (p->normal[1] < 0.0 ? bounds->mins[1] : bounds->maxs[1]) + chunk->first;
+		const vec_t *z = (p->normal[2] < 0.0 ? bounds->mins[2] : bounds->maxs[2]) + chunk->first;
+
+		const vec_t nx = p->normal[0], ny = p->normal[1], nz = p->normal[2], dist = p->dist;
+
+		j = 0;
+
+#if defined(__SSE__)
+		const __m128 nx4 = _mm_set1_ps(nx), ny4 = _mm_set1_ps(ny), nz4 = _mm_set1_ps(nz);
+		const __m128 dist4 = _mm_set1_ps(dist);
+
+		for (; j + 4 <= chunk->count; j += 4) {
+			const __m128 dx = _mm_mul_ps(nx4, _mm_loadu_ps(x + j));
+			const __m128 dy = _mm_mul_ps(ny4, _mm_loadu_ps(y + j));
+			const __m128 dz = _mm_mul_ps(nz4, _mm_loadu_ps(z + j));
+
+			const __m128 d = _mm_add_ps(_mm_add_ps(dx, dy), dz);
+
+			R_CullBspBounds_Mask(culled + j, _mm_movemask_ps(_mm_cmplt_ps(d, dist4)));
+		}
+#endif
+
+		for (; j < chunk->count; j++) {
+			culled[j] &= (nx * x[j] + ny * y[j] + nz * z[j] < dist);
+		}
+	}
+}
+
+/*
+ * @brief Dispatches the frustum culling of the world's packed bounds over the
+ * thread pool. Only the clusters are culled when drawing by cluster, and only
+ * the nodes and leafs otherwise. R_MarkBspSurfaces collects the results.
+ */
+void R_CullBspBounds(void) {
+	uint32_t i, first, count;
+
+	const r_bsp_bounds_t *bounds = &r_model_state.world->bsp->bounds;
+
+	if (r_model_state.world->bsp->num_cluster_verts) {
+		first = bounds->first_cluster;
+		count = bounds->count - bounds->first_cluster;
+	} else {
+		first = 0;
+		count = bounds->first_cluster;
+	}
+
+	r_bsp_cull.num_chunks = Clamp(count / BSP_CULL_CHUNK_MIN, 1, Thread_Count() + 1);
+
+	const uint32_t size = (count + r_bsp_cull.num_chunks - 1) / r_bsp_cull.num_chunks;
+
+	r_bsp_cull_chunk_t *chunk = r_bsp_cull.chunks;
+	for (i = 0; i < r_bsp_cull.num_chunks; i++, chunk++) {
+
+		const uint32_t offset = MIN(i * size, count);
+
+		chunk->first = first + offset;
+		chunk->count = MIN(size, count - offset);
+
+		chunk->thread = Thread_Create(R_CullBspBounds_, chunk);
+	}
+}
+
+/*
+ * @brief Waits for the chunks dispatched by R_CullBspBounds to complete.
+ */
+static void R_WaitBspBounds(void) {
+	uint16_t i;
+
+	for (i = 0; i < r_bsp_cull.num_chunks; i++) {
+		Thread_Wait(r_bsp_cull.chunks[i].thread);
+	}
+
+	r_bsp_cull.num_chunks = 0;
+}
+
+/*
+ * @brief Returns true if the specified node or leaf was culled by
+ * R_CullBspBounds for the current frame.
+ */
+static _Bool R_CulledBspNode(const r_bsp_node_t *node) {
+	const r_bsp_model_t *bsp = r_model_state.world->bsp;
+
+	if (node->contents == CONTENTS_NODE)
+		return bsp->bounds.culled[node - bsp->nodes];
+
+	const r_bsp_leaf_t *leaf = (const r_bsp_leaf_t *) node;
+	return bsp->bounds.culled[bsp->bounds.first_leaf + (leaf - bsp->leafs)];
+}
+
 /*
  * @brief Returns true if the specified entity is completely culled by the view
  * frustum, false otherwise.
@@ -308,8 +494,8 @@ void R_DrawBspLeafs(void) {
 
 /*
  * @brief Top-down BSP node recursion. Nodes identified as within the PVS by
- * R_MarkLeafs are first frustum-culled; those which fail immediately
- * return.
+ * R_MarkLeafs are first frustum-culled by R_CullBspBounds; those which fail
+ * immediately return.
  *
  * For the rest, the front-side child node is recursed. Any surfaces marked
  * in that recursion must then pass a dot-product test to resolve sidedness.
@@ -325,7 +511,7 @@ static void R_MarkBspSurfaces_(r_bsp_node_t *node) {
 	if (node->vis_frame != r_locals.vis_frame)
 		return; // not in view
 
-	if (R_CullBox(node->mins, node->maxs))
+	if (R_CulledBspNode(node))
 		return; // culled out
 
 	// if leaf node, flag surfaces to draw this frame
@@ -385,6 +571,105 @@ static void R_MarkBspSurfaces_(r_bsp_node_t *node) {
 	R_MarkBspSurfaces_(node->children[!side]);
 }
 
+/*
+ * @brief Marks the specified surface, drawn individually when drawing by
+ * cluster, as front or back facing.
+ */
+static void R_MarkBspClusterSurface(r_bsp_surface_t *surf) {
+	const c_bsp_plane_t *plane = surf->plane;
+	vec_t dot;
+
+	if (AXIAL(plane))
+		dot = r_view.origin[plane->type] - plane->dist;
+	else
+		dot = DotProduct(r_view.origin, plane->normal) - plane->dist;
+
+	if (surf->flags & R_SURF_SIDE_BACK)
+		dot = -dot;
+
+	if (dot >= 0.0) { // draw it
+		surf->frame = r_locals.frame;
+		surf->back_frame = -1;
+	} else { // back-facing
+		surf->frame = -1;
+		surf->back_frame = r_locals.frame;
+	}
+}
+
+/*
+ * @brief Marks the surfaces of the visible leafs of no cluster, which are only
+ * in the PVS when everything is, e.g. when the view is outside of the world.
+ * Their surfaces are not in any cluster's material ranges, and so are drawn
+ * individually.
+ */
+static void R_MarkBspUnclusteredLeafs(void) {
+	r_bsp_model_t *bsp = r_model_state.world->bsp;
+	uint32_t i;
+	uint16_t j;
+
+	for (i = 0; i < bsp->num_unclustered_leafs; i++) {
+		const r_bsp_leaf_t *leaf = bsp->unclustered_leafs[i];
+
+		if (leaf->vis_frame != r_locals.vis_frame)
+			continue; // not in view
+
+		if (r_view.area_bits) { // check for door connected areas
+			if (!(r_view.area_bits[leaf->area >> 3] & (1 << (leaf->area & 7))))
+				continue; // not visible
+		}
+
+		if (R_CullBox(leaf->mins, leaf->maxs))
+			continue; // culled out
+
+		r_bsp_surface_t **s = leaf->first_leaf_surface;
+
+		for (j = 0; j < leaf->num_leaf_surfaces; j++, s++) {
+			if ((*s)->flags & R_SURF_NO_CLUSTER)
+				R_MarkBspClusterSurface(*s);
+		}
+
+		bsp->unclustered_frame = r_locals.frame;
+	}
+}
+
+/*
+ * @brief Marks the clusters in the PVS which pass the area and frustum tests,
+ * so that their material ranges are drawn. The surfaces each cluster draws
+ * individually must also pass a dot-product test to resolve sidedness.
+ */
+static void R_MarkBspClusters(void) {
+	uint16_t i, j;
+
+	const byte *culled = r_model_state.world->bsp->bounds.culled
+			+ r_model_state.world->bsp->bounds.first_cluster;
+
+	r_bsp_cluster_t *c = r_model_state.world->bsp->clusters;
+
+	for (i = 0; i < r_model_state.world->bsp->num_clusters; i++, c++) {
+
+		if (c->vis_frame != r_locals.vis_frame)
+			continue; // not in view
+
+		if (r_view.area_bits && c->area != -1) { // check for door connected areas
+			if (!(r_view.area_bits[c->area >> 3] & (1 << (c->area & 7))))
+				continue; // not visible
+		}
+
+		if (culled[i])
+			continue; // culled out
+
+		c->frame = r_locals.frame;
+
+		r_bsp_surface_t **s = c->surfaces;
+
+		for (j = 0; j < c->num_surfaces; j++, s++) {
+			R_MarkBspClusterSurface(*s);
+		}
+	}
+
+	R_MarkBspUnclusteredLeafs();
+}
+
 /*
  * @brief Entry point for BSP recursion and surface-level visibility test.
  */
@@ -396,8 +681,14 @@ void R_MarkBspSurfaces(void) {
 	// clear the bounds of the sky box
 	R_ClearSkyBox();
 
-	// flag all visible world surfaces
-	R_MarkBspSurfaces_(r_model_state.world->bsp->nodes);
+	// collect the frustum culling results
+	R_WaitBspBounds();
+
+	// flag all visible world surfaces, or clusters when drawing by cluster
+	if (r_model_state.world->bsp->num_cluster_verts)
+		R_MarkBspClusters();
+	else
+		R_MarkBspSurfaces_(r_model_state.world->bsp->nodes);
 }
 
 /*
@@ -484,6 +775,9 @@ void R_UpdateVis(void) {
 		for (i = 0; i < r_model_state.world->bsp->num_nodes; i++)
 			r_model_state.world->bsp->nodes[i].vis_frame = r_locals.vis_frame;
 
+		for (i = 0; i < r_model_state.world->bsp->num_clusters; i++)
+			r_model_state.world->bsp->clusters[i].vis_frame = r_locals.vis_frame;
+
 		r_view.num_bsp_clusters = r_model_state.world->bsp->num_clusters;
 		r_view.num_bsp_leafs = r_model_state.world->bsp->num_leafs;
 
@@ -28,6 +28,7 @@ _Bool R_LeafInPhs(const r_bsp_leaf_t *leaf);
 
 #ifdef __R_LOCAL_H__
 _Bool R_CullBox(const vec3_t mins, const vec3_t maxs);
+void R_CullBspBounds(void);
 _Bool R_CullBspModel(const r_entity_t *e);
 void R_DrawBspInlineModel(const r_entity_t *e);
 void R_DrawBspLeafs(void);
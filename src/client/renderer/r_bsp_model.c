@@ -268,6 +268,12 @@ static void R_LoadBspTexinfo(r_bsp_model_t *bsp, const d_bsp_lump_t *l) {
 		out->value = LittleLong(in->value);
 
 		out->material = R_LoadMaterial(va("textures/%s", out->name));
+	}
+
+	// texture coordinates require the diffuse dimensions, so wait for them
+	for (i = 0, out = bsp->texinfo; i < bsp->num_texinfo; i++, out++) {
+
+		R_WaitMedia((r_media_t *) out->material->diffuse);
 
 		// Hack to down-scale high-res textures for legacy levels
 		if (bsp->version == BSP_VERSION) {
@@ -578,6 +584,293 @@ static void R_LoadBspPlanes(r_bsp_model_t *bsp, const d_bsp_lump_t *l) {
 	}
 }
 
+/*
+ * @brief Returns true if the specified world surface is drawn from its clusters'
+ * material ranges. Sky, blended and material-only surfaces rely on per-surface
+ * state or ordering, and so are always drawn individually.
+ */
+static _Bool R_IsBspClusterSurface(const r_bsp_surface_t *surf) {
+
+	if (surf->num_edges < 3)
+		return false;
+
+	if (surf->texinfo->flags & (SURF_SKY | SURF_BLEND_33 | SURF_BLEND_66 | SURF_MATERIAL))
+		return false;
+
+	return true;
+}
+
+/*
+ * @brief Returns true if the specified world surface must still be marked
+ * individually when drawing by cluster, for its own render path or for the
+ * material and flare passes.
+ */
+static _Bool R_IsBspClusterIndividualSurface(const r_bsp_surface_t *surf) {
+
+	if (!R_IsBspClusterSurface(surf))
+		return true;
+
+	return surf->texinfo->material->flags & (STAGE_DIFFUSE | STAGE_FLARE);
+}
+
+/*
+ * @brief Returns true if the specified world surface is blended, and so must be
+ * depth-sorted with the other elements each frame.
+ */
+static _Bool R_IsBspBlendSurface(const r_bsp_surface_t *surf) {
+
+	if (surf->texinfo->flags & SURF_SKY)
+		return false;
+
+	return surf->texinfo->flags & (SURF_BLEND_33 | SURF_BLEND_66);
+}
+
+/*
+ * The world surfaces drawn by cluster, gathered by R_LoadBspClusterSurfaces and
+ * consumed by R_LoadBspClusterArrays once the surfaces arrays are sorted.
+ */
+typedef struct {
+	r_bsp_surface_t *surface;
+	uint16_t cluster;
+} r_bsp_cluster_surface_t;
+
+static GArray *r_bsp_cluster_surfaces;
+
+/*
+ * @brief Allocates and returns the subset of the specified surfaces which
+ * satisfy the given predicate, or NULL if none do.
+ */
+static r_bsp_surface_t **R_LoadBspClusterSurfaces_(r_bsp_model_t *bsp, r_bsp_surface_t **surfs,
+		const uint32_t count, _Bool (*Predicate)(const r_bsp_surface_t *surf), uint16_t *num_out) {
+	uint32_t i;
+
+	*num_out = 0;
+
+	for (i = 0; i < count; i++) {
+		if (Predicate(surfs[i]))
+			(*num_out)++;
+	}
+
+	if (!*num_out)
+		return NULL;
+
+	r_bsp_surface_t **out = Mem_LinkMalloc(*num_out * sizeof(r_bsp_surface_t *), bsp);
+	r_bsp_surface_t **o = out;
+
+	for (i = 0; i < count; i++) {
+		if (Predicate(surfs[i]))
+			*o++ = surfs[i];
+	}
+
+	return out;
+}
+
+/*
+ * @brief Resolves the bounds, area and blended surfaces of each cluster. When
+ * the world is to be drawn by cluster, the individually drawn surfaces are
+ * resolved too, and the vertex count of the triangulated cluster geometry is
+ * accumulated so that R_AllocVertexArrays may reserve space for it.
+ */
+static void R_LoadBspClusterSurfaces(r_bsp_model_t *bsp) {
+	uint32_t i, j;
+	int16_t k;
+
+	if (!bsp->num_clusters || !bsp->num_inline_models)
+		return;
+
+	// bucket the leafs by cluster, offsets[c] ends up at the end of bucket c
+	uint32_t *offsets = Mem_Malloc((bsp->num_clusters + 1) * sizeof(uint32_t));
+	const r_bsp_leaf_t **leafs = Mem_Malloc(bsp->num_leafs * sizeof(r_bsp_leaf_t *));
+
+	const r_bsp_leaf_t *leaf = bsp->leafs;
+	for (i = 0; i < bsp->num_leafs; i++, leaf++) {
+		if (leaf->cluster >= 0 && leaf->cluster < bsp->num_clusters)
+			offsets[leaf->cluster + 1]++;
+	}
+
+	for (i = 0; i < bsp->num_clusters; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	leaf = bsp->leafs;
+	for (i = 0; i < bsp->num_leafs; i++, leaf++) {
+		if (leaf->cluster >= 0 && leaf->cluster < bsp->num_clusters)
+			leafs[offsets[leaf->cluster]++] = leaf;
+	}
+
+	r_bsp_surface_t **surfs = Mem_Malloc(bsp->num_surfaces * sizeof(r_bsp_surface_t *));
+	uint32_t *stamps = Mem_Malloc(bsp->num_surfaces * sizeof(uint32_t));
+
+	const r_bsp_surface_t *first = bsp->surfaces + bsp->inline_models[0].first_surface;
+	const r_bsp_surface_t *last = first + bsp->inline_models[0].num_surfaces;
+
+	if (r_bsp_cluster_surfaces) {
+		g_array_free(r_bsp_cluster_surfaces, true);
+		r_bsp_cluster_surfaces = NULL;
+	}
+
+	if (r_clusters->value) {
+		r_bsp_cluster_surfaces = g_array_new(false, false, sizeof(r_bsp_cluster_surface_t));
+	}
+
+	r_bsp_cluster_t *c = bsp->clusters;
+	for (i = 0; i < bsp->num_clusters; i++, c++) {
+		uint32_t num_surfs = 0;
+
+		ClearBounds(c->mins, c->maxs);
+		c->area = -1;
+
+		// gather the unique world surfaces of the cluster's leafs
+		for (j = i ? offsets[i - 1] : 0; j < offsets[i]; j++) {
+
+			leaf = leafs[j];
+
+			AddPointToBounds(leaf->mins, c->mins, c->maxs);
+			AddPointToBounds(leaf->maxs, c->mins, c->maxs);
+
+			if (j == (i ? offsets[i - 1] : 0))
+				c->area = leaf->area;
+			else if (c->area != leaf->area)
+				c->area = -1;
+
+			r_bsp_surface_t **s = leaf->first_leaf_surface;
+			for (k = 0; k < leaf->num_leaf_surfaces; k++, s++) {
+
+				if (*s < first || *s >= last)
+					continue;
+
+				const ptrdiff_t n = *s - bsp->surfaces;
+				if (stamps[n] == i + 1)
+					continue;
+
+				stamps[n] = i + 1;
+				surfs[num_surfs++] = *s;
+			}
+		}
+
+		c->blend_surfaces = R_LoadBspClusterSurfaces_(bsp, surfs, num_surfs, R_IsBspBlendSurface,
+				&c->num_blend_surfaces);
+
+		if (!r_bsp_cluster_surfaces)
+			continue;
+
+		c->surfaces = R_LoadBspClusterSurfaces_(bsp, surfs, num_surfs,
+				R_IsBspClusterIndividualSurface, &c->num_surfaces);
+
+		for (j = 0; j < num_surfs; j++) {
+
+			if (R_IsBspClusterSurface(surfs[j])) {
+				const r_bsp_cluster_surface_t cs = { surfs[j], i };
+				g_array_append_val(r_bsp_cluster_surfaces, cs);
+
+				bsp->num_cluster_verts += (surfs[j]->num_edges - 2) * 3;
+			}
+		}
+	}
+
+	// surfaces only in leafs of no cluster are marked and drawn individually
+	if (r_bsp_cluster_surfaces) {
+
+		leaf = bsp->leafs;
+		for (i = 0; i < bsp->num_leafs; i++, leaf++) {
+			uint32_t num_surfs = 0;
+
+			if (leaf->contents == CONTENTS_SOLID)
+				continue;
+
+			if (leaf->cluster >= 0 && leaf->cluster < bsp->num_clusters)
+				continue;
+
+			r_bsp_surface_t **s = leaf->first_leaf_surface;
+			for (k = 0; k < leaf->num_leaf_surfaces; k++, s++) {
+
+				if (*s < first || *s >= last)
+					continue;
+
+				if (stamps[*s - bsp->surfaces])
+					continue; // drawn by cluster
+
+				(*s)->flags |= R_SURF_NO_CLUSTER;
+				num_surfs++;
+			}
+
+			if (num_surfs)
+				leafs[bsp->num_unclustered_leafs++] = leaf;
+		}
+
+		if (bsp->num_unclustered_leafs) {
+			const size_t size = bsp->num_unclustered_leafs * sizeof(r_bsp_leaf_t *);
+
+			bsp->unclustered_leafs = Mem_LinkMalloc(size, bsp);
+			memcpy(bsp->unclustered_leafs, leafs, size);
+		}
+	}
+
+	Mem_Free(stamps);
+	Mem_Free(surfs);
+	Mem_Free(leafs);
+	Mem_Free(offsets);
+
+	if (r_bsp_cluster_surfaces) {
+		Com_Debug("Drawing %d surfaces by cluster (%d verts), %d leafs by surface\n",
+				r_bsp_cluster_surfaces->len, bsp->num_cluster_verts, bsp->num_unclustered_leafs);
+	}
+}
+
+/*
+ * @brief Writes the specified bounds at the given index of the packed bounds.
+ */
+static void R_LoadBspBounds_(r_bsp_bounds_t *bounds, uint32_t index, const vec3_t mins,
+		const vec3_t maxs) {
+	uint16_t i;
+
+	for (i = 0; i < 3; i++) {
+		bounds->mins[i][index] = mins[i];
+		bounds->maxs[i][index] = maxs[i];
+	}
+}
+
+/*
+ * @brief Packs the bounds of all nodes, leafs and, when drawing by cluster,
+ * clusters by component, so that R_CullBspBounds may test them in batches.
+ */
+static void R_LoadBspBounds(r_bsp_model_t *bsp) {
+	r_bsp_bounds_t *bounds = &bsp->bounds;
+	uint32_t i;
+
+	bounds->first_leaf = bsp->num_nodes;
+	bounds->first_cluster = bounds->first_leaf + bsp->num_leafs;
+
+	bounds->count = bounds->first_cluster;
+
+	if (bsp->num_cluster_verts)
+		bounds->count += bsp->num_clusters;
+
+	for (i = 0; i < 3; i++) {
+		bounds->mins[i] = Mem_LinkMalloc(bounds->count * sizeof(vec_t), bsp);
+		bounds->maxs[i] = Mem_LinkMalloc(bounds->count * sizeof(vec_t), bsp);
+	}
+
+	bounds->culled = Mem_LinkMalloc(bounds->count, bsp);
+
+	const r_bsp_node_t *node = bsp->nodes;
+	for (i = 0; i < bsp->num_nodes; i++, node++) {
+		R_LoadBspBounds_(bounds, i, node->mins, node->maxs);
+	}
+
+	const r_bsp_leaf_t *leaf = bsp->leafs;
+	for (i = 0; i < bsp->num_leafs; i++, leaf++) {
+		R_LoadBspBounds_(bounds, bounds->first_leaf + i, leaf->mins, leaf->maxs);
+	}
+
+	if (bsp->num_cluster_verts) {
+		const r_bsp_cluster_t *cluster = bsp->clusters;
+		for (i = 0; i < bsp->num_clusters; i++, cluster++) {
+			R_LoadBspBounds_(bounds, bounds->first_cluster + i, cluster->mins, cluster->maxs);
+		}
+	}
+}
+
 /*
  * @brief Writes vertex data for the given surface to the load model's arrays.
  *
@@ -804,6 +1097,168 @@ static void R_LoadBspSurfacesArrays(r_model_t *mod) {
 	R_SortBspSurfacesArrays(mod->bsp);
 }
 
+/*
+ * @brief Returns the sorted surfaces array which draws the specified cluster
+ * surface.
+ */
+static r_bsp_surfaces_t *R_BspClusterSurfacesArray(r_sorted_bsp_surfaces_t *sorted,
+		const r_bsp_surface_t *surf) {
+
+	if (surf->texinfo->flags & SURF_WARP)
+		return &sorted->opaque_warp;
+
+	if (surf->texinfo->flags & SURF_ALPHA_TEST)
+		return &sorted->alpha_test;
+
+	return &sorted->opaque;
+}
+
+#define R_ComparePointers(p1, p2) (((p1) > (p2)) - ((p1) < (p2)))
+
+/*
+ * @brief Compares the render state of the specified surfaces, returning 0 if
+ * they may be drawn together.
+ */
+static int R_BspClusterSurfaces_CompareState(const r_bsp_surface_t *s1,
+		const r_bsp_surface_t *s2) {
+	int order;
+
+	const int32_t mask = SURF_WARP | SURF_ALPHA_TEST;
+	if ((order = (s1->texinfo->flags & mask) - (s2->texinfo->flags & mask)))
+		return order;
+
+	if ((order = g_strcmp0(s1->texinfo->name, s2->texinfo->name)))
+		return order;
+
+	if ((order = R_ComparePointers(s1->texinfo->material, s2->texinfo->material)))
+		return order;
+
+	if ((order = R_ComparePointers(s1->lightmap, s2->lightmap)))
+		return order;
+
+	return R_ComparePointers(s1->deluxemap, s2->deluxemap);
+}
+
+/*
+ * @brief Qsort comparator for R_LoadBspClusterArrays. Cluster surfaces are
+ * grouped by render state, then by cluster.
+ */
+static int R_LoadBspClusterArrays_Compare(const void *p1, const void *p2) {
+	const r_bsp_cluster_surface_t *c1 = (const r_bsp_cluster_surface_t *) p1;
+	const r_bsp_cluster_surface_t *c2 = (const r_bsp_cluster_surface_t *) p2;
+	int order;
+
+	if ((order = R_BspClusterSurfaces_CompareState(c1->surface, c2->surface)))
+		return order;
+
+	if ((order = c1->cluster - c2->cluster))
+		return order;
+
+	return R_ComparePointers(c1->surface, c2->surface);
+}
+
+/*
+ * @brief Copies the specified world vertex to the given index, including all of
+ * its attributes.
+ */
+static void R_LoadBspClusterArrays_Vertex(r_model_t *mod, GLuint in, GLuint out) {
+
+	memcpy(&mod->verts[out * 3], &mod->verts[in * 3], sizeof(vec3_t));
+	memcpy(&mod->texcoords[out * 2], &mod->texcoords[in * 2], sizeof(vec2_t));
+	memcpy(&mod->lightmap_texcoords[out * 2], &mod->lightmap_texcoords[in * 2], sizeof(vec2_t));
+	memcpy(&mod->normals[out * 3], &mod->normals[in * 3], sizeof(vec3_t));
+	memcpy(&mod->tangents[out * 4], &mod->tangents[in * 4], sizeof(vec4_t));
+}
+
+/*
+ * @brief Appends triangulated copies of the cluster surfaces to the world
+ * vertex arrays, ordered by render state and then by cluster. Each run of a
+ * single render state becomes a material reference, and each cluster therein
+ * a range, so that the ranges of adjacent visible clusters may be drawn with
+ * a single call.
+ */
+static void R_LoadBspClusterArrays(r_model_t *mod) {
+	r_bsp_surfaces_t *surfs;
+	uint32_t i, num_ranges;
+	uint16_t j;
+
+	if (!mod->bsp->num_cluster_verts)
+		return;
+
+	r_bsp_cluster_surface_t *in = (r_bsp_cluster_surface_t *) r_bsp_cluster_surfaces->data;
+	const uint32_t len = r_bsp_cluster_surfaces->len;
+
+	qsort(in, len, sizeof(r_bsp_cluster_surface_t), R_LoadBspClusterArrays_Compare);
+
+	// count the material references and ranges
+	num_ranges = 0;
+	for (i = 0; i < len; i++) {
+
+		if (!i || R_BspClusterSurfaces_CompareState(in[i - 1].surface, in[i].surface)) {
+			surfs = R_BspClusterSurfacesArray(mod->bsp->sorted_surfaces, in[i].surface);
+			surfs->num_material_refs++;
+			num_ranges++;
+		} else if (in[i - 1].cluster != in[i].cluster) {
+			num_ranges++;
+		}
+	}
+
+	// allocate them
+	r_bsp_cluster_range_t *ranges = Mem_LinkMalloc(num_ranges * sizeof(*ranges), mod->bsp);
+
+	const size_t count = sizeof(r_sorted_bsp_surfaces_t) / sizeof(r_bsp_surfaces_t);
+	surfs = (r_bsp_surfaces_t *) mod->bsp->sorted_surfaces;
+	for (i = 0; i < count; i++, surfs++) {
+
+		if (surfs->num_material_refs) {
+			const size_t size = surfs->num_material_refs * sizeof(r_bsp_material_ref_t);
+			surfs->material_refs = Mem_LinkMalloc(size, mod->bsp);
+			surfs->num_material_refs = 0;
+		}
+	}
+
+	// and populate them, writing the triangles behind the leaf surfaces
+	GLuint index = mod->num_verts - mod->bsp->num_cluster_verts;
+
+	r_bsp_material_ref_t *ref = NULL;
+	r_bsp_cluster_range_t *range = NULL;
+
+	for (i = 0; i < len; i++) {
+		const r_bsp_surface_t *surf = in[i].surface;
+
+		if (!i || R_BspClusterSurfaces_CompareState(in[i - 1].surface, surf)) {
+			surfs = R_BspClusterSurfacesArray(mod->bsp->sorted_surfaces, surf);
+
+			ref = &surfs->material_refs[surfs->num_material_refs++];
+			ref->surface = surf;
+			ref->ranges = ranges;
+		}
+
+		if (!ref->num_ranges || range->cluster != in[i].cluster) {
+			range = ranges++;
+
+			range->cluster = in[i].cluster;
+			range->index = index;
+
+			ref->num_ranges++;
+		}
+
+		for (j = 1; j < surf->num_edges - 1; j++) {
+			R_LoadBspClusterArrays_Vertex(mod, surf->index, index++);
+			R_LoadBspClusterArrays_Vertex(mod, surf->index + j, index++);
+			R_LoadBspClusterArrays_Vertex(mod, surf->index + j + 1, index++);
+		}
+
+		range->count = index - range->index;
+		range->num_surfaces++;
+	}
+
+	g_array_free(r_bsp_cluster_surfaces, true);
+	r_bsp_cluster_surfaces = NULL;
+
+	Com_Debug("Built %d cluster ranges\n", num_ranges);
+}
+
 /*
  * @brief
  */
@@ -886,12 +1341,18 @@ void R_LoadBspModel(r_model_t *mod, void *buffer) {
 	R_SetupBspInlineModels(mod);
 	Cl_LoadProgress(52);
 
+	R_LoadBspClusterSurfaces(mod->bsp);
+
+	R_LoadBspBounds(mod->bsp);
+
 	R_LoadBspVertexArrays(mod);
 	Cl_LoadProgress(54);
 
 	R_LoadBspSurfacesArrays(mod);
 	Cl_LoadProgress(58);
 
+	R_LoadBspClusterArrays(mod);
+
 	R_InitElements(mod->bsp);
 
 	r_locals.old_cluster = -1; // force bsp iteration
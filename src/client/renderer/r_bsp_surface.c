@@ -22,9 +22,9 @@
 #include "r_local.h"
 
 /*
- * @brief
+ * @brief Binds the textures and material of the specified surface.
  */
-static void R_SetBspSurfaceState_default(const r_bsp_surface_t *surf) {
+static void R_SetBspMaterialState_default(const r_bsp_surface_t *surf) {
 	r_image_t *diffuse;
 
 	if (r_state.blend_enabled) { // alpha blend
@@ -53,11 +53,20 @@ static void R_SetBspSurfaceState_default(const r_bsp_surface_t *surf) {
 	if (texunit_lightmap.enabled) // lightmap texture
 		R_BindLightmapTexture(surf->lightmap->texnum);
 
-	if (r_state.lighting_enabled) { // hardware lighting
-
+	if (r_state.lighting_enabled) // hardware lighting
 		R_UseMaterial(surf, surf->texinfo->material);
+}
+
+/*
+ * @brief
+ */
+static void R_SetBspSurfaceState_default(const r_bsp_surface_t *surf) {
 
-		if (surf->light_frame == r_locals.light_frame) // dynamic light sources
+	R_SetBspMaterialState_default(surf);
+
+	if (r_state.lighting_enabled) { // dynamic light sources
+
+		if (surf->light_frame == r_locals.light_frame)
 			R_EnableLights(surf->lights);
 		else
 			R_EnableLights(0);
@@ -72,6 +81,140 @@ static void R_DrawBspSurface_default(const r_bsp_surface_t *surf) {
 	glDrawArrays(GL_POLYGON, surf->index, surf->num_edges);
 
 	r_view.num_bsp_surfaces++;
+	r_view.num_bsp_draws++;
+}
+
+/*
+ * @brief Returns true if the specified surfaces should be drawn from their
+ * clusters' material ranges. Inline models swap in a negative frame, and are
+ * always drawn by surface.
+ */
+static _Bool R_DrawBspClusters(const r_bsp_surfaces_t *surfs) {
+	return surfs->material_refs && r_locals.frame >= 0;
+}
+
+/*
+ * @brief Returns true if the specified surface should be drawn individually.
+ * When drawing by cluster, only the surfaces of leafs of no cluster are, and
+ * only if any of them were marked this frame.
+ */
+static _Bool R_DrawBspSurface(const r_bsp_surface_t *surf, const _Bool clusters) {
+
+	if (surf->frame != r_locals.frame)
+		return false;
+
+	if (!clusters)
+		return true;
+
+	if (r_model_state.world->bsp->unclustered_frame != r_locals.frame)
+		return false;
+
+	return surf->flags & R_SURF_NO_CLUSTER;
+}
+
+/*
+ * @brief Returns the bit mask of dynamic light sources reaching the specified
+ * cluster, resolving it once per lighting frame.
+ */
+static uint64_t R_BspClusterLights(r_bsp_cluster_t *cluster) {
+	uint16_t i, j;
+
+	if (cluster->light_frame != r_locals.light_frame) {
+		cluster->light_frame = r_locals.light_frame;
+		cluster->lights = 0;
+
+		const r_light_t *l = r_view.lights;
+		for (i = 0; i < r_view.num_lights; i++, l++) {
+			vec_t dist = 0.0;
+
+			for (j = 0; j < 3; j++) { // squared distance to the cluster bounds
+				vec_t d = 0.0;
+
+				if (l->origin[j] < cluster->mins[j])
+					d = cluster->mins[j] - l->origin[j];
+				else if (l->origin[j] > cluster->maxs[j])
+					d = l->origin[j] - cluster->maxs[j];
+
+				dist += d * d;
+			}
+
+			if (dist < l->radius * l->radius)
+				cluster->lights |= (uint64_t) 1 << i;
+		}
+	}
+
+	return cluster->lights;
+}
+
+/*
+ * @brief Draws a merged range of cluster triangles.
+ */
+static void R_DrawBspClusterRange_default(GLuint index, GLuint count, uint64_t lights,
+		const _Bool state) {
+
+	if (state && r_state.lighting_enabled)
+		R_EnableLights(lights);
+
+	glDrawArrays(GL_TRIANGLES, index, count);
+
+	r_view.num_bsp_draws++;
+}
+
+/*
+ * @brief Draws the ranges of the visible clusters for each of the specified
+ * material references. Ranges which are adjacent in the vertex arrays, and
+ * which receive the same light sources, are merged into a single draw.
+ *
+ * @param state If false, no textures, materials or lights are bound.
+ */
+static void R_DrawBspClusters_default(const r_bsp_surfaces_t *surfs, const _Bool state) {
+	size_t i;
+	uint16_t j;
+
+	r_bsp_cluster_t *clusters = r_model_state.world->bsp->clusters;
+
+	const r_bsp_material_ref_t *ref = surfs->material_refs;
+	for (i = 0; i < surfs->num_material_refs; i++, ref++) {
+		GLuint index = 0, count = 0;
+		uint64_t lights = 0;
+
+		const r_bsp_cluster_range_t *range = ref->ranges;
+		for (j = 0; j < ref->num_ranges; j++, range++) {
+			r_bsp_cluster_t *cluster = &clusters[range->cluster];
+
+			if (cluster->frame != r_locals.frame)
+				continue;
+
+			r_view.num_bsp_surfaces += range->num_surfaces;
+
+			uint64_t l = 0;
+
+			if (state) {
+				if (!count) // first visible range, bind the material
+					R_SetBspMaterialState_default(ref->surface);
+
+				if (r_state.lighting_enabled)
+					l = R_BspClusterLights(cluster);
+			}
+
+			if (count) {
+				if (index + count == range->index && l == lights) { // merge it
+					count += range->count;
+					continue;
+				}
+
+				R_DrawBspClusterRange_default(index, count, lights, state);
+			}
+
+			index = range->index;
+			count = range->count;
+			lights = l;
+		}
+
+		if (count) {
+			R_DrawBspClusterRange_default(index, count, lights, state);
+		}
+	}
 }
 
 /*
@@ -82,18 +225,25 @@ static void R_DrawBspSurfaces_default(const r_bsp_surfaces_t *surfs) {
 
 	R_SetArrayState(r_model_state.world);
 
-	// draw the surfaces
-	for (i = 0; i < surfs->count; i++) {
+	const _Bool clusters = R_DrawBspClusters(surfs);
+
+	if (clusters) { // draw the clusters
+		R_DrawBspClusters_default(surfs, true);
+	}
 
-		if (surfs->surfaces[i]->texinfo->flags & SURF_MATERIAL)
-			continue;
+	if (!clusters || r_model_state.world->bsp->unclustered_frame == r_locals.frame) {
+		for (i = 0; i < surfs->count; i++) { // and the surfaces
 
-		if (surfs->surfaces[i]->frame != r_locals.frame)
-			continue;
+			if (surfs->surfaces[i]->texinfo->flags & SURF_MATERIAL)
+				continue;
 
-		R_SetBspSurfaceState_default(surfs->surfaces[i]);
+			if (!R_DrawBspSurface(surfs->surfaces[i], clusters))
+				continue;
 
-		R_DrawBspSurface_default(surfs->surfaces[i]);
+			R_SetBspSurfaceState_default(surfs->surfaces[i]);
+
+			R_DrawBspSurface_default(surfs->surfaces[i]);
+		}
 	}
 
 	// reset state
@@ -119,12 +269,20 @@ static void R_DrawBspSurfacesLines_default(const r_bsp_surfaces_t *surfs) {
 
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-	for (i = 0; i < surfs->count; i++) {
+	const _Bool clusters = R_DrawBspClusters(surfs);
 
-		if (surfs->surfaces[i]->frame != r_locals.frame)
-			continue;
+	if (clusters) {
+		R_DrawBspClusters_default(surfs, false);
+	}
+
+	if (!clusters || r_model_state.world->bsp->unclustered_frame == r_locals.frame) {
+		for (i = 0; i < surfs->count; i++) {
 
-		R_DrawBspSurface_default(surfs->surfaces[i]);
+			if (!R_DrawBspSurface(surfs->surfaces[i], clusters))
+				continue;
+
+			R_DrawBspSurface_default(surfs->surfaces[i]);
+		}
 	}
 
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
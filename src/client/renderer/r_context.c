@@ -67,7 +67,8 @@ void R_InitContext(void) {
 	SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, s ? 1 : 0);
 	SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, s);
 
-	const int32_t i = Clamp(r_swap_interval->integer, 0, 2);
+	// never wait for vertical refresh when benchmarking
+	const int32_t i = time_demo->value ? 0 : Clamp(r_swap_interval->integer, 0, 2);
 
 	SDL_GL_SetAttribute(SDL_GL_SWAP_CONTROL, i);
 
@@ -75,7 +76,9 @@ void R_InitContext(void) {
 
 	SDL_SetGamma(g, g, g);
 
-	flags = SDL_OPENGL;
+	r_context.null = r_null->integer;
+
+	flags = r_context.null ? 0 : SDL_OPENGL;
 
 	if (r_fullscreen->integer) {
 		w = r_width->integer > 0 ? r_width->integer : 0;
@@ -89,6 +92,11 @@ void R_InitContext(void) {
 		flags |= SDL_RESIZABLE;
 	}
 
+	if (r_context.null) { // a software surface, typically of the dummy video driver
+		w = w ? w : 1024;
+		h = h ? h : 768;
+	}
+
 	if ((surface = SDL_SetVideoMode(w, h, 0, flags)) == NULL) {
 		if (r_context.width && r_context.height) {
 			Com_Warn("Failed to set video mode: %s\n", SDL_GetError());
@@ -25,17 +25,22 @@
  * @brief
  */
 void R_AddCorona(const r_corona_t *c) {
+	uint16_t i;
 
 	if (!r_coronas->value)
 		return;
 
-	if (r_view.num_coronas >= MAX_CORONAS)
-		return;
-
 	if (c->radius < 1.0)
 		return;
 
-	r_view.coronas[r_view.num_coronas++] = *c;
+	do { // reserve a slot, as coronas may be added from several threads
+		i = r_view.num_coronas;
+
+		if (i >= MAX_CORONAS)
+			return;
+	} while (!__sync_bool_compare_and_swap(&r_view.num_coronas, i, i + 1));
+
+	r_view.coronas[i] = *c;
 }
 
 /*
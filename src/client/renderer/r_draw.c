@@ -97,6 +97,8 @@ r_draw_t r_draw;
  */
 void R_DrawImage(r_pixel_t x, r_pixel_t y, vec_t scale, const r_image_t *image) {
 
+	R_PrioritizeMedia((const r_media_t *) image);
+
 	R_BindTexture(image->texnum);
 
 	// our texcoords are already setup, just set verts and draw
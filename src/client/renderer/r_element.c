@@ -21,10 +21,9 @@
 
 #include "r_local.h"
 
-#define MIN_ELEMENTS (MAX_PARTICLES + MAX_ENTITIES)
-
 typedef struct {
 	r_element_t *elements; // the elements pool
+	r_element_t *sorted; // the radix sort buffer, swapped with the pool
 	size_t count; // the number of elements in the current frame
 	size_t size; // the total size (max) allocated for this level
 
@@ -34,7 +33,30 @@ typedef struct {
 static r_element_state_t r_element_state;
 
 /*
- * @brief Adds the depth-sorted element to the current frame.
+ * @brief Returns the texture the specified element is drawn with, so that
+ * elements at the same depth may be grouped by it.
+ */
+static GLuint R_ElementTexnum(const r_element_t *e) {
+
+	switch (e->type) {
+		case ELEMENT_BSP_SURFACE_BLEND:
+		case ELEMENT_BSP_SURFACE_BLEND_WARP:
+			return ((const r_bsp_surface_t *) e->element)->texinfo->material->diffuse->texnum;
+
+		case ELEMENT_PARTICLE:
+			return ((const r_particle_t *) e->element)->image->texnum;
+
+		default:
+			return 0;
+	}
+}
+
+/*
+ * @brief Adds the depth-sorted element to the current frame. The sort key packs
+ * the squared distance from the view into the high 24 bits. As a positive
+ * float, its bits order the same as its value, and they are inverted so that
+ * the farthest elements sort first. The type and texture of the element fill
+ * the low 8 bits, grouping elements at the same quantized depth.
  */
 void R_AddElement(const r_element_t *e) {
 	vec3_t delta;
@@ -49,54 +71,131 @@ void R_AddElement(const r_element_t *e) {
 	// copy the element in
 	*el = *e;
 
-	// and resolve its depth
+	// and resolve its key
 	VectorSubtract(r_view.origin, el->origin, delta);
-	el->depth = VectorLength(delta);
+
+	union {
+		vec_t f;
+		uint32_t u;
+	} depth;
+
+	depth.f = DotProduct(delta, delta);
+
+	el->key = (~depth.u & 0xffffff00) | ((el->type & 0x7) << 5) | (R_ElementTexnum(el) & 0x1f);
 }
 
 /*
- * @brief Adds elements for the specified blended surfaces lists.
+ * @brief Adds an element for the specified blended surface, if it is visible and
+ * has not already been added through another cluster.
  */
-static void R_AddBspSurfaceElements(void) {
+static void R_AddBspSurfaceElement(r_bsp_surface_t *s) {
 	static r_element_t e;
 
-	r_bsp_surface_t *s = r_model_state.world->bsp->surfaces;
+	if (s->frame != r_locals.frame)
+		return;
 
-	uint16_t i;
-	for (i = 0; i < r_model_state.world->bsp->num_surfaces; i++, s++) {
+	if (s->element_frame == r_locals.frame)
+		return;
 
-		if (s->texinfo->flags & (SURF_BLEND_33 | SURF_BLEND_66)) {
-			if (s->frame == r_locals.frame) {
+	s->element_frame = r_locals.frame;
 
-				if (s->texinfo->flags & SURF_WARP) {
-					e.type = ELEMENT_BSP_SURFACE_BLEND_WARP;
-				} else {
-					e.type = ELEMENT_BSP_SURFACE_BLEND;
-				}
+	if (s->texinfo->flags & SURF_WARP) {
+		e.type = ELEMENT_BSP_SURFACE_BLEND_WARP;
+	} else {
+		e.type = ELEMENT_BSP_SURFACE_BLEND;
+	}
 
-				e.element = (const void *) s;
-				e.origin = (const vec_t *) s->center;
+	e.element = (const void *) s;
+	e.origin = (const vec_t *) s->center;
 
-				R_AddElement(&e);
-			}
-		}
-	}
+	R_AddElement(&e);
 }
 
 /*
- * @brief Qsort comparator for render elements. Qsort sorts elements into
- * ascending order, so we return negative values when a is behind b (b - a).
+ * @brief Adds elements for the blended surfaces of the clusters in the PVS.
+ * Without PVS data, the blended surfaces arrays are used instead.
  */
-static int R_SortElements_Compare(const void *a, const void *b) {
-	return ((r_element_t *) b)->depth - ((r_element_t *) a)->depth;
+static void R_AddBspSurfaceElements(void) {
+	const r_bsp_model_t *bsp = r_model_state.world->bsp;
+	uint16_t i, j;
+
+	if (!bsp->num_clusters || r_no_vis->value || r_locals.cluster == -1) {
+		const r_sorted_bsp_surfaces_t *sorted = bsp->sorted_surfaces;
+
+		for (i = 0; i < sorted->blend.count; i++) {
+			R_AddBspSurfaceElement(sorted->blend.surfaces[i]);
+		}
+
+		for (i = 0; i < sorted->blend_warp.count; i++) {
+			R_AddBspSurfaceElement(sorted->blend_warp.surfaces[i]);
+		}
+
+		return;
+	}
+
+	const r_bsp_cluster_t *c = bsp->clusters;
+	for (i = 0; i < bsp->num_clusters; i++, c++) {
+
+		if (c->vis_frame != r_locals.vis_frame)
+			continue;
+
+		for (j = 0; j < c->num_blend_surfaces; j++) {
+			R_AddBspSurfaceElement(c->blend_surfaces[j]);
+		}
+	}
 }
 
 /*
- * @brief Sorts the specified elements array by their distance from the view.
- * Elements are sorted farthest-first so that they are rendered back-to-front.
+ * @brief Sorts the elements of the current frame by key, farthest-first so that
+ * they are rendered back-to-front. This is a stable, least significant digit
+ * radix sort, one byte per pass. Passes over a byte which all keys share are
+ * skipped.
  */
-static void R_SortElements_(r_element_t *e, const size_t count) {
-	qsort(e, count, sizeof(r_element_t), R_SortElements_Compare);
+static void R_SortElements_(void) {
+	uint32_t histograms[4][256];
+	size_t i, j;
+
+	memset(histograms, 0, sizeof(histograms));
+
+	const size_t count = r_element_state.count;
+
+	r_element_t *in = r_element_state.elements;
+	r_element_t *out = r_element_state.sorted;
+
+	for (i = 0; i < count; i++) {
+		const uint32_t key = in[i].key;
+
+		for (j = 0; j < 4; j++) {
+			histograms[j][(key >> (j << 3)) & 0xff]++;
+		}
+	}
+
+	for (j = 0; j < 4; j++) {
+		uint32_t *offsets = histograms[j];
+		const uint32_t shift = j << 3;
+
+		if (offsets[(in[0].key >> shift) & 0xff] == count)
+			continue;
+
+		uint32_t offset = 0;
+
+		for (i = 0; i < 256; i++) {
+			const uint32_t n = offsets[i];
+			offsets[i] = offset;
+			offset += n;
+		}
+
+		for (i = 0; i < count; i++) {
+			out[offsets[(in[i].key >> shift) & 0xff]++] = in[i];
+		}
+
+		r_element_t *swap = in;
+		in = out;
+		out = swap;
+	}
+
+	r_element_state.elements = in;
+	r_element_state.sorted = out;
 }
 
 /*
@@ -107,10 +206,12 @@ void R_SortElements(void *data __attribute__((unused))) {
 
 	R_AddBspSurfaceElements();
 
+	R_AddParticleElements();
+
 	if (!r_element_state.count)
 		return;
 
-	R_SortElements_(r_element_state.elements, r_element_state.count);
+	R_SortElements_();
 
 	R_UpdateParticles(r_element_state.elements, r_element_state.count);
 }
@@ -214,6 +315,7 @@ void R_InitElements(r_bsp_model_t *bsp) {
 
 	surfs->surfaces = Mem_LinkMalloc(surfs->count * sizeof(r_bsp_surface_t **), bsp);
 
-	r_element_state.size = MIN_ELEMENTS + r_element_state.surfs.count;
+	r_element_state.size = r_view.max_particles + MAX_ENTITIES + r_element_state.surfs.count;
 	r_element_state.elements = Mem_LinkMalloc(r_element_state.size * sizeof(r_element_t), bsp);
+	r_element_state.sorted = Mem_LinkMalloc(r_element_state.size * sizeof(r_element_t), bsp);
 }
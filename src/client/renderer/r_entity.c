@@ -55,23 +55,12 @@ static r_entity_t **R_EntityList(const r_entity_t *e) {
 }
 
 /*
- * @brief Copies the specified entity into the view structure and inserts it
- * into the appropriate sorted chain. The sorted chains allow for object
- * instancing.
+ * @brief Inserts the specified entity into the appropriate sorted chain. The
+ * sorted chains allow for object instancing.
  */
-const r_entity_t *R_AddEntity(const r_entity_t *ent) {
-	r_entity_t *e, *in, **ents;
+static void R_ChainEntity(r_entity_t *e) {
+	r_entity_t *in, **ents;
 
-	if (r_view.num_entities == MAX_ENTITIES) {
-		Com_Warn("MAX_ENTITIES reached\n");
-		return NULL;
-	}
-
-	// copy in to renderer array
-	e = &r_view.entities[r_view.num_entities++];
-	*e = *ent;
-
-	// and insert into the sorted draw list
 	ents = R_EntityList(e);
 	in = *ents;
 
@@ -91,6 +80,29 @@ const r_entity_t *R_AddEntity(const r_entity_t *ent) {
 		e->next = *ents;
 		*ents = e;
 	}
+}
+
+/*
+ * @brief Copies the specified entity into the view structure. The entity is
+ * chained for drawing when the view is culled, as the view may be reused
+ * across several frames. The view may be populated from several threads at
+ * once, so the slot is reserved atomically.
+ */
+const r_entity_t *R_AddEntity(const r_entity_t *ent) {
+	uint16_t i;
+
+	do {
+		i = r_view.num_entities;
+
+		if (i == MAX_ENTITIES) {
+			Com_Warn("MAX_ENTITIES reached\n");
+			return NULL;
+		}
+	} while (!__sync_bool_compare_and_swap(&r_view.num_entities, i, i + 1));
+
+	// copy in to renderer array
+	r_entity_t *e = &r_view.entities[i];
+	*e = *ent;
 
 	return e;
 }
@@ -210,20 +222,108 @@ static _Bool R_CullEntity(r_entity_t *e) {
 }
 
 /*
- * @brief Performs a frustum-cull of all entities. This is performed in a separate
- * thread while the renderer draws the world. Entities which pass a frustum
- * cull will also have their static lighting information updated.
+ * @brief A contiguous chunk of r_view.entities, culled by one thread. The mesh
+ * entities which pass are gathered into the chunk's slice of the visible list.
  */
-void R_CullEntities(void *data __attribute__((unused))) {
-	r_entity_t *e = r_view.entities;
+typedef struct {
+	uint16_t first;
+	uint16_t count;
+	uint16_t num_visible;
+	thread_t *thread;
+} r_entity_cull_chunk_t;
+
+#define ENTITY_CULL_CHUNK_MIN 32
+
+static r_entity_t *r_entity_visible[MAX_ENTITIES];
+
+/*
+ * @brief Sets the transform matrix for, and frustum culls, the entities of the
+ * specified chunk which are not linked to a parent. Linked entities depend on
+ * their parent's matrix, and are culled once all chunks have completed.
+ */
+static void R_CullEntities_(void *data) {
+	r_entity_cull_chunk_t *chunk = (r_entity_cull_chunk_t *) data;
 	uint16_t i;
 
-	for (i = 0, e = r_view.entities; i < r_view.num_entities; i++, e++) {
+	r_entity_t **visible = r_entity_visible + chunk->first;
+	r_entity_t *e = r_view.entities + chunk->first;
+
+	chunk->num_visible = 0;
+
+	for (i = 0; i < chunk->count; i++, e++) {
+
+		if (e->parent)
+			continue;
 
 		R_SetMatrixForEntity(e); // set the transform matrix
 
 		if (!R_CullEntity(e)) { // cull it
 
+			if (IS_MESH_MODEL(e->model)) {
+				visible[chunk->num_visible++] = e;
+			}
+		}
+	}
+}
+
+/*
+ * @brief Performs a frustum-cull of all entities. This is performed in a separate
+ * thread while the renderer draws the world, and is further split into chunks
+ * over the thread pool. Entities which pass a frustum cull will also have their
+ * static lighting information updated. This traces against the collision model,
+ * which is not reentrant, so it is done here once the chunks have completed.
+ */
+void R_CullEntities(void *data __attribute__((unused))) {
+	static r_entity_cull_chunk_t chunks[MAX_THREADS + 1];
+	uint16_t i, j;
+
+	// rebuild the sorted draw lists
+	memset(&r_entities, 0, sizeof(r_entities));
+
+	r_entity_t *e = r_view.entities;
+
+	for (i = 0; i < r_view.num_entities; i++, e++) {
+		R_ChainEntity(e);
+	}
+
+	const uint16_t count = r_view.num_entities;
+	const uint16_t num_chunks = Clamp(count / ENTITY_CULL_CHUNK_MIN, 1, Thread_Count() + 1);
+
+	const uint16_t size = (count + num_chunks - 1) / num_chunks;
+
+	r_entity_cull_chunk_t *chunk = chunks;
+	for (i = 0; i < num_chunks; i++, chunk++) {
+
+		chunk->first = MIN(i * size, count);
+		chunk->count = MIN(size, count - chunk->first);
+
+		chunk->thread = Thread_Create(R_CullEntities_, chunk);
+	}
+
+	// merge the visible lists, updating static lighting
+	for (i = 0, chunk = chunks; i < num_chunks; i++, chunk++) {
+
+		Thread_Wait(chunk->thread);
+
+		r_entity_t **visible = r_entity_visible + chunk->first;
+
+		for (j = 0; j < chunk->num_visible; j++) {
+			R_UpdateMeshModelLighting(visible[j]);
+		}
+	}
+
+	// and finally the linked entities, in order
+	e = r_view.entities;
+
+	for (i = 0; i < r_view.num_entities; i++, e++) {
+
+		if (!e->parent)
+			continue;
+
+		R_SetMatrixForEntity(e);
+
+		if (!R_CullEntity(e)) {
+
 			if (IS_MESH_MODEL(e->model)) {
 				R_UpdateMeshModelLighting(e);
 			}
@@ -380,7 +480,4 @@ void R_DrawEntities(void) {
 	R_Color(NULL);
 
 	R_DrawNullEntities();
-
-	// clear draw lists for next frame
-	memset(&r_entities, 0, sizeof(r_entities));
 }
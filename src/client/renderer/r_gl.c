@@ -73,11 +73,22 @@ void R_EnforceGlVersion(void) {
 	Com_Error(ERR_FATAL, "OpenGL version %s is less than 1.3\n", s);
 }
 
+/*
+ * @brief Multitexture stub for the null renderer.
+ */
+static void APIENTRY R_ActiveTexture_null(GLenum texture __attribute__((unused))) {
+}
+
 /*
  * @brief
  */
 void R_InitGlExtensions(void) {
 
+	if (r_context.null) { // without a context, only multitexture is required
+		qglActiveTexture = qglClientActiveTexture = R_ActiveTexture_null;
+		return;
+	}
+
 	// multitexture
 	if (strstr(r_config.extensions_string, "GL_ARB_multitexture")) {
 		qglActiveTexture = SDL_GL_GetProcAddress("glActiveTexture");
@@ -56,7 +56,7 @@ static void R_TextureMode(void) {
 	r_image_state.filter_min = r_texture_modes[i].minimize;
 	r_image_state.filter_mag = r_texture_modes[i].maximize;
 
-	if (r_anisotropy->value)
+	if (r_anisotropy->value && !r_context.null)
 		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &r_image_state.anisotropy);
 	else
 		r_image_state.anisotropy = 1.0;
@@ -85,6 +85,11 @@ void R_Screenshot_f(void) {
 		return;
 	}
 
+	if (r_context.null) {
+		Com_Warn("No OpenGL context to capture\n");
+		return;
+	}
+
 	last_screenshot = i; // save for next call
 
 	const uint32_t width = r_context.width;
@@ -191,6 +196,17 @@ void R_UploadImage(r_image_t *image, GLenum format, byte *data) {
 		Com_Error(ERR_DROP, "NULL image or data\n");
 	}
 
+	if (r_context.null) { // only the texture names are needed
+		static GLuint texnum;
+
+		if (!image->texnum) {
+			image->texnum = ++texnum;
+		}
+
+		R_RegisterMedia((r_media_t *) image);
+		return;
+	}
+
 	if (!image->texnum) {
 		glGenTextures(1, &(image->texnum));
 	}
@@ -233,11 +249,128 @@ static _Bool R_RetainImage(r_media_t *self) {
  * @brief Free event listener for images.
  */
 static void R_FreeImage(r_media_t *media) {
+
+	if (r_context.null)
+		return;
+
 	glDeleteTextures(1, &((r_image_t *) media)->texnum);
 }
 
 /*
- * @brief Loads the image by the specified name.
+ * @brief Returns the name of the specified image type, for load time reporting.
+ */
+static const char *R_ImageTypeName(r_image_type_t type) {
+
+	switch (type) {
+	case IT_NULL:
+		return "null";
+	case IT_PROGRAM:
+		return "program";
+	case IT_FONT:
+		return "font";
+	case IT_EFFECT:
+		return "effect";
+	case IT_DIFFUSE:
+		return "diffuse";
+	case IT_LIGHTMAP:
+		return "lightmap";
+	case IT_DELUXEMAP:
+		return "deluxemap";
+	case IT_NORMALMAP:
+		return "normalmap";
+	case IT_GLOSSMAP:
+		return "glossmap";
+	case IT_ENVMAP:
+		return "envmap";
+	case IT_FLARE:
+		return "flare";
+	case IT_SKY:
+		return "sky";
+	case IT_PIC:
+		return "pic";
+	}
+
+	return "image";
+}
+
+/*
+ * @brief The decoded pixels of an image awaiting upload.
+ */
+typedef struct {
+	r_image_t image; // the decoded dimensions and average color
+	SDL_Surface *surf;
+} r_image_load_t;
+
+/*
+ * @brief Decodes and filters the image for the specified load. This runs on
+ * the thread pool, so the image itself is left untouched.
+ */
+static void R_DecodeImage(r_media_load_t *load) {
+	r_image_load_t *il = (r_image_load_t *) load->data;
+
+	if (Img_LoadImage(load->media->name, &il->surf)) {
+
+		il->image.width = il->surf->w;
+		il->image.height = il->surf->h;
+
+		if (il->image.type & IT_MASK_FILTER) {
+			R_FilterImage(&il->image, GL_RGBA, il->surf->pixels);
+		}
+	}
+}
+
+/*
+ * @brief Uploads the decoded image, replacing the placeholder texture. Images
+ * which fail to decode receive a copy of the null image.
+ */
+static void R_UploadDecodedImage(r_media_load_t *load) {
+	r_image_t *image = (r_image_t *) load->media;
+	const r_image_load_t *il = (r_image_load_t *) load->data;
+
+	image->texnum = 0;
+
+	if (il->surf) {
+		image->width = il->image.width;
+		image->height = il->image.height;
+
+		VectorCopy(il->image.color, image->color);
+
+		R_UploadImage(image, GL_RGBA, il->surf->pixels);
+	} else {
+		Com_Warn("Couldn't decode %s\n", image->media.name);
+
+		byte data[16 * 16 * 3];
+		memset(&data, 0xff, sizeof(data));
+
+		R_UploadImage(image, GL_RGB, data);
+	}
+}
+
+/*
+ * @brief Releases the decoded image. If the load was discarded, the image
+ * gives back the placeholder texture rather than deleting it.
+ */
+static void R_FreeDecodedImage(r_media_load_t *load) {
+	r_image_t *image = (r_image_t *) load->media;
+	r_image_load_t *il = (r_image_load_t *) load->data;
+
+	if (image->texnum == r_image_state.null->texnum) {
+		image->texnum = 0;
+	}
+
+	if (il->surf) {
+		SDL_FreeSurface(il->surf);
+	}
+
+	Mem_Free(il);
+}
+
+/*
+ * @brief Loads the image by the specified name. Images which exist are decoded
+ * asynchronously, presenting the null image until they are uploaded. Fonts and
+ * program images, whose dimensions are needed right away, are always loaded
+ * immediately, as are all images when r_async_media is disabled. Callers
+ * requiring the dimensions of other images should use R_WaitMedia.
  */
 r_image_t *R_LoadImage(const char *name, r_image_type_t type) {
 	r_image_t *image;
@@ -251,24 +384,28 @@ r_image_t *R_LoadImage(const char *name, r_image_type_t type) {
 
 	if (!(image = (r_image_t *) R_FindMedia(key))) {
 
-		SDL_Surface *surf;
-		if (Img_LoadImage(key, &surf)) { // attempt to load the image
+		if (Img_Exists(key)) { // queue the image, and present a placeholder
 			image = (r_image_t *) R_AllocMedia(key, sizeof(r_image_t));
 
 			image->media.Retain = R_RetainImage;
 			image->media.Free = R_FreeImage;
 
-			image->width = surf->w;
-			image->height = surf->h;
+			image->texnum = r_image_state.null->texnum;
+			image->width = r_image_state.null->width;
+			image->height = r_image_state.null->height;
 			image->type = type;
 
-			if (image->type & IT_MASK_FILTER) {
-				R_FilterImage(image, GL_RGBA, surf->pixels);
-			}
+			R_RegisterMedia((r_media_t *) image);
+
+			r_image_load_t *il = Mem_TagMalloc(sizeof(r_image_load_t), MEM_TAG_RENDERER);
+			il->image.type = type;
 
-			R_UploadImage(image, GL_RGBA, surf->pixels);
+			R_LoadMediaAsync((r_media_t *) image, R_ImageTypeName(type), R_DecodeImage, R_UploadDecodedImage,
+					R_FreeDecodedImage, il);
 
-			SDL_FreeSurface(surf);
+			if (!r_async_media->value || type == IT_FONT || type == IT_PROGRAM) {
+				R_WaitMedia((r_media_t *) image);
+			}
 		} else {
 			Com_Debug("Couldn't load %s\n", key);
 			image = r_image_state.null;
@@ -338,7 +475,7 @@ static void R_InitShellImage() {
  */
 void R_InitImages(void) {
 
-	Img_InitPalette();
+	Img_InitPalette(); // before any images are decoded on the thread pool
 
 	memset(&r_image_state, 0, sizeof(r_image_state));
 
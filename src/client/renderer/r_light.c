@@ -25,20 +25,27 @@
  * @brief
  */
 void R_AddLight(const r_light_t *l) {
+	uint16_t i;
 
 	if (!r_lighting->value)
 		return;
 
-	if (r_view.num_lights == MAX_LIGHTS) {
-		Com_Debug("MAX_LIGHTS reached\n");
-		return;
-	}
+	do { // reserve a slot, as lights may be added from several threads
+		i = r_view.num_lights;
+
+		if (i == MAX_LIGHTS) {
+			Com_Debug("MAX_LIGHTS reached\n");
+			return;
+		}
+	} while (!__sync_bool_compare_and_swap(&r_view.num_lights, i, i + 1));
 
-	r_view.lights[r_view.num_lights++] = *l;
+	r_view.lights[i] = *l;
 }
 
 /*
- * @brief
+ * @brief Adds a light which decays over the specified sustain. Free slots are
+ * claimed by setting their sustain atomically, as sustained lights may be
+ * added from several threads.
  */
 void R_AddSustainedLight(const r_sustained_light_t *s) {
 	int32_t i;
@@ -46,29 +53,31 @@ void R_AddSustainedLight(const r_sustained_light_t *s) {
 	if (!r_lighting->value)
 		return;
 
-	for (i = 0; i < MAX_LIGHTS; i++)
-		if (!r_view.sustained_lights[i].sustain)
+	const uint32_t sustain = MAX(r_view.time + s->sustain, 1);
+
+	for (i = 0; i < MAX_LIGHTS; i++) {
+		if (__sync_bool_compare_and_swap(&r_view.sustained_lights[i].sustain, 0, sustain))
 			break;
+	}
 
 	if (i == MAX_LIGHTS) {
 		Com_Debug("MAX_LIGHTS reached\n");
 		return;
 	}
 
-	r_view.sustained_lights[i] = *s;
-
+	r_view.sustained_lights[i].light = s->light;
 	r_view.sustained_lights[i].time = r_view.time;
-	r_view.sustained_lights[i].sustain = r_view.time + s->sustain;
 }
 
 /*
- * @brief
+ * @brief Adds the sustained lights to the view, scaled by their remaining
+ * intensity. This is called once the view has been populated.
  */
-static void R_AddSustainedLights(void) {
+void R_AddSustainedLights(void) {
 	r_sustained_light_t *s;
 	int32_t i;
 
-	// sustains must be recalculated every frame
+	// sustains must be recalculated every time the view is populated
 	for (i = 0, s = r_view.sustained_lights; i < MAX_LIGHTS; i++, s++) {
 
 		if (s->sustain <= r_view.time) { // clear it
@@ -158,8 +167,6 @@ void R_MarkLights(void) {
 	if (r_locals.light_frame == INT16_MAX) // avoid overflows
 		r_locals.light_frame = 0;
 
-	R_AddSustainedLights();
-
 	// flag all surfaces for each light source
 	for (i = 0; i < r_view.num_lights; i++) {
 
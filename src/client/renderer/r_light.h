@@ -26,6 +26,7 @@
 
 void R_AddLight(const r_light_t *l);
 void R_AddSustainedLight(const r_sustained_light_t *s);
+void R_AddSustainedLights(void);
 
 #ifdef __R_LOCAL_H__
 void R_ResetLights(void);
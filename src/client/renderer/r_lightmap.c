@@ -27,15 +27,38 @@
  * point to provide precision.
  */
 
+/*
+ * @brief A surface awaiting its lightmap, queued while the BSP is loaded.
+ */
 typedef struct {
-	r_image_t *lightmap;
-	r_image_t *deluxemap;
+	r_bsp_surface_t *surface;
+	const byte *data;
+	r_pixel_t smax, tmax;
+} r_lightmap_surface_t;
+
+/*
+ * @brief A run of surfaces whose lightmaps are built by one thread.
+ */
+typedef struct {
+	const r_bsp_model_t *bsp;
+	const r_lightmap_surface_t *surfaces;
+	uint32_t count;
+	thread_t *thread;
+} r_lightmap_chunk_t;
+
+#define LIGHTMAP_CHUNK_MIN 64
 
+typedef struct {
 	r_pixel_t block_size; // lightmap block size (NxN)
 	r_pixel_t *allocated; // block availability
 
 	byte *sample_buffer; // RGB buffers for uploading
 	byte *direction_buffer;
+
+	r_lightmap_surface_t *surfaces; // queued surfaces
+	uint32_t num_surfaces;
+
+	r_lightmap_chunk_t chunks[MAX_THREADS + 1];
 } r_lightmap_state_t;
 
 static r_lightmap_state_t r_lightmap_state;
@@ -71,18 +94,18 @@ static r_image_t *R_AllocLightmap_(r_image_type_t type) {
 #define R_AllocDeluxemap() R_AllocLightmap_(IT_DELUXEMAP)
 
 /*
- * @brief
+ * @brief Uploads the buffers to the specified lightmap and deluxemap, and
+ * clears them for the next block.
  */
-static void R_UploadLightmapBlock(r_bsp_model_t *bsp) {
+static void R_UploadLightmapBlock(r_bsp_model_t *bsp, r_image_t *lightmap, r_image_t *deluxemap) {
 
-	R_UploadImage(r_lightmap_state.lightmap, GL_RGB, r_lightmap_state.sample_buffer);
+	R_UploadImage(lightmap, GL_RGB, r_lightmap_state.sample_buffer);
 
 	if (bsp->version == BSP_VERSION_Q2W) { // upload deluxe block as well
-		R_UploadImage(r_lightmap_state.deluxemap, GL_RGB, r_lightmap_state.direction_buffer);
+		R_UploadImage(deluxemap, GL_RGB, r_lightmap_state.direction_buffer);
 	}
 
-	// clear the allocation block and buffers
-	memset(r_lightmap_state.allocated, 0, r_lightmap_state.block_size * sizeof(r_pixel_t));
+	// clear the buffers
 	memset(r_lightmap_state.sample_buffer, 0, r_lightmap_state.block_size * r_lightmap_state.block_size * 3);
 	memset(r_lightmap_state.direction_buffer, 0, r_lightmap_state.block_size * r_lightmap_state.block_size * 3);
 }
@@ -124,7 +147,7 @@ static _Bool R_AllocLightmapBlock(r_pixel_t w, r_pixel_t h, r_pixel_t *x, r_pixe
 /*
  * @brief
  */
-static void R_BuildDefaultLightmap(r_bsp_model_t *bsp, r_bsp_surface_t *surf, byte *sout,
+static void R_BuildDefaultLightmap(const r_bsp_model_t *bsp, const r_bsp_surface_t *surf, byte *sout,
 		byte *dout, size_t stride) {
 	int32_t i, j;
 
@@ -172,85 +195,47 @@ static void R_FilterLightmap(r_pixel_t width, r_pixel_t height, byte *lightmap)
 /*
  * @brief Consume raw lightmap and deluxemap RGB/XYZ data from the surface samples,
  * writing processed lightmap and deluxemap RGB to the specified destinations.
+ * The lightmap is filtered in place, one row at a time, so that no scratch
+ * memory is required.
  *
  * @param in The beginning of the surface lightmap [and deluxemap] data.
- * @param sout The destination for processed lightmap data.
+ * @param lout The destination for processed lightmap data.
  * @param dout The destination for processed deluxemap data.
  */
 static void R_BuildLightmap(const r_bsp_model_t *bsp, const r_bsp_surface_t *surf, const byte *in,
 		byte *lout, byte *dout, size_t stride) {
-	byte *lightmap, *lm, *deluxemap, *dm;
-	size_t i;
+	r_pixel_t s, t;
 
 	const r_pixel_t smax = (surf->st_extents[0] / bsp->lightmaps->scale) + 1;
 	const r_pixel_t tmax = (surf->st_extents[1] / bsp->lightmaps->scale) + 1;
 
-	const size_t size = smax * tmax;
-	stride -= (smax * 3);
-
-	lightmap = (byte *) Mem_TagMalloc(size * 3, MEM_TAG_RENDERER);
-	lm = lightmap;
-
-	deluxemap = dm = NULL;
-
-	if (bsp->version == BSP_VERSION_Q2W) {
-		deluxemap = (byte *) Mem_TagMalloc(size * 3, MEM_TAG_RENDERER);
-		dm = deluxemap;
-	}
-
-	// convert the raw lightmap samples to RGBA for softening
-	for (i = 0; i < size; i++) {
-		*lm++ = *in++;
-		*lm++ = *in++;
-		*lm++ = *in++;
-
-		// read in directional samples for per-pixel lighting as well
-		if (bsp->version == BSP_VERSION_Q2W) {
-			*dm++ = *in++;
-			*dm++ = *in++;
-			*dm++ = *in++;
-		}
-	}
-
-	// apply modulate, contrast, saturation, etc..
-	R_FilterLightmap(smax, tmax, lightmap);
-
-	// the lightmap is uploaded to the card via the strided block
-
-	lm = lightmap;
-
-	if (bsp->version == BSP_VERSION_Q2W) {
-		dm = deluxemap;
-	}
-
-	r_pixel_t s, t;
 	for (t = 0; t < tmax; t++, lout += stride, dout += stride) {
+		byte *lm = lout, *dm = dout;
+
 		for (s = 0; s < smax; s++) {
 
 			// copy the lightmap to the strided block
-			*lout++ = *lm++;
-			*lout++ = *lm++;
-			*lout++ = *lm++;
+			*lm++ = *in++;
+			*lm++ = *in++;
+			*lm++ = *in++;
 
 			// and the deluxemap for maps which include it
 			if (bsp->version == BSP_VERSION_Q2W) {
-				*dout++ = *dm++;
-				*dout++ = *dm++;
-				*dout++ = *dm++;
+				*dm++ = *in++;
+				*dm++ = *in++;
+				*dm++ = *in++;
 			}
 		}
-	}
-
-	Mem_Free(lightmap);
 
-	if (bsp->version == BSP_VERSION_Q2W)
-		Mem_Free(deluxemap);
+		// apply modulate, contrast, saturation, etc..
+		R_FilterLightmap(smax, 1, lout);
+	}
 }
 
 /*
- * @brief Creates the lightmap and deluxemap for the specified surface. The GL
- * textures to which the lightmap and deluxemap are written is stored on the
- * surface.
+ * @brief Queues the lightmap and deluxemap for the specified surface. The
+ * lightmaps of all queued surfaces are packed, built and uploaded in
+ * R_EndBspSurfaceLightmaps.
  *
  * @param data If NULL, a default lightmap and deluxemap will be generated.
  */
@@ -259,52 +244,24 @@ void R_CreateBspSurfaceLightmap(r_bsp_model_t *bsp, r_bsp_surface_t *surf, const
 	if (!(surf->flags & R_SURF_LIGHTMAP))
 		return;
 
-	const r_pixel_t smax = (surf->st_extents[0] / bsp->lightmaps->scale) + 1;
-	const r_pixel_t tmax = (surf->st_extents[1] / bsp->lightmaps->scale) + 1;
-
-	if (!R_AllocLightmapBlock(smax, tmax, &surf->light_s, &surf->light_t)) {
-
-		R_UploadLightmapBlock(bsp); // upload the last block
-
-		r_lightmap_state.lightmap = R_AllocLightmap();
-
-		if (bsp->version == BSP_VERSION_Q2W) {
-			r_lightmap_state.deluxemap = R_AllocDeluxemap();
-		}
-
-		if (!R_AllocLightmapBlock(smax, tmax, &surf->light_s, &surf->light_t)) {
-			Com_Error(ERR_DROP, "Consecutive calls to R_AllocLightmapBlock failed");
-		}
-	}
-
-	surf->lightmap = r_lightmap_state.lightmap;
-	surf->deluxemap = r_lightmap_state.deluxemap;
+	r_lightmap_surface_t *ls = &r_lightmap_state.surfaces[r_lightmap_state.num_surfaces++];
 
-	byte *sout = r_lightmap_state.sample_buffer;
-	sout += (surf->light_t * r_lightmap_state.block_size + surf->light_s) * 3;
+	ls->surface = surf;
+	ls->data = data;
 
-	byte *dout = r_lightmap_state.direction_buffer;
-	dout += (surf->light_t * r_lightmap_state.block_size + surf->light_s) * 3;
-
-	const size_t stride = r_lightmap_state.block_size * 3;
-
-	if (data)
-		R_BuildLightmap(bsp, surf, data, sout, dout, stride);
-	else
-		R_BuildDefaultLightmap(bsp, surf, sout, dout, stride);
+	ls->smax = (surf->st_extents[0] / bsp->lightmaps->scale) + 1;
+	ls->tmax = (surf->st_extents[1] / bsp->lightmaps->scale) + 1;
 }
 
 /*
  * @brief
  */
 void R_BeginBspSurfaceLightmaps(r_bsp_model_t *bsp) {
-	int32_t max;
+	const int32_t max = r_config.max_texture_size;
 
 	// users can tune lightmap size for their card
 	r_lightmap_state.block_size = r_lightmap_block_size->integer;
 
-	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max);
-
 	// but clamp it to the card's capability to avoid errors
 	r_lightmap_state.block_size = Clamp(r_lightmap_state.block_size, 256, (r_pixel_t) max);
 
@@ -314,28 +271,163 @@ void R_BeginBspSurfaceLightmaps(r_bsp_model_t *bsp) {
 
 	r_lightmap_state.allocated = Mem_TagMalloc(bs * sizeof(r_pixel_t), MEM_TAG_RENDERER);
 
-	r_lightmap_state.sample_buffer = Mem_TagMalloc(bs * bs * sizeof(uint32_t), MEM_TAG_RENDERER);
-	r_lightmap_state.direction_buffer = Mem_TagMalloc(bs * bs * sizeof(uint32_t), MEM_TAG_RENDERER);
+	r_lightmap_state.sample_buffer = Mem_TagMalloc(bs * bs * 3, MEM_TAG_RENDERER);
+	r_lightmap_state.direction_buffer = Mem_TagMalloc(bs * bs * 3, MEM_TAG_RENDERER);
+
+	const size_t size = bsp->num_surfaces * sizeof(r_lightmap_surface_t);
+	r_lightmap_state.surfaces = Mem_TagMalloc(size, MEM_TAG_RENDERER);
+
+	r_lightmap_state.num_surfaces = 0;
+}
+
+/*
+ * @brief qsort comparator for packing taller lightmaps first.
+ */
+static int R_EndBspSurfaceLightmaps_Compare(const void *a, const void *b) {
+
+	const r_lightmap_surface_t *ls1 = (const r_lightmap_surface_t *) a;
+	const r_lightmap_surface_t *ls2 = (const r_lightmap_surface_t *) b;
+
+	int order;
+
+	if ((order = ls2->tmax - ls1->tmax))
+		return order;
 
-	// generate the initial texture for lightmap data
-	r_lightmap_state.lightmap = R_AllocLightmap();
+	if ((order = ls2->smax - ls1->smax))
+		return order;
 
-	// and, if applicable, deluxemaps too
-	if (bsp->version == BSP_VERSION_Q2W) {
-		r_lightmap_state.deluxemap = R_AllocDeluxemap();
+	return (int) (ls1->surface - ls2->surface);
+}
+
+/*
+ * @brief Thread entry point to build the lightmaps for a run of surfaces into
+ * the buffers of the current block. Surfaces never overlap within the block.
+ */
+static void R_EndBspSurfaceLightmaps_(void *data) {
+	const r_lightmap_chunk_t *chunk = (r_lightmap_chunk_t *) data;
+	uint32_t i;
+
+	const size_t stride = r_lightmap_state.block_size * 3;
+
+	const r_lightmap_surface_t *ls = chunk->surfaces;
+	for (i = 0; i < chunk->count; i++, ls++) {
+		const r_bsp_surface_t *surf = ls->surface;
+
+		const size_t offset = (surf->light_t * r_lightmap_state.block_size + surf->light_s) * 3;
+
+		byte *sout = r_lightmap_state.sample_buffer + offset;
+		byte *dout = r_lightmap_state.direction_buffer + offset;
+
+		if (ls->data)
+			R_BuildLightmap(chunk->bsp, surf, ls->data, sout, dout, stride);
+		else
+			R_BuildDefaultLightmap(chunk->bsp, surf, sout, dout, stride);
 	}
 }
 
 /*
- * @brief
+ * @brief Builds the lightmaps for the specified surfaces, which share a block,
+ * over the thread pool, and uploads the block.
+ */
+static void R_BuildLightmapBlock(r_bsp_model_t *bsp, const r_lightmap_surface_t *surfaces,
+		uint32_t count) {
+	uint32_t i, num_chunks;
+
+	num_chunks = Clamp(count / LIGHTMAP_CHUNK_MIN, 1, Thread_Count() + 1);
+
+	const uint32_t size = (count + num_chunks - 1) / num_chunks;
+
+	r_lightmap_chunk_t *chunk = r_lightmap_state.chunks;
+	for (i = 0; i < num_chunks; i++, chunk++) {
+
+		const uint32_t offset = MIN(i * size, count);
+
+		chunk->bsp = bsp;
+		chunk->surfaces = surfaces + offset;
+		chunk->count = MIN(size, count - offset);
+
+		chunk->thread = Thread_Create(R_EndBspSurfaceLightmaps_, chunk);
+	}
+
+	for (i = 0; i < num_chunks; i++) {
+		Thread_Wait(r_lightmap_state.chunks[i].thread);
+	}
+
+	R_UploadLightmapBlock(bsp, surfaces->surface->lightmap, surfaces->surface->deluxemap);
+}
+
+/*
+ * @brief Packs the queued lightmaps into blocks, tallest first, and then
+ * builds and uploads each block once.
  */
 void R_EndBspSurfaceLightmaps(r_bsp_model_t *bsp) {
+	r_image_t *lightmap = NULL, *deluxemap = NULL;
+	uint32_t i, first, num_blocks, area;
 
-	// upload the pending lightmap block
-	R_UploadLightmapBlock(bsp);
+	const uint32_t start = Sys_Milliseconds();
+
+	r_lightmap_surface_t *surfaces = r_lightmap_state.surfaces;
+	const uint32_t count = r_lightmap_state.num_surfaces;
+
+	qsort(surfaces, count, sizeof(r_lightmap_surface_t), R_EndBspSurfaceLightmaps_Compare);
+
+	const r_pixel_t bs = r_lightmap_state.block_size;
+
+	num_blocks = area = 0;
+
+	r_lightmap_surface_t *ls = surfaces;
+	for (i = 0; i < count; i++, ls++) {
+		r_bsp_surface_t *surf = ls->surface;
+
+		if (!lightmap || !R_AllocLightmapBlock(ls->smax, ls->tmax, &surf->light_s, &surf->light_t)) {
+
+			memset(r_lightmap_state.allocated, 0, bs * sizeof(r_pixel_t));
+
+			lightmap = R_AllocLightmap();
+
+			if (bsp->version == BSP_VERSION_Q2W) {
+				deluxemap = R_AllocDeluxemap();
+			}
+
+			if (!R_AllocLightmapBlock(ls->smax, ls->tmax, &surf->light_s, &surf->light_t)) {
+				Com_Error(ERR_DROP, "Consecutive calls to R_AllocLightmapBlock failed");
+			}
+
+			num_blocks++;
+		}
+
+		surf->lightmap = lightmap;
+		surf->deluxemap = deluxemap;
+
+		area += ls->smax * ls->tmax;
+	}
+
+	const uint32_t packed = Sys_Milliseconds();
+
+	// the surfaces of each block are contiguous, so build them in runs
+	for (first = i = 0; i <= count; i++) {
+
+		if (i == count || surfaces[i].surface->lightmap != surfaces[first].surface->lightmap) {
+
+			if (i > first)
+				R_BuildLightmapBlock(bsp, surfaces + first, i - first);
+
+			first = i;
+		}
+	}
+
+	const uint32_t built = Sys_Milliseconds();
+
+	Com_Debug("Lightmaps: %u surfaces, %u blocks, %.1f%% occupancy\n", count, num_blocks,
+			num_blocks ? 100.0 * area / (num_blocks * (vec_t) bs * bs) : 0.0);
+
+	Com_Debug("Lightmaps: packed in %ums, built and uploaded in %ums\n", packed - start,
+			built - packed);
 
 	Mem_Free(r_lightmap_state.allocated);
 
 	Mem_Free(r_lightmap_state.sample_buffer);
 	Mem_Free(r_lightmap_state.direction_buffer);
+
+	Mem_Free(r_lightmap_state.surfaces);
 }
@@ -45,8 +45,10 @@ cvar_t *r_draw_bsp_normals;
 cvar_t *r_draw_wireframe;
 
 cvar_t *r_anisotropy;
+cvar_t *r_async_media;
 cvar_t *r_brightness;
 cvar_t *r_bumpmap;
+cvar_t *r_clusters;
 cvar_t *r_contrast;
 cvar_t *r_coronas;
 cvar_t *r_draw_buffer;
@@ -62,9 +64,11 @@ cvar_t *r_lighting;
 cvar_t *r_line_alpha;
 cvar_t *r_line_width;
 cvar_t *r_materials;
+cvar_t *r_max_particles;
 cvar_t *r_modulate;
 cvar_t *r_monochrome;
 cvar_t *r_multisample;
+cvar_t *r_null;
 cvar_t *r_parallax;
 cvar_t *r_programs;
 cvar_t *r_render_mode;
@@ -132,6 +136,43 @@ static void R_DrawDeveloperTools(void) {
 	R_DrawBspLeafs();
 }
 
+/*
+ * @brief Timed entry point for the entity culling thread.
+ */
+static void R_CullEntities_(void *data) {
+
+	Cl_TimeDemoBegin(CL_TIME_DEMO_CULL_ENTITIES);
+
+	R_CullEntities(data);
+
+	Cl_TimeDemoEnd(CL_TIME_DEMO_CULL_ENTITIES);
+}
+
+/*
+ * @brief Timed entry point for the element sorting thread.
+ */
+static void R_SortElements_(void *data) {
+
+	Cl_TimeDemoBegin(CL_TIME_DEMO_SORT_ELEMENTS);
+
+	R_SortElements(data);
+
+	Cl_TimeDemoEnd(CL_TIME_DEMO_SORT_ELEMENTS);
+}
+
+/*
+ * @brief Waits for the specified thread, excluding the wait from the draw phase
+ * so that time_demo does not count the other phases twice.
+ */
+static void R_DrawView_Wait(thread_t *thread) {
+
+	Cl_TimeDemoEnd(CL_TIME_DEMO_DRAW);
+
+	Thread_Wait(thread);
+
+	Cl_TimeDemoBegin(CL_TIME_DEMO_DRAW);
+}
+
 /*
  * @brief Main entry point for drawing the scene (world and entities).
  */
@@ -139,20 +180,29 @@ void R_DrawView(void) {
 
 	R_UpdateFrustum();
 
+	// dispatch threads to frustum cull the world while we update the PVS
+	R_CullBspBounds();
+
 	R_UpdateVis();
 
+	Cl_TimeDemoBegin(CL_TIME_DEMO_MARK_BSP_SURFACES);
+
 	R_MarkBspSurfaces();
 
+	Cl_TimeDemoEnd(CL_TIME_DEMO_MARK_BSP_SURFACES);
+
+	Cl_TimeDemoBegin(CL_TIME_DEMO_DRAW);
+
 	R_EnableFog(true);
 
 	R_DrawSkyBox();
 
 	// wait for the client to fully populate the scene
-	Thread_Wait(r_view.thread);
+	R_DrawView_Wait(r_view.thread);
 
 	// dispatch threads to cull entities and sort elements while we draw the world
-	thread_t *cull_entities = Thread_Create(R_CullEntities, NULL);
-	thread_t *sort_elements = Thread_Create(R_SortElements, NULL);
+	thread_t *cull_entities = Thread_Create(R_CullEntities_, NULL);
+	thread_t *sort_elements = Thread_Create(R_SortElements_, NULL);
 
 	R_MarkLights();
 
@@ -175,14 +225,14 @@ void R_DrawView(void) {
 	R_EnableBlend(false);
 
 	// wait for entity culling to complete
-	Thread_Wait(cull_entities);
+	R_DrawView_Wait(cull_entities);
 
 	R_DrawEntities();
 
 	R_EnableBlend(true);
 
 	// wait for element sorting to complete
-	Thread_Wait(sort_elements);
+	R_DrawView_Wait(sort_elements);
 
 	R_DrawElements();
 
@@ -195,6 +245,8 @@ void R_DrawView(void) {
 	R_EnableBlend(false);
 
 	R_ResetArrayState();
+
+	Cl_TimeDemoEnd(CL_TIME_DEMO_DRAW);
 }
 
 /*
@@ -263,6 +315,9 @@ void R_BeginFrame(void) {
 		r_render_mode->modified = false;
 	}
 
+	// upload any media that has finished decoding
+	R_UpdateMedia();
+
 	R_Clear();
 }
 
@@ -280,7 +335,9 @@ void R_EndFrame(void) {
 		}
 	}
 
-	SDL_GL_SwapBuffers(); // swap buffers
+	if (!r_context.null) {
+		SDL_GL_SwapBuffers(); // swap buffers
+	}
 }
 
 /*
@@ -290,6 +347,8 @@ void R_InitView(void) {
 
 	memset(&r_view, 0, sizeof(r_view));
 
+	R_InitParticles();
+
 	R_RenderMode(r_render_mode->string);
 
 	memset(&r_locals, 0, sizeof(r_locals));
@@ -399,10 +458,14 @@ static void R_InitLocal(void) {
 	// settings and preferences
 	r_anisotropy = Cvar_Get("r_anisotropy", "1", CVAR_ARCHIVE | CVAR_R_MEDIA,
 			"Controls anisotropic texture filtering");
+	r_async_media = Cvar_Get("r_async_media", "1", CVAR_ARCHIVE,
+			"Decodes media on background threads, uploading it over several frames");
 	r_brightness = Cvar_Get("r_brightness", "1.0", CVAR_ARCHIVE | CVAR_R_MEDIA,
 			"Controls texture brightness");
 	r_bumpmap = Cvar_Get("r_bumpmap", "1.0", CVAR_ARCHIVE | CVAR_R_MEDIA,
 			"Controls the intensity of bump-mapping effects");
+	r_clusters = Cvar_Get("r_clusters", "0", CVAR_ARCHIVE | CVAR_R_MEDIA,
+			"Draws the world by PVS cluster with per-material draw lists");
 	r_contrast = Cvar_Get("r_contrast", "1.0", CVAR_ARCHIVE | CVAR_R_MEDIA,
 			"Controls texture contrast");
 	r_coronas = Cvar_Get("r_coronas", "1", CVAR_ARCHIVE, "Controls the rendering of coronas");
@@ -427,12 +490,16 @@ static void R_InitLocal(void) {
 	r_line_width = Cvar_Get("r_line_width", "1.0", CVAR_ARCHIVE, NULL);
 	r_materials = Cvar_Get("r_materials", "1", CVAR_ARCHIVE,
 			"Enables or disables the materials (progressive texture effects) system");
+	r_max_particles = Cvar_Get("r_max_particles", "16384", CVAR_ARCHIVE | CVAR_R_CONTEXT,
+			"The maximum number of particles drawn each frame");
 	r_modulate = Cvar_Get("r_modulate", "3.0", CVAR_ARCHIVE | CVAR_R_MEDIA,
 			"Controls the brightness of world surface lightmaps");
 	r_monochrome = Cvar_Get("r_monochrome", "0", CVAR_ARCHIVE | CVAR_R_MEDIA,
 			"Loads all world textures as monochrome");
 	r_multisample = Cvar_Get("r_multisample", "0", CVAR_ARCHIVE | CVAR_R_CONTEXT,
 			"Controls multisampling (anti-aliasing)");
+	r_null = Cvar_Get("r_null", "0", CVAR_R_CONTEXT,
+			"Renders without an OpenGL context, for headless benchmarks");
 	r_parallax = Cvar_Get("r_parallax", "1.0", CVAR_ARCHIVE,
 			"Controls the intensity of parallax mapping effects");
 	r_programs = Cvar_Get("r_programs", "1", CVAR_ARCHIVE, "Controls GLSL shaders");
@@ -474,6 +541,16 @@ static void R_InitConfig(void) {
 
 	memset(&r_config, 0, sizeof(r_config));
 
+	if (r_context.null) { // there is nothing to query
+		r_config.renderer_string = r_config.vendor_string = "null";
+		r_config.version_string = "1.3";
+		r_config.extensions_string = "GL_ARB_multitexture";
+
+		r_config.max_texunits = r_config.max_teximage_units = MAX_GL_TEXUNITS;
+		r_config.max_texture_size = 4096;
+		return;
+	}
+
 	r_config.renderer_string = (const char *) glGetString(GL_RENDERER);
 	r_config.vendor_string = (const char *) glGetString(GL_VENDOR);
 	r_config.version_string = (const char *) glGetString(GL_VERSION);
@@ -481,6 +558,7 @@ static void R_InitConfig(void) {
 
 	glGetIntegerv(GL_MAX_TEXTURE_UNITS, &r_config.max_texunits);
 	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &r_config.max_teximage_units);
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &r_config.max_texture_size);
 
 	Com_Print("  Renderer: ^2%s^7\n", r_config.renderer_string);
 	Com_Print("  Vendor:   ^2%s^7\n", r_config.vendor_string);
@@ -540,5 +618,7 @@ void R_Shutdown(void) {
 
 	R_ShutdownState();
 
+	R_ShutdownParticles();
+
 	Mem_FreeTag(MEM_TAG_RENDERER);
 }
@@ -26,8 +26,10 @@
 
 // settings and preferences
 extern cvar_t *r_anisotropy;
+extern cvar_t *r_async_media;
 extern cvar_t *r_brightness;
 extern cvar_t *r_bumpmap;
+extern cvar_t *r_clusters;
 extern cvar_t *r_contrast;
 extern cvar_t *r_coronas;
 extern cvar_t *r_draw_buffer;
@@ -43,9 +45,11 @@ extern cvar_t *r_lighting;
 extern cvar_t *r_line_alpha;
 extern cvar_t *r_line_width;
 extern cvar_t *r_materials;
+extern cvar_t *r_max_particles;
 extern cvar_t *r_modulate;
 extern cvar_t *r_monochrome;
 extern cvar_t *r_multisample;
+extern cvar_t *r_null;
 extern cvar_t *r_parallax;
 extern cvar_t *r_programs;
 extern cvar_t *r_render_mode;
@@ -81,6 +85,7 @@ typedef struct {
 
 	int32_t max_texunits;
 	int32_t max_teximage_units;
+	int32_t max_texture_size;
 } r_config_t;
 
 extern r_config_t r_config;
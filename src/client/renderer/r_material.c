@@ -417,9 +417,11 @@ void R_DrawMaterialBspSurfaces(const r_bsp_surfaces_t *surfs) {
 
 /*
  * @brief Re-draws the currently bound arrays from the given offset to count after
- * setting GL state for the stage.
+ * setting GL state for the stage. If elements is not NULL, the arrays are drawn
+ * indexed.
  */
-void R_DrawMeshMaterial(r_material_t *m, const GLuint offset, const GLuint count) {
+void R_DrawMeshMaterial(r_material_t *m, const GLuint *elements, const GLuint offset,
+		const GLuint count) {
 	const _Bool blend = r_state.blend_enabled;
 
 	if (!r_materials->value || r_draw_wireframe->value)
@@ -449,7 +451,10 @@ void R_DrawMeshMaterial(r_material_t *m, const GLuint offset, const GLuint count
 
 		R_SetStageState(NULL, s);
 
-		glDrawArrays(GL_TRIANGLES, offset, count);
+		if (elements)
+			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, elements + offset);
+		else
+			glDrawArrays(GL_TRIANGLES, offset, count);
 	}
 
 	glPolygonOffset(0.0, 0.0);
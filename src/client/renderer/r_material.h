@@ -59,7 +59,8 @@ r_material_t *R_LoadMaterial(const char *diffuse);
 )
 
 void R_DrawMaterialBspSurfaces(const r_bsp_surfaces_t *surfs);
-void R_DrawMeshMaterial(r_material_t *m, const GLuint offset, const GLuint count);
+void R_DrawMeshMaterial(r_material_t *m, const GLuint *elements, const GLuint offset,
+		const GLuint count);
 void R_LoadMaterials(const r_model_t *mod);
 #endif /* __R_LOCAL_H__ */
 
@@ -21,10 +21,30 @@
 
 #include "r_local.h"
 
+#define MAX_MEDIA_LOAD_TYPES 16
+
+// milliseconds per frame which may be spent uploading decoded media
+#define MEDIA_UPLOAD_BUDGET 4
+
+/*
+ * @brief Accumulated load times for a type of media.
+ */
+typedef struct {
+	const char *type;
+	uint32_t count;
+	uint64_t decode_time, upload_time;
+} r_media_load_stats_t;
+
 typedef struct {
 	GHashTable *media;
 	GList *keys;
 	int32_t seed; // for tracking stale assets
+
+	GList *loads; // pending asynchronous loads, in request order
+	uint32_t frame;
+
+	r_media_load_stats_t load_stats[MAX_MEDIA_LOAD_TYPES];
+	uint16_t num_load_stats;
 } r_media_state_t;
 
 static r_media_state_t r_media_state;
@@ -33,6 +53,7 @@ static r_media_state_t r_media_state;
  * @brief Prints information about all currently loaded media to the console.
  */
 void R_ListMedia_f(void) {
+	uint16_t i;
 
 	Com_Print("Loaded media:\n");
 
@@ -40,10 +61,18 @@ void R_ListMedia_f(void) {
 	while (key) {
 		r_media_t *media = g_hash_table_lookup(r_media_state.media, key->data);
 
-		Com_Print("%s\n", media->name);
+		Com_Print("%s%s\n", media->name, media->load ? " (pending)" : "");
 
 		key = key->next;
 	}
+
+	Com_Print("Load times:\n");
+
+	const r_media_load_stats_t *stats = r_media_state.load_stats;
+	for (i = 0; i < r_media_state.num_load_stats; i++, stats++) {
+		Com_Print("%-12s %5u loaded, %8.1fms decode, %8.1fms upload\n", stats->type, stats->count,
+				stats->decode_time / 1000.0, stats->upload_time / 1000.0);
+	}
 }
 
 /*
@@ -152,6 +181,216 @@ r_media_t *R_AllocMedia(const char *name, size_t size) {
 	return media;
 }
 
+/*
+ * @brief Returns the load time accumulator for the specified media type.
+ */
+static r_media_load_stats_t *R_MediaLoadStats(const char *type) {
+	uint16_t i;
+
+	r_media_load_stats_t *stats = r_media_state.load_stats;
+	for (i = 0; i < r_media_state.num_load_stats; i++, stats++) {
+		if (!g_strcmp0(stats->type, type))
+			return stats;
+	}
+
+	if (r_media_state.num_load_stats == MAX_MEDIA_LOAD_TYPES)
+		return NULL;
+
+	r_media_state.num_load_stats++;
+
+	stats->type = type;
+	return stats;
+}
+
+/*
+ * @brief Thread entry point for decoding media.
+ */
+static void R_DecodeMedia(void *data) {
+	r_media_load_t *load = (r_media_load_t *) data;
+
+	const uint64_t start = Sys_Microseconds();
+
+	load->Decode(load);
+
+	load->decode_time = Sys_Microseconds() - start;
+	load->decoded = true;
+}
+
+/*
+ * @brief Returns the number of loads which may decode at once. Half of the
+ * thread pool is left available to the renderer.
+ */
+static uint16_t R_MediaThreads(void) {
+	return MAX(Thread_Count() / 2, 1);
+}
+
+/*
+ * @brief Dispatches pending loads until max are decoding, choosing the most
+ * recently wanted media first.
+ */
+static void R_DispatchMedia(uint16_t max) {
+	uint16_t count = 0;
+	GList *l;
+
+	for (l = r_media_state.loads; l; l = l->next) {
+		if (((r_media_load_t *) l->data)->dispatched)
+			count++;
+	}
+
+	while (count < max) {
+		r_media_load_t *best = NULL;
+
+		for (l = r_media_state.loads; l; l = l->next) {
+			r_media_load_t *load = (r_media_load_t *) l->data;
+
+			if (!load->dispatched && (!best || load->priority > best->priority))
+				best = load;
+		}
+
+		if (!best)
+			break;
+
+		best->dispatched = true;
+		best->thread = Thread_Create(R_DecodeMedia, best);
+
+		count++;
+	}
+}
+
+/*
+ * @brief Completes the specified load, waiting for it to decode. If upload is
+ * false, the load is simply discarded.
+ */
+static void R_FinishMediaLoad(r_media_load_t *load, _Bool upload) {
+
+	Thread_Wait(load->thread);
+
+	r_media_state.loads = g_list_remove(r_media_state.loads, load);
+	load->media->load = NULL;
+
+	if (upload) {
+		const uint64_t start = Sys_Microseconds();
+
+		load->Upload(load);
+
+		r_media_load_stats_t *stats = R_MediaLoadStats(load->type);
+		if (stats) {
+			stats->count++;
+			stats->decode_time += load->decode_time;
+			stats->upload_time += Sys_Microseconds() - start;
+		}
+	}
+
+	load->Free(load);
+
+	Mem_Free(load);
+}
+
+/*
+ * @brief Queues the specified media for asynchronous loading. Until it is
+ * uploaded, the media should present a placeholder. Decoding begins as soon
+ * as a thread is available.
+ */
+void R_LoadMediaAsync(r_media_t *media, const char *type, void (*Decode)(r_media_load_t *self),
+		void (*Upload)(r_media_load_t *self), void (*Free)(r_media_load_t *self), void *data) {
+
+	r_media_load_t *load = Mem_TagMalloc(sizeof(r_media_load_t), MEM_TAG_RENDERER);
+
+	load->media = media;
+	load->type = type;
+
+	load->Decode = Decode;
+	load->Upload = Upload;
+	load->Free = Free;
+
+	load->data = data;
+	load->priority = r_media_state.frame;
+
+	media->load = load;
+
+	r_media_state.loads = g_list_append(r_media_state.loads, load);
+
+	R_DispatchMedia(R_MediaThreads());
+}
+
+/*
+ * @brief Flags the specified media as wanted for the current frame, so that
+ * it is decoded and uploaded ahead of media that is not visible.
+ */
+void R_PrioritizeMedia(const r_media_t *media) {
+
+	if (media->load) {
+		media->load->priority = r_media_state.frame;
+	}
+}
+
+/*
+ * @brief Completes any pending load for the specified media immediately,
+ * decoding it in this thread if it has not been dispatched.
+ */
+void R_WaitMedia(r_media_t *media) {
+	r_media_load_t *load = media->load;
+
+	if (!load)
+		return;
+
+	if (!load->dispatched) {
+		load->dispatched = true;
+		R_DecodeMedia(load);
+	}
+
+	R_FinishMediaLoad(load, true);
+}
+
+/*
+ * @brief Called once per frame to upload decoded media, within a fixed time
+ * budget, and to dispatch pending loads.
+ */
+void R_UpdateMedia(void) {
+
+	r_media_state.frame++;
+
+	const uint32_t start = Sys_Milliseconds();
+
+	GList *l = r_media_state.loads;
+	while (l) {
+		GList *next = l->next;
+
+		r_media_load_t *load = (r_media_load_t *) l->data;
+		if (load->decoded) {
+			R_FinishMediaLoad(load, true);
+
+			if (Sys_Milliseconds() - start >= MEDIA_UPLOAD_BUDGET)
+				break;
+		}
+
+		l = next;
+	}
+
+	R_DispatchMedia(R_MediaThreads());
+}
+
+/*
+ * @brief Completes all pending loads, using the entire thread pool.
+ */
+void R_FinishMedia(void) {
+
+	while (r_media_state.loads) {
+		GList *l;
+
+		R_DispatchMedia(MAX(Thread_Count(), 1));
+
+		for (l = r_media_state.loads; l; l = l->next) {
+			r_media_load_t *load = (r_media_load_t *) l->data;
+
+			if (load->dispatched) {
+				R_WaitMedia(load->media);
+				break;
+			}
+		}
+	}
+}
+
 /*
  * @brief GHRFunc for freeing media. If data is non-NULL, then the media is
  * always freed. Otherwise, only media with stale seed values and no explicit
@@ -168,6 +407,11 @@ static gboolean R_FreeMedia_(gpointer key, gpointer value, gpointer data) {
 
 	Com_Debug("Freeing %s\n", media->name);
 
+	// discard any pending load
+	if (media->load) {
+		R_FinishMediaLoad(media->load, false);
+	}
+
 	// ask the implementation to clean up
 	if (media->Free) {
 		media->Free(media);
@@ -218,5 +462,6 @@ void R_ShutdownMedia(void) {
 
 	g_hash_table_destroy(r_media_state.media);
 	g_list_free(r_media_state.keys);
+	g_list_free(r_media_state.loads);
 }
 
@@ -26,11 +26,40 @@
 
 #ifdef __R_LOCAL_H__
 
+/*
+ * @brief An asynchronous media load. Decode runs on the thread pool and must
+ * not touch GL state, Upload runs on the main thread once decoding completes,
+ * and Free releases the decoded data whether or not it was uploaded.
+ */
+typedef struct r_media_load_s {
+	r_media_t *media;
+	const char *type; // for load time reporting
+
+	void (*Decode)(struct r_media_load_s *self);
+	void (*Upload)(struct r_media_load_s *self);
+	void (*Free)(struct r_media_load_s *self);
+
+	void *data;
+
+	uint32_t priority; // the frame in which the media was last wanted
+	uint64_t decode_time;
+
+	_Bool dispatched;
+	_Bool decoded;
+	thread_t *thread;
+} r_media_load_t;
+
 void R_ListMedia_f(void);
 void R_RegisterDependency(r_media_t *dependent, r_media_t *dependency);
 void R_RegisterMedia(r_media_t *media);
 r_media_t *R_FindMedia(const char *name);
 r_media_t *R_AllocMedia(const char *name, size_t size);
+void R_LoadMediaAsync(r_media_t *media, const char *type, void (*Decode)(r_media_load_t *self),
+		void (*Upload)(r_media_load_t *self), void (*Free)(r_media_load_t *self), void *data);
+void R_PrioritizeMedia(const r_media_t *media);
+void R_WaitMedia(r_media_t *media);
+void R_UpdateMedia(void);
+void R_FinishMedia(void);
 void R_FreeMedia(void);
 void R_BeginLoading(void);
 void R_InitMedia(void);
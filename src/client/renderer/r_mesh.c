@@ -213,9 +213,10 @@ static void R_SetMeshState_default(const r_entity_t *e) {
 	} else { // or use the default arrays
 		R_ResetArrayState();
 
-		// but take advantage of static texture coordinate arrays
+		// but take advantage of static, indexed texture coordinate arrays
 		if (texunit_diffuse.enabled) {
-			R_BindArray(GL_TEXTURE_COORD_ARRAY, GL_FLOAT, e->model->texcoords);
+			const r_md3_t *md3 = (r_md3_t *) e->model->mesh->data;
+			R_BindArray(GL_TEXTURE_COORD_ARRAY, GL_FLOAT, md3->texcoords);
 		}
 	}
 
@@ -224,6 +225,8 @@ static void R_SetMeshState_default(const r_entity_t *e) {
 		if (!(e->effects & EF_NO_DRAW)) { // setup state for diffuse render
 			r_mesh_state.material = e->skins[0] ? e->skins[0] : e->model->mesh->material;
 
+			R_PrioritizeMedia((const r_media_t *) r_mesh_state.material->diffuse);
+
 			R_BindTexture(r_mesh_state.material->diffuse->texnum);
 
 			R_SetMeshColor_default(e);
@@ -278,7 +281,13 @@ static void R_SetMeshState_default(const r_entity_t *e) {
  */
 static void R_ResetMeshState_default(const r_entity_t *e) {
 
-	if (e->model->mesh->num_frames > 1) {
+	if (e->model->mesh->num_frames > 1) { // restore the default arrays
+		R_BindDefaultArray(GL_VERTEX_ARRAY);
+
+		if (r_state.lighting_enabled) {
+			R_BindDefaultArray(GL_NORMAL_ARRAY);
+		}
+
 		if (texunit_diffuse.enabled) {
 			R_BindDefaultArray(GL_TEXTURE_COORD_ARRAY);
 		}
@@ -290,6 +299,30 @@ static void R_ResetMeshState_default(const r_entity_t *e) {
 	R_RotateForEntity(NULL);
 }
 
+/*
+ * @brief Returns the element array for the specified entity, or NULL if the
+ * entity's model is drawn from its static, de-indexed arrays.
+ */
+static const GLuint *R_MeshElements_default(const r_entity_t *e) {
+
+	if (e->model->mesh->num_frames > 1)
+		return ((const r_md3_t *) e->model->mesh->data)->elements;
+
+	return NULL;
+}
+
+/*
+ * @brief Draws count vertexes of the specified entity, starting at offset.
+ */
+static void R_DrawMeshArrays_default(const r_entity_t *e, GLuint offset, GLuint count) {
+	const GLuint *elements = R_MeshElements_default(e);
+
+	if (elements)
+		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, elements + offset);
+	else
+		glDrawArrays(GL_TRIANGLES, offset, count);
+}
+
 #define MESH_SHADOW_SCALE 1.5
 #define MESH_SHADOW_ALPHA 0.15
 
@@ -352,7 +385,7 @@ static void R_DrawMeshShell_default(const r_entity_t *e) {
 
 	R_EnableShell(true);
 
-	glDrawArrays(GL_TRIANGLES, 0, e->model->num_verts);
+	R_DrawMeshArrays_default(e, 0, e->model->num_verts);
 
 	R_EnableShell(false);
 
@@ -403,7 +436,7 @@ static void R_DrawMeshShadow_default(const r_entity_t *e) {
 
 	R_EnableStencilTest(true);
 
-	glDrawArrays(GL_TRIANGLES, 0, e->model->num_verts);
+	R_DrawMeshArrays_default(e, 0, e->model->num_verts);
 
 	R_EnableStencilTest(false);
 
@@ -423,61 +456,116 @@ static void R_DrawMeshShadow_default(const r_entity_t *e) {
 }
 
 /*
- * @brief
+ * @brief Clears the interpolated vertex streams. This must be called whenever
+ * models are freed, as streams are keyed by model.
  */
-static void R_InterpolateMeshModel_default(const r_entity_t *e) {
-	const r_md3_t *md3;
-	const d_md3_frame_t *frame, *old_frame;
-	const r_md3_mesh_t *mesh;
-	vec3_t trans;
-	int32_t vert_index;
-	int32_t i, j;
-
-	md3 = (r_md3_t *) e->model->mesh->data;
+void R_FreeMeshStreams(void) {
 
-	frame = &md3->frames[e->frame];
-	old_frame = &md3->frames[e->old_frame];
+	memset(r_mesh_state.streams, 0, sizeof(r_mesh_state.streams));
 
-	vert_index = 0;
+	r_mesh_state.num_streams = 0;
+	r_mesh_state.num_stream_verts = 0;
+}
 
-	for (i = 0; i < 3; i++) // calculate the translation
-		trans[i] = e->back_lerp * old_frame->translate[i] + e->lerp * frame->translate[i];
+/*
+ * @brief Returns the vertex stream for the pose of the specified entity. New
+ * streams are allocated with NULL arrays, and all streams are released once
+ * the table or the vertex pool fills.
+ */
+static r_mesh_stream_t *R_MeshStream(const r_entity_t *e) {
+	const r_md3_t *md3 = (r_md3_t *) e->model->mesh->data;
+	r_mesh_stream_t *stream;
 
-	for (i = 0, mesh = md3->meshes; i < md3->num_meshes; i++, mesh++) { // iterate the meshes
+	const uint32_t hash = (uint32_t) ((uintptr_t) e->model >> 4) ^ (e->frame * 31) ^ (e->old_frame
+			* 131) ^ (uint32_t) (e->lerp * 1024.0);
 
-		const r_md3_vertex_t *v = mesh->verts + e->frame * mesh->num_verts;
-		const r_md3_vertex_t *ov = mesh->verts + e->old_frame * mesh->num_verts;
+	uint32_t i = hash & (MESH_STREAMS - 1);
 
-		const uint32_t *tri = mesh->tris;
+	while (true) {
+		stream = &r_mesh_state.streams[i];
 
-		for (j = 0; j < mesh->num_verts; j++, v++, ov++) { // interpolate the vertexes
-			VectorSet(r_mesh_state.vertexes[j],
-					trans[0] + ov->point[0] * e->back_lerp + v->point[0] * e->lerp,
-					trans[1] + ov->point[1] * e->back_lerp + v->point[1] * e->lerp,
-					trans[2] + ov->point[2] * e->back_lerp + v->point[2] * e->lerp);
+		if (!stream->model)
+			break;
 
-			if (r_state.lighting_enabled) { // and the normals
-				VectorSet(r_mesh_state.normals[j],
-						v->normal[0] + (ov->normal[0] - v->normal[0]) * e->back_lerp,
-						v->normal[1] + (ov->normal[1] - v->normal[1]) * e->back_lerp,
-						v->normal[2] + (ov->normal[2] - v->normal[2]) * e->back_lerp);
-			}
+		if (stream->model == e->model && stream->frame == e->frame && stream->old_frame
+				== e->old_frame && stream->lerp == e->lerp) {
+			return stream;
 		}
 
-		for (j = 0; j < mesh->num_tris; j++, tri += 3) { // populate the triangles
+		i = (i + 1) & (MESH_STREAMS - 1);
+	}
 
-			VectorCopy(r_mesh_state.vertexes[tri[0]], (&r_state.vertex_array_3d[vert_index + 0]));
-			VectorCopy(r_mesh_state.vertexes[tri[1]], (&r_state.vertex_array_3d[vert_index + 3]));
-			VectorCopy(r_mesh_state.vertexes[tri[2]], (&r_state.vertex_array_3d[vert_index + 6]));
+	// keep the table sparse, and ensure the pool can hold the model
+	if (r_mesh_state.num_streams == MESH_STREAMS / 2 || r_mesh_state.num_stream_verts
+			+ md3->num_verts > MESH_STREAM_VERTS) {
 
-			if (r_state.lighting_enabled) { // normal vectors for lighting
-				VectorCopy(r_mesh_state.normals[tri[0]], (&r_state.normal_array[vert_index + 0]));
-				VectorCopy(r_mesh_state.normals[tri[1]], (&r_state.normal_array[vert_index + 3]));
-				VectorCopy(r_mesh_state.normals[tri[2]], (&r_state.normal_array[vert_index + 6]));
-			}
+		R_FreeMeshStreams();
+
+		stream = &r_mesh_state.streams[hash & (MESH_STREAMS - 1)];
+	}
+
+	stream->model = e->model;
+	stream->frame = e->frame;
+	stream->old_frame = e->old_frame;
+	stream->lerp = e->lerp;
+
+	r_mesh_state.num_streams++;
+
+	return stream;
+}
+
+/*
+ * @brief Interpolates count components between from and to. This is written
+ * plainly so that the compiler may vectorize it.
+ */
+static void R_InterpolateMeshStream(GLfloat *restrict out, const GLfloat *restrict from,
+		const GLfloat *restrict to, const vec_t back_lerp, const vec_t lerp, const uint32_t count) {
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		out[i] = from[i] * back_lerp + to[i] * lerp;
+	}
+}
 
-			vert_index += 9;
+/*
+ * @brief Interpolates the indexed vertex arrays of the specified entity, and
+ * binds the resulting stream. Streams are reused by every draw of the same
+ * pose, including shells and shadows.
+ */
+static void R_InterpolateMeshModel_default(const r_entity_t *e) {
+	const r_md3_t *md3 = (r_md3_t *) e->model->mesh->data;
+
+	r_mesh_stream_t *stream = R_MeshStream(e);
+
+	const uint32_t count = md3->num_verts * 3;
+
+	const size_t frame = e->frame * count;
+	const size_t old_frame = e->old_frame * count;
+
+	if (!stream->verts) { // allocate and interpolate the vertexes
+		const size_t offset = r_mesh_state.num_stream_verts * 3;
+
+		stream->verts = r_mesh_state.stream_verts + offset;
+		stream->normals = r_mesh_state.stream_normals + offset;
+
+		r_mesh_state.num_stream_verts += md3->num_verts;
+
+		R_InterpolateMeshStream(stream->verts, md3->verts + old_frame, md3->verts + frame,
+				e->back_lerp, e->lerp, count);
+	}
+
+	R_BindArray(GL_VERTEX_ARRAY, GL_FLOAT, stream->verts);
+
+	if (r_state.lighting_enabled) { // and the normals
+
+		if (!stream->lit) {
+			R_InterpolateMeshStream(stream->normals, md3->normals + old_frame, md3->normals
+					+ frame, e->back_lerp, e->lerp, count);
+
+			stream->lit = true;
 		}
+
+		R_BindArray(GL_NORMAL_ARRAY, GL_FLOAT, stream->normals);
 	}
 }
 
@@ -500,9 +588,10 @@ static void R_DrawMeshParts_default(const r_entity_t *e, const r_md3_t *md3) {
 			}
 		}
 
-		glDrawArrays(GL_TRIANGLES, offset, mesh->num_tris * 3);
+		R_DrawMeshArrays_default(e, offset, mesh->num_tris * 3);
 
-		R_DrawMeshMaterial(r_mesh_state.material, offset, mesh->num_tris * 3);
+		R_DrawMeshMaterial(r_mesh_state.material, R_MeshElements_default(e), offset,
+				mesh->num_tris * 3);
 
 		offset += mesh->num_tris * 3;
 	}
@@ -534,9 +623,9 @@ void R_DrawMeshModel_default(const r_entity_t *e) {
 		if (e->model->type == MOD_MD3) {
 			R_DrawMeshParts_default(e, (const r_md3_t *) e->model->mesh->data);
 		} else {
-			glDrawArrays(GL_TRIANGLES, 0, e->model->num_verts);
+			R_DrawMeshArrays_default(e, 0, e->model->num_verts);
 
-			R_DrawMeshMaterial(r_mesh_state.material, 0, e->model->num_verts);
+			R_DrawMeshMaterial(r_mesh_state.material, NULL, 0, e->model->num_verts);
 		}
 
 		R_DrawMeshShell_default(e); // draw any shell effects
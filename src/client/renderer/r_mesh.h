@@ -26,9 +26,33 @@
 
 #ifdef __R_LOCAL_H__
 
+// the interpolated vertex streams of animated models are cached by key
+#define MESH_STREAMS 512
+#define MESH_STREAM_VERTS 0x20000
+
+/*
+ * @brief An interpolated pose of an animated model, which may be drawn any
+ * number of times (shells, shadows, other entities sharing the pose).
+ */
+typedef struct {
+	const r_model_t *model;
+	uint16_t frame, old_frame;
+	vec_t lerp;
+	_Bool lit; // true when the normals have been interpolated
+	GLfloat *verts;
+	GLfloat *normals;
+} r_mesh_stream_t;
+
 typedef struct {
 	r_material_t *material;
 
+	r_mesh_stream_t streams[MESH_STREAMS];
+	uint16_t num_streams;
+
+	GLfloat stream_verts[MESH_STREAM_VERTS * 3];
+	GLfloat stream_normals[MESH_STREAM_VERTS * 3];
+	uint32_t num_stream_verts;
+
 	vec3_t vertexes[MD3_MAX_TRIANGLES * 3];
 	vec3_t normals[MD3_MAX_TRIANGLES * 3];
 	vec4_t tangents[MD3_MAX_TRIANGLES * 3];
@@ -41,6 +65,7 @@ void R_ApplyMeshModelConfig(r_entity_t *e);
 _Bool R_CullMeshModel(const r_entity_t *e);
 void R_UpdateMeshModelLighting(const r_entity_t *e);
 void R_DrawMeshModel_default(const r_entity_t *e);
+void R_FreeMeshStreams(void);
 #endif /* __R_LOCAL_H__ */
 
 #endif /* __R_MESH_H__ */
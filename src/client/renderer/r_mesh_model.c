@@ -262,6 +262,70 @@ static void R_LoadMd3Tangents(r_md3_mesh_t *mesh) {
 	Mem_Free(tan2);
 }
 
+/*
+ * @brief Loads the indexed vertex arrays for the specified animated MD3 model.
+ * The vertexes and normals of every frame are laid out contiguously so that
+ * they may be interpolated in a single pass at draw time. Elements are offset
+ * by the vertexes of preceding meshes.
+ */
+static void R_LoadMd3IndexedArrays(r_model_t *mod) {
+	r_md3_t *md3 = (r_md3_t *) mod->mesh->data;
+	const r_md3_mesh_t *mesh;
+	uint32_t num_elements = 0;
+	int32_t i, j, k;
+
+	md3->num_verts = 0;
+
+	for (i = 0, mesh = md3->meshes; i < md3->num_meshes; i++, mesh++) {
+		md3->num_verts += mesh->num_verts;
+		num_elements += mesh->num_tris * 3;
+	}
+
+	if (md3->num_verts > MAX_GL_ARRAY_LENGTH) {
+		Com_Error(ERR_DROP, "%s has too many vertexes\n", mod->media.name);
+	}
+
+	const size_t size = md3->num_frames * md3->num_verts * sizeof(vec3_t);
+
+	md3->verts = Mem_LinkMalloc(size, mod->mesh);
+	md3->normals = Mem_LinkMalloc(size, mod->mesh);
+
+	md3->texcoords = Mem_LinkMalloc(md3->num_verts * sizeof(vec2_t), mod->mesh);
+	md3->elements = Mem_LinkMalloc(num_elements * sizeof(GLuint), mod->mesh);
+
+	GLfloat *texcoords = md3->texcoords;
+	GLuint *elements = md3->elements;
+	uint32_t first_vert = 0;
+
+	for (i = 0, mesh = md3->meshes; i < md3->num_meshes; i++, mesh++) {
+
+		for (j = 0; j < md3->num_frames; j++) {
+			const d_md3_frame_t *frame = &md3->frames[j];
+			const r_md3_vertex_t *v = mesh->verts + j * mesh->num_verts;
+
+			const size_t offset = (j * md3->num_verts + first_vert) * 3;
+
+			GLfloat *verts = md3->verts + offset;
+			GLfloat *normals = md3->normals + offset;
+
+			for (k = 0; k < mesh->num_verts; k++, v++, verts += 3, normals += 3) {
+				VectorAdd(frame->translate, v->point, verts);
+				VectorCopy(v->normal, normals);
+			}
+		}
+
+		for (j = 0; j < mesh->num_verts; j++, texcoords += 2) {
+			memcpy(texcoords, &mesh->coords[j], sizeof(vec2_t));
+		}
+
+		for (j = 0; j < mesh->num_tris * 3; j++) {
+			*elements++ = first_vert + mesh->tris[j];
+		}
+
+		first_vert += mesh->num_verts;
+	}
+}
+
 /*
  * @brief Loads and populates vertex array data for the specified MD3 model.
  */
@@ -322,6 +386,10 @@ static void R_LoadMd3VertexArrays(r_model_t *mod) {
 			texcoord_index += 6;
 		}
 	}
+
+	if (mod->mesh->num_frames > 1) { // animated models are drawn indexed
+		R_LoadMd3IndexedArrays(mod);
+	}
 }
 
 /*
@@ -352,6 +420,9 @@ void R_LoadMd3Model(r_model_t *mod, void *buffer) {
 			"(%i should be %i)\n", mod->media.name, version, MD3_VERSION);
 	}
 
+	// interpolated streams are keyed by model, and this one may reuse a freed model
+	R_FreeMeshStreams();
+
 	mod->mesh = Mem_LinkMalloc(sizeof(r_mesh_model_t), mod);
 	mod->mesh->data = out_md3 = Mem_LinkMalloc(sizeof(r_md3_t), mod->mesh);
 
@@ -53,6 +53,8 @@ void R_AllocVertexArrays(r_model_t *mod) {
 				mod->num_verts += (*s)->num_edges;
 			}
 		}
+
+		mod->num_verts += mod->bsp->num_cluster_verts;
 	} else if (mod->type == MOD_MD3) {
 		const r_md3_t *md3 = (r_md3_t *) mod->mesh->data;
 		const r_md3_mesh_t *mesh = md3->meshes;
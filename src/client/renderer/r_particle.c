@@ -22,34 +22,62 @@
 #include "r_local.h"
 
 /*
- * @brief Copies the specified particle into the view structure, provided it
- * passes a basic visibility test.
+ * @brief Copies the specified particles into the view structure, so that the
+ * caller may reuse its array immediately. The slots are reserved atomically,
+ * as particles may be added from several threads.
  */
-void R_AddParticle(const r_particle_t *p) {
-	static r_element_t e;
+void R_AddParticles(const r_particle_t *particles, const uint32_t count) {
+	uint32_t i, n;
 
-	if (r_view.num_particles >= MAX_PARTICLES)
-		return;
+	do {
+		i = r_view.num_particles;
+		n = MIN(count, r_view.max_particles - i);
 
-	if (p->type != PARTICLE_BEAM) {
-		if (R_LeafForPoint(p->org, NULL)->vis_frame != r_locals.vis_frame) {
+		if (n == 0)
 			return;
-		}
-	}
+	} while (!__sync_bool_compare_and_swap(&r_view.num_particles, i, i + n));
+
+	memcpy(r_view.particles + i, particles, n * sizeof(r_particle_t));
+}
+
+/*
+ * @brief Copies the specified particle into the view structure.
+ */
+void R_AddParticle(const r_particle_t *p) {
+	R_AddParticles(p, 1);
+}
 
-	r_view.particles[r_view.num_particles++] = *p;
+/*
+ * @brief Adds elements for the particles of the view which pass a basic
+ * visibility test. This is done once the PVS for the current frame has been
+ * resolved, as the view may be reused across several frames.
+ */
+void R_AddParticleElements(void) {
+	static r_element_t e;
+	uint32_t i;
 
 	e.type = ELEMENT_PARTICLE;
 
-	e.element = (const void *) p;
-	e.origin = (const vec_t *) p->org;
+	const r_particle_t *p = r_view.particles;
+	for (i = 0; i < r_view.num_particles; i++, p++) {
 
-	R_AddElement(&e);
+		if (p->type != PARTICLE_BEAM) {
+			if (R_LeafForPoint(p->org, NULL)->vis_frame != r_locals.vis_frame) {
+				continue;
+			}
+		}
+
+		e.element = (const void *) p;
+		e.origin = (const vec_t *) p->org;
+
+		R_AddElement(&e);
+	}
 }
 
 /*
  * @brief Pools commonly used angular vectors for particle calculations and
- * accumulates particle primitives each frame.
+ * accumulates particle primitives each frame. The view's particles and their
+ * primitives are sized by r_max_particles.
  */
 typedef struct {
 	vec3_t weather_right;
@@ -57,13 +85,57 @@ typedef struct {
 	vec3_t splash_right[2];
 	vec3_t splash_up[2];
 
-	GLfloat verts[MAX_PARTICLES * 3 * 4];
-	GLfloat texcoords[MAX_PARTICLES * 2 * 4];
-	GLubyte colors[MAX_PARTICLES * 4 * 4];
+	uint32_t max_particles;
+	r_particle_t *particles;
+
+	GLfloat *verts;
+	GLfloat *texcoords;
+	GLubyte *colors;
 } r_particle_state_t;
 
 static r_particle_state_t r_particle_state;
 
+/*
+ * @brief Allocates the view's particles and their primitives, once for each
+ * initialization of the renderer, and points the view at them.
+ */
+void R_InitParticles(void) {
+
+	if (!r_particle_state.particles) {
+		const uint32_t count = Clamp(r_max_particles->integer, 1024, MAX_PARTICLES);
+
+		r_particle_state.max_particles = count;
+		r_particle_state.particles = Mem_TagMalloc(count * sizeof(r_particle_t), MEM_TAG_RENDERER);
+
+		r_particle_state.verts = Mem_TagMalloc(count * 3 * 4 * sizeof(GLfloat), MEM_TAG_RENDERER);
+		r_particle_state.texcoords = Mem_TagMalloc(count * 2 * 4 * sizeof(GLfloat),
+				MEM_TAG_RENDERER);
+		r_particle_state.colors = Mem_TagMalloc(count * 4 * 4 * sizeof(GLubyte), MEM_TAG_RENDERER);
+	}
+
+	r_view.max_particles = r_particle_state.max_particles;
+	r_view.particles = r_particle_state.particles;
+}
+
+/*
+ * @brief Frees the view's particles and their primitives.
+ */
+void R_ShutdownParticles(void) {
+
+	if (r_particle_state.particles) {
+		Mem_Free(r_particle_state.particles);
+
+		Mem_Free(r_particle_state.verts);
+		Mem_Free(r_particle_state.texcoords);
+		Mem_Free(r_particle_state.colors);
+	}
+
+	memset(&r_particle_state, 0, sizeof(r_particle_state));
+
+	r_view.max_particles = 0;
+	r_view.particles = NULL;
+}
+
 /*
  * @brief Generates the vertex coordinates for the specified particle.
  */
@@ -25,8 +25,12 @@
 #include "r_types.h"
 
 void R_AddParticle(const r_particle_t *p);
+void R_AddParticles(const r_particle_t *particles, const uint32_t count);
 
 #ifdef __R_LOCAL_H__
+void R_InitParticles(void);
+void R_ShutdownParticles(void);
+void R_AddParticleElements(void);
 void R_UpdateParticles(r_element_t *e, const size_t count);
 void R_DrawParticles(const r_element_t *e, const size_t count);
 #endif /* __R_LOCAL_H__ */
@@ -39,7 +39,7 @@ void R_GetError_(const char *function, const char *msg) {
 	GLenum err;
 	char *s;
 
-	if (!r_get_error->value)
+	if (!r_get_error->value || r_context.null)
 		return;
 
 	while (true) {
@@ -37,6 +37,7 @@ typedef struct r_media_s {
 	_Bool (*Retain)(struct r_media_s *self);
 	void (*Free)(struct r_media_s *self);
 	int32_t seed;
+	struct r_media_load_s *load; // the pending asynchronous load, if any
 } r_media_t;
 
 typedef int16_t r_pixel_t;
@@ -193,12 +194,14 @@ typedef struct {
 // r_bsp_surface_t flags
 #define R_SURF_SIDE_BACK	1
 #define R_SURF_LIGHTMAP		2
+#define R_SURF_NO_CLUSTER	4 // only in leafs of no cluster, so drawn individually
 
 typedef struct {
 	int16_t vis_frame; // PVS frame
 	int16_t frame; // renderer frame
 	int16_t back_frame; // back-facing renderer frame
 	int16_t light_frame; // dynamic lighting frame
+	int16_t element_frame; // depth-sorted renderer frame
 
 	c_bsp_plane_t *plane;
 	uint16_t flags; // R_SURF flags
@@ -229,13 +232,38 @@ typedef struct {
 	uint64_t lights; // bit mask of enabled light sources
 } r_bsp_surface_t;
 
+/*
+ * @brief A contiguous range of triangles in the world vertex buffers, sharing
+ * a single material, which belong to one PVS cluster.
+ */
+typedef struct {
+	uint16_t cluster;
+	uint16_t num_surfaces;
+	GLuint index; // first vertex in the world vertex buffers
+	GLuint count; // vertex count
+} r_bsp_cluster_range_t;
+
+/*
+ * @brief All geometry of the world sharing a single material, grouped by
+ * cluster so that the ranges of visible clusters may be merged when drawn.
+ */
+typedef struct {
+	const r_bsp_surface_t *surface; // a representative surface, for state
+	r_bsp_cluster_range_t *ranges;
+	uint16_t num_ranges;
+} r_bsp_material_ref_t;
+
 /*
  * @brief Surfaces are assigned to arrays based on their render path and then
- * sorted by material to reduce glBindTexture calls.
+ * sorted by material to reduce glBindTexture calls. When the world is drawn
+ * by cluster, the material references are populated as well.
  */
 typedef struct {
 	r_bsp_surface_t **surfaces;
 	size_t count;
+
+	r_bsp_material_ref_t *material_refs;
+	size_t num_material_refs;
 } r_bsp_surfaces_t;
 
 typedef struct {
@@ -314,12 +342,45 @@ typedef struct {
 } r_bsp_leaf_t;
 
 /*
- * @brief
+ * @brief BSP clusters group the leafs sharing a row of PVS data. Each holds its
+ * blended surfaces, so that they may be depth-sorted without scanning the
+ * world. When the world is drawn by cluster, each also holds its bounds and
+ * the surfaces which must still be drawn individually.
  */
 typedef struct {
 	int16_t vis_frame; // PVS eligibility
+	int16_t frame; // renderer frame
+	int16_t light_frame; // dynamic lighting frame
+	int16_t area; // -1 if the cluster spans several areas
+
+	vec3_t mins; // for bounding box culling
+	vec3_t maxs;
+
+	r_bsp_surface_t **surfaces; // not drawn by material reference
+	uint16_t num_surfaces;
+
+	r_bsp_surface_t **blend_surfaces;
+	uint16_t num_blend_surfaces;
+
+	uint64_t lights; // bit mask of enabled light sources
 } r_bsp_cluster_t;
 
+/*
+ * @brief The bounds of the BSP nodes, leafs and clusters, packed by component at
+ * load time so that they may be frustum culled in wide, branch-free batches.
+ * Nodes are followed by leafs, and then by clusters when drawing by cluster.
+ */
+typedef struct {
+	uint32_t count;
+	uint32_t first_leaf;
+	uint32_t first_cluster;
+
+	vec_t *mins[3];
+	vec_t *maxs[3];
+
+	byte *culled; // frustum culling results for the current frame
+} r_bsp_bounds_t;
+
 /*
  * @brief BSP lightmap parameters.
  */
@@ -398,6 +459,13 @@ typedef struct {
 
 	uint16_t num_animations;
 	r_md3_animation_t *animations;
+
+	// indexed arrays for animated models, interpolated at draw time
+	uint32_t num_verts;
+	GLfloat *verts; // frame major, with the frame translation applied
+	GLfloat *normals;
+	GLfloat *texcoords;
+	GLuint *elements; // per mesh, in the order of the meshes
 } r_md3_t;
 
 typedef struct {
@@ -475,6 +543,14 @@ typedef struct {
 	uint16_t num_clusters;
 	r_bsp_cluster_t *clusters;
 
+	uint32_t num_cluster_verts; // non-zero when drawing by cluster
+
+	const r_bsp_leaf_t **unclustered_leafs; // leafs of no cluster, marked by surface
+	uint32_t num_unclustered_leafs;
+	int16_t unclustered_frame; // renderer frame in which their surfaces were marked
+
+	r_bsp_bounds_t bounds;
+
 	r_bsp_lightmaps_t *lightmaps;
 
 	uint16_t num_bsp_lights;
@@ -656,7 +732,7 @@ typedef struct r_particle_s {
 	vec3_t dir;
 } r_particle_t;
 
-#define MAX_PARTICLES		16384
+#define MAX_PARTICLES		0x20000 // the most which r_max_particles may allow
 
 /*
  * @brief Coronas are soft, alpha-blended, rounded sprites.
@@ -687,7 +763,7 @@ typedef struct {
 	r_element_type_t type;
 	const void *element;
 	const vec_t *origin;
-	vec_t depth; // resolved for all elements
+	uint32_t key; // depth, type and material, resolved for all elements
 	void *data;
 } r_element_t;
 
@@ -737,8 +813,9 @@ typedef struct {
 	uint16_t num_entities;
 	r_entity_t entities[MAX_ENTITIES];
 
-	uint16_t num_particles;
-	r_particle_t particles[MAX_PARTICLES];
+	uint32_t num_particles;
+	uint32_t max_particles; // sized by r_max_particles
+	r_particle_t *particles;
 
 	uint16_t num_coronas;
 	r_corona_t coronas[MAX_CORONAS];
@@ -764,6 +841,7 @@ typedef struct {
 	uint32_t num_bsp_clusters;
 	uint32_t num_bsp_leafs;
 	uint32_t num_bsp_surfaces;
+	uint32_t num_bsp_draws;
 
 	uint32_t num_mesh_models;
 	uint32_t num_mesh_tris;
@@ -778,6 +856,7 @@ typedef struct {
 	r_pixel_t width, height;
 
 	_Bool fullscreen;
+	_Bool null; // no OpenGL context, see r_null
 
 	int32_t red_bits, green_bits, blue_bits, alpha_bits;
 	int32_t stencil_bits, depth_bits, double_buffer;
@@ -38,9 +38,14 @@ extern cl_static_t cls;
  */
 static void S_Stop(void) {
 
-	Mix_HaltChannel(-1);
+	SDL_LockAudio();
 
 	memset(s_env.channels, 0, sizeof(s_env.channels));
+	memset(s_env.entity_channels, 0, sizeof(s_env.entity_channels));
+
+	SDL_UnlockAudio();
+
+	s_env.num_active_channels = 0;
 }
 
 /*
@@ -49,7 +54,7 @@ static void S_Stop(void) {
  */
 void S_Frame(void) {
 	s_channel_t *ch;
-	int32_t i, j;
+	int32_t i;
 
 	if (!s_env.initialized)
 		return;
@@ -57,7 +62,7 @@ void S_Frame(void) {
 	S_FrameMusic();
 
 	if (cls.state != CL_ACTIVE) {
-		if (Mix_Playing(-1) > 0)
+		if (s_env.num_active_channels)
 			S_Stop();
 		return;
 	}
@@ -69,28 +74,17 @@ void S_Frame(void) {
 		}
 	}
 
-	if (s_reverse->modified) { // update reverse stereo
+	if (s_reverse->modified) { // update reverse stereo for music, channels are panned as mixed
 		Mix_SetReverseStereo(MIX_CHANNEL_POST, s_reverse->integer);
 		s_reverse->modified = false;
 	}
 
 	// update spatialization for current sounds
-	ch = s_env.channels;
+	Cl_TimeDemoBegin(CL_TIME_DEMO_SPATIALIZE);
 
-	for (i = 0; i < MAX_CHANNELS; i++, ch++) {
-
-		if (!ch->sample)
-			continue;
-
-		if (S_SpatializeChannel(ch)) {
-			Mix_SetPosition(i, ch->angle, ch->dist);
-		} else {
-			Mix_FadeOutChannel(i, 250);
-		}
+	S_SpatializeChannels();
 
-		// reset channel's count for loop samples
-		ch->count = 0;
-	}
+	Cl_TimeDemoEnd(CL_TIME_DEMO_SPATIALIZE);
 
 	// add new dynamic sounds
 	for (i = 0; i < cl.frame.num_entities; i++) {
@@ -101,12 +95,7 @@ void S_Frame(void) {
 		if (!ent->sound)
 			continue;
 
-		for (j = 0; j < MAX_CHANNELS; j++) {
-			if (s_env.channels[j].ent_num == ent->number)
-				break;
-		}
-
-		if (j == MAX_CHANNELS)
+		if (S_EntityChannel(ent->number) == -1)
 			S_PlaySample(NULL, ent->number, cl.sound_precache[ent->sound], ATTEN_NORM);
 	}
 
@@ -216,6 +205,7 @@ static void S_InitLocal(void) {
 
 	Cvar_ClearAll(CVAR_S_MASK);
 
+	Cmd_Add("s_bench_mix", S_BenchMix_f, CMD_SOUND, "Benchmark the mixer with synthetic voices");
 	Cmd_Add("s_list_media", S_ListMedia_f, CMD_SOUND, "List all currently loaded media");
 	Cmd_Add("s_next_track", S_NextTrack_f, CMD_SOUND, "Play the next music track.");
 	Cmd_Add("s_play", S_Play_f, CMD_SOUND, NULL);
@@ -258,12 +248,18 @@ void S_Init(void) {
 		return;
 	}
 
-	if (Mix_AllocateChannels(MAX_CHANNELS) != MAX_CHANNELS) {
-		Com_Warn("%s\n", Mix_GetError());
+	if (format != AUDIO_S16SYS || channels != 2) {
+		Com_Warn("Unsupported audio format %x with %d channels\n", format, channels);
+		Mix_CloseAudio();
 		return;
 	}
 
-	Mix_ChannelFinished(S_FreeChannel);
+	// SDL_mixer plays music, and our channels are mixed after it
+	Mix_AllocateChannels(0);
+
+	Mix_SetPostMix(S_MixChannels, NULL);
+
+	s_env.lock = SDL_CreateMutex();
 
 	Com_Print("Sound initialized %dKHz %d channels\n", freq, channels);
 
@@ -281,7 +277,7 @@ void S_Shutdown(void) {
 
 	S_Stop();
 
-	Mix_AllocateChannels(0);
+	Mix_SetPostMix(NULL, NULL);
 
 	S_ShutdownMusic();
 
@@ -289,6 +285,11 @@ void S_Shutdown(void) {
 
 	Mix_CloseAudio();
 
+	if (s_env.lock) {
+		SDL_DestroyMutex(s_env.lock);
+		s_env.lock = NULL;
+	}
+
 	if (SDL_WasInit(SDL_INIT_EVERYTHING) == SDL_INIT_AUDIO)
 		SDL_Quit();
 	else
@@ -19,37 +19,358 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
  */
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "s_local.h"
 #include "client.h"
 
 extern cl_client_t cl;
 extern cl_static_t cls;
 
+#define SOUND_MIX_FRAMES 1024 // the bus is mixed in blocks of this many frames
+
+#define SOUND_PHASE_BITS 16 // the fixed point precision of resampled positions
+#define SOUND_PHASE_MASK ((1 << SOUND_PHASE_BITS) - 1)
+
+static vec_t s_bus[SOUND_MIX_FRAMES * 2]; // owned by the audio thread
+
 /*
- * @brief
+ * @brief Mixes up to count frames of the sample at its own rate into the bus.
+ * The gains ramp by delta per frame from those specified.
  */
-static int32_t S_AllocChannel(void) {
-	int32_t i;
+static void S_MixSample(const int16_t *restrict in, vec_t *restrict bus, const uint32_t count,
+		const vec2_t gain, const vec2_t delta) {
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	// four stereo frames per iteration, widening the samples to float in two halves
+	const __m128 step = _mm_set_ps(delta[1] * 4.0, delta[0] * 4.0, delta[1] * 4.0, delta[0] * 4.0);
+
+	__m128 g0 = _mm_set_ps(gain[1] + delta[1], gain[0] + delta[0], gain[1], gain[0]);
+	__m128 g1 = _mm_add_ps(g0, _mm_set_ps(delta[1] * 2.0, delta[0] * 2.0, delta[1] * 2.0,
+			delta[0] * 2.0));
+
+	for (; i + 4 <= count; i += 4) {
+		const __m128i s = _mm_loadu_si128((const __m128i *) (in + i * 2));
+
+		const __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+		const __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+
+		vec_t *b = bus + i * 2;
+
+		_mm_storeu_ps(b + 0, _mm_add_ps(_mm_loadu_ps(b + 0), _mm_mul_ps(lo, g0)));
+		_mm_storeu_ps(b + 4, _mm_add_ps(_mm_loadu_ps(b + 4), _mm_mul_ps(hi, g1)));
+
+		g0 = _mm_add_ps(g0, step);
+		g1 = _mm_add_ps(g1, step);
+	}
+#endif
+
+	for (; i < count; i++) {
+		bus[i * 2 + 0] += in[i * 2 + 0] * (gain[0] + delta[0] * i);
+		bus[i * 2 + 1] += in[i * 2 + 1] * (gain[1] + delta[1] * i);
+	}
+}
+
+/*
+ * @brief Resamples up to frames of the channel's sample into the bus at its
+ * pitch, interpolating linearly between sample frames. The gains ramp by delta
+ * per frame from those specified. Returns the frames mixed.
+ */
+static uint32_t S_ResampleChannel(s_channel_t *ch, vec_t *restrict bus, const uint32_t frames,
+		const vec2_t gain, const vec2_t delta) {
+	uint32_t i = 0;
+
+	const Mix_Chunk *chunk = ch->sample->chunk;
+
+	const int16_t *restrict in = (const int16_t *) chunk->abuf;
+	const uint32_t length = chunk->alen / 4;
+
+	const uint64_t step = (uint64_t) (ch->pitch * (1 << SOUND_PHASE_BITS));
+	uint64_t pos = ((uint64_t) ch->position << SOUND_PHASE_BITS) + ch->phase;
+
+#if defined(__SSE2__)
+	// two stereo frames per iteration, gathered with the frames following them
+	const __m128 ramp = _mm_set_ps(delta[1] * 2.0, delta[0] * 2.0, delta[1] * 2.0, delta[0] * 2.0);
+	__m128 g = _mm_set_ps(gain[1] + delta[1], gain[0] + delta[0], gain[1], gain[0]);
+
+	for (; i + 2 <= frames; i += 2, pos += step * 2) {
+		const uint64_t j0 = pos >> SOUND_PHASE_BITS, j1 = (pos + step) >> SOUND_PHASE_BITS;
+
+		if (j1 + 1 >= length)
+			break;
+
+		const vec_t f0 = (pos & SOUND_PHASE_MASK) / (vec_t) (1 << SOUND_PHASE_BITS);
+		const vec_t f1 = ((pos + step) & SOUND_PHASE_MASK) / (vec_t) (1 << SOUND_PHASE_BITS);
+
+		const int16_t *a0 = in + j0 * 2, *a1 = in + j1 * 2;
+
+		const __m128 a = _mm_set_ps(a1[1], a1[0], a0[1], a0[0]);
+		const __m128 b = _mm_set_ps(a1[3], a1[2], a0[3], a0[2]);
+		const __m128 f = _mm_set_ps(f1, f1, f0, f0);
+
+		const __m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), f));
+
+		vec_t *o = bus + i * 2;
+		_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(s, g)));
+
+		g = _mm_add_ps(g, ramp);
+	}
+#endif
+
+	for (; i < frames; i++, pos += step) {
+		const uint64_t j = pos >> SOUND_PHASE_BITS;
+
+		if (j >= length)
+			break;
+
+		const uint64_t k = MIN(j + 1, length - 1);
+		const vec_t f = (pos & SOUND_PHASE_MASK) / (vec_t) (1 << SOUND_PHASE_BITS);
+
+		const vec_t l = in[j * 2 + 0] + (in[k * 2 + 0] - in[j * 2 + 0]) * f;
+		const vec_t r = in[j * 2 + 1] + (in[k * 2 + 1] - in[j * 2 + 1]) * f;
+
+		bus[i * 2 + 0] += l * (gain[0] + delta[0] * i);
+		bus[i * 2 + 1] += r * (gain[1] + delta[1] * i);
+	}
+
+	ch->position = (uint32_t) (pos >> SOUND_PHASE_BITS);
+	ch->phase = (uint32_t) (pos & SOUND_PHASE_MASK);
+
+	return i;
+}
+
+/*
+ * @brief Mixes up to frames of the channel's sample into the bus, ramping its
+ * gains linearly from those of the previous block toward those resolved by the
+ * last spatialization. Samples are 16 bit stereo at the device rate, as
+ * SDL_mixer converts chunks when they are loaded, so only channels pitched away
+ * from 1.0 are resampled. Returns the frames mixed.
+ */
+static uint32_t S_MixChannel(s_channel_t *ch, vec_t *restrict bus, const uint32_t frames) {
+	uint32_t count;
+
+	const Mix_Chunk *chunk = ch->sample->chunk;
+
+	const vec2_t gain = { ch->mix_gain[0], ch->mix_gain[1] };
+	const vec2_t delta = { (ch->gain[0] - gain[0]) / frames, (ch->gain[1] - gain[1]) / frames };
+
+	if (ch->pitch == 1.0) {
+		const int16_t *in = ((const int16_t *) chunk->abuf) + ch->position * 2;
+		count = MIN(frames, chunk->alen / 4 - ch->position);
+
+		S_MixSample(in, bus, count, gain, delta);
+
+		ch->position += count;
+	} else {
+		count = S_ResampleChannel(ch, bus, frames, gain, delta);
+	}
+
+	ch->mix_gain[0] = ch->gain[0];
+	ch->mix_gain[1] = ch->gain[1];
+
+	return count;
+}
+
+/*
+ * @brief Adds the bus to the output stream, saturating to 16 bit.
+ */
+static void S_MixBus(int16_t *restrict out, const vec_t *restrict bus, const uint32_t samples) {
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	// eight samples per iteration, clamped before conversion and packed with saturation
+	const __m128 min = _mm_set1_ps(-32768.0), max = _mm_set1_ps(32767.0);
+
+	for (; i + 8 <= samples; i += 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *) (out + i));
+
+		__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+		__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+
+		lo = _mm_min_ps(_mm_max_ps(_mm_add_ps(lo, _mm_loadu_ps(bus + i + 0)), min), max);
+		hi = _mm_min_ps(_mm_max_ps(_mm_add_ps(hi, _mm_loadu_ps(bus + i + 4)), min), max);
+
+		const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+		_mm_storeu_si128((__m128i *) (out + i), packed);
+	}
+#endif
+
+	for (; i < samples; i++) {
+		const vec_t s = out[i] + bus[i];
+		out[i] = (int16_t) Clamp(s, -32768.0, 32767.0);
+	}
+}
+
+/*
+ * @brief Mixes the specified channels into the 16 bit stereo output stream,
+ * through the specified bus of SOUND_MIX_FRAMES frames. Channels which finish,
+ * or which were stopped, are freed.
+ */
+static void S_MixChannels_(s_channel_t *channels, uint16_t num_channels, vec_t *bus,
+		int16_t *out, uint32_t frames) {
+	uint16_t i;
+
+	while (frames) {
+		const uint32_t count = MIN(frames, SOUND_MIX_FRAMES);
+
+		memset(bus, 0, count * 2 * sizeof(vec_t));
+
+		for (i = 0; i < num_channels; i++) {
+			s_channel_t *ch = &channels[i];
+
+			if (!ch->sample)
+				continue;
+
+			if (S_MixChannel(ch, bus, count) < count || ch->stop) {
+				memset(ch, 0, sizeof(*ch));
+			}
+		}
+
+		S_MixBus(out, bus, count * 2);
+
+		out += count * 2;
+		frames -= count;
+	}
+}
+
+/*
+ * @brief SDL_mixer post-mix callback, mixing our channels into the stream
+ * after music. This runs on the audio thread, which holds the audio lock.
+ */
+void S_MixChannels(void *udata __attribute__((unused)), Uint8 *stream, int32_t len) {
+	S_MixChannels_(s_env.channels, MAX_CHANNELS, s_bus, (int16_t *) stream, len / 4);
+}
+
+/*
+ * @brief Returns the cost of interrupting the specified channel. Unattenuated
+ * sounds are the most important, and then the nearest sounds.
+ */
+static int32_t S_ChannelPriority(const s_channel_t *ch) {
+	return (ch->atten << 8) + ch->dist;
+}
+
+/*
+ * @brief Returns a free channel for the specified sound. If every channel is
+ * busy, the least important channel is stolen, provided that it is less
+ * important than the new sound. Returns -1 if no channel is available. The
+ * audio lock must be held.
+ */
+static int32_t S_AllocChannel(const s_channel_t *ch) {
+	int32_t i, j = -1;
 
 	for (i = 0; i < MAX_CHANNELS; i++) {
-		if (!s_env.channels[i].sample)
+		const s_channel_t *c = &s_env.channels[i];
+
+		if (!c->sample)
 			return i;
+
+		if (c->stop)
+			continue;
+
+		if (j == -1 || S_ChannelPriority(c) > S_ChannelPriority(&s_env.channels[j]))
+			j = i;
+	}
+
+	if (j != -1 && S_ChannelPriority(&s_env.channels[j]) > S_ChannelPriority(ch)) {
+		memset(&s_env.channels[j], 0, sizeof(s_env.channels[0]));
+		return j;
 	}
 
 	return -1;
 }
 
 /*
- * @brief
+ * @brief Returns a channel playing a sound of the specified entity, or -1. The
+ * indexed channel is checked first. Should it have finished, or been reused,
+ * while another channel of the entity plays on, that channel is indexed.
  */
-void S_FreeChannel(int32_t c) {
-	memset(&s_env.channels[c], 0, sizeof(s_env.channels[0]));
+int32_t S_EntityChannel(uint16_t ent_num) {
+	int32_t i;
+
+	if ((i = s_env.entity_channels[ent_num] - 1) != -1) {
+		const s_channel_t *ch = &s_env.channels[i];
+
+		if (ch->sample && ch->ent_num == ent_num)
+			return i;
+	}
+
+	for (i = 0; i < MAX_CHANNELS; i++) {
+		const s_channel_t *ch = &s_env.channels[i];
+
+		if (ch->sample && ch->ent_num == ent_num)
+			break;
+	}
+
+	if (i == MAX_CHANNELS) {
+		s_env.entity_channels[ent_num] = 0;
+		return -1;
+	}
+
+	s_env.entity_channels[ent_num] = i + 1;
+	return i;
 }
 
 #define SOUND_MAX_DISTANCE 2048.0
 
+#define SOUND_OCCLUSION_DISTANCE 32.0 // retrace once the sound or view moves this far
+#define SOUND_OCCLUSION_INTERVAL 250 // or after this many milliseconds
+#define SOUND_OCCLUSION_TRACES 8 // traces per frame for channels which already have one
+
+/*
+ * @brief Returns true if the channel's occlusion trace is stale.
+ */
+static _Bool S_OcclusionExpired(const s_channel_t *ch) {
+	vec3_t delta;
+
+	if (cls.real_time - ch->occlusion_time > SOUND_OCCLUSION_INTERVAL)
+		return true;
+
+	const vec_t threshold = SOUND_OCCLUSION_DISTANCE * SOUND_OCCLUSION_DISTANCE;
+
+	VectorSubtract(ch->org, ch->occlusion_org, delta);
+	if (DotProduct(delta, delta) > threshold)
+		return true;
+
+	VectorSubtract(r_view.origin, ch->occlusion_view, delta);
+	if (DotProduct(delta, delta) > threshold)
+		return true;
+
+	return false;
+}
+
+/*
+ * @brief Resolves whether the channel's line of sight to the view is blocked.
+ * Channels which have never been traced are always traced. Stale traces are
+ * refreshed while this frame's budget allows, and are otherwise reused.
+ */
+static void S_OccludeChannel(s_channel_t *ch) {
+
+	if (ch->occlusion_time) {
+
+		if (!S_OcclusionExpired(ch))
+			return;
+
+		if (s_env.num_traces >= SOUND_OCCLUSION_TRACES)
+			return;
+	}
+
+	const c_trace_t tr = Cl_Trace(r_view.origin, ch->org, NULL, NULL, 0, MASK_SHOT);
+
+	ch->occluded = tr.fraction < 1.0;
+
+	VectorCopy(ch->org, ch->occlusion_org);
+	VectorCopy(r_view.origin, ch->occlusion_view);
+	ch->occlusion_time = cls.real_time ? cls.real_time : 1;
+
+	s_env.num_traces++;
+}
+
 /*
- * @brief Set distance and stereo panning for the specified channel.
+ * @brief Resolves the distance and stereo gains of the specified channel. The
+ * sound is panned by its angle to the view with constant power.
  */
 _Bool S_SpatializeChannel(s_channel_t *ch) {
 	vec3_t delta;
@@ -63,8 +384,8 @@ _Bool S_SpatializeChannel(s_channel_t *ch) {
 	vec_t dist = VectorNormalize(delta) * ch->atten;
 
 	if (dist < SOUND_MAX_DISTANCE) { // check if there's a clear line of sight to the origin
-		c_trace_t tr = Cl_Trace(r_view.origin, ch->org, NULL, NULL, 0, MASK_SHOT);
-		if (tr.fraction < 1.0) {
+		S_OccludeChannel(ch);
+		if (ch->occluded) {
 			dist *= 1.25;
 		}
 	}
@@ -73,66 +394,197 @@ _Bool S_SpatializeChannel(s_channel_t *ch) {
 
 	ch->dist = (uint8_t) Clamp(dist, 0.0, 255.0);
 
-	const vec_t dot = DotProduct(r_view.right, delta);
-	const vec_t angle = acos(dot) * 180.0 / M_PI - 90.0;
+	vec_t pan = DotProduct(r_view.right, delta);
 
-	ch->angle = (int16_t) (360.0 - angle) % 360;
+	if (s_reverse->integer)
+		pan = -pan;
+
+	const vec_t gain = s_volume->value * (255 - ch->dist) / 255.0;
+
+	ch->gain[0] = gain * sqrt(0.5 * (1.0 - pan));
+	ch->gain[1] = gain * sqrt(0.5 * (1.0 + pan));
 
 	return ch->dist < 255;
 }
 
+/*
+ * @brief Updates the spatialization of all playing channels for this frame.
+ * The channels are spatialized from a copy, so that the audio lock is not held
+ * across occlusion traces, and the results are published under it. When the
+ * trace budget is spent, the channels following the last one traced are
+ * offered the first traces of the next frame. Channels which are no longer
+ * audible are faded out by the mixer.
+ */
+void S_SpatializeChannels(void) {
+	static s_channel_t channels[MAX_CHANNELS];
+	int32_t i, j, traced = -1;
+
+	SDL_mutexP(s_env.lock);
+
+	const uint16_t start = s_env.trace_channel;
+
+	s_env.num_traces = 0;
+
+	SDL_LockAudio();
+
+	memcpy(channels, s_env.channels, sizeof(channels));
+
+	SDL_UnlockAudio();
+
+	for (j = 0; j < MAX_CHANNELS; j++) {
+
+		i = (start + j) & (MAX_CHANNELS - 1);
+		s_channel_t *ch = &channels[i];
+
+		if (!ch->sample || ch->stop)
+			continue;
+
+		const uint16_t num_traces = s_env.num_traces;
+
+		if (!S_SpatializeChannel(ch)) {
+			ch->gain[0] = ch->gain[1] = 0.0;
+			ch->stop = true;
+		}
+
+		if (s_env.num_traces > num_traces)
+			traced = i;
+
+		// reset channel's count for loop samples
+		ch->count = 0;
+	}
+
+	SDL_LockAudio();
+
+	for (i = 0; i < MAX_CHANNELS; i++) {
+		const s_channel_t *c = &channels[i];
+		s_channel_t *ch = &s_env.channels[i];
+
+		if (!c->sample || ch->sample != c->sample)
+			continue; // the channel has since been mixed to completion
+
+		VectorCopy(c->org, ch->org);
+		ch->count = c->count;
+		ch->dist = c->dist;
+		ch->gain[0] = c->gain[0];
+		ch->gain[1] = c->gain[1];
+		ch->stop = c->stop;
+
+		VectorCopy(c->occlusion_org, ch->occlusion_org);
+		VectorCopy(c->occlusion_view, ch->occlusion_view);
+		ch->occlusion_time = c->occlusion_time;
+		ch->occluded = c->occluded;
+	}
+
+	SDL_UnlockAudio();
+
+	if (s_env.num_traces >= SOUND_OCCLUSION_TRACES)
+		s_env.trace_channel = (traced + 1) & (MAX_CHANNELS - 1);
+
+	SDL_mutexV(s_env.lock);
+}
+
+/*
+ * @brief Spatializes the specified sound and, if it is audible, starts it on a
+ * free or stolen channel. Returns the channel, or -1. The sound lock must be
+ * held, while the audio lock is taken only to publish the channel.
+ */
+static int32_t S_StartChannel(const s_channel_t *ch) {
+	s_channel_t channel = *ch;
+
+	if (!S_SpatializeChannel(&channel))
+		return -1;
+
+	if (channel.pitch == 0.0)
+		channel.pitch = 1.0;
+
+	// start at full gain, rather than ramping up from silence
+	channel.mix_gain[0] = channel.gain[0];
+	channel.mix_gain[1] = channel.gain[1];
+
+	SDL_LockAudio();
+
+	const int32_t i = S_AllocChannel(&channel);
+
+	if (i != -1)
+		s_env.channels[i] = channel;
+
+	SDL_UnlockAudio();
+
+	return i;
+}
+
 /*
  * @brief
  */
-void S_PlaySample(const vec3_t org, uint16_t ent_num, s_sample_t *sample, int32_t atten) {
-	s_channel_t *ch;
+static void S_PlaySample_(const vec3_t org, uint16_t ent_num, s_sample_t *sample, int32_t atten) {
+	s_channel_t ch;
 	int32_t i;
 
-	if (!s_env.initialized)
-		return;
-
 	if (sample && sample->media.name[0] == '*') // resolve the model-specific sample
 		sample = S_LoadModelSample(&cl.entities[ent_num].current, sample->media.name);
 
 	if (!sample || !sample->chunk)
 		return;
 
-	if ((i = S_AllocChannel()) == -1)
-		return;
-
-	ch = &s_env.channels[i];
+	memset(&ch, 0, sizeof(ch));
 
 	if (org) { // positioned sound
-		VectorCopy(org, ch->org);
-		ch->ent_num = -1;
+		VectorCopy(org, ch.org);
+		ch.ent_num = -1;
 	} else
 		// entity sound
-		ch->ent_num = ent_num;
+		ch.ent_num = ent_num;
 
-	ch->atten = atten;
-	ch->sample = sample;
+	ch.atten = atten;
+	ch.sample = sample;
 
-	if (S_SpatializeChannel(ch)) {
-		Mix_SetPosition(i, ch->angle, ch->dist);
-		Mix_PlayChannel(i, ch->sample->chunk, 0);
-	} else {
-		S_FreeChannel(i);
-	}
+	if ((i = S_StartChannel(&ch)) == -1)
+		return;
+
+	if (ch.ent_num != -1 && S_EntityChannel(ent_num) == -1)
+		s_env.entity_channels[ent_num] = i + 1;
 }
 
 /*
- * @brief
+ * @brief Samples may be played from the client game's view population jobs,
+ * so the sound lock is held throughout. This serializes model sample loading
+ * and the occlusion traces of spatialization, which are not reentrant, without
+ * stalling the mixer.
+ */
+void S_PlaySample(const vec3_t org, uint16_t ent_num, s_sample_t *sample, int32_t atten) {
+
+	if (!s_env.initialized)
+		return;
+
+	SDL_mutexP(s_env.lock);
+
+	S_PlaySample_(org, ent_num, sample, atten);
+
+	SDL_mutexV(s_env.lock);
+}
+
+/*
+ * @brief Merges the specified loop sample into a nearby channel playing it, or
+ * starts a new one. As with S_PlaySample, the sound lock is held throughout,
+ * while the audio lock is held only to find and update the existing channel.
  */
 void S_LoopSample(const vec3_t org, s_sample_t *sample) {
 	s_channel_t *ch;
 	vec3_t delta;
 	int32_t i;
 
+	if (!s_env.initialized)
+		return;
+
 	if (!sample || !sample->chunk)
 		return;
 
 	ch = NULL;
 
+	SDL_mutexP(s_env.lock);
+
+	SDL_LockAudio();
+
 	for (i = 0; i < MAX_CHANNELS; i++) { // find existing loop sound
 
 		if (s_env.channels[i].ent_num != -1)
@@ -152,26 +604,25 @@ void S_LoopSample(const vec3_t org, s_sample_t *sample) {
 	if (ch) { // update existing loop sample
 		ch->count++;
 		VectorMix(ch->org, org, 1.0 / ch->count, ch->org);
-	} else { // or allocate a new one
+	}
 
-		if ((i = S_AllocChannel()) == -1)
-			return;
+	SDL_UnlockAudio();
 
-		ch = &s_env.channels[i];
+	if (!ch) { // or allocate a new one
+		s_channel_t channel;
 
-		VectorCopy(org, ch->org);
-		ch->ent_num = -1;
-		ch->count = 1;
-		ch->atten = ATTEN_IDLE;
-		ch->sample = sample;
+		memset(&channel, 0, sizeof(channel));
 
-		if (S_SpatializeChannel(ch)) {
-			Mix_SetPosition(i, ch->angle, ch->dist);
-			Mix_PlayChannel(i, ch->sample->chunk, 0);
-		} else {
-			S_FreeChannel(i);
-		}
+		VectorCopy(org, channel.org);
+		channel.ent_num = -1;
+		channel.count = 1;
+		channel.atten = ATTEN_IDLE;
+		channel.sample = sample;
+
+		S_StartChannel(&channel);
 	}
+
+	SDL_mutexV(s_env.lock);
 }
 
 /*
@@ -192,3 +643,68 @@ void S_StartLocalSample(const char *name) {
 
 	S_PlaySample(NULL, cl.entity_num + 1, sample, ATTEN_NONE);
 }
+
+/*
+ * @brief s_bench_mix [voices] [seconds] [pitch]
+ *
+ * Mixes a synthetic tone on the specified number of voices into a scratch
+ * buffer, and reports the cost relative to real time. Voices pitched away from
+ * 1.0 are resampled. The benchmark mixes through its own bus, and the audio
+ * device is not used, so this may be run alongside the mixer, or without sound
+ * hardware.
+ */
+void S_BenchMix_f(void) {
+	uint32_t i;
+
+	const uint16_t num_voices = Cmd_Argc() > 1 ? Clamp(atoi(Cmd_Argv(1)), 1, 4096) : MAX_CHANNELS;
+	const vec_t seconds = Cmd_Argc() > 2 ? Clamp(atof(Cmd_Argv(2)), 0.1, 60.0) : 10.0;
+	const vec_t pitch = Cmd_Argc() > 3 ? Clamp(atof(Cmd_Argv(3)), 0.25, 4.0) : 1.0;
+
+	const uint32_t rate = s_rate->integer > 0 ? s_rate->integer : 44100;
+	const uint32_t frames = rate * seconds;
+
+	// enough of the tone to last the benchmark at the specified pitch
+	const uint32_t tone_frames = frames * pitch + 1;
+
+	int16_t *tone = Mem_Malloc(tone_frames * 4);
+	int16_t *out = Mem_Malloc(frames * 4);
+
+	vec_t *bus = Mem_Malloc(SOUND_MIX_FRAMES * 2 * sizeof(vec_t));
+
+	for (i = 0; i < tone_frames; i++) {
+		tone[i * 2 + 0] = tone[i * 2 + 1] = 8192.0 * sin(2.0 * M_PI * 440.0 * i / rate);
+	}
+
+	Mix_Chunk chunk = { .allocated = 0, .abuf = (Uint8 *) tone, .alen = tone_frames * 4, .volume =
+			MIX_MAX_VOLUME };
+
+	s_sample_t sample;
+	memset(&sample, 0, sizeof(sample));
+
+	sample.chunk = &chunk;
+
+	s_channel_t *channels = Mem_Malloc(num_voices * sizeof(s_channel_t));
+
+	for (i = 0; i < num_voices; i++) { // spread the voices across the stereo field
+		const vec_t pan = (2.0 * i / num_voices) - 1.0;
+
+		channels[i].sample = &sample;
+		channels[i].pitch = pitch;
+		channels[i].gain[0] = sqrt(0.5 * (1.0 - pan)) / num_voices;
+		channels[i].gain[1] = sqrt(0.5 * (1.0 + pan)) / num_voices;
+	}
+
+	const uint64_t start = Sys_Microseconds();
+
+	S_MixChannels_(channels, num_voices, bus, out, frames);
+
+	const vec_t elapsed = (Sys_Microseconds() - start) / 1000.0;
+
+	Com_Print("%u voices at pitch %.2f, %.1fs of audio at %uHz mixed in %.1fms (%.0fx real time)\n",
+			num_voices, pitch, seconds, rate, elapsed, seconds * 1000.0 / MAX(elapsed, 0.001));
+
+	Mem_Free(channels);
+	Mem_Free(bus);
+	Mem_Free(out);
+	Mem_Free(tone);
+}
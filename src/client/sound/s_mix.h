@@ -28,8 +28,11 @@ void S_StartLocalSample(const char *name);
 
 #ifdef __S_LOCAL_H__
 
-void S_FreeChannel(int32_t c);
+void S_MixChannels(void *udata, Uint8 *stream, int32_t len);
+int32_t S_EntityChannel(uint16_t ent_num);
 _Bool S_SpatializeChannel(s_channel_t *channel);
+void S_SpatializeChannels(void);
+void S_BenchMix_f(void);
 
 #endif /* __S_LOCAL_H__ */
 
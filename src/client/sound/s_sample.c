@@ -72,9 +72,7 @@ static void S_LoadSampleChunk(s_sample_t *sample) {
 			break;
 	}
 
-	if (sample->chunk)
-		Mix_VolumeChunk(sample->chunk, s_volume->value * MIX_MAX_VOLUME);
-	else
+	if (!sample->chunk)
 		Com_Warn("Failed to load %s\n", sample->media.name);
 }
 
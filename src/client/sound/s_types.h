@@ -46,12 +46,21 @@ typedef struct s_channel_s {
 	int32_t ent_num; // for entities and dynamic sounds
 	int32_t count; // for looped sounds
 	int32_t atten;
-	int16_t angle;
 	uint8_t dist;
+	vec_t gain[2]; // the left and right gains resolved by spatialization
+	vec_t mix_gain[2]; // the gains at the end of the last mixed block
+	vec_t pitch; // the playback rate relative to the sample's, resampled when not 1.0
+	uint32_t position; // the next sample frame to be mixed
+	uint32_t phase; // the fraction of a frame past position, in 1/65536ths, when resampling
+	_Bool stop; // fade out and free once mixed
 	s_sample_t *sample;
+	vec3_t occlusion_org; // the sound origin when occlusion was last traced
+	vec3_t occlusion_view; // the view origin when occlusion was last traced
+	uint32_t occlusion_time; // when occlusion was last traced, 0 for never
+	_Bool occluded;
 } s_channel_t;
 
-#define MAX_CHANNELS 64
+#define MAX_CHANNELS 128
 
 typedef struct s_music_s {
 	s_media_t media;
@@ -67,6 +76,13 @@ typedef struct s_env_s {
 	_Bool initialized; // is the sound subsystem initialized
 	_Bool update; // inform the client of state changes
 
+	uint8_t entity_channels[MAX_EDICTS]; // channel + 1 of each entity's sound, validated on use
+
+	uint16_t trace_channel; // the channel which is first offered an occlusion trace
+	uint16_t num_traces; // occlusion traces run this frame
+
+	SDL_mutex *lock; // serializes starting sounds, and their occlusion traces
+
 	uint16_t num_active_channels;
 } s_env_t;
 
@@ -40,7 +40,13 @@
  * @brief Quake net protocol version; this must be changed when the structure
  * of any net message or serialized data type changes.
  */
-#define PROTOCOL			1005
+#define PROTOCOL			1006
+
+/*
+ * @brief The previous protocol version, which is still negotiated for older
+ * peers. It differs from PROTOCOL only in its byte-aligned entity deltas.
+ */
+#define PROTOCOL_LEGACY		1005
 
 /*
  * @brief The IP address of the master server, where the authoritative list of
@@ -97,6 +103,14 @@
 		!*f || *f == '/' || strstr(f, "..") || strchr(f, ' ') \
 	)
 
+/*
+ * @brief UDP downloads are transferred in chunks, of which up to DOWNLOAD_WINDOW
+ * may be in flight to PROTOCOL clients. The client buffers chunks which arrive
+ * out of order, and acknowledges them selectively.
+ */
+#define DOWNLOAD_CHUNK_SIZE	1024
+#define DOWNLOAD_WINDOW		32
+
 typedef enum {
 	ERR_NONE,
 	ERR_PRINT,
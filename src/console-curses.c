@@ -29,6 +29,7 @@
 #define CURSES_HISTORYSIZE 64
 #define CURSES_LINESIZE 1024
 #define CURSES_TIMEOUT 250	// 250 msec redraw timeout
+#define CURSES_PANELSIZE 4096
 
 static WINDOW *stdwin; // ncurses standard window
 
@@ -44,6 +45,9 @@ cvar_t *con_timeout;
 
 static char version_string[32];
 
+static char panel[CURSES_PANELSIZE]; // status text drawn above the console
+static uint16_t panel_lines;
+
 static uint32_t curses_redraw; // indicates what part needs to be drawn
 static uint32_t curses_last_update; // number of milliseconds since last redraw
 
@@ -95,6 +99,32 @@ static void Curses_DrawInput(void) {
 	wmove(stdwin, LINES - 1, 3 + input_pos);
 }
 
+/*
+ * @brief Draw the status panel, if any, beneath the header.
+ */
+static void Curses_DrawPanel(void) {
+	int32_t y = 1;
+
+	if (!panel_lines)
+		return;
+
+	Curses_SetColor(CON_COLOR_ALT);
+
+	const char *line = panel;
+	while (*line && y <= panel_lines) {
+		const char *end = strchr(line, '\n');
+		const int32_t len = end ? end - line : (int32_t) strlen(line);
+
+		mvaddnstr(y++, 2, line, MIN(len, COLS - 4));
+
+		line += len + (end ? 1 : 0);
+	}
+
+	mvhline(y, 1, ACS_HLINE, COLS - 2);
+
+	Curses_SetColor(CON_COLOR_DEFAULT);
+}
+
 /*
  * @brief Draw the content of the console, parse color codes and line breaks.
  */
@@ -111,15 +141,17 @@ static void Curses_DrawConsole(void) {
 	w = COLS - 1;
 	h = LINES - 1;
 
-	if (w < 3 && h < 3)
+	const int32_t top = panel_lines ? panel_lines + 1 : 0;
+
+	if ((w < 3 && h < 3) || h - 2 - top < 1)
 		return;
 
-	Con_Resize(&sv_console, w - 1, h - 2);
+	Con_Resize(&sv_console, w - 1, h - 2 - top);
 	Curses_SetColor(CON_COLOR_DEFAULT);
 
 	lines = sv_console.height + 1;
 
-	y = 1;
+	y = 1 + top;
 	for (line = sv_console.last_line - sv_console.scroll - lines; line < sv_console.last_line
 			- sv_console.scroll; line++) {
 		if (line >= 0 && *sv_console.line_start[line]) {
@@ -150,7 +182,7 @@ static void Curses_DrawConsole(void) {
 	// draw a scroll indicator
 	if (sv_console.last_line > 0) {
 		Curses_SetColor(CON_COLOR_ALT);
-		mvaddnstr(1 + ((sv_console.last_line-sv_console.scroll) * sv_console.height / sv_console.last_line) , w, "O", 1);
+		mvaddnstr(1 + top + ((sv_console.last_line-sv_console.scroll) * sv_console.height / sv_console.last_line) , w, "O", 1);
 	}
 
 	// reset drawing colors
@@ -164,6 +196,30 @@ void Curses_Refresh(void) {
 	curses_redraw |= 2;
 }
 
+/*
+ * @brief Set the status panel drawn above the console, or remove it if text
+ * is NULL. The panel is redrawn along with the console.
+ */
+void Curses_SetPanel(const char *text) {
+	const char *c;
+
+	if (text) {
+		g_strlcpy(panel, text, sizeof(panel));
+	} else {
+		panel[0] = '\0';
+	}
+
+	panel_lines = 0;
+	for (c = panel; *c; c++) {
+		if (*c == '\n' || *(c + 1) == '\0')
+			panel_lines++;
+	}
+
+	panel_lines = MIN(panel_lines, (LINES - 1) / 2);
+
+	curses_redraw |= 2;
+}
+
 /*
  * @brief Draw everything
  */
@@ -178,6 +234,7 @@ static void Curses_Draw(void) {
 		if ((curses_redraw & 2) == 2) {
 			// Refresh screen
 			Curses_DrawBackground();
+			Curses_DrawPanel();
 			Curses_DrawConsole();
 			Curses_DrawInput();
 		} else if ((curses_redraw & 1) == 1) {
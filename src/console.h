@@ -74,6 +74,7 @@ void Curses_Init(void);
 void Curses_Shutdown(void);
 void Curses_Frame(uint32_t msec);
 void Curses_Refresh(void);
+void Curses_SetPanel(const char *text);
 
 #endif /* HAVE_CURSES */
 
@@ -0,0 +1,520 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <zlib.h>
+
+#include "demo.h"
+
+#define DEMO_HEADER_SIZE (5 * sizeof(int32_t))
+#define DEMO_INDEX_OFFSET (4 * sizeof(int32_t))
+
+#define DEMO_BLOCK_HEADER_SIZE (3 * sizeof(int32_t))
+#define DEMO_MESSAGE_HEADER_SIZE (2 * sizeof(int32_t))
+
+/*
+ * @brief Reads a little-endian long from the file.
+ */
+static _Bool Demo_ReadLong(file_t *file, int32_t *l) {
+
+	if (Fs_Read(file, l, sizeof(*l), 1) != 1)
+		return false;
+
+	*l = LittleLong(*l);
+	return true;
+}
+
+/*
+ * @brief Writes a little-endian long to the file.
+ */
+static void Demo_WriteLong(file_t *file, int32_t l) {
+
+	l = LittleLong(l);
+	Fs_Write(file, &l, sizeof(l), 1);
+}
+
+/*
+ * @brief Allocates a demo for the specified file.
+ */
+static demo_t *Demo_Alloc(file_t *file, _Bool write) {
+
+	demo_t *demo = Mem_Malloc(sizeof(demo_t));
+
+	demo->file = file;
+	demo->write = write;
+
+	demo->keyframes = g_array_new(false, false, sizeof(demo_keyframe_t));
+	demo->last_frame = -1;
+
+	demo->block = Mem_LinkMalloc(DEMO_BLOCK_SIZE, demo);
+	demo->keyframe = -1;
+
+	demo->frame_num = -1;
+
+	return demo;
+}
+
+/*
+ * @brief Frees the demo, closing its file.
+ */
+static void Demo_Free(demo_t *demo) {
+
+	Fs_Close(demo->file);
+
+	g_array_free(demo->keyframes, true);
+
+	Mem_Free(demo);
+}
+
+/*
+ * @brief Reads the index, or rebuilds it from the block headers if the demo
+ * was not properly closed. Either way, the file is left at the first block.
+ */
+static void Demo_ReadIndex(demo_t *demo) {
+	int32_t count, last_frame, i;
+
+	if (demo->index) {
+		if (Fs_Seek(demo->file, demo->index) && Demo_ReadLong(demo->file, &count)
+				&& Demo_ReadLong(demo->file, &last_frame)) {
+
+			for (i = 0; i < count; i++) {
+				demo_keyframe_t k;
+
+				if (!Demo_ReadLong(demo->file, &k.frame_num))
+					break;
+
+				if (!Demo_ReadLong(demo->file, (int32_t *) &k.offset))
+					break;
+
+				g_array_append_val(demo->keyframes, k);
+			}
+
+			if (i == count) {
+				demo->last_frame = last_frame;
+				Fs_Seek(demo->file, DEMO_HEADER_SIZE);
+				return;
+			}
+		}
+
+		Com_Warn("Corrupt demo index, rebuilding\n");
+
+		g_array_set_size(demo->keyframes, 0);
+		demo->index = 0;
+	}
+
+	uint32_t offset = DEMO_HEADER_SIZE;
+
+	while (Fs_Seek(demo->file, offset)) {
+		int32_t keyframe, size, len;
+
+		if (!Demo_ReadLong(demo->file, &keyframe))
+			break;
+
+		if (!Demo_ReadLong(demo->file, &size) || !Demo_ReadLong(demo->file, &len))
+			break;
+
+		if (size < 0 || len < 0 || len > size)
+			break;
+
+		if (keyframe != -1) {
+			const demo_keyframe_t k = { keyframe, offset };
+			g_array_append_val(demo->keyframes, k);
+
+			demo->last_frame = MAX(demo->last_frame, keyframe);
+		}
+
+		offset += DEMO_BLOCK_HEADER_SIZE + len;
+	}
+
+	Com_Debug("Rebuilt index of %u keyframes\n", demo->keyframes->len);
+
+	Fs_Seek(demo->file, DEMO_HEADER_SIZE);
+}
+
+/*
+ * @brief Opens the specified demo for playback. Both indexed and flat demos
+ * are supported, though only the former can seek.
+ */
+demo_t *Demo_OpenRead(const char *filename) {
+	int32_t magic, version, flags, hz, index;
+
+	file_t *file = Fs_OpenRead(filename);
+	if (!file)
+		return NULL;
+
+	demo_t *demo = Demo_Alloc(file, false);
+
+	if (!Demo_ReadLong(file, &magic) || magic != DEMO_MAGIC) {
+		Fs_Seek(file, 0); // a flat demo
+		return demo;
+	}
+
+	if (!Demo_ReadLong(file, &version) || !Demo_ReadLong(file, &flags)
+			|| !Demo_ReadLong(file, &hz) || !Demo_ReadLong(file, &index)) {
+		Com_Warn("%s: Incomplete demo header\n", filename);
+		Demo_Free(demo);
+		return NULL;
+	}
+
+	if (version < 1 || version > DEMO_VERSION) {
+		Com_Warn("%s: Unsupported demo version %d\n", filename, version);
+		Demo_Free(demo);
+		return NULL;
+	}
+
+	demo->version = version;
+	demo->flags = flags;
+	demo->hz = hz;
+	demo->index = index;
+
+	Demo_ReadIndex(demo);
+
+	return demo;
+}
+
+/*
+ * @brief Opens the specified demo for recording. The index is written when the
+ * demo is closed.
+ */
+demo_t *Demo_OpenWrite(const char *filename, uint32_t hz, uint32_t flags) {
+
+	file_t *file = Fs_OpenWrite(filename);
+	if (!file)
+		return NULL;
+
+	demo_t *demo = Demo_Alloc(file, true);
+
+	demo->version = DEMO_VERSION;
+	demo->flags = flags;
+	demo->hz = hz;
+
+	Demo_WriteLong(file, DEMO_MAGIC);
+	Demo_WriteLong(file, demo->version);
+	Demo_WriteLong(file, demo->flags);
+	Demo_WriteLong(file, demo->hz);
+	Demo_WriteLong(file, 0);
+
+	return demo;
+}
+
+/*
+ * @brief Writes the current block, deflating it if the demo is compressed.
+ */
+static void Demo_WriteBlock(demo_t *demo) {
+	byte *deflated = NULL;
+
+	if (demo->size) {
+		const uint32_t offset = (uint32_t) Fs_Tell(demo->file);
+
+		byte *data = demo->block;
+		uLongf len = demo->size;
+
+		if (demo->flags & DEMO_COMPRESS) {
+			uLongf deflated_len = compressBound(len);
+			deflated = Mem_Malloc(deflated_len);
+
+			if (compress2(deflated, &deflated_len, data, len, Z_BEST_SPEED) == Z_OK) {
+				if (deflated_len < len) {
+					data = deflated;
+					len = deflated_len;
+				}
+			}
+		}
+
+		Demo_WriteLong(demo->file, demo->keyframe);
+		Demo_WriteLong(demo->file, demo->size);
+		Demo_WriteLong(demo->file, len);
+
+		Fs_Write(demo->file, data, len, 1);
+
+		if (demo->keyframe != -1) {
+			const demo_keyframe_t k = { demo->keyframe, offset };
+			g_array_append_val(demo->keyframes, k);
+		}
+
+		if (deflated) {
+			Mem_Free(deflated);
+		}
+	}
+
+	demo->size = 0;
+	demo->keyframe = -1;
+}
+
+/*
+ * @brief Closes the demo. Recorded demos are finished with their index.
+ */
+void Demo_Close(demo_t *demo) {
+	guint i;
+
+	if (demo->write) {
+		Demo_WriteBlock(demo);
+
+		demo->index = (uint32_t) Fs_Tell(demo->file);
+
+		Demo_WriteLong(demo->file, demo->keyframes->len);
+		Demo_WriteLong(demo->file, demo->last_frame);
+
+		for (i = 0; i < demo->keyframes->len; i++) {
+			const demo_keyframe_t *k = &g_array_index(demo->keyframes, demo_keyframe_t, i);
+
+			Demo_WriteLong(demo->file, k->frame_num);
+			Demo_WriteLong(demo->file, k->offset);
+		}
+
+		if (Fs_Seek(demo->file, DEMO_INDEX_OFFSET)) {
+			Demo_WriteLong(demo->file, demo->index);
+		} else {
+			Com_Warn("Failed to write demo index: %s\n", Fs_LastError());
+		}
+	}
+
+	Demo_Free(demo);
+}
+
+/*
+ * @brief Reads and inflates the next block, returning false at the end of the
+ * demo or if the block is corrupt.
+ */
+static _Bool Demo_ReadBlock(demo_t *demo) {
+	int32_t keyframe, size, len;
+
+	if (demo->index && Fs_Tell(demo->file) >= demo->index)
+		return false;
+
+	if (!Demo_ReadLong(demo->file, &keyframe))
+		return false; // the end of a demo that was not properly closed
+
+	if (!Demo_ReadLong(demo->file, &size) || !Demo_ReadLong(demo->file, &len)) {
+		Com_Warn("Incomplete demo block\n");
+		return false;
+	}
+
+	if (size < 0 || len < 0 || len > size || size > DEMO_BLOCK_SIZE) {
+		Com_Warn("Corrupt demo block: %d, %d bytes\n", size, len);
+		return false;
+	}
+
+	demo->size = demo->read = 0;
+	demo->keyframe = keyframe;
+
+	if (len == size) {
+		if (len && Fs_Read(demo->file, demo->block, len, 1) != 1) {
+			Com_Warn("Incomplete demo block\n");
+			return false;
+		}
+	} else {
+		byte *deflated = Mem_Malloc(len);
+		_Bool inflated = false;
+
+		if (Fs_Read(demo->file, deflated, len, 1) == 1) {
+			uLongf inflated_len = size;
+
+			if (uncompress(demo->block, &inflated_len, deflated, len) == Z_OK) {
+				inflated = inflated_len == (uLongf) size;
+			}
+		}
+
+		Mem_Free(deflated);
+
+		if (!inflated) {
+			Com_Warn("Failed to inflate demo block\n");
+			return false;
+		}
+	}
+
+	demo->size = size;
+	return true;
+}
+
+/*
+ * @brief Reads the next message into the specified buffer.
+ *
+ * @return The size of the message, or -1 at the end of the demo.
+ */
+int32_t Demo_ReadMessage(demo_t *demo, void *data, size_t len) {
+	int32_t frame_num, size;
+
+	if (demo->version == 0) {
+
+		if (!Demo_ReadLong(demo->file, &size)) { // improperly terminated demo file
+			Com_Warn("Failed to read demo file\n");
+			return -1;
+		}
+
+		if (size == -1) // properly terminated demo file
+			return -1;
+
+		if (size < 0 || (size_t) size > len) {
+			Com_Warn("Corrupt demo file: %d > %u\n", size, (uint32_t) len);
+			return -1;
+		}
+
+		if (size && Fs_Read(demo->file, data, size, 1) != 1) {
+			Com_Warn("Incomplete or corrupt demo file\n");
+			return -1;
+		}
+
+		return size;
+	}
+
+	while (demo->read == demo->size) {
+		if (!Demo_ReadBlock(demo))
+			return -1;
+	}
+
+	if (demo->size - demo->read < DEMO_MESSAGE_HEADER_SIZE) {
+		Com_Warn("Corrupt demo block\n");
+		return -1;
+	}
+
+	memcpy(&frame_num, demo->block + demo->read, sizeof(frame_num));
+	memcpy(&size, demo->block + demo->read + sizeof(frame_num), sizeof(size));
+
+	demo->read += DEMO_MESSAGE_HEADER_SIZE;
+
+	frame_num = LittleLong(frame_num);
+	size = LittleLong(size);
+
+	if (size < 0 || (size_t) size > len || demo->read + size > demo->size) {
+		Com_Warn("Corrupt demo message: %d bytes\n", size);
+		return -1;
+	}
+
+	memcpy(data, demo->block + demo->read, size);
+	demo->read += size;
+
+	demo->frame_num = frame_num;
+	return size;
+}
+
+/*
+ * @brief Appends a message to the current block. The frame number is that of
+ * the most recent frame received, including any frame in the message itself.
+ */
+void Demo_WriteMessage(demo_t *demo, int32_t frame_num, const void *data, size_t len) {
+
+	if (demo->size + DEMO_MESSAGE_HEADER_SIZE + len > DEMO_BLOCK_SIZE) {
+		Demo_WriteBlock(demo);
+	}
+
+	const int32_t header[] = { LittleLong(frame_num), LittleLong(len) };
+
+	memcpy(demo->block + demo->size, header, sizeof(header));
+	demo->size += sizeof(header);
+
+	memcpy(demo->block + demo->size, data, len);
+	demo->size += len;
+
+	demo->frame_num = frame_num;
+	demo->last_frame = MAX(demo->last_frame, frame_num);
+}
+
+/*
+ * @brief Writes the current block and begins a new one at the specified
+ * keyframe. The caller must follow this with messages that allow a client to
+ * resume from nothing, namely the config strings and an uncompressed frame.
+ */
+void Demo_BeginKeyframe(demo_t *demo, int32_t frame_num) {
+
+	Demo_WriteBlock(demo);
+
+	demo->keyframe = frame_num;
+}
+
+/*
+ * @brief Returns the last keyframe at or before the specified frame, or the
+ * first keyframe if there are none before it.
+ */
+static const demo_keyframe_t *Demo_FindKeyframe_(const demo_t *demo, int32_t frame_num) {
+
+	if (demo->keyframes->len == 0)
+		return NULL;
+
+	guint lo = 0, hi = demo->keyframes->len - 1;
+
+	while (lo < hi) {
+		const guint mid = (lo + hi + 1) / 2;
+
+		if (g_array_index(demo->keyframes, demo_keyframe_t, mid).frame_num <= frame_num)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	return &g_array_index(demo->keyframes, demo_keyframe_t, lo);
+}
+
+/*
+ * @return The keyframe Demo_Seek would resume from for the specified frame, or
+ * -1 if the demo can not seek.
+ */
+int32_t Demo_FindKeyframe(const demo_t *demo, int32_t frame_num) {
+
+	const demo_keyframe_t *k = Demo_FindKeyframe_(demo, frame_num);
+
+	return k ? k->frame_num : -1;
+}
+
+/*
+ * @brief Seeks to the last keyframe at or before the specified frame.
+ *
+ * @return The keyframe, or -1 if the demo can not seek.
+ */
+int32_t Demo_Seek(demo_t *demo, int32_t frame_num) {
+
+	if (demo->write)
+		return -1;
+
+	const demo_keyframe_t *k = Demo_FindKeyframe_(demo, frame_num);
+
+	if (!k)
+		return -1;
+
+	if (!Fs_Seek(demo->file, k->offset)) {
+		Com_Warn("Failed to seek to frame %d: %s\n", k->frame_num, Fs_LastError());
+		return -1;
+	}
+
+	if (!Demo_ReadBlock(demo))
+		return -1;
+
+	demo->frame_num = k->frame_num;
+	return k->frame_num;
+}
+
+/*
+ * @return The first keyframe of the demo, or -1 if it has none.
+ */
+int32_t Demo_FirstFrame(const demo_t *demo) {
+
+	if (demo->keyframes->len == 0)
+		return -1;
+
+	return g_array_index(demo->keyframes, demo_keyframe_t, 0).frame_num;
+}
+
+/*
+ * @return The last frame of the demo, or its last keyframe if it was not
+ * properly closed.
+ */
+int32_t Demo_LastFrame(const demo_t *demo) {
+	return demo->last_frame;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef __DEMO_H__
+#define __DEMO_H__
+
+#include "filesystem.h"
+
+/*
+ * @brief Indexed demos begin with this header, followed by blocks of
+ * messages. Demos without it are a flat stream of length-prefixed messages.
+ *
+ * [long] magic [long] version [long] flags [long] frame rate [long] index
+ */
+#define DEMO_MAGIC (('D' << 24) + ('W' << 16) + ('2' << 8) + 'Q')
+#define DEMO_VERSION 1
+
+/*
+ * @brief Demo flags.
+ */
+#define DEMO_COMPRESS 0x1 // blocks are deflated
+
+/*
+ * @brief Blocks are written at each keyframe, or before they would grow larger.
+ * Each block is preceded by [long] keyframe [long] size [long] stored size,
+ * where keyframe is -1 for blocks that do not begin with one. Messages within
+ * a block are [long] frame [long] size [size bytes].
+ */
+#define DEMO_BLOCK_SIZE (256 * 1024)
+
+/*
+ * @brief The index, written after the last block, maps keyframes to the file
+ * offsets of their blocks: [long] count [long] last frame, and count [long]
+ * frame [long] offset.
+ */
+typedef struct {
+	int32_t frame_num;
+	uint32_t offset;
+} demo_keyframe_t;
+
+/*
+ * @brief A demo file, open for reading or for writing.
+ */
+typedef struct {
+	file_t *file;
+	_Bool write;
+
+	uint32_t version; // 0 for flat demos, which can not seek
+	uint32_t flags;
+	uint32_t hz; // the server frame rate, for converting time to frames
+	uint32_t index; // the file offset of the index, or 0 if not yet written
+
+	GArray *keyframes;
+	int32_t last_frame;
+
+	byte *block; // the current block, inflated
+	size_t size; // the size of the current block
+	size_t read; // the read offset into the current block
+	int32_t keyframe; // the keyframe of the current block, or -1
+
+	int32_t frame_num; // the frame of the most recent message
+} demo_t;
+
+demo_t *Demo_OpenRead(const char *filename);
+demo_t *Demo_OpenWrite(const char *filename, uint32_t hz, uint32_t flags);
+void Demo_Close(demo_t *demo);
+int32_t Demo_ReadMessage(demo_t *demo, void *data, size_t len);
+void Demo_WriteMessage(demo_t *demo, int32_t frame_num, const void *data, size_t len);
+void Demo_BeginKeyframe(demo_t *demo, int32_t frame_num);
+int32_t Demo_FindKeyframe(const demo_t *demo, int32_t frame_num);
+int32_t Demo_Seek(demo_t *demo, int32_t frame_num);
+int32_t Demo_FirstFrame(const demo_t *demo);
+int32_t Demo_LastFrame(const demo_t *demo);
+
+#endif /* __DEMO_H__ */
@@ -249,7 +249,7 @@ void G_BulletProjectile(g_edict_t *ent, vec3_t start, vec3_t dir, int32_t damage
 		VectorMA(end, Randomc() * hspread, right, end);
 		VectorMA(end, Randomc() * vspread, up, end);
 
-		tr = gi.Trace(start, end, NULL, NULL, ent, MASK_SHOT);
+		tr = gi.RewindTrace(start, end, NULL, NULL, ent, MASK_SHOT, ent);
 	}
 
 	// send trails and marks
@@ -660,7 +660,7 @@ static void G_LightningProjectile_Think(g_edict_t *self) {
 	VectorMA(end, 10.0 * sin(g_level.time / 4.0), up, end);
 	VectorMA(end, 10.0 * Randomc(), right, end);
 
-	tr = gi.Trace(start, end, NULL, NULL, self, MASK_SHOT | MASK_WATER);
+	tr = gi.RewindTrace(start, end, NULL, NULL, self, MASK_SHOT | MASK_WATER, self->owner);
 
 	if (tr.contents & MASK_WATER) { // entered water, play sound, leave trail
 		VectorCopy(tr.end, water_start);
@@ -671,7 +671,7 @@ static void G_LightningProjectile_Think(g_edict_t *self) {
 			self->locals.water_level = 1;
 		}
 
-		tr = gi.Trace(water_start, end, NULL, NULL, self, MASK_SHOT);
+		tr = gi.RewindTrace(water_start, end, NULL, NULL, self, MASK_SHOT, self->owner);
 		G_BubbleTrail(water_start, &tr);
 	} else {
 		if (self->locals.water_level) { // exited water, play sound, no trail
@@ -759,7 +759,7 @@ void G_RailgunProjectile(g_edict_t *ent, vec3_t start, vec3_t aimdir, int32_t da
 	memset(&tr, 0, sizeof(tr));
 
 	while (ignore) {
-		tr = gi.Trace(from, end, NULL, NULL, ignore, content_mask);
+		tr = gi.RewindTrace(from, end, NULL, NULL, ignore, content_mask, ent);
 		if (!tr.ent) {
 			break;
 		}
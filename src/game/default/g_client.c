@@ -345,7 +345,7 @@ static void G_Give(g_client_t *client, char *it, int16_t quantity) {
 		client->locals.persistent.inventory[index] = 1;
 
 		if (item->ammo) {
-			const g_item_t *ammo = G_FindItem(item->ammo);
+			const g_item_t *ammo = G_AmmoForItem(item);
 			const uint16_t ammo_index = ITEM_INDEX(ammo);
 
 			if (quantity > -1)
@@ -1206,6 +1206,7 @@ static void G_ClientMove(g_edict_t *ent, user_cmd_t *cmd) {
 		if (!other->locals.Touch)
 			continue;
 
+		G_WakeEntity(other);
 		other->locals.Touch(other, ent, NULL, NULL);
 	}
 }
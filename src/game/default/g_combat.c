@@ -180,6 +180,8 @@ void G_Damage(g_edict_t *targ, g_edict_t *inflictor, g_edict_t *attacker, vec3_t
 	if (!targ->locals.take_damage)
 		return;
 
+	G_WakeEntity(targ);
+
 	if (targ != attacker && targ->client->locals.respawn_protection_time > g_level.time)
 		return;
 
@@ -311,18 +313,29 @@ void G_Damage(g_edict_t *targ, g_edict_t *inflictor, g_edict_t *attacker, vec3_t
 	}
 }
 
+static uint16_t g_radius_damage_scope;
+
 /*
- * @brief
+ * @brief Damages all entities within radius of the inflictor. Candidates are
+ * resolved in a single batch through the server's area nodes.
  */
 void G_RadiusDamage(g_edict_t *inflictor, g_edict_t *attacker, g_edict_t *ignore, int32_t damage,
 		int32_t knockback, vec_t radius, int32_t mod) {
-	g_edict_t *ent;
+	g_edict_t *ents[MAX_EDICTS];
 	vec_t d, k, dist;
 	vec3_t dir;
+	int32_t i;
+
+	gi.ProfileBegin(g_radius_damage_scope);
+
+	const int32_t count = gi.RadiusEdicts(inflictor->s.origin, radius, ents, MAX_EDICTS,
+			AREA_SOLID | AREA_TRIGGERS);
 
-	ent = NULL;
+	for (i = 0; i < count; i++) {
+		g_edict_t *ent = ents[i];
 
-	while ((ent = G_FindRadius(ent, inflictor->s.origin, radius)) != NULL) {
+		if (!ent->in_use) // freed by damage dealt earlier in this batch
+			continue;
 
 		if (ent == ignore)
 			continue;
@@ -352,4 +365,80 @@ void G_RadiusDamage(g_edict_t *inflictor, g_edict_t *attacker, g_edict_t *ignore
 		G_Damage(ent, inflictor, attacker, dir, ent->s.origin, vec3_origin, (int32_t) d,
 				(int32_t) k, DAMAGE_RADIUS, mod);
 	}
+
+	gi.ProfileEnd(g_radius_damage_scope);
+}
+
+static uint16_t g_bench_radius_scopes[2];
+
+/*
+ * @brief g_bench_radius [count] [radius]
+ *
+ * Simulates a frame with many simultaneous explosions, resolving the entities
+ * around count entity origins both through RadiusEdicts and by scanning every
+ * edict, as G_RadiusDamage once did. Enable sv_profile to compare the two.
+ */
+static void G_BenchRadius_f(void) {
+	g_edict_t *ents[MAX_EDICTS];
+	int32_t i, j, k, area, scan;
+
+	const int32_t count = gi.Argc() > 1 ? atoi(gi.Argv(1)) : 256;
+	const vec_t radius = gi.Argc() > 2 ? atof(gi.Argv(2)) : 150.0;
+
+	area = scan = 0;
+
+	for (i = 0, j = 1; i < count; i++) {
+		const g_edict_t *origin = NULL;
+
+		for (k = 0; k < ge.num_edicts && !origin; k++, j = (j + 1) % ge.num_edicts) {
+			if (g_game.edicts[j].in_use)
+				origin = &g_game.edicts[j];
+		}
+
+		if (!origin)
+			break;
+
+		gi.ProfileBegin(g_bench_radius_scopes[0]);
+
+		area += gi.RadiusEdicts(origin->s.origin, radius, ents, MAX_EDICTS,
+				AREA_SOLID | AREA_TRIGGERS);
+
+		gi.ProfileEnd(g_bench_radius_scopes[0]);
+
+		gi.ProfileBegin(g_bench_radius_scopes[1]);
+
+		const g_edict_t *ent = g_game.edicts;
+		for (k = 0; k < ge.num_edicts; k++, ent++) {
+			vec3_t delta;
+
+			if (!ent->in_use || ent->solid == SOLID_NOT)
+				continue;
+
+			VectorAdd(ent->mins, ent->maxs, delta);
+			VectorMA(ent->s.origin, 0.5, delta, delta);
+			VectorSubtract(origin->s.origin, delta, delta);
+
+			if (VectorLength(delta) <= radius)
+				scan++;
+		}
+
+		gi.ProfileEnd(g_bench_radius_scopes[1]);
+	}
+
+	gi.Print("%d queries of radius %1.0f: %d entities by area, %d by scan\n", i, radius, area,
+			scan);
+}
+
+/*
+ * @brief Resolves the profiling scopes and commands for combat.
+ */
+void G_InitCombat(void) {
+
+	g_radius_damage_scope = gi.ProfileScope("G_RadiusDamage");
+
+	g_bench_radius_scopes[0] = gi.ProfileScope("G_BenchRadius: area");
+	g_bench_radius_scopes[1] = gi.ProfileScope("G_BenchRadius: scan");
+
+	gi.Cmd("g_bench_radius", G_BenchRadius_f, CMD_GAME,
+			"Benchmarks radius queries for a frame of simultaneous explosions");
 }
@@ -31,6 +31,7 @@ void G_Damage(g_edict_t *targ, g_edict_t *inflictor, g_edict_t *attacker, vec3_t
 _Bool G_OnSameTeam(const g_edict_t *ent1, const g_edict_t *ent2);
 void G_RadiusDamage(g_edict_t *inflictor, g_edict_t *attacker, g_edict_t *ignore,
 		int32_t damage, int32_t knockback, vec_t radius, int32_t mod);
+void G_InitCombat(void);
 #endif /* __GAME_LOCAL_H__ */
 
 #endif /* G_COMBAT_H_ */
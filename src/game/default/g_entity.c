@@ -81,12 +81,22 @@ static g_edict_spawn_t g_edict_spawns[] = {
 
 		{ NULL, NULL } };
 
+/*
+ * @brief Lookup tables for spawning entities, resolved once in G_InitEntities.
+ */
+static struct {
+	GHashTable *spawns; // class names to g_edict_spawn_t
+	GHashTable *fields; // case-insensitive keys to g_field_t
+
+	uint16_t spawn_entities_scope;
+	uint16_t parse_entity_scope;
+} g_entity_state;
+
 /*
  * @brief Finds the spawn function for the entity and calls it.
  */
 static void G_SpawnEntity(g_edict_t *ent) {
-	g_edict_spawn_t *s;
-	int32_t i;
+	const g_edict_spawn_t *s;
 
 	if (!ent->class_name) {
 		gi.Debug("NULL classname\n");
@@ -94,24 +104,16 @@ static void G_SpawnEntity(g_edict_t *ent) {
 	}
 
 	// check item spawn functions
-	const g_item_t *item = g_items;
-	for (i = 0; i < g_num_items; i++, item++) {
-
-		if (!item->class_name)
-			continue;
-
-		if (!g_strcmp0(item->class_name, ent->class_name)) { // found it
-			G_SpawnItem(ent, item);
-			return;
-		}
+	const g_item_t *item = G_FindItemByClassName(ent->class_name);
+	if (item) {
+		G_SpawnItem(ent, item);
+		return;
 	}
 
 	// check normal spawn functions
-	for (s = g_edict_spawns; s->name; s++) {
-		if (!g_strcmp0(s->name, ent->class_name)) { // found it
-			s->Spawn(ent);
-			return;
-		}
+	if ((s = g_hash_table_lookup(g_entity_state.spawns, ent->class_name))) {
+		s->Spawn(ent);
+		return;
 	}
 
 	gi.Debug("%s doesn't have a spawn function\n", ent->class_name);
@@ -227,48 +229,44 @@ static void G_ParseField(const char *key, const char *value, g_edict_t *ent) {
 	vec_t v;
 	vec3_t vec;
 
-	for (f = fields; f->name; f++) {
+	if (!(f = g_hash_table_lookup(g_entity_state.fields, key))) {
+		//gi.Debug("%s is not a field\n", key);
+		return;
+	}
 
-		if (!(f->flags & FFL_NO_SPAWN) && !g_ascii_strcasecmp(f->name, key)) { // found it
+	if (f->flags & FFL_SPAWN_TEMP)
+		b = (byte *) &g_game.spawn;
+	else
+		b = (byte *) ent;
 
-			if (f->flags & FFL_SPAWN_TEMP)
-				b = (byte *) &g_game.spawn;
-			else
-				b = (byte *) ent;
-
-			switch (f->type) {
-				case F_SHORT:
-					*(int16_t *) (b + f->ofs) = (int16_t) atoi(value);
-					break;
-				case F_INT:
-					*(int32_t *) (b + f->ofs) = atoi(value);
-					break;
-				case F_FLOAT:
-					*(vec_t *) (b + f->ofs) = atof(value);
-					break;
-				case F_STRING:
-					*(char **) (b + f->ofs) = G_NewString(value);
-					break;
-				case F_VECTOR:
-					sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
-					((vec_t *) (b + f->ofs))[0] = vec[0];
-					((vec_t *) (b + f->ofs))[1] = vec[1];
-					((vec_t *) (b + f->ofs))[2] = vec[2];
-					break;
-				case F_ANGLE:
-					v = atof(value);
-					((vec_t *) (b + f->ofs))[0] = 0;
-					((vec_t *) (b + f->ofs))[1] = v;
-					((vec_t *) (b + f->ofs))[2] = 0;
-					break;
-				default:
-					break;
-			}
-			return;
-		}
+	switch (f->type) {
+		case F_SHORT:
+			*(int16_t *) (b + f->ofs) = (int16_t) atoi(value);
+			break;
+		case F_INT:
+			*(int32_t *) (b + f->ofs) = atoi(value);
+			break;
+		case F_FLOAT:
+			*(vec_t *) (b + f->ofs) = atof(value);
+			break;
+		case F_STRING:
+			*(char **) (b + f->ofs) = G_NewString(value);
+			break;
+		case F_VECTOR:
+			sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
+			((vec_t *) (b + f->ofs))[0] = vec[0];
+			((vec_t *) (b + f->ofs))[1] = vec[1];
+			((vec_t *) (b + f->ofs))[2] = vec[2];
+			break;
+		case F_ANGLE:
+			v = atof(value);
+			((vec_t *) (b + f->ofs))[0] = 0;
+			((vec_t *) (b + f->ofs))[1] = v;
+			((vec_t *) (b + f->ofs))[2] = 0;
+			break;
+		default:
+			break;
 	}
-
-	//gi.Debug("%s is not a field\n", key);
 }
 
 /*
@@ -281,6 +279,8 @@ static const char *G_ParseEntity(const char *data, g_edict_t *ent) {
 	char key[MAX_QPATH];
 	const char *tok;
 
+	gi.ProfileBegin(g_entity_state.parse_entity_scope);
+
 	init = false;
 	memset(&g_game.spawn, 0, sizeof(g_game.spawn));
 
@@ -317,6 +317,8 @@ static const char *G_ParseEntity(const char *data, g_edict_t *ent) {
 	if (!init)
 		memset(ent, 0, sizeof(*ent));
 
+	gi.ProfileEnd(g_entity_state.parse_entity_scope);
+
 	return data;
 }
 
@@ -395,10 +397,12 @@ static void G_InitMedia(void) {
  */
 void G_SpawnEntities(const char *name, const char *entities) {
 	g_edict_t *ent;
-	int32_t inhibit;
+	int32_t inhibit, count;
 	char *com_token;
 	int32_t i;
 
+	gi.ProfileBegin(g_entity_state.spawn_entities_scope);
+
 	gi.FreeTag(MEM_TAG_GAME_LEVEL);
 
 	memset(&g_level, 0, sizeof(g_level));
@@ -413,7 +417,7 @@ void G_SpawnEntities(const char *name, const char *entities) {
 	ge.num_edicts = sv_max_clients->integer + 1;
 
 	ent = NULL;
-	inhibit = 0;
+	inhibit = count = 0;
 
 	// parse ents
 	while (true) {
@@ -432,6 +436,7 @@ void G_SpawnEntities(const char *name, const char *entities) {
 			ent = G_Spawn(__func__);
 
 		entities = G_ParseEntity(entities, ent);
+		count++;
 
 		// handle legacy spawn flags
 		if (ent != g_game.edicts) {
@@ -458,7 +463,7 @@ void G_SpawnEntities(const char *name, const char *entities) {
 		}
 	}
 
-	gi.Debug("%i entities inhibited\n", inhibit);
+	gi.Debug("%i entities parsed, %i inhibited\n", count, inhibit);
 
 	G_InitEntityTeams();
 
@@ -467,6 +472,59 @@ void G_SpawnEntities(const char *name, const char *entities) {
 	G_ResetTeams();
 
 	G_ResetVote();
+
+	G_WakeEntities();
+
+	gi.ProfileEnd(g_entity_state.spawn_entities_scope);
+}
+
+/*
+ * @brief Builds the spawn function and field lookup tables. As when the tables
+ * were scanned, class names must match exactly, while field keys are matched
+ * regardless of case.
+ */
+void G_InitEntities(void) {
+	const g_edict_spawn_t *s;
+	const g_field_t *f;
+
+	memset(&g_entity_state, 0, sizeof(g_entity_state));
+
+	g_entity_state.spawns = g_hash_table_new(g_str_hash, g_str_equal);
+
+	for (s = g_edict_spawns; s->name; s++) {
+		if (!g_hash_table_lookup(g_entity_state.spawns, s->name))
+			g_hash_table_insert(g_entity_state.spawns, (gpointer) s->name, (gpointer) s);
+	}
+
+	g_entity_state.fields = g_hash_table_new(G_StrCaseHash, G_StrCaseEqual);
+
+	for (f = fields; f->name; f++) {
+
+		if (f->flags & FFL_NO_SPAWN)
+			continue;
+
+		if (!g_hash_table_lookup(g_entity_state.fields, f->name))
+			g_hash_table_insert(g_entity_state.fields, (gpointer) f->name, (gpointer) f);
+	}
+
+	g_entity_state.spawn_entities_scope = gi.ProfileScope("G_SpawnEntities");
+	g_entity_state.parse_entity_scope = gi.ProfileScope("G_ParseEntity");
+}
+
+/*
+ * @brief Frees the spawn function and field lookup tables.
+ */
+void G_ShutdownEntities(void) {
+
+	if (g_entity_state.spawns) {
+		g_hash_table_destroy(g_entity_state.spawns);
+	}
+
+	if (g_entity_state.fields) {
+		g_hash_table_destroy(g_entity_state.fields);
+	}
+
+	memset(&g_entity_state, 0, sizeof(g_entity_state));
 }
 
 /*
@@ -25,6 +25,8 @@
 #include "g_types.h"
 
 #ifdef __GAME_LOCAL_H__
+void G_InitEntities(void);
+void G_ShutdownEntities(void);
 void G_SpawnEntities(const char *name, const char *entities);
 #endif /* __GAME_LOCAL_H__ */
 
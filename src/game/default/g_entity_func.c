@@ -211,10 +211,14 @@ static void G_MoveInfo_Accelerative(g_edict_t *ent) {
 
 /*
  * @brief Sets up movement for the specified entity. Both constant and accelerative
- * movements are initiated through this function.
+ * movements are initiated through this function. Movers are often started by
+ * the touch of their trigger, or by another part of their team, while they
+ * sleep, so they are woken here.
  */
 static void G_MoveInfo_Init(g_edict_t *ent, vec3_t dest, void(*Done)(g_edict_t*)) {
 
+	G_WakeEntity(ent);
+
 	VectorClear(ent->locals.velocity);
 
 	VectorSubtract(dest, ent->s.origin, ent->locals.move_info.dir);
@@ -302,10 +306,13 @@ static void G_MoveInfo_Angular_Begin(g_edict_t *ent) {
 }
 
 /*
- * @brief
+ * @brief Sets up rotation for the specified entity, which is woken as in
+ * G_MoveInfo_Init.
  */
 static void G_MoveInfo_Angular_Init(g_edict_t *ent, void(*Done)(g_edict_t *)) {
 
+	G_WakeEntity(ent);
+
 	VectorClear(ent->locals.avelocity);
 
 	ent->locals.move_info.Done = Done;
@@ -23,6 +23,15 @@
 
 static void G_ItemDropToFloor(g_edict_t *ent);
 
+/*
+ * @brief Item lookup tables, resolved once in G_InitItems.
+ */
+static struct {
+	GHashTable *names; // case-insensitive item names
+	GHashTable *class_names;
+	const g_item_t *ammo[MAX_ITEMS]; // the ammo item for each weapon, or NULL
+} g_item_state;
+
 /*
  * @brief
  */
@@ -38,41 +47,30 @@ const g_item_t *G_ItemByIndex(uint16_t index) {
  * @brief
  */
 const g_item_t *G_FindItemByClassName(const char *class_name) {
-	int32_t i;
-
-	const g_item_t *it = g_items;
-	for (i = 0; i < g_num_items; i++, it++) {
-
-		if (!it->class_name)
-			continue;
 
-		if (!g_strcmp0(it->class_name, class_name))
-			return it;
-	}
+	if (!class_name)
+		return NULL;
 
-	return NULL;
+	return g_hash_table_lookup(g_item_state.class_names, class_name);
 }
 
 /*
  * @brief
  */
 const g_item_t *G_FindItem(const char *name) {
-	int32_t i;
 
 	if (!name)
 		return NULL;
 
-	const g_item_t *it = g_items;
-	for (i = 0; i < g_num_items; i++, it++) {
-
-		if (!it->name)
-			continue;
+	return g_hash_table_lookup(g_item_state.names, name);
+}
 
-		if (!g_ascii_strcasecmp(it->name, name))
-			return it;
-	}
+/*
+ * @brief Returns the ammo item used by the specified weapon, or NULL.
+ */
+const g_item_t *G_AmmoForItem(const g_item_t *item) {
 
-	return NULL;
+	return g_item_state.ammo[ITEM_INDEX(item)];
 }
 
 /*
@@ -640,7 +638,7 @@ g_edict_t *G_DropItem(g_edict_t *ent, const g_item_t *item) {
 	}
 
 	if (item->type == ITEM_WEAPON) {
-		const g_item_t *ammo = G_FindItem(item->ammo);
+		const g_item_t *ammo = G_AmmoForItem(item);
 		if (ammo)
 			dropped->locals.health = ammo->quantity;
 		else
@@ -741,7 +739,7 @@ void G_PrecacheItem(const g_item_t *it) {
 
 	// parse everything for its ammo
 	if (it->ammo && it->ammo[0]) {
-		const g_item_t *ammo = G_FindItem(it->ammo);
+		const g_item_t *ammo = G_AmmoForItem(it);
 		if (ammo != it)
 			G_PrecacheItem(ammo);
 	}
@@ -823,7 +821,7 @@ void G_SpawnItem(g_edict_t *ent, const g_item_t *item) {
 	}
 
 	if (ent->locals.item->type == ITEM_WEAPON) {
-		const g_item_t *ammo = G_FindItem(ent->locals.item->ammo);
+		const g_item_t *ammo = G_AmmoForItem(ent->locals.item);
 		if (ammo)
 			ent->locals.health = ammo->quantity;
 		else
@@ -1661,3 +1659,57 @@ const g_item_t g_items[] = {
 		"quad/attack.wav quad/expire.wav" }, };
 
 const uint16_t g_num_items = lengthof(g_items);
+
+/*
+ * @brief Builds the item lookup tables. Item names are matched regardless of
+ * case, as they are typed by players; class names come from the entity string.
+ */
+void G_InitItems(void) {
+	uint16_t i;
+
+	if (g_num_items > MAX_ITEMS) {
+		gi.Error("Too many items: %d > %d\n", g_num_items, MAX_ITEMS);
+	}
+
+	memset(&g_item_state, 0, sizeof(g_item_state));
+
+	g_item_state.names = g_hash_table_new(G_StrCaseHash, G_StrCaseEqual);
+	g_item_state.class_names = g_hash_table_new(g_str_hash, g_str_equal);
+
+	// walk backwards so that the first item to declare a name wins, as before
+	for (i = g_num_items; i-- > 0;) {
+		const g_item_t *it = &g_items[i];
+
+		if (it->name)
+			g_hash_table_insert(g_item_state.names, (gpointer) it->name, (gpointer) it);
+
+		if (it->class_name)
+			g_hash_table_insert(g_item_state.class_names, (gpointer) it->class_name, (gpointer) it);
+	}
+
+	for (i = 0; i < g_num_items; i++) {
+		const g_item_t *ammo = G_FindItem(g_items[i].ammo);
+
+		if (g_items[i].ammo && !ammo) {
+			gi.Error("%s has invalid ammo %s\n", g_items[i].name, g_items[i].ammo);
+		}
+
+		g_item_state.ammo[i] = ammo;
+	}
+}
+
+/*
+ * @brief Frees the item lookup tables.
+ */
+void G_ShutdownItems(void) {
+
+	if (g_item_state.names) {
+		g_hash_table_destroy(g_item_state.names);
+	}
+
+	if (g_item_state.class_names) {
+		g_hash_table_destroy(g_item_state.class_names);
+	}
+
+	memset(&g_item_state, 0, sizeof(g_item_state));
+}
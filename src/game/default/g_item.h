@@ -33,12 +33,15 @@ extern const uint16_t g_num_items;
 
 _Bool G_AddAmmo(g_edict_t *ent, const g_item_t *item, int16_t count);
 g_edict_t *G_DropItem(g_edict_t *ent, const g_item_t *item);
+const g_item_t *G_AmmoForItem(const g_item_t *item);
 const g_item_t *G_FindItem(const char *name);
 const g_item_t *G_FindItemByClassName(const char *class_name);
 const g_item_t *G_ItemByIndex(uint16_t index);
 void G_PrecacheItem(const g_item_t *it);
+void G_InitItems(void);
 void G_ResetFlag(g_edict_t *ent);
 void G_SetItemRespawn(g_edict_t *ent, uint32_t delay);
+void G_ShutdownItems(void);
 void G_SpawnItem(g_edict_t *ent, const g_item_t *item);
 _Bool G_SetAmmo(g_edict_t *ent, const g_item_t *item, int16_t count);
 void G_TossFlag(g_edict_t *self);
@@ -34,6 +34,7 @@ cvar_t *g_auto_join;
 cvar_t *g_capture_limit;
 cvar_t *g_cheats;
 cvar_t *g_ctf;
+cvar_t *g_entity_sleep;
 cvar_t *g_frag_limit;
 cvar_t *g_friendly_fire;
 cvar_t *g_gameplay;
@@ -159,6 +160,8 @@ static void G_ResetItems(void) {
 			}
 		}
 	}
+
+	G_WakeEntities();
 }
 
 /*
@@ -819,7 +822,6 @@ static void G_ExitLevel(void) {
  * Nothing would happen in Quake land if this weren't called.
  */
 static void G_Frame(void) {
-	int32_t i;
 	g_edict_t *ent;
 
 	g_level.frame_num++;
@@ -833,13 +835,12 @@ static void G_Frame(void) {
 		}
 	}
 
-	// treat each object in turn
-	// even the world gets a chance to think
-	ent = &g_game.edicts[0];
-	for (i = 0; i < ge.num_edicts; i++, ent++) {
+	G_BeginEntities();
 
-		if (!ent->in_use)
-			continue;
+	// treat each awake object in turn
+	// even the world gets a chance to think
+	for (ent = G_NextEntity(NULL); ent; ent = G_NextEntity(ent)) {
+		const int32_t i = ent - g_game.edicts;
 
 		g_level.current_entity = ent;
 
@@ -858,6 +859,8 @@ static void G_Frame(void) {
 			G_ClientBeginFrame(ent);
 		else
 			G_RunEntity(ent);
+
+		G_ScheduleEntity(ent);
 	}
 
 	// see if a vote has passed
@@ -1134,6 +1137,8 @@ void G_Init(void) {
 			"The capture limit per level");
 	g_cheats = gi.Cvar("g_cheats", "0", CVAR_SERVER_INFO, NULL);
 	g_ctf = gi.Cvar("g_ctf", "0", CVAR_SERVER_INFO, "Enables capture the flag gameplay");
+	g_entity_sleep = gi.Cvar("g_entity_sleep", "1", 0,
+			"Lets idle entities sleep until they think or are disturbed");
 	g_frag_limit = gi.Cvar("g_frag_limit", "30", CVAR_SERVER_INFO, "The frag limit per level");
 	g_friendly_fire = gi.Cvar("g_friendly_fire", "1", CVAR_SERVER_INFO, "Enables friendly fire");
 	g_gameplay = gi.Cvar("g_gameplay", "0", CVAR_SERVER_INFO,
@@ -1200,8 +1205,16 @@ void G_Init(void) {
 	ge.max_edicts = g_max_entities->integer;
 	ge.num_edicts = sv_max_clients->integer + 1;
 
+	G_InitItems();
+
+	G_InitEntities();
+
 	G_Ai_Init(); // initialize the AI
 
+	G_InitPhysics();
+
+	G_InitCombat();
+
 	// set these to false to avoid spurious game restarts and alerts on init
 	g_gameplay->modified = g_teams->modified = g_match->modified = g_rounds->modified
 			= g_ctf->modified = g_cheats->modified = g_frag_limit->modified
@@ -1224,6 +1237,10 @@ void G_Shutdown(void) {
 	mysql_close(mysql); // and db
 #endif
 
+	G_ShutdownEntities();
+
+	G_ShutdownItems();
+
 	gi.FreeTag(MEM_TAG_GAME_LEVEL);
 	gi.FreeTag(MEM_TAG_GAME);
 }
@@ -73,6 +73,7 @@ extern cvar_t *g_auto_join;
 extern cvar_t *g_capture_limit;
 extern cvar_t *g_cheats;
 extern cvar_t *g_ctf;
+extern cvar_t *g_entity_sleep;
 extern cvar_t *g_frag_limit;
 extern cvar_t *g_friendly_fire;
 extern cvar_t *g_gameplay;
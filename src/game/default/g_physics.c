@@ -99,6 +99,9 @@ static void G_Impact(g_edict_t *e1, c_trace_t *trace) {
 
 	e2 = trace->ent;
 
+	G_WakeEntity(e1);
+	G_WakeEntity(e2);
+
 	if (e1->locals.Touch && e1->solid != SOLID_NOT)
 		e1->locals.Touch(e1, e2, &trace->plane, trace->surface);
 
@@ -304,6 +307,8 @@ static _Bool G_Push(g_edict_t *pusher, vec3_t move, vec3_t amove) {
 		}
 
 		if ((pusher->locals.move_type == MOVE_TYPE_PUSH) || (check->locals.ground_entity == pusher)) {
+			G_WakeEntity(check);
+
 			// move this entity
 			g_pushed_p->ent = check;
 			VectorCopy(check->s.origin, g_pushed_p->origin);
@@ -551,11 +556,31 @@ static void G_Physics_Toss(g_edict_t *ent) {
 	}
 }
 
+static uint16_t g_physics_scopes[MOVE_TYPE_TOSS + 1];
+
+/*
+ * @brief Resolves the profiling scopes for G_RunEntity, one per move type.
+ */
+void G_InitPhysics(void) {
+
+	g_physics_scopes[MOVE_TYPE_NONE] = gi.ProfileScope("G_RunEntity: none");
+	g_physics_scopes[MOVE_TYPE_NO_CLIP] = gi.ProfileScope("G_RunEntity: no_clip");
+	g_physics_scopes[MOVE_TYPE_PUSH] = gi.ProfileScope("G_RunEntity: push");
+	g_physics_scopes[MOVE_TYPE_STOP] = gi.ProfileScope("G_RunEntity: stop");
+	g_physics_scopes[MOVE_TYPE_FLY] = gi.ProfileScope("G_RunEntity: fly");
+	g_physics_scopes[MOVE_TYPE_TOSS] = gi.ProfileScope("G_RunEntity: toss");
+}
+
 /*
  * @brief
  */
 void G_RunEntity(g_edict_t *ent) {
 
+	const uint16_t scope = ent->locals.move_type < lengthof(g_physics_scopes) ?
+			g_physics_scopes[ent->locals.move_type] : 0;
+
+	gi.ProfileBegin(scope);
+
 	switch ((int32_t) ent->locals.move_type) {
 		case MOVE_TYPE_PUSH:
 		case MOVE_TYPE_STOP:
@@ -575,4 +600,245 @@ void G_RunEntity(g_edict_t *ent) {
 			gi.Error("Bad move type %i\n", ent->locals.move_type);
 			break;
 	}
+
+	gi.ProfileEnd(scope);
+}
+
+#define G_THINK_WHEEL_SLOTS 256
+
+/*
+ * @brief The entity schedule. Entities which are awake are run each frame, in
+ * order of their number, exactly as if every slot were visited. Idle entities
+ * sleep until their next think, which is bucketed by frame on a timing wheel,
+ * or until they are disturbed by another entity. Numbers are stored offset by
+ * one in the wheel, so that zero terminates each list.
+ */
+static struct {
+	uint32_t awake[MAX_EDICTS / 32];
+
+	uint16_t wheel[G_THINK_WHEEL_SLOTS];
+	uint16_t next[MAX_EDICTS + 1], prev[MAX_EDICTS + 1];
+	uint32_t frame[MAX_EDICTS + 1]; // the frame on which each scheduled think is due
+} g_schedule;
+
+#define G_Awake(n) (g_schedule.awake[(n) >> 5] & (1u << ((n) & 31)))
+#define G_SetAwake(n) (g_schedule.awake[(n) >> 5] |= (1u << ((n) & 31)))
+#define G_ClearAwake(n) (g_schedule.awake[(n) >> 5] &= ~(1u << ((n) & 31)))
+
+/*
+ * @brief Removes the entity from the timing wheel, if it is on it.
+ */
+static void G_UnscheduleThink(const uint16_t num) {
+	const uint16_t n = num + 1;
+
+	if (!g_schedule.frame[n])
+		return;
+
+	if (g_schedule.prev[n])
+		g_schedule.next[g_schedule.prev[n]] = g_schedule.next[n];
+	else
+		g_schedule.wheel[g_schedule.frame[n] & (G_THINK_WHEEL_SLOTS - 1)] = g_schedule.next[n];
+
+	if (g_schedule.next[n])
+		g_schedule.prev[g_schedule.next[n]] = g_schedule.prev[n];
+
+	g_schedule.next[n] = g_schedule.prev[n] = 0;
+	g_schedule.frame[n] = 0;
+}
+
+/*
+ * @brief Adds the entity to the timing wheel, to be woken on the given frame.
+ */
+static void G_ScheduleThink(const uint16_t num, const uint32_t frame) {
+	const uint16_t n = num + 1;
+
+	G_UnscheduleThink(num);
+
+	uint16_t *head = &g_schedule.wheel[frame & (G_THINK_WHEEL_SLOTS - 1)];
+
+	g_schedule.next[n] = *head;
+	if (*head)
+		g_schedule.prev[*head] = n;
+
+	*head = n;
+	g_schedule.frame[n] = frame;
+}
+
+/*
+ * @brief Wakes the specified entity, so that it is run on the current frame
+ * if it has not yet been visited, or on the next. Team masters are woken with
+ * their slaves, as they run the team's thinks and moves.
+ */
+void G_WakeEntity(g_edict_t *ent) {
+
+	if (!ent)
+		return;
+
+	G_SetAwake(ent - g_game.edicts);
+
+	if (ent->locals.team_master && ent->locals.team_master != ent)
+		G_SetAwake(ent->locals.team_master - g_game.edicts);
+}
+
+/*
+ * @brief Clears the timing wheel and wakes every entity. This is called when
+ * entities are spawned or reset in bulk.
+ */
+void G_WakeEntities(void) {
+
+	memset(&g_schedule, 0, sizeof(g_schedule));
+	memset(g_schedule.awake, 0xff, sizeof(g_schedule.awake));
+}
+
+/*
+ * @brief Wakes the entities whose thinks are due this frame.
+ */
+void G_BeginEntities(void) {
+
+	if (g_entity_sleep->modified) {
+		g_entity_sleep->modified = false;
+		G_WakeEntities();
+	}
+
+	uint16_t n = g_schedule.wheel[g_level.frame_num & (G_THINK_WHEEL_SLOTS - 1)];
+	while (n) {
+		const uint16_t next = g_schedule.next[n];
+
+		if (g_schedule.frame[n] <= g_level.frame_num) {
+			G_UnscheduleThink(n - 1);
+			G_WakeEntity(&g_game.edicts[n - 1]);
+		}
+
+		n = next;
+	}
+}
+
+/*
+ * @brief Returns the next awake entity after the specified one, or the first
+ * if NULL. Freed entities fall asleep as they are encountered. Entities woken
+ * during the frame are returned if they have not yet been passed.
+ */
+g_edict_t *G_NextEntity(g_edict_t *ent) {
+	uint32_t n = ent ? (ent - g_game.edicts) + 1 : 0;
+
+	while (n < ge.num_edicts) {
+		const uint32_t bits = g_schedule.awake[n >> 5] >> (n & 31);
+
+		if (!bits) { // skip the rest of this word
+			n = (n | 31) + 1;
+			continue;
+		}
+
+		if (!(bits & 1)) {
+			n++;
+			continue;
+		}
+
+		g_edict_t *e = &g_game.edicts[n];
+
+		if (e->in_use)
+			return e;
+
+		if (n > (uint32_t) sv_max_clients->integer) // clients never sleep
+			G_ClearAwake(n);
+
+		n++;
+	}
+
+	return NULL;
+}
+
+/*
+ * @brief Returns true if the entity's velocities are zero.
+ */
+static _Bool G_IsStill(const g_edict_t *ent) {
+	return VectorCompare(ent->locals.velocity, vec3_origin)
+			&& VectorCompare(ent->locals.avelocity, vec3_origin);
+}
+
+/*
+ * @brief Returns true if running the entity would do nothing but think, and
+ * resolves the time of that think. This mirrors the G_Physics_ functions.
+ */
+static _Bool G_IsIdle(const g_edict_t *ent, uint32_t *think) {
+	const g_edict_t *part;
+
+	*think = ent->locals.next_think;
+
+	if (!VectorCompare(ent->s.origin, ent->s.old_origin))
+		return false;
+
+	if (ent->locals.ground_entity && ent->locals.ground_entity != g_game.edicts)
+		return false;
+
+	switch ((int32_t) ent->locals.move_type) {
+		case MOVE_TYPE_NONE:
+			return true;
+		case MOVE_TYPE_NO_CLIP:
+			return G_IsStill(ent);
+		case MOVE_TYPE_PUSH:
+		case MOVE_TYPE_STOP:
+			if (ent->locals.flags & FL_TEAM_SLAVE)
+				return true;
+
+			// the team master runs the thinks of all of its parts
+			for (part = ent; part; part = part->locals.team_chain) {
+
+				if (!G_IsStill(part))
+					return false;
+
+				const uint32_t t = part->locals.next_think;
+				if (t && (!*think || t < *think))
+					*think = t;
+			}
+			return true;
+		case MOVE_TYPE_FLY:
+		case MOVE_TYPE_TOSS:
+			if (ent->locals.flags & FL_TEAM_SLAVE)
+				return true;
+
+			if (ent->locals.ground_entity)
+				return ent->locals.velocity[2] <= 0.1;
+
+			return ent->locals.item && (ent->locals.spawn_flags & 4);
+		default:
+			return false;
+	}
+}
+
+/*
+ * @brief Called after the entity has run for this frame. Idle entities are put
+ * to sleep, and scheduled to wake on the frame their next think is due.
+ */
+void G_ScheduleEntity(g_edict_t *ent) {
+	uint32_t think;
+
+	if (!g_entity_sleep->integer)
+		return;
+
+	const uint16_t num = ent - g_game.edicts;
+
+	if (num && num <= sv_max_clients->integer)
+		return;
+
+	if (!ent->in_use) {
+		G_ClearAwake(num);
+		return;
+	}
+
+	if (!G_IsIdle(ent, &think))
+		return;
+
+	if (think) { // G_RunThink fires once the level time is within 1ms
+		const uint32_t frame = (think + gi.frame_millis - 2) / gi.frame_millis;
+
+		if (frame <= g_level.frame_num + 1)
+			return;
+
+		G_ScheduleThink(num, frame);
+	} else {
+		G_UnscheduleThink(num);
+	}
+
+	G_ClearAwake(num);
 }
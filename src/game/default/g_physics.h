@@ -25,7 +25,13 @@
 #include "g_types.h"
 
 #ifdef __GAME_LOCAL_H__
+void G_BeginEntities(void);
+void G_InitPhysics(void);
+g_edict_t *G_NextEntity(g_edict_t *ent);
 void G_RunEntity(g_edict_t *ent);
+void G_ScheduleEntity(g_edict_t *ent);
+void G_WakeEntities(void);
+void G_WakeEntity(g_edict_t *ent);
 #endif /* __GAME_LOCAL_H__ */
 
 #endif /* __GAME_PHYSICS_H__ */
@@ -120,40 +120,6 @@ g_edict_t *G_Find(g_edict_t *from, ptrdiff_t field, const char *match) {
 	return NULL;
 }
 
-/*
- * @brief Returns entities that have origins within a spherical area
- *
- * G_FindRadius(origin, radius)
- */
-g_edict_t *G_FindRadius(g_edict_t *from, vec3_t org, vec_t rad) {
-	vec3_t eorg;
-	int32_t j;
-
-	if (!from)
-		from = g_game.edicts;
-	else
-		from++;
-
-	for (; from < &g_game.edicts[ge.num_edicts]; from++) {
-
-		if (!from->in_use)
-			continue;
-
-		if (from->solid == SOLID_NOT)
-			continue;
-
-		for (j = 0; j < 3; j++)
-			eorg[j] = org[j] - (from->s.origin[j] + (from->mins[j] + from->maxs[j]) * 0.5);
-
-		if (VectorLength(eorg) > rad)
-			continue;
-
-		return from;
-	}
-
-	return NULL;
-}
-
 /*
  * @brief Searches all active entities for the next one that holds
  * the matching string at fieldofs(use the ELOFS() macro) in the structure.
@@ -264,6 +230,7 @@ void G_UseTargets(g_edict_t *ent, g_edict_t *activator) {
 			}
 
 			if (t->locals.Use) {
+				G_WakeEntity(t);
 				t->locals.Use(t, ent, activator);
 				if (!ent->in_use) { // see if our target freed us
 					gi.Debug("%s was removed while using targets\n", etos(ent));
@@ -294,6 +261,27 @@ void G_SetMoveDir(vec3_t angles, vec3_t move_dir) {
 	VectorClear(angles);
 }
 
+/*
+ * @brief Case-insensitive string hash, for tables keyed by map and user input.
+ */
+guint G_StrCaseHash(gconstpointer key) {
+	const char *s = (const char *) key;
+	guint hash = 5381;
+
+	while (*s) {
+		hash = (hash << 5) + hash + g_ascii_tolower(*s++);
+	}
+
+	return hash;
+}
+
+/*
+ * @brief Case-insensitive string equality, complementing G_StrCaseHash.
+ */
+gboolean G_StrCaseEqual(gconstpointer a, gconstpointer b) {
+	return g_ascii_strcasecmp((const char *) a, (const char *) b) == 0;
+}
+
 /*
  * @brief
  */
@@ -315,6 +303,8 @@ void G_InitEdict(g_edict_t *e, const char *class_name) {
 
 	e->locals.timestamp = g_level.time;
 	e->s.number = e - g_game.edicts;
+
+	G_WakeEntity(e);
 }
 
 /*
@@ -378,6 +368,7 @@ void G_TouchTriggers(g_edict_t *ent) {
 		if (!hit->locals.Touch)
 			continue;
 
+		G_WakeEntity(hit);
 		hit->locals.Touch(hit, ent, NULL, NULL);
 	}
 }
@@ -400,8 +391,10 @@ void G_TouchSolids(g_edict_t *ent) {
 		if (!hit->in_use)
 			continue;
 
-		if (ent->locals.Touch)
+		if (ent->locals.Touch) {
+			G_WakeEntity(hit);
 			ent->locals.Touch(hit, ent, NULL, NULL);
+		}
 
 		if (!ent->in_use)
 			break;
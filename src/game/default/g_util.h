@@ -30,7 +30,6 @@ _Bool G_KillBox(g_edict_t *ent);
 void G_ProjectSpawn(g_edict_t *ent);
 void G_InitProjectile(g_edict_t *ent, vec3_t forward, vec3_t right, vec3_t up, vec3_t org);
 g_edict_t *G_Find(g_edict_t *from, ptrdiff_t field, const char *match);
-g_edict_t *G_FindRadius(g_edict_t *from, vec3_t org, vec_t rad);
 g_edict_t *G_PickTarget(char *target_name);
 void G_UseTargets(g_edict_t *ent, g_edict_t *activator);
 void G_SetMoveDir(vec3_t angles, vec3_t movedir);
@@ -54,6 +53,8 @@ void G_TouchTriggers(g_edict_t *ent);
 void G_TouchSolids(g_edict_t *ent);
 c_trace_t G_PushEntity(g_edict_t *ent, vec3_t push);
 char *G_CopyString(char *in);
+guint G_StrCaseHash(gconstpointer key);
+gboolean G_StrCaseEqual(gconstpointer a, gconstpointer b);
 
 #endif /* __GAME_LOCAL_H__ */
 
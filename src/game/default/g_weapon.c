@@ -28,7 +28,7 @@ _Bool G_PickupWeapon(g_edict_t *ent, g_edict_t *other) {
 	int32_t delta;
 
 	const uint16_t index = ITEM_INDEX(ent->locals.item);
-	const g_item_t *ammo = G_FindItem(ent->locals.item->ammo);
+	const g_item_t *ammo = G_AmmoForItem(ent->locals.item);
 	const uint16_t ammo_index = ITEM_INDEX(ammo);
 
 	delta = ent->locals.health - other->client->locals.persistent.inventory[ammo_index];
@@ -75,7 +75,7 @@ void G_ChangeWeapon(g_edict_t *ent) {
 	// resolve ammo
 	if (ent->client->locals.persistent.weapon && ent->client->locals.persistent.weapon->ammo)
 		ent->client->locals.ammo_index
-				= ITEM_INDEX(G_FindItem(ent->client->locals.persistent.weapon->ammo));
+				= ITEM_INDEX(G_AmmoForItem(ent->client->locals.persistent.weapon));
 	else
 		ent->client->locals.ammo_index = 0;
 
@@ -158,7 +158,7 @@ void G_UseWeapon(g_edict_t *ent, const g_item_t *item) {
 		return;
 
 	if (item->ammo) { // ensure we have ammo
-		uint16_t index = ITEM_INDEX(G_FindItem(item->ammo));
+		uint16_t index = ITEM_INDEX(G_AmmoForItem(item));
 
 		if (!ent->client->locals.persistent.inventory[index]) {
 			gi.ClientPrint(ent, PRINT_HIGH, "Not enough ammo for %s\n", item->name);
@@ -184,7 +184,7 @@ void G_DropWeapon(g_edict_t *ent, const g_item_t *item) {
 		return;
 	}
 
-	const g_item_t *ammo = G_FindItem(item->ammo);
+	const g_item_t *ammo = G_AmmoForItem(item);
 	const uint16_t ammo_index = ITEM_INDEX(ammo);
 	if (ent->client->locals.persistent.inventory[ammo_index] <= 0) {
 		gi.ClientPrint(ent, PRINT_HIGH, "Can't drop a weapon without ammo\n");
@@ -24,7 +24,7 @@
 
 #include "shared.h"
 
-#define GAME_API_VERSION 1
+#define GAME_API_VERSION 4
 
 // edict->sv_flags
 #define SVF_NO_CLIENT 1  // don't send entity to clients
@@ -148,6 +148,11 @@ typedef struct {
 	int32_t (*PointContents)(const vec3_t point);
 	c_trace_t (*Trace)(const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs,
 			const g_edict_t *skip, const int32_t contents);
+	// like Trace, but clients are clipped where the shooting client last saw
+	// them, up to sv_max_rewind milliseconds ago, for hitscan weapons
+	c_trace_t (*RewindTrace)(const vec3_t start, const vec3_t end, const vec3_t mins,
+			const vec3_t maxs, const g_edict_t *skip, const int32_t contents,
+			const g_edict_t *shooter);
 
 	// PVS / PHS
 	_Bool (*inPVS)(const vec3_t p1, const vec3_t p2);
@@ -162,6 +167,11 @@ typedef struct {
 	void (*UnlinkEdict)(g_edict_t *ent); // call before removing an interactive edict
 	int32_t (*AreaEdicts)(const vec3_t mins, const vec3_t maxs, g_edict_t **area_edicts,
 			const int32_t max_area_edicts, const int32_t area_type);
+	// like AreaEdicts, but returns only those entities whose bounding box
+	// centers lie within radius of origin, in entity number order; area_type
+	// is a mask of AREA_SOLID and AREA_TRIGGERS
+	int32_t (*RadiusEdicts)(const vec3_t origin, const vec_t radius, g_edict_t **area_edicts,
+			const int32_t max_area_edicts, const int32_t area_type);
 
 	// network messaging
 	void (*Multicast)(const vec3_t origin, multicast_t to);
@@ -182,6 +192,12 @@ typedef struct {
 	void (*BroadcastPrint)(const int32_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
 	void (*ClientPrint)(const g_edict_t *ent, const int32_t level, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
 
+	// profiling scopes are resolved by name once, and timed by the server
+	// only while sv_profile is active
+	uint16_t (*ProfileScope)(const char *name);
+	void (*ProfileBegin)(const uint16_t scope);
+	void (*ProfileEnd)(const uint16_t scope);
+
 } g_import_t;
 
 // functions exported by the game subsystem
@@ -86,6 +86,24 @@ static SDL_PixelFormat img_pixel_format = {
 // image formats, tried in this order
 static const char *img_formats[] = { "tga", "png", "jpg", "wal", "pcx", NULL };
 
+/*
+ * @brief Returns true if an image by the specified name exists in any of the
+ * supported formats. The image is not loaded.
+ */
+_Bool Img_Exists(const char *name) {
+	char path[MAX_QPATH];
+	int32_t i;
+
+	for (i = 0; img_formats[i]; i++) {
+		g_snprintf(path, sizeof(path), "%s.%s", name, img_formats[i]);
+
+		if (Fs_Exists(path))
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * @brief Loads the specified image from the game filesystem and populates
  * the provided SDL_Surface. Image formats are tried in the order they appear
@@ -194,6 +212,9 @@ _Bool Img_LoadTypedImage(const char *name, const char *type, SDL_Surface **surf)
 
 /*
  * @brief Initializes the 8bit color palette required for .wal texture loading.
+ * The renderer calls this before any images are decoded on the thread pool,
+ * so the palette is marked initialized even if it fails to load, lest a decode
+ * lazily load it again concurrently.
  */
 void Img_InitPalette(void) {
 	SDL_Surface *surf;
@@ -201,8 +222,11 @@ void Img_InitPalette(void) {
 	uint32_t v;
 	int32_t i;
 
-	if (!Img_LoadTypedImage(IMG_PALETTE, "pcx", &surf))
+	if (!Img_LoadTypedImage(IMG_PALETTE, "pcx", &surf)) {
+		Com_Warn("Failed to load %s\n", IMG_PALETTE);
+		img_palette_initialized = true;
 		return;
+	}
 
 	for (i = 0; i < IMG_PALETTE_SIZE; i++) {
 		r = surf->format->palette->colors[i].r;
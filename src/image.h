@@ -34,6 +34,7 @@
 typedef uint32_t img_palette_t[IMG_PALETTE_SIZE];
 extern img_palette_t img_palette;
 
+_Bool Img_Exists(const char *name);
 _Bool Img_LoadImage(const char *name, SDL_Surface **surf);
 _Bool Img_LoadTypedImage(const char *name, const char *type, SDL_Surface **surf);
 void Img_InitPalette(void);
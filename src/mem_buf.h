@@ -34,6 +34,8 @@ typedef struct {
 	size_t max_size; // maximum size before overflow
 	size_t size; // current size
 	size_t read;
+	uint8_t bits; // bits written to the last byte, 0 when byte aligned
+	uint8_t read_bits; // bits read from the last byte, 0 when byte aligned
 } mem_buf_t;
 
 void Mem_InitBuffer(mem_buf_t *buf, byte *data, size_t len);
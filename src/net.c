@@ -33,6 +33,10 @@
 #include "net.h"
 
 in_addr_t net_lo;
+cvar_t *net_loss;
+cvar_t *net_latency;
+cvar_t *net_jitter;
+cvar_t *net_rate;
 
 /*
  * @return A printable error string for the most recent OS-level network error.
@@ -218,6 +222,12 @@ void Net_Init(void) {
 	// assign a small random number for the qport
 	Cvar_Get("net_qport", va("%d", Sys_Milliseconds() & 255), CVAR_NO_SET, NULL);
 
+	// network simulation, applied to outgoing loopback and UDP datagrams
+	net_loss = Cvar_Get("net_loss", "0", 0, "Simulated packet loss percentage");
+	net_latency = Cvar_Get("net_latency", "0", 0, "Simulated one-way latency in milliseconds");
+	net_jitter = Cvar_Get("net_jitter", "0", 0, "Simulated random latency in milliseconds");
+	net_rate = Cvar_Get("net_rate", "0", 0, "Simulated bandwidth in bytes per second");
+
 	net_lo = inet_addr("127.0.0.1");
 }
 
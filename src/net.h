@@ -76,6 +76,10 @@ typedef enum {
 } net_src_t;
 
 extern in_addr_t net_lo;
+extern cvar_t *net_loss;
+extern cvar_t *net_latency;
+extern cvar_t *net_jitter;
+extern cvar_t *net_rate;
 
 /*
  * @brief Max length of a single packet, due to UDP fragmentation. No single
@@ -0,0 +1,344 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "net_frame.h"
+
+/*
+ * @brief Returns the entity state at the specified index of the frame.
+ */
+const entity_state_t *Net_EntityState(const net_entities_t *entities, uint32_t index) {
+	return &entities->states[(entities->first + index) % entities->num_states];
+}
+
+/*
+ * @brief Writes a delta update of the frame's entities to the message. Entities
+ * present in the delta frame are delta compressed from it, and all others from
+ * the specified baselines. Clients using PROTOCOL receive the bit-packed
+ * encoding, others the byte-aligned one.
+ *
+ * @param from The delta frame, or NULL for an uncompressed frame.
+ * @param num_clients The old origins of entities numbered up to this are always
+ * written, as they are for newly visible entities.
+ */
+void Net_WriteEntities(mem_buf_t *msg, const net_entities_t *from, const net_entities_t *to,
+		const entity_state_t *baselines, uint16_t num_clients, int32_t protocol) {
+
+	const _Bool packed = protocol == PROTOCOL;
+	const uint16_t from_num_entities = from ? from->num_entities : 0;
+	uint16_t last_num = 0;
+
+	uint32_t old_index = 0, new_index = 0;
+	while (new_index < to->num_entities || old_index < from_num_entities) {
+		const entity_state_t *old_state = NULL, *new_state = NULL;
+		uint16_t old_num = 0xffff, new_num = 0xffff;
+
+		if (new_index < to->num_entities) {
+			new_state = Net_EntityState(to, new_index);
+			new_num = new_state->number;
+		}
+
+		if (old_index < from_num_entities) {
+			old_state = Net_EntityState(from, old_index);
+			old_num = old_state->number;
+		}
+
+		if (new_num == old_num) { // delta update from old position
+			const _Bool is_new = new_num <= num_clients;
+
+			if (packed)
+				Net_WritePackedDeltaEntity(msg, old_state, new_state, false, is_new, &last_num);
+			else
+				Net_WriteDeltaEntity(msg, old_state, new_state, false, is_new);
+
+			old_index++;
+			new_index++;
+		} else if (new_num < old_num) { // this is a new entity, send it from the baseline
+			const entity_state_t *baseline = &baselines[new_num];
+
+			if (packed)
+				Net_WritePackedDeltaEntity(msg, baseline, new_state, true, true, &last_num);
+			else
+				Net_WriteDeltaEntity(msg, baseline, new_state, true, true);
+
+			new_index++;
+		} else { // the old entity isn't present in the new message
+			if (packed) {
+				Net_WritePackedEntityHeader(msg, &last_num, old_num, U_REMOVE);
+			} else {
+				Net_WriteShort(msg, old_num);
+				Net_WriteShort(msg, U_REMOVE);
+			}
+
+			old_index++;
+		}
+	}
+
+	if (packed)
+		Net_WritePackedEntityEnd(msg);
+	else
+		Net_WriteShort(msg, 0); // end of entities
+}
+
+/*
+ * @brief Reads an entity delta from the specified base, appending the resulting
+ * entity state to the frame.
+ */
+static void Net_ReadEntity(mem_buf_t *msg, net_entities_t *to, const entity_state_t *from,
+		uint16_t number, uint16_t bits, int32_t protocol) {
+
+	entity_state_t *state = &to->states[(to->first + to->num_entities) % to->num_states];
+	to->num_entities++;
+
+	if (protocol == PROTOCOL)
+		Net_ReadPackedDeltaEntity(msg, from, state, number, bits);
+	else
+		Net_ReadDeltaEntity(msg, from, state, number, bits);
+}
+
+/*
+ * @brief Advances to the next entity state of the delta frame.
+ */
+static void Net_NextOldState(const net_entities_t *from, uint32_t *old_index,
+		const entity_state_t **old_state, uint16_t *old_number) {
+
+	if (!from || ++(*old_index) >= from->num_entities) {
+		*old_number = 0xffff;
+	} else {
+		*old_state = Net_EntityState(from, *old_index);
+		*old_number = (*old_state)->number;
+	}
+}
+
+/*
+ * @brief Reads a delta update written by Net_WriteEntities. The entity states
+ * are appended to the ring at to->first, and to->num_entities is set. The caller
+ * advances its ring past them.
+ *
+ * @param show Print each entity as it is parsed.
+ */
+void Net_ReadEntities(mem_buf_t *msg, const net_entities_t *from, net_entities_t *to,
+		const entity_state_t *baselines, int32_t protocol, _Bool show) {
+	const entity_state_t *old_state = NULL;
+	uint32_t old_index = 0;
+	uint16_t old_number = 0xffff, last_number = 0;
+
+	to->num_entities = 0;
+
+	if (from && from->num_entities) {
+		old_state = Net_EntityState(from, 0);
+		old_number = old_state->number;
+	}
+
+	while (true) {
+		uint16_t number, bits;
+
+		if (protocol == PROTOCOL) {
+			number = Net_ReadPackedEntityHeader(msg, &last_number, &bits);
+		} else {
+			number = Net_ReadShort(msg);
+			bits = number ? Net_ReadShort(msg) : 0;
+		}
+
+		if (number >= MAX_EDICTS)
+			Com_Error(ERR_DROP, "Bad number: %i\n", number);
+
+		if (msg->read > msg->size)
+			Com_Error(ERR_DROP, "End of message\n");
+
+		if (!number)
+			break;
+
+		while (old_number < number) { // one or more entities from the delta frame are unchanged
+
+			if (show)
+				Com_Print("   unchanged: %i\n", old_number);
+
+			Net_ReadEntity(msg, to, old_state, old_number, 0, protocol);
+			Net_NextOldState(from, &old_index, &old_state, &old_number);
+		}
+
+		if (bits & U_REMOVE) { // present in the delta frame, but not in this one
+
+			if (show)
+				Com_Print("   remove: %i\n", number);
+
+			if (old_number != number)
+				Com_Warn("U_REMOVE: %u != %u\n", old_number, number);
+
+			Net_NextOldState(from, &old_index, &old_state, &old_number);
+			continue;
+		}
+
+		if (old_number == number) { // delta from the previous state
+
+			if (show)
+				Com_Print("   delta: %i\n", number);
+
+			Net_ReadEntity(msg, to, old_state, number, bits, protocol);
+			Net_NextOldState(from, &old_index, &old_state, &old_number);
+			continue;
+		}
+
+		// delta from the baseline
+
+		if (show)
+			Com_Print("   baseline: %i\n", number);
+
+		Net_ReadEntity(msg, to, &baselines[number], number, bits, protocol);
+	}
+
+	while (old_number != 0xffff) { // any remaining entities in the delta frame are unchanged
+
+		if (show)
+			Com_Print("   unchanged: %i\n", old_number);
+
+		Net_ReadEntity(msg, to, old_state, old_number, 0, protocol);
+		Net_NextOldState(from, &old_index, &old_state, &old_number);
+	}
+}
+
+/*
+ * @brief Returns the baselines which entities absent from the delta frame are
+ * delta compressed from.
+ */
+const entity_state_t *Net_Baselines(const net_baseline_t *baseline,
+		const entity_state_t *map_baselines) {
+
+	if (baseline->frame_num)
+		return baseline->entities;
+
+	return map_baselines;
+}
+
+/*
+ * @brief Folds the specified frame into a copy of the baselines, which await
+ * acknowledgement as the pending baselines.
+ *
+ * @param next_state The next entity state to be written to the frame's ring.
+ *
+ * @return False if the frame's entity states may have been overwritten.
+ */
+_Bool Net_FoldBaseline(net_baseline_t *pending, const net_baseline_t *baseline,
+		const entity_state_t *map_baselines, const net_entities_t *entities, uint32_t next_state,
+		const player_state_t *ps, int32_t frame_num) {
+	uint32_t i;
+
+	if (next_state - entities->first > entities->num_states - MAX_PACKET_ENTITIES)
+		return false;
+
+	if (baseline->frame_num) {
+		*pending = *baseline;
+	} else {
+		memcpy(pending->entities, map_baselines, sizeof(pending->entities));
+		memset(&pending->ps, 0, sizeof(pending->ps));
+	}
+
+	for (i = 0; i < entities->num_entities; i++) {
+		const entity_state_t *s = Net_EntityState(entities, i);
+		pending->entities[s->number] = *s;
+	}
+
+	pending->ps = *ps;
+	pending->frame_num = frame_num;
+
+	return true;
+}
+
+/*
+ * @brief Folds the client's most recently acknowledged frame into its pending
+ * baselines, at most every NET_BASELINE_INTERVAL frames. The frame number is
+ * sent to the client, which does the same, and acknowledges the result. See
+ * Net_AcknowledgeBaseline.
+ *
+ * @param frame_num The frame being written.
+ * @param last_frame The frame the client last acknowledged, whose entities and
+ * player state are given.
+ */
+void Net_UpdateBaseline(net_baseline_t *pending, const net_baseline_t *baseline,
+		const entity_state_t *map_baselines, int32_t frame_num, int32_t last_frame,
+		const net_entities_t *entities, uint32_t next_state, const player_state_t *ps) {
+
+	if (pending->frame_num) {
+		if (frame_num - pending->frame_num < PACKET_BACKUP - 3)
+			return; // still waiting
+
+		pending->frame_num = 0; // the client may no longer have the frame, try again
+	}
+
+	if (last_frame <= 0 || frame_num - last_frame >= PACKET_BACKUP - 3)
+		return;
+
+	if (last_frame - baseline->frame_num < NET_BASELINE_INTERVAL)
+		return;
+
+	Net_FoldBaseline(pending, baseline, map_baselines, entities, next_state, ps, last_frame);
+}
+
+/*
+ * @brief Promotes the pending baselines once the client has folded them too.
+ */
+void Net_AcknowledgeBaseline(net_baseline_t *baseline, net_baseline_t *pending, int32_t frame_num) {
+
+	if (frame_num && frame_num == pending->frame_num) {
+		*baseline = *pending;
+		pending->frame_num = 0;
+	}
+}
+
+/*
+ * @brief Writes the frame numbers of the baselines new entities are delta
+ * compressed from, and of those the client should fold.
+ */
+void Net_WriteBaselines(mem_buf_t *msg, const net_baseline_t *baseline,
+		const net_baseline_t *pending) {
+
+	Net_WriteLong(msg, baseline->frame_num);
+	Net_WriteLong(msg, pending->frame_num);
+}
+
+/*
+ * @brief Reads the baselines written by Net_WriteBaselines, promoting our
+ * pending baselines or reverting to the map baselines as the server has.
+ *
+ * @return The frame the server asks us to fold, or 0 if there is none or it has
+ * already been folded. See Net_FoldBaseline.
+ */
+int32_t Net_ReadBaselines(mem_buf_t *msg, net_baseline_t *baseline, net_baseline_t *pending) {
+
+	const int32_t baseline_num = Net_ReadLong(msg);
+	const int32_t pending_num = Net_ReadLong(msg);
+
+	if (baseline_num != baseline->frame_num) {
+		if (baseline_num == 0) { // the server has reverted to the map baselines
+			baseline->frame_num = 0;
+			pending->frame_num = 0;
+		} else if (baseline_num == pending->frame_num) {
+			*baseline = *pending;
+		} else {
+			Com_Error(ERR_DROP, "Missing baseline %d\n", baseline_num);
+		}
+	}
+
+	if (pending_num == pending->frame_num)
+		return 0;
+
+	return pending_num;
+}
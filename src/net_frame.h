@@ -0,0 +1,72 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef __NET_FRAME_H__
+#define __NET_FRAME_H__
+
+#include "net_message.h"
+
+/*
+ * @brief The entity states of a frame. These are a window of a ring of entity
+ * states, which is accumulated over many frames by both the server and client.
+ */
+typedef struct {
+	entity_state_t *states; // the ring
+	uint32_t num_states; // the size of the ring
+	uint32_t first; // the index (not wrapped) of the frame's first entity state
+	uint16_t num_entities;
+} net_entities_t;
+
+/*
+ * @brief Entity and player state baselines. Entities absent from the delta frame,
+ * or all entities when there is none, are delta compressed from these rather than
+ * from the map baselines, so that packet loss does not force full updates. The
+ * server and client each fold a frame the client has received into a copy of
+ * their baselines, which the server promotes once the client acknowledges it.
+ * Only PROTOCOL maintains them.
+ */
+typedef struct {
+	int32_t frame_num; // the frame last folded into these baselines, 0 for the map's
+	entity_state_t entities[MAX_EDICTS];
+	player_state_t ps;
+} net_baseline_t;
+
+#define NET_BASELINE_INTERVAL (PACKET_BACKUP / 2) // frames between baseline updates
+
+const entity_state_t *Net_EntityState(const net_entities_t *entities, uint32_t index);
+void Net_WriteEntities(mem_buf_t *msg, const net_entities_t *from, const net_entities_t *to,
+		const entity_state_t *baselines, uint16_t num_clients, int32_t protocol);
+void Net_ReadEntities(mem_buf_t *msg, const net_entities_t *from, net_entities_t *to,
+		const entity_state_t *baselines, int32_t protocol, _Bool show);
+const entity_state_t *Net_Baselines(const net_baseline_t *baseline,
+		const entity_state_t *map_baselines);
+_Bool Net_FoldBaseline(net_baseline_t *pending, const net_baseline_t *baseline,
+		const entity_state_t *map_baselines, const net_entities_t *entities, uint32_t next_state,
+		const player_state_t *ps, int32_t frame_num);
+void Net_UpdateBaseline(net_baseline_t *pending, const net_baseline_t *baseline,
+		const entity_state_t *map_baselines, int32_t frame_num, int32_t last_frame,
+		const net_entities_t *entities, uint32_t next_state, const player_state_t *ps);
+void Net_AcknowledgeBaseline(net_baseline_t *baseline, net_baseline_t *pending, int32_t frame_num);
+void Net_WriteBaselines(mem_buf_t *msg, const net_baseline_t *baseline,
+		const net_baseline_t *pending);
+int32_t Net_ReadBaselines(mem_buf_t *msg, net_baseline_t *baseline, net_baseline_t *pending);
+
+#endif /* __NET_FRAME_H__ */
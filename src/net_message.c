@@ -72,6 +72,28 @@ void Net_WriteLong(mem_buf_t *sb, const int32_t c) {
 	buf[3] = c >> 24;
 }
 
+/*
+ * @brief Writes the low `bits` bits of `value` to the buffer, least significant
+ * bit first. Subsequent byte-level writes resume on the next byte boundary.
+ */
+void Net_WriteBits(mem_buf_t *buf, uint32_t value, uint8_t bits) {
+
+	while (bits) {
+		if (buf->bits == 0) {
+			*(byte *) Mem_AllocBuffer(buf, 1) = 0;
+		}
+
+		const uint8_t n = MIN(bits, 8 - buf->bits);
+		const uint32_t mask = (1 << n) - 1;
+
+		buf->data[buf->size - 1] |= (value & mask) << buf->bits;
+		buf->bits = (buf->bits + n) & 7;
+
+		value >>= n;
+		bits -= n;
+	}
+}
+
 /*
  * @brief
  */
@@ -179,11 +201,132 @@ void Net_WriteDeltaUserCmd(mem_buf_t *buf, const user_cmd_t *from, const user_cm
 }
 
 /*
- * @brief Writes an entity's state changes to a net message. Can delta from
- * either a baseline or a previous packet_entity
+ * @brief Writes the delta between two player states to a net message.
  */
-void Net_WriteDeltaEntity(mem_buf_t *buf, const entity_state_t *from, const entity_state_t *to,
-		_Bool force, _Bool is_new) {
+void Net_WriteDeltaPlayerState(mem_buf_t *buf, const player_state_t *from, const player_state_t *to) {
+	uint16_t pm_state_bits;
+	uint32_t stat_bits;
+	int32_t i;
+
+	// determine what needs to be sent
+	pm_state_bits = 0;
+
+	if (to->pm_state.type != from->pm_state.type)
+		pm_state_bits |= PS_PM_TYPE;
+
+	if (to->pm_state.origin[0] != from->pm_state.origin[0] || to->pm_state.origin[1]
+			!= from->pm_state.origin[1] || to->pm_state.origin[2] != from->pm_state.origin[2])
+		pm_state_bits |= PS_PM_ORIGIN;
+
+	if (to->pm_state.velocity[0] != from->pm_state.velocity[0] || to->pm_state.velocity[1]
+			!= from->pm_state.velocity[1] || to->pm_state.velocity[2] != from->pm_state.velocity[2])
+		pm_state_bits |= PS_PM_VELOCITY;
+
+	if (to->pm_state.flags != from->pm_state.flags)
+		pm_state_bits |= PS_PM_FLAGS;
+
+	if (to->pm_state.time != from->pm_state.time)
+		pm_state_bits |= PS_PM_TIME;
+
+	if (to->pm_state.gravity != from->pm_state.gravity)
+		pm_state_bits |= PS_PM_GRAVITY;
+
+	if (to->pm_state.view_offset[0] != from->pm_state.view_offset[0] || to->pm_state.view_offset[1]
+			!= from->pm_state.view_offset[1] || to->pm_state.view_offset[2]
+			!= from->pm_state.view_offset[2])
+		pm_state_bits |= PS_PM_VIEW_OFFSET;
+
+	if (to->pm_state.view_angles[0] != from->pm_state.view_angles[0] || to->pm_state.view_angles[1]
+			!= from->pm_state.view_angles[1] || to->pm_state.view_angles[2]
+			!= from->pm_state.view_angles[2])
+		pm_state_bits |= PS_PM_VIEW_ANGLES;
+
+	if (to->pm_state.kick_angles[0] != from->pm_state.kick_angles[0] || to->pm_state.kick_angles[1]
+			!= from->pm_state.kick_angles[1] || to->pm_state.kick_angles[2]
+			!= from->pm_state.kick_angles[2])
+		pm_state_bits |= PS_PM_KICK_ANGLES;
+
+	if (to->pm_state.delta_angles[0] != from->pm_state.delta_angles[0]
+			|| to->pm_state.delta_angles[1] != from->pm_state.delta_angles[1]
+			|| to->pm_state.delta_angles[2] != from->pm_state.delta_angles[2])
+		pm_state_bits |= PS_PM_DELTA_ANGLES;
+
+	// write it
+	Net_WriteShort(buf, pm_state_bits);
+
+	// write the pm_state_t
+	if (pm_state_bits & PS_PM_TYPE)
+		Net_WriteByte(buf, to->pm_state.type);
+
+	if (pm_state_bits & PS_PM_ORIGIN) {
+		Net_WriteShort(buf, to->pm_state.origin[0]);
+		Net_WriteShort(buf, to->pm_state.origin[1]);
+		Net_WriteShort(buf, to->pm_state.origin[2]);
+	}
+
+	if (pm_state_bits & PS_PM_VELOCITY) {
+		Net_WriteShort(buf, to->pm_state.velocity[0]);
+		Net_WriteShort(buf, to->pm_state.velocity[1]);
+		Net_WriteShort(buf, to->pm_state.velocity[2]);
+	}
+
+	if (pm_state_bits & PS_PM_FLAGS)
+		Net_WriteShort(buf, to->pm_state.flags);
+
+	if (pm_state_bits & PS_PM_TIME)
+		Net_WriteShort(buf, to->pm_state.time);
+
+	if (pm_state_bits & PS_PM_GRAVITY)
+		Net_WriteShort(buf, to->pm_state.gravity);
+
+	if (pm_state_bits & PS_PM_VIEW_OFFSET) {
+		Net_WriteShort(buf, to->pm_state.view_offset[0]);
+		Net_WriteShort(buf, to->pm_state.view_offset[1]);
+		Net_WriteShort(buf, to->pm_state.view_offset[2]);
+	}
+
+	if (pm_state_bits & PS_PM_VIEW_ANGLES) {
+		Net_WriteShort(buf, to->pm_state.view_angles[0]);
+		Net_WriteShort(buf, to->pm_state.view_angles[1]);
+		Net_WriteShort(buf, to->pm_state.view_angles[2]);
+	}
+
+	if (pm_state_bits & PS_PM_KICK_ANGLES) {
+		Net_WriteShort(buf, to->pm_state.kick_angles[0]);
+		Net_WriteShort(buf, to->pm_state.kick_angles[1]);
+		Net_WriteShort(buf, to->pm_state.kick_angles[2]);
+	}
+
+	if (pm_state_bits & PS_PM_DELTA_ANGLES) {
+		Net_WriteShort(buf, to->pm_state.delta_angles[0]);
+		Net_WriteShort(buf, to->pm_state.delta_angles[1]);
+		Net_WriteShort(buf, to->pm_state.delta_angles[2]);
+	}
+
+	// send stats
+	stat_bits = 0;
+
+	for (i = 0; i < MAX_STATS; i++) {
+		if (to->stats[i] != from->stats[i]) {
+			stat_bits |= 1 << i;
+		}
+	}
+
+	Net_WriteLong(buf, stat_bits);
+
+	for (i = 0; i < MAX_STATS; i++) {
+		if (stat_bits & (1 << i)) {
+			Net_WriteShort(buf, to->stats[i]);
+		}
+	}
+}
+
+/*
+ * @brief Resolves the U_* bits describing the changes from one entity state
+ * to another.
+ */
+static uint16_t Net_DeltaEntityBits(const entity_state_t *from, const entity_state_t *to,
+		_Bool is_new) {
 
 	uint16_t bits = 0;
 
@@ -226,6 +369,18 @@ void Net_WriteDeltaEntity(mem_buf_t *buf, const entity_state_t *from, const enti
 	if (to->solid != from->solid)
 		bits |= U_SOLID;
 
+	return bits;
+}
+
+/*
+ * @brief Writes an entity's state changes to a net message. Can delta from
+ * either a baseline or a previous packet_entity
+ */
+void Net_WriteDeltaEntity(mem_buf_t *buf, const entity_state_t *from, const entity_state_t *to,
+		_Bool force, _Bool is_new) {
+
+	const uint16_t bits = Net_DeltaEntityBits(from, to, is_new);
+
 	if (!bits && !force)
 		return; // nothing to send
 
@@ -271,11 +426,165 @@ void Net_WriteDeltaEntity(mem_buf_t *buf, const entity_state_t *from, const enti
 		Net_WriteShort(buf, to->solid);
 }
 
+/*
+ * @brief Writes the header of a packed entity delta: a continuation bit, the
+ * entity number coded against the previously written number, and the U_* bits.
+ */
+void Net_WritePackedEntityHeader(mem_buf_t *buf, uint16_t *last_number, uint16_t number,
+		uint16_t bits) {
+
+	const int32_t delta = number - *last_number;
+
+	Net_WriteBits(buf, 1, 1);
+
+	if (delta == 1) {
+		Net_WriteBits(buf, 1, 1);
+	} else if (delta > 1 && delta < 2 + (1 << U_PACKED_SKIP_BITS)) {
+		Net_WriteBits(buf, 0, 1);
+		Net_WriteBits(buf, 1, 1);
+		Net_WriteBits(buf, delta - 2, U_PACKED_SKIP_BITS);
+	} else {
+		Net_WriteBits(buf, 0, 1);
+		Net_WriteBits(buf, 0, 1);
+		Net_WriteBits(buf, number, U_PACKED_NUMBER_BITS);
+	}
+
+	Net_WriteBits(buf, bits, U_PACKED_BITS);
+
+	*last_number = number;
+}
+
+/*
+ * @brief Terminates the packed entity deltas of a frame.
+ */
+void Net_WritePackedEntityEnd(mem_buf_t *buf) {
+	Net_WriteBits(buf, 0, 1);
+}
+
+/*
+ * @brief Quantizes a vector component exactly as Net_WriteVector does.
+ */
+static int16_t Net_QuantizeVector(const vec_t v) {
+	return (int16_t) (int32_t) (v * 8.0);
+}
+
+/*
+ * @brief Writes each component of `pos` as the smallest of an unchanged flag,
+ * an 8 or 12 bit delta from `base`, or the absolute quantized value.
+ */
+static void Net_WritePackedPosition(mem_buf_t *buf, const vec3_t base, const vec3_t pos) {
+	int32_t i;
+
+	for (i = 0; i < 3; i++) {
+		const int16_t p = Net_QuantizeVector(pos[i]);
+		const int32_t delta = p - Net_QuantizeVector(base[i]);
+
+		if (delta == 0) {
+			Net_WriteBits(buf, 0, 2);
+		} else if (delta >= -128 && delta < 128) {
+			Net_WriteBits(buf, 1, 2);
+			Net_WriteBits(buf, delta, 8);
+		} else if (delta >= -2048 && delta < 2048) {
+			Net_WriteBits(buf, 2, 2);
+			Net_WriteBits(buf, delta, 12);
+		} else {
+			Net_WriteBits(buf, 3, 2);
+			Net_WriteBits(buf, (uint16_t) p, 16);
+		}
+	}
+}
+
+/*
+ * @brief Writes only the components of `angles` which differ from `base`
+ * after quantization.
+ */
+static void Net_WritePackedAngles(mem_buf_t *buf, const vec3_t base, const vec3_t angles) {
+	int32_t i;
+
+	for (i = 0; i < 3; i++) {
+		const int32_t a = (int32_t) (angles[i] * 255.0 / 360.0) & 255;
+		const int32_t b = (int32_t) (base[i] * 255.0 / 360.0) & 255;
+
+		if (a == b) {
+			Net_WriteBits(buf, 0, 1);
+		} else {
+			Net_WriteBits(buf, 1, 1);
+			Net_WriteBits(buf, a, 8);
+		}
+	}
+}
+
+/*
+ * @brief Writes a model index only if it differs from `base`.
+ */
+static void Net_WritePackedModel(mem_buf_t *buf, const uint8_t base, const uint8_t model) {
+
+	if (model == base) {
+		Net_WriteBits(buf, 0, 1);
+	} else {
+		Net_WriteBits(buf, 1, 1);
+		Net_WriteBits(buf, model, 8);
+	}
+}
+
+/*
+ * @brief Writes an entity's state changes to a net message using the bit-packed
+ * encoding of PROTOCOL. Positions are coded as small deltas where possible, and
+ * the entity number is coded against `last_number`, which is updated.
+ */
+void Net_WritePackedDeltaEntity(mem_buf_t *buf, const entity_state_t *from,
+		const entity_state_t *to, _Bool force, _Bool is_new, uint16_t *last_number) {
+
+	const uint16_t bits = Net_DeltaEntityBits(from, to, is_new);
+
+	if (!bits && !force)
+		return; // nothing to send
+
+	Net_WritePackedEntityHeader(buf, last_number, to->number, bits);
+
+	if (bits & U_ORIGIN)
+		Net_WritePackedPosition(buf, from->origin, to->origin);
+
+	if (bits & U_OLD_ORIGIN) // typically very near the new origin
+		Net_WritePackedPosition(buf, to->origin, to->old_origin);
+
+	if (bits & U_ANGLES)
+		Net_WritePackedAngles(buf, from->angles, to->angles);
+
+	if (bits & U_ANIMATIONS) {
+		Net_WriteBits(buf, to->animation1, 8);
+		Net_WriteBits(buf, to->animation2, 8);
+	}
+
+	if (bits & U_EVENT)
+		Net_WriteBits(buf, to->event, 8);
+
+	if (bits & U_EFFECTS)
+		Net_WriteBits(buf, to->effects, 16);
+
+	if (bits & U_MODELS) {
+		Net_WritePackedModel(buf, from->model1, to->model1);
+		Net_WritePackedModel(buf, from->model2, to->model2);
+		Net_WritePackedModel(buf, from->model3, to->model3);
+		Net_WritePackedModel(buf, from->model4, to->model4);
+	}
+
+	if (bits & U_CLIENT)
+		Net_WriteBits(buf, to->client, 8);
+
+	if (bits & U_SOUND)
+		Net_WriteBits(buf, to->sound, 8);
+
+	if (bits & U_SOLID)
+		Net_WriteBits(buf, to->solid, 16);
+}
+
 /*
  * @brief
  */
 void Net_BeginReading(mem_buf_t *msg) {
 	msg->read = 0;
+	msg->read_bits = 0;
 }
 
 /*
@@ -300,6 +609,7 @@ int32_t Net_ReadChar(mem_buf_t *sb) {
 	else
 		c = (signed char) sb->data[sb->read];
 	sb->read++;
+	sb->read_bits = 0;
 
 	return c;
 }
@@ -315,6 +625,7 @@ int32_t Net_ReadByte(mem_buf_t *sb) {
 	else
 		c = (byte) sb->data[sb->read];
 	sb->read++;
+	sb->read_bits = 0;
 
 	return c;
 }
@@ -331,6 +642,7 @@ int32_t Net_ReadShort(mem_buf_t *sb) {
 		c = (int16_t) (sb->data[sb->read] + (sb->data[sb->read + 1] << 8));
 
 	sb->read += 2;
+	sb->read_bits = 0;
 
 	return c;
 }
@@ -348,10 +660,47 @@ int32_t Net_ReadLong(mem_buf_t *sb) {
 				+ (sb->data[sb->read + 3] << 24);
 
 	sb->read += 4;
+	sb->read_bits = 0;
 
 	return c;
 }
 
+/*
+ * @brief Reads `bits` bits, least significant bit first. Like the byte-level
+ * reads, exhausting the buffer advances `read` beyond `size` and yields zeros.
+ */
+uint32_t Net_ReadBits(mem_buf_t *sb, uint8_t bits) {
+	uint32_t value = 0;
+	uint8_t shift = 0;
+
+	while (bits) {
+		if (sb->read_bits == 0) {
+			sb->read++;
+		}
+
+		const byte b = sb->read > sb->size ? 0 : sb->data[sb->read - 1];
+
+		const uint8_t n = MIN(bits, 8 - sb->read_bits);
+		const uint32_t mask = (1 << n) - 1;
+
+		value |= ((b >> sb->read_bits) & mask) << shift;
+		sb->read_bits = (sb->read_bits + n) & 7;
+
+		shift += n;
+		bits -= n;
+	}
+
+	return value;
+}
+
+/*
+ * @brief Reads `bits` bits as a two's complement signed value.
+ */
+static int32_t Net_ReadSignedBits(mem_buf_t *sb, uint8_t bits) {
+	const uint32_t sign = 1 << (bits - 1);
+	return (int32_t) ((Net_ReadBits(sb, bits) ^ sign) - sign);
+}
+
 /*
  * @brief
  */
@@ -477,6 +826,77 @@ void Net_ReadDeltaUserCmd(mem_buf_t *sb, const user_cmd_t *from, user_cmd_t *to)
 	to->msec = Net_ReadByte(sb);
 }
 
+/*
+ * @brief Reads the delta between two player states from a net message.
+ */
+void Net_ReadDeltaPlayerState(mem_buf_t *buf, const player_state_t *from, player_state_t *to) {
+	uint16_t pm_state_bits;
+	uint32_t stat_bits;
+	int32_t i;
+
+	// copy old value before delta parsing
+	*to = *from;
+
+	pm_state_bits = Net_ReadShort(buf);
+
+	// parse the pm_state_t
+	if (pm_state_bits & PS_PM_TYPE)
+		to->pm_state.type = Net_ReadByte(buf);
+
+	if (pm_state_bits & PS_PM_ORIGIN) {
+		to->pm_state.origin[0] = Net_ReadShort(buf);
+		to->pm_state.origin[1] = Net_ReadShort(buf);
+		to->pm_state.origin[2] = Net_ReadShort(buf);
+	}
+
+	if (pm_state_bits & PS_PM_VELOCITY) {
+		to->pm_state.velocity[0] = Net_ReadShort(buf);
+		to->pm_state.velocity[1] = Net_ReadShort(buf);
+		to->pm_state.velocity[2] = Net_ReadShort(buf);
+	}
+
+	if (pm_state_bits & PS_PM_FLAGS)
+		to->pm_state.flags = Net_ReadShort(buf);
+
+	if (pm_state_bits & PS_PM_TIME)
+		to->pm_state.time = Net_ReadShort(buf);
+
+	if (pm_state_bits & PS_PM_GRAVITY)
+		to->pm_state.gravity = Net_ReadShort(buf);
+
+	if (pm_state_bits & PS_PM_VIEW_OFFSET) {
+		to->pm_state.view_offset[0] = Net_ReadShort(buf);
+		to->pm_state.view_offset[1] = Net_ReadShort(buf);
+		to->pm_state.view_offset[2] = Net_ReadShort(buf);
+	}
+
+	if (pm_state_bits & PS_PM_VIEW_ANGLES) {
+		to->pm_state.view_angles[0] = Net_ReadShort(buf);
+		to->pm_state.view_angles[1] = Net_ReadShort(buf);
+		to->pm_state.view_angles[2] = Net_ReadShort(buf);
+	}
+
+	if (pm_state_bits & PS_PM_KICK_ANGLES) {
+		to->pm_state.kick_angles[0] = Net_ReadShort(buf);
+		to->pm_state.kick_angles[1] = Net_ReadShort(buf);
+		to->pm_state.kick_angles[2] = Net_ReadShort(buf);
+	}
+
+	if (pm_state_bits & PS_PM_DELTA_ANGLES) {
+		to->pm_state.delta_angles[0] = Net_ReadShort(buf);
+		to->pm_state.delta_angles[1] = Net_ReadShort(buf);
+		to->pm_state.delta_angles[2] = Net_ReadShort(buf);
+	}
+
+	// parse stats
+	stat_bits = Net_ReadLong(buf);
+
+	for (i = 0; i < MAX_STATS; i++) {
+		if (stat_bits & (1 << i))
+			to->stats[i] = Net_ReadShort(buf);
+	}
+}
+
 /*
  * @brief
  */
@@ -527,3 +947,126 @@ void Net_ReadDeltaEntity(mem_buf_t *buf, const entity_state_t *from, entity_stat
 		to->solid = Net_ReadShort(buf);
 }
 
+/*
+ * @brief Reads the header of a packed entity delta, returning the entity number
+ * and its U_* bits, or 0 at the end of the frame's entities.
+ */
+uint16_t Net_ReadPackedEntityHeader(mem_buf_t *buf, uint16_t *last_number, uint16_t *bits) {
+	uint16_t number;
+
+	if (!Net_ReadBits(buf, 1)) {
+		*bits = 0;
+		return 0;
+	}
+
+	if (Net_ReadBits(buf, 1)) {
+		number = *last_number + 1;
+	} else if (Net_ReadBits(buf, 1)) {
+		number = *last_number + 2 + Net_ReadBits(buf, U_PACKED_SKIP_BITS);
+	} else {
+		number = Net_ReadBits(buf, U_PACKED_NUMBER_BITS);
+	}
+
+	*bits = Net_ReadBits(buf, U_PACKED_BITS);
+
+	return *last_number = number;
+}
+
+/*
+ * @brief Reads a position written by Net_WritePackedPosition.
+ */
+static void Net_ReadPackedPosition(mem_buf_t *buf, const vec3_t base, vec3_t pos) {
+	int32_t i;
+
+	for (i = 0; i < 3; i++) {
+		const int16_t b = Net_QuantizeVector(base[i]);
+
+		switch (Net_ReadBits(buf, 2)) {
+			case 0:
+				pos[i] = b * (1.0 / 8.0);
+				break;
+			case 1:
+				pos[i] = (int16_t) (b + Net_ReadSignedBits(buf, 8)) * (1.0 / 8.0);
+				break;
+			case 2:
+				pos[i] = (int16_t) (b + Net_ReadSignedBits(buf, 12)) * (1.0 / 8.0);
+				break;
+			default:
+				pos[i] = (int16_t) Net_ReadBits(buf, 16) * (1.0 / 8.0);
+				break;
+		}
+	}
+}
+
+/*
+ * @brief Reads angles written by Net_WritePackedAngles.
+ */
+static void Net_ReadPackedAngles(mem_buf_t *buf, vec3_t angles) {
+	int32_t i;
+
+	for (i = 0; i < 3; i++) {
+		if (Net_ReadBits(buf, 1)) {
+			angles[i] = (int8_t) Net_ReadBits(buf, 8) * (360.0 / 255.0);
+		}
+	}
+}
+
+/*
+ * @brief Reads a model index written by Net_WritePackedModel.
+ */
+static void Net_ReadPackedModel(mem_buf_t *buf, uint8_t *model) {
+
+	if (Net_ReadBits(buf, 1)) {
+		*model = Net_ReadBits(buf, 8);
+	}
+}
+
+/*
+ * @brief Reads an entity delta written by Net_WritePackedDeltaEntity.
+ */
+void Net_ReadPackedDeltaEntity(mem_buf_t *buf, const entity_state_t *from, entity_state_t *to,
+		uint16_t number, uint16_t bits) {
+
+	// set everything to the state we are delta'ing from
+	*to = *from;
+
+	to->number = number;
+
+	if (bits & U_ORIGIN)
+		Net_ReadPackedPosition(buf, from->origin, to->origin);
+
+	if (bits & U_OLD_ORIGIN)
+		Net_ReadPackedPosition(buf, to->origin, to->old_origin);
+
+	if (bits & U_ANGLES)
+		Net_ReadPackedAngles(buf, to->angles);
+
+	if (bits & U_ANIMATIONS) {
+		to->animation1 = Net_ReadBits(buf, 8);
+		to->animation2 = Net_ReadBits(buf, 8);
+	}
+
+	if (bits & U_EVENT)
+		to->event = Net_ReadBits(buf, 8);
+	else
+		to->event = 0;
+
+	if (bits & U_EFFECTS)
+		to->effects = Net_ReadBits(buf, 16);
+
+	if (bits & U_MODELS) {
+		Net_ReadPackedModel(buf, &to->model1);
+		Net_ReadPackedModel(buf, &to->model2);
+		Net_ReadPackedModel(buf, &to->model3);
+		Net_ReadPackedModel(buf, &to->model4);
+	}
+
+	if (bits & U_CLIENT)
+		to->client = Net_ReadBits(buf, 8);
+
+	if (bits & U_SOUND)
+		to->sound = Net_ReadBits(buf, 8);
+
+	if (bits & U_SOLID)
+		to->solid = Net_ReadBits(buf, 16);
+}
@@ -65,6 +65,13 @@
 #define U_SOLID					0x200 // encoded bounding box
 #define U_REMOVE				0x400 // remove this entity, don't add it
 
+/*
+ * @brief Field widths of the bit-packed entity header used by PROTOCOL.
+ */
+#define U_PACKED_BITS			11 // U_ORIGIN through U_REMOVE
+#define U_PACKED_NUMBER_BITS	10 // absolute entity numbers, see MAX_EDICTS
+#define U_PACKED_SKIP_BITS		4 // short skips between entity numbers
+
 /*
  * @brief These flags indicate which fields a given sound packet will contain.
  */
@@ -80,6 +87,7 @@ void Net_WriteChar(mem_buf_t *sb, const int32_t c);
 void Net_WriteByte(mem_buf_t *buf, const int32_t c);
 void Net_WriteShort(mem_buf_t *buf, const int32_t c);
 void Net_WriteLong(mem_buf_t *buf, const int32_t c);
+void Net_WriteBits(mem_buf_t *buf, uint32_t value, uint8_t bits);
 void Net_WriteString(mem_buf_t *buf, const char *s);
 void Net_WriteVector(mem_buf_t *buf, const vec_t f);
 void Net_WritePosition(mem_buf_t *buf, const vec3_t pos);
@@ -87,8 +95,14 @@ void Net_WriteAngle(mem_buf_t *buf, const vec_t f);
 void Net_WriteAngles(mem_buf_t *buf, const vec3_t angles);
 void Net_WriteDir(mem_buf_t *buf, const vec3_t dir);
 void Net_WriteDeltaUserCmd(mem_buf_t *buf, const user_cmd_t *from, const user_cmd_t *to);
+void Net_WriteDeltaPlayerState(mem_buf_t *buf, const player_state_t *from, const player_state_t *to);
 void Net_WriteDeltaEntity(mem_buf_t *buf, const entity_state_t *from, const entity_state_t *to,
 		_Bool force, _Bool newentity);
+void Net_WritePackedEntityHeader(mem_buf_t *buf, uint16_t *last_number, uint16_t number,
+		uint16_t bits);
+void Net_WritePackedEntityEnd(mem_buf_t *buf);
+void Net_WritePackedDeltaEntity(mem_buf_t *buf, const entity_state_t *from,
+		const entity_state_t *to, _Bool force, _Bool is_new, uint16_t *last_number);
 
 void Net_BeginReading(mem_buf_t *buf);
 void Net_ReadData(mem_buf_t *buf, void *data, size_t len);
@@ -96,6 +110,7 @@ int32_t Net_ReadChar(mem_buf_t *buf);
 int32_t Net_ReadByte(mem_buf_t *buf);
 int32_t Net_ReadShort(mem_buf_t *buf);
 int32_t Net_ReadLong(mem_buf_t *buf);
+uint32_t Net_ReadBits(mem_buf_t *buf, uint8_t bits);
 char *Net_ReadString(mem_buf_t *buf);
 char *Net_ReadStringLine(mem_buf_t *buf);
 vec_t Net_ReadVector(mem_buf_t *buf);
@@ -104,7 +119,11 @@ vec_t Net_ReadAngle(mem_buf_t *buf);
 void Net_ReadAngles(mem_buf_t *buf, vec3_t angles);
 void Net_ReadDir(mem_buf_t *buf, vec3_t vector);
 void Net_ReadDeltaUserCmd(mem_buf_t *buf, const user_cmd_t *from, user_cmd_t *to);
+void Net_ReadDeltaPlayerState(mem_buf_t *buf, const player_state_t *from, player_state_t *to);
 void Net_ReadDeltaEntity(mem_buf_t *buf, const entity_state_t *from, entity_state_t *to,
 		uint16_t bits, uint16_t number);
+uint16_t Net_ReadPackedEntityHeader(mem_buf_t *buf, uint16_t *last_number, uint16_t *bits);
+void Net_ReadPackedDeltaEntity(mem_buf_t *buf, const entity_state_t *from, entity_state_t *to,
+		uint16_t number, uint16_t bits);
 
 #endif /* __NET_MESSAGE_H__ */
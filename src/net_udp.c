@@ -22,8 +22,15 @@
 #include <sys/time.h>
 
 #include "net_udp.h"
+#include "sys.h"
 
-#define MAX_NET_UDP_LOOPS 4
+#define MAX_NET_UDP_LOOPS 16
+
+/*
+ * @brief The simulated link will hold back at most this many milliseconds of
+ * traffic at net_rate before dropping datagrams, like a router queue would.
+ */
+#define NET_SIM_MAX_BACKLOG 1000
 
 typedef struct {
 	byte data[MAX_MSG_SIZE];
@@ -35,9 +42,24 @@ typedef struct {
 	int32_t send, recv;
 } net_udp_loop_t;
 
+/*
+ * @brief A datagram held back by the network simulator until its release time.
+ */
+typedef struct {
+	net_src_t source;
+	int32_t sock;
+	net_addr_t to;
+	uint32_t time;
+	size_t size;
+	byte data[MAX_MSG_SIZE];
+} net_udp_sim_datagram_t;
+
 typedef struct {
 	net_udp_loop_t loops[2];
 	int32_t sockets[2];
+
+	GList *sim_datagrams; // sorted by release time
+	uint32_t sim_busy[2]; // when each simulated link is next idle
 } net_udp_state_t;
 
 static net_udp_state_t net_udp_state;
@@ -74,7 +96,10 @@ static _Bool Net_ReceiveDatagram_Loop(net_src_t source, net_addr_t *from, mem_bu
  */
 _Bool Net_ReceiveDatagram(net_src_t source, net_addr_t *from, mem_buf_t *buf) {
 
+	Net_RunSimulation();
+
 	buf->read = buf->size = 0;
+	buf->read_bits = 0;
 
 	memset(from, 0, sizeof(*from));
 	from->type = NA_DATAGRAM;
@@ -120,7 +145,7 @@ _Bool Net_ReceiveDatagram(net_src_t source, net_addr_t *from, mem_buf_t *buf) {
 }
 
 /*
- * @brief
+ * @brief Queues a datagram for the other end of the loopback.
  */
 static _Bool Net_SendDatagram_Loop(net_src_t source, const void *data, size_t len) {
 	net_udp_loop_t *loop = &net_udp_state.loops[source ^ 1];
@@ -134,12 +159,146 @@ static _Bool Net_SendDatagram_Loop(net_src_t source, const void *data, size_t le
 	return true;
 }
 
+/*
+ * @brief Writes a datagram to the specified socket.
+ */
+static _Bool Net_SendDatagram_Socket(int32_t sock, const net_addr_t *to, const void *data,
+		size_t len) {
+	struct sockaddr_in to_addr;
+
+	Net_NetAddrToSockaddr(to, &to_addr);
+
+	ssize_t sent = sendto(sock, data, len, 0, (const struct sockaddr *) &to_addr, sizeof(to_addr));
+
+	if (sent == -1) {
+		Com_Warn("%s to %s\n", Net_GetErrorString(), Net_NetaddrToString(to));
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * @brief GCompareFunc for Net_SimulateDatagram. Datagrams released at the
+ * same time retain the order in which they were sent.
+ */
+static int32_t Net_SimulateDatagram_Compare(gconstpointer a, gconstpointer b) {
+	const net_udp_sim_datagram_t *da = (const net_udp_sim_datagram_t *) a;
+	const net_udp_sim_datagram_t *db = (const net_udp_sim_datagram_t *) b;
+
+	return da->time >= db->time ? 1 : -1;
+}
+
+/*
+ * @brief Subjects an outgoing datagram to the simulated network conditions
+ * (net_loss, net_latency, net_jitter and net_rate). Returns true if the
+ * datagram was dropped or held back, false if it should be sent immediately.
+ */
+static _Bool Net_SimulateDatagram(net_src_t source, int32_t sock, const net_addr_t *to,
+		const void *data, size_t len) {
+
+	if (net_loss->value && Randomf() * 100.0 < net_loss->value)
+		return true;
+
+	if (!net_latency->value && !net_jitter->value && !net_rate->value)
+		return false;
+
+	const uint32_t now = Sys_Milliseconds();
+	uint32_t time = now;
+
+	if (net_rate->value) { // serialize the datagram onto the link
+		uint32_t *busy = &net_udp_state.sim_busy[source];
+
+		if (*busy < now)
+			*busy = now;
+
+		if (*busy - now > NET_SIM_MAX_BACKLOG)
+			return true;
+
+		*busy += len * 1000 / net_rate->value;
+		time = *busy;
+	}
+
+	time += net_latency->value + Randomf() * net_jitter->value;
+
+	net_udp_sim_datagram_t *d = Mem_Malloc(sizeof(*d));
+
+	d->source = source;
+	d->sock = sock;
+	d->to = *to;
+	d->time = time;
+	d->size = len;
+
+	memcpy(d->data, data, len);
+
+	net_udp_state.sim_datagrams = g_list_insert_sorted(net_udp_state.sim_datagrams, d,
+			Net_SimulateDatagram_Compare);
+
+	return true;
+}
+
+/*
+ * @brief Releases any datagrams held back by the network simulator whose time
+ * has come. This is called implicitly when sending and receiving.
+ */
+void Net_RunSimulation(void) {
+
+	if (!net_udp_state.sim_datagrams)
+		return;
+
+	const uint32_t now = Sys_Milliseconds();
+
+	while (net_udp_state.sim_datagrams) {
+		net_udp_sim_datagram_t *d = (net_udp_sim_datagram_t *) net_udp_state.sim_datagrams->data;
+
+		if (d->time > now)
+			break;
+
+		if (d->to.type == NA_LOOP) {
+			Net_SendDatagram_Loop(d->source, d->data, d->size);
+		} else {
+			Net_SendDatagram_Socket(d->sock, &d->to, d->data, d->size);
+		}
+
+		net_udp_state.sim_datagrams = g_list_delete_link(net_udp_state.sim_datagrams,
+				net_udp_state.sim_datagrams);
+
+		Mem_Free(d);
+	}
+}
+
+/*
+ * @brief Discards any datagrams the network simulator holds for the given source.
+ */
+static void Net_ClearSimulation(net_src_t source) {
+	GList *e = net_udp_state.sim_datagrams;
+
+	while (e) {
+		GList *next = e->next;
+		net_udp_sim_datagram_t *d = (net_udp_sim_datagram_t *) e->data;
+
+		if (d->source == source) {
+			net_udp_state.sim_datagrams = g_list_delete_link(net_udp_state.sim_datagrams, e);
+			Mem_Free(d);
+		}
+
+		e = next;
+	}
+
+	net_udp_state.sim_busy[source] = 0;
+}
+
 /*
  * @brief Send a datagram to the specified address.
  */
 _Bool Net_SendDatagram(net_src_t source, const net_addr_t *to, const void *data, size_t len) {
 
+	Net_RunSimulation();
+
 	if (to->type == NA_LOOP) {
+		if (Net_SimulateDatagram(source, 0, to, data, len))
+			return true;
+
 		return Net_SendDatagram_Loop(source, data, len);
 	}
 
@@ -151,17 +310,10 @@ _Bool Net_SendDatagram(net_src_t source, const net_addr_t *to, const void *data,
 		Com_Error(ERR_DROP, "Bad address type\n");
 	}
 
-	struct sockaddr_in to_addr;
-	Net_NetAddrToSockaddr(to, &to_addr);
-
-	ssize_t sent = sendto(sock, data, len, 0, (const struct sockaddr *) &to_addr, sizeof(to_addr));
-
-	if (sent == -1) {
-		Com_Warn("%s to %s\n", Net_GetErrorString(), Net_NetaddrToString(to));
-		return false;
-	}
+	if (Net_SimulateDatagram(source, sock, to, data, len))
+		return true;
 
-	return true;
+	return Net_SendDatagram_Socket(sock, to, data, len);
 }
 
 /*
@@ -200,6 +352,8 @@ void Net_Config(net_src_t source, _Bool up) {
 			*sock = Net_Socket(NA_DATAGRAM, iface, port);
 		}
 	} else {
+		Net_ClearSimulation(source);
+
 		if (*sock != 0) {
 			Net_CloseSocket(*sock);
 			*sock = 0;
@@ -207,3 +361,16 @@ void Net_Config(net_src_t source, _Bool up) {
 	}
 }
 
+/*
+ * @brief Assigns an externally managed socket to the given net_src_t, returning
+ * the previous one. This allows a single process to drive several clients,
+ * each from its own port. The caller remains responsible for closing it.
+ */
+int32_t Net_SetSocket(net_src_t source, int32_t sock) {
+
+	const int32_t previous = net_udp_state.sockets[source];
+	net_udp_state.sockets[source] = sock;
+
+	return previous;
+}
+
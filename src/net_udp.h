@@ -27,7 +27,10 @@
 _Bool Net_ReceiveDatagram(net_src_t source, net_addr_t *from, mem_buf_t *buf);
 _Bool Net_SendDatagram(net_src_t source, const net_addr_t *to, const void *data, size_t len);
 
+void Net_RunSimulation(void);
+
 void Net_Config(net_src_t source, _Bool up);
+int32_t Net_SetSocket(net_src_t source, int32_t sock);
 void Net_Sleep(uint32_t msec);
 
 #endif /* __NET_UDP_H__ */
@@ -193,7 +193,7 @@ typedef enum {
 	SV_CMD_CBUF_TEXT, // [string] stuffed into client's console buffer, should be \n terminated
 	SV_CMD_CONFIG_STRING, // [short] [string]
 	SV_CMD_DISCONNECT,
-	SV_CMD_DOWNLOAD, // [short] size [size bytes]
+	SV_CMD_DOWNLOAD, // [short] size [byte] percent [size bytes], see sv_download.c for PROTOCOL
 	SV_CMD_FRAME,
 	SV_CMD_PRINT, // [byte] id [string] null terminated string
 	SV_CMD_RECONNECT,
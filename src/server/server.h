@@ -24,17 +24,21 @@
 
 #include "cmodel.h"
 #include "console.h"
+#include "demo.h"
 #include "filesystem.h"
 #include "game/game.h"
 #include "net_chan.h"
+#include "net_frame.h"
 #include "thread.h"
 
 #include "sv_admin.h"
 #include "sv_client.h"
+#include "sv_download.h"
 #include "sv_entity.h"
 #include "sv_game.h"
 #include "sv_init.h"
 #include "sv_main.h"
+#include "sv_profile.h"
 #include "sv_send.h"
 #include "sv_types.h"
 #include "sv_world.h"
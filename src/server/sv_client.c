@@ -42,7 +42,7 @@ static void Sv_New_f(void) {
 
 	// send the server data
 	Net_WriteByte(&sv_client->net_chan.message, SV_CMD_SERVER_DATA);
-	Net_WriteLong(&sv_client->net_chan.message, PROTOCOL);
+	Net_WriteLong(&sv_client->net_chan.message, sv_client->protocol);
 	Net_WriteLong(&sv_client->net_chan.message, svs.spawn_count);
 	Net_WriteLong(&sv_client->net_chan.message, svs.frame_rate);
 	Net_WriteByte(&sv_client->net_chan.message, 0);
@@ -187,38 +187,25 @@ static void Sv_Begin_f(void) {
 }
 
 /*
- * @brief
+ * @brief Requests the next chunk of a PROTOCOL_LEGACY download.
  */
 static void Sv_NextDownload_f(void) {
-	byte buf[MAX_MSG_SIZE];
-	mem_buf_t msg;
+	Sv_NextDownload(sv_client);
+}
 
-	sv_download_t *download = &sv_client->download;
+/*
+ * @brief Acknowledges chunks of a PROTOCOL download.
+ */
+static void Sv_DownloadAck_f(void) {
 
-	if (!download->buffer)
+	if (Cmd_Argc() != 4)
 		return;
 
-	Mem_InitBuffer(&msg, buf, sizeof(buf));
-
-	int32_t len = Clamp(download->size - download->count, 0, 1024);
-
-	Net_WriteByte(&msg, SV_CMD_DOWNLOAD);
-	Net_WriteShort(&msg, len);
-
-	int32_t percent = download->count * 100 / (Clamp(download->size, 1, download->size));
-	Net_WriteByte(&msg, percent);
+	const uint8_t id = strtoul(Cmd_Argv(1), NULL, 0);
+	const int32_t offset = strtol(Cmd_Argv(2), NULL, 0);
+	const uint32_t mask = strtoul(Cmd_Argv(3), NULL, 0);
 
-	Mem_WriteBuffer(&msg, download->buffer + download->count, len);
-	Mem_WriteBuffer(&sv_client->net_chan.message, msg.data, msg.size);
-
-	download->count += len;
-
-	if (download->count == download->size) {
-		Com_Debug("Finished download to %s\n", Sv_NetaddrToString(sv_client));
-
-		Fs_Free(download->buffer);
-		download->buffer = NULL;
-	}
+	Sv_AcknowledgeDownload(sv_client, id, offset, mask);
 }
 
 /*
@@ -257,41 +244,15 @@ static void Sv_Download_f(void) {
 	}
 
 	if (!sv_udp_download->value) { // ensure server wishes to allow
-		Net_WriteByte(&sv_client->net_chan.message, SV_CMD_DOWNLOAD);
-		Net_WriteShort(&sv_client->net_chan.message, -1);
-		Net_WriteByte(&sv_client->net_chan.message, 0);
+		Sv_RefuseDownload(sv_client);
 		return;
 	}
 
-	sv_download_t *download = &sv_client->download;
+	const int32_t offset = Cmd_Argc() > 2 ? strtol(Cmd_Argv(2), NULL, 0) : 0;
 
-	if (download->buffer) { // free last download
-		Fs_Free(download->buffer);
+	if (Sv_BeginDownload(sv_client, filename, offset)) {
+		Com_Debug("Downloading %s to %s\n", filename, sv_client->name);
 	}
-
-	memset(download, 0, sizeof(*download));
-
-	// try to load the file
-	download->size = (int32_t) Fs_Load(filename, (void *) &download->buffer);
-
-	if (download->size == -1) {
-		Com_Warn("Couldn't download %s to %s\n", filename, Sv_NetaddrToString(sv_client));
-		Net_WriteByte(&sv_client->net_chan.message, SV_CMD_DOWNLOAD);
-		Net_WriteShort(&sv_client->net_chan.message, -1);
-		Net_WriteByte(&sv_client->net_chan.message, 0);
-		return;
-	}
-
-	if (Cmd_Argc() > 2) {
-		download->count = strtol(Cmd_Argv(2), NULL, 0);
-		if (download->count < 0 || download->count > download->size) {
-			Com_Warn("Invalid offset (%d) from %s\n", download->count, Sv_NetaddrToString(sv_client));
-			download->count = download->size;
-		}
-	}
-
-	Sv_NextDownload_f();
-	Com_Debug("Downloading %s to %s\n", filename, sv_client->name);
 }
 
 /*
@@ -325,6 +286,59 @@ static void Sv_Info_f(void) {
 	Cvar_Enumerate(Sv_Info_f_enumerate, (void *) sv_client);
 }
 
+/*
+ * @brief Prints to a client of the demo server, which has no edict.
+ */
+static void Sv_DemoPrint(const char *s) {
+
+	Net_WriteByte(&sv_client->net_chan.message, SV_CMD_PRINT);
+	Net_WriteByte(&sv_client->net_chan.message, PRINT_HIGH);
+	Net_WriteString(&sv_client->net_chan.message, s);
+}
+
+/*
+ * @brief Seeks the demo being played back to the keyframe nearest the given
+ * time, in seconds from the start of the demo, or relative to the current
+ * frame if prefixed by + or -.
+ */
+static void Sv_Seek_f(void) {
+
+	if (sv.state != SV_ACTIVE_DEMO)
+		return;
+
+	demo_t *demo = sv.demo_file;
+
+	const int32_t first_frame = Demo_FirstFrame(demo);
+
+	if (first_frame == -1 || !demo->hz) {
+		Sv_DemoPrint("Demo is not indexed, convert it with q2wdemo -convert\n");
+		return;
+	}
+
+	const char *s = Cmd_Argv(1);
+	const int32_t frames = atof(s) * demo->hz;
+	const _Bool relative = *s == '+' || *s == '-';
+
+	int32_t frame_num = (relative ? demo->frame_num : first_frame) + frames;
+	frame_num = Clamp(frame_num, first_frame, Demo_LastFrame(demo));
+
+	// seeking forward by less than the keyframe interval would go backwards
+	if (relative && frames > 0 && Demo_FindKeyframe(demo, frame_num) <= demo->frame_num) {
+		Sv_DemoPrint("No keyframe in range, try fast_forward\n");
+		return;
+	}
+
+	const int32_t keyframe = Demo_Seek(demo, frame_num);
+
+	if (keyframe == -1) {
+		Sv_DemoPrint("Seek failed\n");
+		return;
+	}
+
+	const uint32_t seconds = (keyframe - first_frame) / demo->hz;
+	Sv_DemoPrint(va("Seeked to %u:%02u\n", seconds / 60, seconds % 60));
+}
+
 typedef struct sv_user_string_cmd_s {
 	char *name;
 	void (*func)(void);
@@ -340,6 +354,8 @@ sv_user_string_cmd_t sv_user_string_cmds[] = {
 		{ "info", Sv_Info_f },
 		{ "download", Sv_Download_f },
 		{ "nextdl", Sv_NextDownload_f },
+		{ "dlack", Sv_DownloadAck_f },
+		{ "seek", Sv_Seek_f },
 		{ NULL, NULL } };
 
 /*
@@ -378,7 +394,9 @@ static void Sv_ClientThink(sv_client_t *cl, user_cmd_t *cmd) {
 
 	cl->cmd_msec += cmd->msec;
 
+	Sv_ProfileBegin(SV_PROFILE_CLIENT_THINK);
 	svs.game->ClientThink(cl->edict, cmd);
+	Sv_ProfileEnd(SV_PROFILE_CLIENT_THINK);
 }
 
 #define CMD_MAX_MOVES 1
@@ -427,6 +445,16 @@ void Sv_ParseClientMessage(sv_client_t *cl) {
 				}
 
 				last_frame = Net_ReadLong(&net_message);
+
+				if (cl->protocol == PROTOCOL) {
+					const int32_t baseline = Net_ReadLong(&net_message);
+
+					if (last_frame == -1) // the client wants an uncompressed frame
+						Sv_ResetBaseline(cl);
+					else
+						Sv_AcknowledgeBaseline(cl, baseline);
+				}
+
 				if (last_frame != cl->last_frame) {
 					cl->last_frame = last_frame;
 					if (cl->last_frame > -1) {
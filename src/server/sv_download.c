@@ -0,0 +1,384 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "sv_local.h"
+
+/*
+ * @brief The initial round trip time estimate for new downloads, in milliseconds.
+ */
+#define SV_DOWNLOAD_RTT 200
+
+/*
+ * @brief Files being downloaded, shared by all of their downloaders.
+ */
+static GList *sv_download_files;
+
+/*
+ * @brief Returns the shared copy of the specified file, loading it for its
+ * first downloader. Returns NULL if the file could not be loaded.
+ */
+static sv_download_file_t *Sv_OpenDownloadFile(const char *filename) {
+	sv_download_file_t *file;
+	GList *e;
+
+	for (e = sv_download_files; e; e = e->next) {
+		file = (sv_download_file_t *) e->data;
+
+		if (!g_strcmp0(file->name, filename)) {
+			file->ref_count++;
+			return file;
+		}
+	}
+
+	if (strlen(filename) >= sizeof(file->name))
+		return NULL;
+
+	file = Mem_TagMalloc(sizeof(*file), MEM_TAG_SERVER);
+	g_strlcpy(file->name, filename, sizeof(file->name));
+
+	file->size = (int32_t) Fs_Load(filename, (void *) &file->buffer);
+
+	if (file->size == -1) {
+		Mem_Free(file);
+		return NULL;
+	}
+
+	file->ref_count = 1;
+
+	sv_download_files = g_list_prepend(sv_download_files, file);
+
+	Com_Debug("Loaded %s (%d bytes) for download\n", file->name, file->size);
+	return file;
+}
+
+/*
+ * @brief Releases a reference to the specified file, freeing it if this was
+ * its last downloader.
+ */
+static void Sv_CloseDownloadFile(sv_download_file_t *file) {
+
+	if (--file->ref_count)
+		return;
+
+	Com_Debug("Freeing %s\n", file->name);
+
+	sv_download_files = g_list_remove(sv_download_files, file);
+
+	Fs_Free(file->buffer);
+	Mem_Free(file);
+}
+
+/*
+ * @brief Returns the number of the chunk at the specified offset. For the end
+ * of the file, this is the number of chunks in the download.
+ */
+static int32_t Sv_DownloadChunk(const sv_download_t *download, const int32_t offset) {
+	return (offset - download->start + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
+}
+
+/*
+ * @brief Writes a PROTOCOL download message for the specified chunk. A zero
+ * length chunk announces the download.
+ */
+static void Sv_WriteDownloadChunk(mem_buf_t *msg, const sv_download_t *download,
+		const int32_t offset, const int32_t len) {
+
+	Net_WriteByte(msg, SV_CMD_DOWNLOAD);
+	Net_WriteByte(msg, download->id);
+	Net_WriteLong(msg, download->file->size);
+	Net_WriteLong(msg, offset);
+	Net_WriteShort(msg, len);
+
+	Mem_WriteBuffer(msg, download->file->buffer + offset, len);
+}
+
+/*
+ * @brief Informs the client that the file it requested is not available.
+ */
+void Sv_RefuseDownload(sv_client_t *client) {
+	mem_buf_t *msg = &client->net_chan.message;
+
+	Net_WriteByte(msg, SV_CMD_DOWNLOAD);
+
+	if (client->protocol == PROTOCOL) {
+		Net_WriteByte(msg, client->download.id);
+		Net_WriteLong(msg, -1);
+		Net_WriteLong(msg, 0);
+		Net_WriteShort(msg, 0);
+	} else {
+		Net_WriteShort(msg, -1);
+		Net_WriteByte(msg, 0);
+	}
+}
+
+/*
+ * @brief Begins (or resumes, from the specified offset) downloading the given
+ * file to the client. PROTOCOL clients are sent an announcement, after which
+ * the file is streamed from Sv_SendDownload. Returns false if the file could
+ * not be loaded, in which case the download is refused.
+ */
+_Bool Sv_BeginDownload(sv_client_t *client, const char *filename, int32_t offset) {
+	sv_download_t *download = &client->download;
+
+	Sv_EndDownload(client);
+
+	download->id++;
+
+	if (!(download->file = Sv_OpenDownloadFile(filename))) {
+		Com_Warn("Couldn't download %s to %s\n", filename, Sv_NetaddrToString(client));
+		Sv_RefuseDownload(client);
+		return false;
+	}
+
+	if (offset < 0 || offset > download->file->size) {
+		Com_Warn("Invalid offset (%d) from %s\n", offset, Sv_NetaddrToString(client));
+		offset = download->file->size;
+	}
+
+	download->start = download->offset = offset;
+
+	if (client->protocol == PROTOCOL) {
+		download->rtt = SV_DOWNLOAD_RTT;
+		download->last_ack = quake2world.time;
+
+		Sv_WriteDownloadChunk(&client->net_chan.message, download, offset, 0);
+	} else {
+		Sv_NextDownload(client);
+	}
+
+	return true;
+}
+
+/*
+ * @brief Sends the next chunk of the download to a PROTOCOL_LEGACY client, which
+ * requests each chunk in turn.
+ */
+void Sv_NextDownload(sv_client_t *client) {
+	byte buf[MAX_MSG_SIZE];
+	mem_buf_t msg;
+
+	sv_download_t *download = &client->download;
+
+	if (!download->file || client->protocol == PROTOCOL)
+		return;
+
+	Mem_InitBuffer(&msg, buf, sizeof(buf));
+
+	const int32_t size = download->file->size;
+	const int32_t len = Clamp(size - download->offset, 0, DOWNLOAD_CHUNK_SIZE);
+
+	Net_WriteByte(&msg, SV_CMD_DOWNLOAD);
+	Net_WriteShort(&msg, len);
+
+	// the client finishes the download upon receiving 100 percent
+	const int32_t percent = size ? (download->offset + len) * 100 / size : 100;
+	Net_WriteByte(&msg, percent);
+
+	Mem_WriteBuffer(&msg, download->file->buffer + download->offset, len);
+	Mem_WriteBuffer(&client->net_chan.message, msg.data, msg.size);
+
+	download->offset += len;
+
+	if (download->offset == size) {
+		Com_Debug("Finished download to %s\n", Sv_NetaddrToString(client));
+		Sv_EndDownload(client);
+	}
+}
+
+/*
+ * @brief Handles an acknowledgement from a PROTOCOL client. The client has
+ * received all of the file up to offset, and, by mask, the chunks following
+ * the one at offset.
+ */
+void Sv_AcknowledgeDownload(sv_client_t *client, const uint8_t id, const int32_t offset,
+		const uint32_t mask) {
+	int32_t i;
+
+	sv_download_t *download = &client->download;
+
+	if (!download->file || download->id != id || client->protocol != PROTOCOL)
+		return; // stale, or not using the windowed protocol
+
+	if (offset < download->offset || offset > download->file->size)
+		return; // stale, or invalid
+
+	if (offset != download->file->size && (offset - download->start) % DOWNLOAD_CHUNK_SIZE) {
+		Com_Warn("Invalid offset (%d) from %s\n", offset, Sv_NetaddrToString(client));
+		return;
+	}
+
+	const int32_t base = Sv_DownloadChunk(download, download->offset);
+	const int32_t new_base = Sv_DownloadChunk(download, offset);
+
+	if (new_base - base > DOWNLOAD_WINDOW) {
+		Com_Warn("Acknowledgement beyond window from %s\n", Sv_NetaddrToString(client));
+		return;
+	}
+
+	const uint32_t now = quake2world.time;
+
+	// sample the round trip time of chunks acknowledged for the first time
+	for (i = 0; i < DOWNLOAD_WINDOW; i++) {
+		const int32_t chunk = base + i;
+
+		if (chunk == new_base)
+			continue;
+
+		if (chunk > new_base && !(mask & (1u << (chunk - new_base - 1))))
+			continue;
+
+		if (download->acked & (1u << i))
+			continue;
+
+		const uint32_t sent_time = download->sent_time[chunk % DOWNLOAD_WINDOW];
+
+		// ignore retransmitted chunks, for which the sample is ambiguous
+		if (!sent_time || (download->resent & (1u << i)))
+			continue;
+
+		download->rtt = (download->rtt * 7 + (now - sent_time)) / 8;
+		download->backoff = 0;
+
+		// chunks sent before this one, but still unacknowledged, were lost
+		download->acked_time = MAX(download->acked_time, sent_time);
+	}
+
+	// slide the window, freeing the slots of the chunks it has passed
+	for (i = base; i < new_base; i++) {
+		download->sent_time[i % DOWNLOAD_WINDOW] = 0;
+	}
+
+	const int32_t shift = new_base - base;
+
+	download->acked = shift < DOWNLOAD_WINDOW ? download->acked >> shift : 0;
+	download->resent = shift < DOWNLOAD_WINDOW ? download->resent >> shift : 0;
+
+	download->acked |= mask << 1;
+
+	download->offset = offset;
+	download->last_ack = now;
+
+	if (download->offset == download->file->size) {
+		Com_Debug("Finished download to %s\n", Sv_NetaddrToString(client));
+		Sv_EndDownload(client);
+	}
+}
+
+/*
+ * @brief Streams the unacknowledged chunks within the download window to a
+ * PROTOCOL client. The window is the product of the client's rate and the
+ * round trip time, and chunks are paced to the rate. Chunks are retransmitted
+ * once a chunk sent after them is acknowledged, or if they are not acknowledged
+ * within a couple of round trips. The chunks sent are also counted towards the
+ * client's rate estimation, so that Sv_RateDrop holds back game datagrams while
+ * a download saturates the connection.
+ */
+void Sv_SendDownload(sv_client_t *client) {
+	byte buf[MAX_MSG_SIZE];
+	mem_buf_t msg;
+	int32_t i;
+
+	sv_download_t *download = &client->download;
+
+	if (!download->file || client->protocol != PROTOCOL)
+		return;
+
+	const uint32_t now = quake2world.time;
+
+	if (now - download->last_ack > SV_DOWNLOAD_TIMEOUT) {
+		Com_Debug("Download of %s to %s timed out\n", download->file->name,
+				Sv_NetaddrToString(client));
+		Sv_EndDownload(client);
+		return;
+	}
+
+	const int32_t window = Clamp(client->rate * download->rtt / 1000 / DOWNLOAD_CHUNK_SIZE + 1, 2,
+			DOWNLOAD_WINDOW);
+
+	download->credit += client->rate / svs.frame_rate;
+	download->credit = MIN(download->credit, (uint32_t) window * DOWNLOAD_CHUNK_SIZE);
+
+	const uint32_t timeout = (download->rtt * 2 + 1000 / svs.frame_rate) << download->backoff;
+
+	const int32_t base = Sv_DownloadChunk(download, download->offset);
+	const int32_t num_chunks = Sv_DownloadChunk(download, download->file->size);
+
+	Mem_InitBuffer(&msg, buf, sizeof(buf));
+
+	for (i = 0; i < window && base + i < num_chunks; i++) {
+
+		if (download->acked & (1u << i))
+			continue;
+
+		uint32_t *sent_time = &download->sent_time[(base + i) % DOWNLOAD_WINDOW];
+
+		if (*sent_time) {
+			if (*sent_time < download->acked_time) { // a later chunk has arrived
+				*sent_time = 0;
+			} else if (now - *sent_time < timeout) {
+				continue;
+			} else if (i == 0) { // the oldest chunk timed out, so back off
+				download->backoff = MIN(download->backoff + 1, 2);
+			}
+
+			download->resent |= (1u << i);
+		}
+
+		const int32_t offset = download->start + (base + i) * DOWNLOAD_CHUNK_SIZE;
+		const int32_t len = MIN(DOWNLOAD_CHUNK_SIZE, download->file->size - offset);
+
+		if (download->credit < (uint32_t) len)
+			break;
+
+		download->credit -= len;
+
+		// flush any reliable message first, so that the chunk is not dumped
+		if (Netchan_NeedReliable(&client->net_chan)) {
+			Netchan_Transmit(&client->net_chan, NULL, 0);
+		}
+
+		Mem_ClearBuffer(&msg);
+		Sv_WriteDownloadChunk(&msg, download, offset, len);
+
+		Netchan_Transmit(&client->net_chan, msg.data, msg.size);
+
+		client->message_size[sv.frame_num % CLIENT_RATE_MESSAGES] += msg.size;
+
+		*sent_time = now;
+	}
+}
+
+/*
+ * @brief Releases the client's download, if any.
+ */
+void Sv_EndDownload(sv_client_t *client) {
+	sv_download_t *download = &client->download;
+
+	if (download->file) {
+		Sv_CloseDownloadFile(download->file);
+	}
+
+	const uint8_t id = download->id;
+
+	memset(download, 0, sizeof(*download));
+
+	download->id = id;
+}
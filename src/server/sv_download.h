@@ -0,0 +1,37 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef __SV_DOWNLOAD_H__
+#define __SV_DOWNLOAD_H__
+
+#include "sv_types.h"
+
+#ifdef __SV_LOCAL_H__
+void Sv_RefuseDownload(sv_client_t *client);
+_Bool Sv_BeginDownload(sv_client_t *client, const char *filename, int32_t offset);
+void Sv_NextDownload(sv_client_t *client);
+void Sv_AcknowledgeDownload(sv_client_t *client, const uint8_t id, const int32_t offset,
+		const uint32_t mask);
+void Sv_SendDownload(sv_client_t *client);
+void Sv_EndDownload(sv_client_t *client);
+#endif /* __SV_LOCAL_H__ */
+
+#endif /* __SV_DOWNLOAD_H__ */
@@ -22,194 +22,80 @@
 #include "sv_local.h"
 
 /*
- * @brief Writes a delta update of an entity_state_t list to the message.
+ * @brief Reverts the client to the map baselines, e.g. because it has asked
+ * for an uncompressed frame.
  */
-static void Sv_EmitEntities(sv_frame_t *from, sv_frame_t *to, mem_buf_t *msg) {
-	entity_state_t *old_state = NULL, *new_state = NULL;
-	uint32_t old_index, new_index;
-	uint16_t old_num, new_num;
-	uint16_t from_num_entities;
-
-	if (!from)
-		from_num_entities = 0;
-	else
-		from_num_entities = from->num_entities;
-
-	new_index = 0;
-	old_index = 0;
-	while (new_index < to->num_entities || old_index < from_num_entities) {
-		if (new_index >= to->num_entities)
-			new_num = 0xffff;
-		else {
-			new_state = &svs.entity_states[(to->first_entity + new_index) % svs.num_entity_states];
-			new_num = new_state->number;
-		}
-
-		if (old_index >= from_num_entities)
-			old_num = 0xffff;
-		else {
-			old_state
-					= &svs.entity_states[(from->first_entity + old_index) % svs.num_entity_states];
-			old_num = old_state->number;
-		}
-
-		if (new_num == old_num) { // delta update from old position
-			Net_WriteDeltaEntity(msg, old_state, new_state, false,
-					new_state->number <= sv_max_clients->integer);
-			old_index++;
-			new_index++;
-			continue;
-		}
+void Sv_ResetBaseline(sv_client_t *client) {
 
-		if (new_num < old_num) { // this is a new entity, send it from the baseline
-			Net_WriteDeltaEntity(msg, &sv.baselines[new_num], new_state, true, true);
-			new_index++;
-			continue;
-		}
-
-		if (new_num > old_num) { // the old entity isn't present in the new message
-			const int16_t bits = U_REMOVE;
-
-			Net_WriteShort(msg, old_num);
-			Net_WriteShort(msg, bits);
-
-			old_index++;
-			continue;
-		}
-	}
-
-	Net_WriteShort(msg, 0); // end of entities
+	client->baseline.frame_num = 0;
+	client->pending_baseline.frame_num = 0;
 }
 
 /*
- * @brief
+ * @brief Resolves the entity states of the specified frame.
  */
-static void Sv_WritePlayerstate(sv_frame_t *from, sv_frame_t *to, mem_buf_t *msg) {
-	uint16_t pm_state_bits;
-	uint32_t stat_bits;
-	player_state_t *ps, *ops;
-	player_state_t dummy;
-	int32_t i;
-
-	ps = &to->ps;
-
-	if (!from) {
-		memset(&dummy, 0, sizeof(dummy));
-		ops = &dummy;
-	} else {
-		ops = &from->ps;
-	}
-
-	// determine what needs to be sent
-	pm_state_bits = 0;
-
-	if (ps->pm_state.type != ops->pm_state.type)
-		pm_state_bits |= PS_PM_TYPE;
-
-	if (ps->pm_state.origin[0] != ops->pm_state.origin[0] || ps->pm_state.origin[1]
-			!= ops->pm_state.origin[1] || ps->pm_state.origin[2] != ops->pm_state.origin[2])
-		pm_state_bits |= PS_PM_ORIGIN;
+static void Sv_FrameEntities(const sv_frame_t *frame, net_entities_t *entities) {
 
-	if (ps->pm_state.velocity[0] != ops->pm_state.velocity[0] || ps->pm_state.velocity[1]
-			!= ops->pm_state.velocity[1] || ps->pm_state.velocity[2] != ops->pm_state.velocity[2])
-		pm_state_bits |= PS_PM_VELOCITY;
-
-	if (ps->pm_state.flags != ops->pm_state.flags)
-		pm_state_bits |= PS_PM_FLAGS;
-
-	if (ps->pm_state.time != ops->pm_state.time)
-		pm_state_bits |= PS_PM_TIME;
-
-	if (ps->pm_state.gravity != ops->pm_state.gravity)
-		pm_state_bits |= PS_PM_GRAVITY;
-
-	if (ps->pm_state.view_offset[0] != ops->pm_state.view_offset[0] || ps->pm_state.view_offset[1]
-			!= ops->pm_state.view_offset[1] || ps->pm_state.view_offset[2]
-			!= ops->pm_state.view_offset[2])
-		pm_state_bits |= PS_PM_VIEW_OFFSET;
-
-	if (ps->pm_state.view_angles[0] != ops->pm_state.view_angles[0] || ps->pm_state.view_angles[1]
-			!= ops->pm_state.view_angles[1] || ps->pm_state.view_angles[2]
-			!= ops->pm_state.view_angles[2])
-		pm_state_bits |= PS_PM_VIEW_ANGLES;
-
-	if (ps->pm_state.kick_angles[0] != ops->pm_state.kick_angles[0] || ps->pm_state.kick_angles[1]
-			!= ops->pm_state.kick_angles[1] || ps->pm_state.kick_angles[2]
-			!= ops->pm_state.kick_angles[2])
-		pm_state_bits |= PS_PM_KICK_ANGLES;
-
-	if (ps->pm_state.delta_angles[0] != ops->pm_state.delta_angles[0]
-			|| ps->pm_state.delta_angles[1] != ops->pm_state.delta_angles[1]
-			|| ps->pm_state.delta_angles[2] != ops->pm_state.delta_angles[2])
-		pm_state_bits |= PS_PM_DELTA_ANGLES;
-
-	// write it
-	Net_WriteShort(msg, pm_state_bits);
-
-	// write the pmove_state_t
-	if (pm_state_bits & PS_PM_TYPE)
-		Net_WriteByte(msg, ps->pm_state.type);
-
-	if (pm_state_bits & PS_PM_ORIGIN) {
-		Net_WriteShort(msg, ps->pm_state.origin[0]);
-		Net_WriteShort(msg, ps->pm_state.origin[1]);
-		Net_WriteShort(msg, ps->pm_state.origin[2]);
-	}
-
-	if (pm_state_bits & PS_PM_VELOCITY) {
-		Net_WriteShort(msg, ps->pm_state.velocity[0]);
-		Net_WriteShort(msg, ps->pm_state.velocity[1]);
-		Net_WriteShort(msg, ps->pm_state.velocity[2]);
-	}
+	entities->states = svs.entity_states;
+	entities->num_states = svs.num_entity_states;
+	entities->first = frame->first_entity;
+	entities->num_entities = frame->num_entities;
+}
 
-	if (pm_state_bits & PS_PM_FLAGS)
-		Net_WriteShort(msg, ps->pm_state.flags);
+/*
+ * @brief Promotes the pending baselines once the client has folded them too.
+ */
+void Sv_AcknowledgeBaseline(sv_client_t *client, int32_t frame_num) {
+	Net_AcknowledgeBaseline(&client->baseline, &client->pending_baseline, frame_num);
+}
 
-	if (pm_state_bits & PS_PM_TIME)
-		Net_WriteShort(msg, ps->pm_state.time);
+/*
+ * @brief Folds the client's most recently acknowledged frame into a copy of its
+ * baselines. See Net_UpdateBaseline.
+ */
+static void Sv_UpdateBaseline(sv_client_t *client) {
+	net_entities_t entities;
 
-	if (pm_state_bits & PS_PM_GRAVITY)
-		Net_WriteShort(msg, ps->pm_state.gravity);
+	const sv_frame_t *frame = &client->frames[client->last_frame & PACKET_MASK];
+	Sv_FrameEntities(frame, &entities);
 
-	if (pm_state_bits & PS_PM_VIEW_OFFSET) {
-		Net_WriteShort(msg, ps->pm_state.view_offset[0]);
-		Net_WriteShort(msg, ps->pm_state.view_offset[1]);
-		Net_WriteShort(msg, ps->pm_state.view_offset[2]);
-	}
+	Net_UpdateBaseline(&client->pending_baseline, &client->baseline, sv.baselines, sv.frame_num,
+			client->last_frame, &entities, svs.next_entity_state, &frame->ps);
+}
 
-	if (pm_state_bits & PS_PM_VIEW_ANGLES) {
-		Net_WriteShort(msg, ps->pm_state.view_angles[0]);
-		Net_WriteShort(msg, ps->pm_state.view_angles[1]);
-		Net_WriteShort(msg, ps->pm_state.view_angles[2]);
-	}
+/*
+ * @brief Writes a delta update of an entity_state_t list to the message.
+ */
+static void Sv_EmitEntities(const sv_client_t *client, sv_frame_t *from, sv_frame_t *to,
+		mem_buf_t *msg) {
+	net_entities_t from_entities, to_entities;
 
-	if (pm_state_bits & PS_PM_KICK_ANGLES) {
-		Net_WriteShort(msg, ps->pm_state.kick_angles[0]);
-		Net_WriteShort(msg, ps->pm_state.kick_angles[1]);
-		Net_WriteShort(msg, ps->pm_state.kick_angles[2]);
+	if (from) {
+		Sv_FrameEntities(from, &from_entities);
 	}
 
-	if (pm_state_bits & PS_PM_DELTA_ANGLES) {
-		Net_WriteShort(msg, ps->pm_state.delta_angles[0]);
-		Net_WriteShort(msg, ps->pm_state.delta_angles[1]);
-		Net_WriteShort(msg, ps->pm_state.delta_angles[2]);
-	}
+	Sv_FrameEntities(to, &to_entities);
 
-	// send stats
-	stat_bits = 0;
+	const entity_state_t *baselines = Net_Baselines(&client->baseline, sv.baselines);
 
-	for (i = 0; i < MAX_STATS; i++) {
-		if (ps->stats[i] != ops->stats[i]) {
-			stat_bits |= 1 << i;
-		}
-	}
+	Net_WriteEntities(msg, from ? &from_entities : NULL, &to_entities, baselines,
+			sv_max_clients->integer, client->protocol);
+}
 
-	Net_WriteLong(msg, stat_bits);
+/*
+ * @brief
+ */
+static void Sv_WritePlayerstate(const sv_client_t *client, sv_frame_t *from, sv_frame_t *to,
+		mem_buf_t *msg) {
+	player_state_t dummy;
 
-	for (i = 0; i < MAX_STATS; i++) {
-		if (stat_bits & (1 << i)) {
-			Net_WriteShort(msg, ps->stats[i]);
-		}
+	if (from) {
+		Net_WriteDeltaPlayerState(msg, &from->ps, &to->ps);
+	} else if (client->baseline.frame_num) {
+		Net_WriteDeltaPlayerState(msg, &client->baseline.ps, &to->ps);
+	} else {
+		memset(&dummy, 0, sizeof(dummy));
+		Net_WriteDeltaPlayerState(msg, &dummy, &to->ps);
 	}
 }
 
@@ -240,6 +126,12 @@ void Sv_WriteFrame(sv_client_t *client, mem_buf_t *msg) {
 	Net_WriteByte(msg, SV_CMD_FRAME);
 	Net_WriteLong(msg, sv.frame_num);
 	Net_WriteLong(msg, delta_frame_num); // what we are delta'ing from
+
+	if (client->protocol == PROTOCOL) {
+		Sv_UpdateBaseline(client);
+
+		Net_WriteBaselines(msg, &client->baseline, &client->pending_baseline);
+	}
 	Net_WriteByte(msg, client->surpress_count); // rate dropped packets
 	client->surpress_count = 0;
 
@@ -248,10 +140,10 @@ void Sv_WriteFrame(sv_client_t *client, mem_buf_t *msg) {
 	Net_WriteData(msg, frame->area_bits, frame->area_bytes);
 
 	// delta encode the playerstate
-	Sv_WritePlayerstate(delta_frame, frame, msg);
+	Sv_WritePlayerstate(client, delta_frame, frame, msg);
 
 	// delta encode the entities
-	Sv_EmitEntities(delta_frame, frame, msg);
+	Sv_EmitEntities(client, delta_frame, frame, msg);
 }
 
 /*
@@ -259,12 +151,11 @@ void Sv_WriteFrame(sv_client_t *client, mem_buf_t *msg) {
  * bounding box provides some leniency because the client's actual view origin
  * is likely slightly different than what we think it is.
  */
-static byte *Sv_ClientPVS(const vec3_t org) {
-	static byte pvs[MAX_BSP_LEAFS >> 3];
+static void Sv_ClientPVS(const vec3_t org, byte *pvs) {
 	int32_t leafs[64];
 	int32_t i, j, count;
 	int32_t longs;
-	byte *src;
+	const byte *src;
 	vec3_t mins, maxs;
 
 	for (i = 0; i < 3; i++) {
@@ -283,7 +174,7 @@ static byte *Sv_ClientPVS(const vec3_t org) {
 	for (i = 0; i < count; i++)
 		leafs[i] = Cm_LeafCluster(leafs[i]);
 
-	memcpy(pvs, Cm_ClusterPVS(leafs[0]), longs << 2);
+	memcpy(pvs, Sv_ClusterPVS(leafs[0]), longs << 2);
 
 	// or in all the other leaf bits
 	for (i = 1; i < count; i++) {
@@ -292,12 +183,79 @@ static byte *Sv_ClientPVS(const vec3_t org) {
 				break;
 		if (j != i)
 			continue; // already have the cluster we want
-		src = Cm_ClusterPVS(leafs[i]);
+		src = Sv_ClusterPVS(leafs[i]);
 		for (j = 0; j < longs; j++)
-			((uint32_t *) pvs)[j] |= ((uint32_t *) src)[j];
+			((uint32_t *) pvs)[j] |= ((const uint32_t *) src)[j];
 	}
+}
 
-	return pvs;
+/*
+ * @brief Resolves the specified client's view from its current player state.
+ */
+static void Sv_UpdateClientView(sv_client_t *client) {
+	sv_client_view_t *view = &client->view;
+	int32_t i;
+
+	Sv_ProfileCount(SV_PROFILE_CLIENT_VIEW);
+
+	const pm_state_t *pm = &client->edict->client->ps.pm_state;
+
+	VectorScale(pm->origin, 0.125, view->origin);
+	for (i = 0; i < 3; i++)
+		view->origin[i] += pm->view_offset[i] * 0.125;
+
+	view->leaf_num = Sv_PointLeafnum(view->origin);
+	view->cluster = Cm_LeafCluster(view->leaf_num);
+	view->area = Cm_LeafArea(view->leaf_num);
+
+	// calculate the visible areas
+	view->area_bytes = Cm_WriteAreaBits(view->area_bits, view->area);
+
+	// resolve the visibility data
+	Sv_ClientPVS(view->origin, view->pvs);
+	memcpy(view->phs, Sv_ClusterPHS(view->cluster), ((Cm_NumClusters() + 31) >> 5) << 2);
+
+	view->frame_num = sv.frame_num;
+}
+
+/*
+ * @brief Returns the specified client's view for the current frame. Views are
+ * resolved for all active clients after the game has run, and otherwise on
+ * demand, e.g. for multicasts issued by the game itself.
+ */
+const sv_client_view_t *Sv_ClientView(sv_client_t *client) {
+
+	if (client->view.frame_num == sv.frame_num) {
+		Sv_ProfileCount(SV_PROFILE_CLIENT_VIEW_CACHED);
+	} else {
+		Sv_UpdateClientView(client);
+	}
+
+	return &client->view;
+}
+
+/*
+ * @brief Resolves the views of all active clients, now that the game has run.
+ * These are used to build the client frames, and by any multicasts issued
+ * before the next game frame.
+ */
+void Sv_UpdateClientViews(void) {
+	sv_client_t *client;
+	int32_t i;
+
+	if (sv.state != SV_ACTIVE_GAME)
+		return;
+
+	for (i = 0, client = svs.clients; i < sv_max_clients->integer; i++, client++) {
+
+		if (client->state != SV_CLIENT_ACTIVE)
+			continue;
+
+		if (!client->edict->client)
+			continue;
+
+		Sv_UpdateClientView(client);
+	}
 }
 
 /*
@@ -306,17 +264,11 @@ static byte *Sv_ClientPVS(const vec3_t org) {
  */
 void Sv_BuildClientFrame(sv_client_t *client) {
 	uint32_t e;
-	vec3_t org;
 	g_edict_t *ent;
 	g_edict_t *cent;
-	pm_state_t *pm;
 	sv_frame_t *frame;
 	entity_state_t *state;
 	int32_t i;
-	int32_t area, cluster;
-	int32_t leaf;
-	byte *phs;
-	byte *vis;
 
 	cent = client->edict;
 	if (!cent->client)
@@ -328,26 +280,15 @@ void Sv_BuildClientFrame(sv_client_t *client) {
 	frame->sent_time = svs.real_time; // save it for ping calc later
 
 	// find the client's PVS
-	pm = &cent->client->ps.pm_state;
+	const sv_client_view_t *view = Sv_ClientView(client);
 
-	VectorScale(pm->origin, 0.125, org);
-	for (i = 0; i < 3; i++)
-		org[i] += pm->view_offset[i] * 0.125;
-
-	leaf = Cm_PointLeafnum(org);
-	area = Cm_LeafArea(leaf);
-	cluster = Cm_LeafCluster(leaf);
-
-	// calculate the visible areas
-	frame->area_bytes = Cm_WriteAreaBits(frame->area_bits, area);
+	// copy the visible areas
+	frame->area_bytes = view->area_bytes;
+	memcpy(frame->area_bits, view->area_bits, sizeof(frame->area_bits));
 
 	// grab the current player_state_t
 	frame->ps = cent->client->ps;
 
-	// resolve the visibility data
-	vis = Sv_ClientPVS(org);
-	phs = Cm_ClusterPHS(cluster);
-
 	// build up the list of relevant entities
 	frame->num_entities = 0;
 	frame->first_entity = svs.next_entity_state;
@@ -366,13 +307,13 @@ void Sv_BuildClientFrame(sv_client_t *client) {
 		// ignore if not touching a PVS leaf
 		if (ent != cent) {
 			// check area
-			if (!Cm_AreasConnected(area, ent->area_num)) { // doors can occupy two areas, so
+			if (!Cm_AreasConnected(view->area, ent->area_num)) { // doors can occupy two areas, so
 				// we may need to check another one
-				if (!ent->area_num2 || !Cm_AreasConnected(area, ent->area_num2))
+				if (!ent->area_num2 || !Cm_AreasConnected(view->area, ent->area_num2))
 					continue; // blocked by a door
 			}
 
-			const byte *vis_data = ent->s.sound || ent->s.event ? phs : vis;
+			const byte *vis_data = ent->s.sound || ent->s.event ? view->phs : view->pvs;
 
 			if (ent->num_clusters == -1) { // too many leafs for individual check, go by head_node
 				if (!Cm_HeadnodeVisible(ent->head_node, vis_data))
@@ -25,7 +25,11 @@
 #include "sv_types.h"
 
 #ifdef __SV_LOCAL_H__
+void Sv_ResetBaseline(sv_client_t *client);
+void Sv_AcknowledgeBaseline(sv_client_t *client, int32_t frame_num);
 void Sv_WriteFrame(sv_client_t *client, mem_buf_t *msg);
+const sv_client_view_t *Sv_ClientView(sv_client_t *client);
+void Sv_UpdateClientViews(void);
 void Sv_BuildClientFrame(sv_client_t *client);
 #endif /* __SV_LOCAL_H__ */
 
@@ -152,14 +152,14 @@ static _Bool Sv_InPVS(const vec3_t p1, const vec3_t p2) {
 	int32_t leaf_num;
 	int32_t cluster;
 	int32_t area1, area2;
-	byte *mask;
+	const byte *mask;
 
-	leaf_num = Cm_PointLeafnum(p1);
+	leaf_num = Sv_PointLeafnum(p1);
 	cluster = Cm_LeafCluster(leaf_num);
 	area1 = Cm_LeafArea(leaf_num);
-	mask = Cm_ClusterPVS(cluster);
+	mask = Sv_ClusterPVS(cluster);
 
-	leaf_num = Cm_PointLeafnum(p2);
+	leaf_num = Sv_PointLeafnum(p2);
 	cluster = Cm_LeafCluster(leaf_num);
 	area2 = Cm_LeafArea(leaf_num);
 
@@ -179,14 +179,14 @@ static _Bool Sv_InPHS(const vec3_t p1, const vec3_t p2) {
 	int32_t leaf_num;
 	int32_t cluster;
 	int32_t area1, area2;
-	byte *mask;
+	const byte *mask;
 
-	leaf_num = Cm_PointLeafnum(p1);
+	leaf_num = Sv_PointLeafnum(p1);
 	cluster = Cm_LeafCluster(leaf_num);
 	area1 = Cm_LeafArea(leaf_num);
-	mask = Cm_ClusterPHS(cluster);
+	mask = Sv_ClusterPHS(cluster);
 
-	leaf_num = Cm_PointLeafnum(p2);
+	leaf_num = Sv_PointLeafnum(p2);
 	cluster = Cm_LeafCluster(leaf_num);
 	area2 = Cm_LeafArea(leaf_num);
 
@@ -269,6 +269,7 @@ void Sv_InitGame(void) {
 	import.PositionedSound = Sv_PositionedSound;
 
 	import.Trace = Sv_Trace;
+	import.RewindTrace = Sv_RewindTrace;
 	import.PointContents = Sv_PointContents;
 	import.inPVS = Sv_InPVS;
 	import.inPHS = Sv_InPHS;
@@ -278,6 +279,7 @@ void Sv_InitGame(void) {
 	import.LinkEdict = Sv_LinkEdict;
 	import.UnlinkEdict = Sv_UnlinkEdict;
 	import.AreaEdicts = Sv_AreaEdicts;
+	import.RadiusEdicts = Sv_RadiusEdicts;
 
 	import.Multicast = Sv_Multicast;
 	import.Unicast = Sv_Unicast;
@@ -296,6 +298,10 @@ void Sv_InitGame(void) {
 	import.BroadcastPrint = Sv_BroadcastPrint;
 	import.ClientPrint = Sv_ClientPrint;
 
+	import.ProfileScope = Sv_ProfileScope;
+	import.ProfileBegin = Sv_ProfileBegin;
+	import.ProfileEnd = Sv_ProfileEnd;
+
 	svs.game = (g_export_t *) Sys_LoadLibrary("game", &game_handle, "G_LoadGame", &import);
 
 	if (!svs.game) {
@@ -135,7 +135,7 @@ static void Sv_ClearState() {
 	if (svs.initialized) { // if we were intialized, cleanup
 
 		if (sv.demo_file) {
-			Fs_Close(sv.demo_file);
+			Demo_Close(sv.demo_file);
 		}
 	}
 
@@ -172,10 +172,7 @@ static void Sv_ShutdownClients(void) {
 		return;
 
 	for (i = 0, cl = svs.clients; i < sv_max_clients->integer; i++, cl++) {
-
-		if (cl->download.buffer) {
-			Fs_Free(cl->download.buffer);
-		}
+		Sv_EndDownload(cl);
 	}
 
 	Mem_Free(svs.clients);
@@ -233,6 +230,10 @@ static void Sv_InitClients(void) {
 
 		// invalidate last frame to force a baseline
 		svs.clients[i].last_frame = -1;
+
+		// and the view, which was resolved in the previous level
+		svs.clients[i].view.frame_num = -1;
+		Sv_ResetBaseline(&svs.clients[i]);
 		svs.clients[i].last_message = svs.real_time;
 	}
 }
@@ -251,7 +252,10 @@ static void Sv_LoadMedia(const char *server, sv_state_t state) {
 	if (state == SV_ACTIVE_DEMO) { // loading a demo
 		sv.models[0] = Cm_LoadBsp(NULL, &map_size);
 
-		sv.demo_file = Fs_OpenRead(va("demos/%s.dem", sv.name));
+		if (!(sv.demo_file = Demo_OpenRead(va("demos/%s.dem", sv.name)))) {
+			Com_Error(ERR_DROP, "Couldn't open demos/%s.dem\n", sv.name);
+		}
+
 		svs.spawn_count = 0;
 
 		Com_Print("  Loaded demo %s.\n", sv.name);
@@ -33,6 +33,7 @@ cvar_t *sv_enforce_time;
 cvar_t *sv_hostname;
 cvar_t *sv_hz;
 cvar_t *sv_max_clients;
+cvar_t *sv_max_rewind;
 cvar_t *sv_no_areas;
 cvar_t *sv_public;
 cvar_t *sv_rcon_password; // password for remote server commands
@@ -57,9 +58,7 @@ void Sv_DropClient(sv_client_t *cl) {
 		Netchan_Transmit(&cl->net_chan, cl->net_chan.message.data, cl->net_chan.message.size);
 	}
 
-	if (cl->download.buffer) {
-		Fs_Free(cl->download.buffer);
-	}
+	Sv_EndDownload(cl);
 
 	ent = cl->edict;
 
@@ -67,6 +66,7 @@ void Sv_DropClient(sv_client_t *cl) {
 
 	cl->edict = ent;
 	cl->last_frame = -1;
+	cl->view.frame_num = -1;
 }
 
 /*
@@ -125,7 +125,7 @@ static void Svc_Info(void) {
 		return; // ignore in single player
 
 	const int32_t p = atoi(Cmd_Argv(1));
-	if (p != PROTOCOL) {
+	if (p != PROTOCOL && p != PROTOCOL_LEGACY) {
 		g_snprintf(string, sizeof(string), "%s: Wrong protocol: %d != %d", sv_hostname->string, p,
 				PROTOCOL);
 	} else {
@@ -184,8 +184,9 @@ static void Svc_GetChallenge(void) {
 		i = oldest;
 	}
 
-	// send it back
-	Netchan_OutOfBandPrint(NS_UDP_SERVER, &net_from, "challenge %i", svs.challenges[i].challenge);
+	// send it back, along with the newest protocol we speak
+	Netchan_OutOfBandPrint(NS_UDP_SERVER, &net_from, "challenge %i %i", svs.challenges[i].challenge,
+			PROTOCOL);
 }
 
 /*
@@ -202,8 +203,8 @@ static void Svc_Connect(void) {
 
 	const int32_t version = strtol(Cmd_Argv(1), NULL, 0);
 
-	// resolve protocol
-	if (version != PROTOCOL) {
+	// resolve protocol, older clients will not know to ask for the newest one
+	if (version != PROTOCOL && version != PROTOCOL_LEGACY) {
 		Netchan_OutOfBandPrint(NS_UDP_SERVER, addr, "print\nServer is version %d.\n", PROTOCOL);
 		return;
 	}
@@ -319,6 +320,9 @@ static void Svc_Connect(void) {
 
 	Netchan_Setup(NS_UDP_SERVER, &client->net_chan, addr, qport);
 
+	client->protocol = version;
+	Sv_ResetBaseline(client);
+
 	Mem_InitBuffer(&client->datagram.buffer, client->datagram.data, sizeof(client->datagram.data));
 	client->datagram.buffer.allow_overflow = true;
 
@@ -613,7 +617,11 @@ static void Sv_RunGameFrame(void) {
 	}
 
 	if (sv.state == SV_ACTIVE_GAME) {
+		Sv_ProfileBegin(SV_PROFILE_GAME_FRAME);
 		svs.game->Frame();
+		Sv_ProfileEnd(SV_PROFILE_GAME_FRAME);
+
+		Sv_RecordRewindFrame();
 	}
 }
 
@@ -793,10 +801,14 @@ void Sv_Frame(const uint32_t msec) {
 	svs.real_time += msec;
 
 	// check timeouts
+	Sv_ProfileBegin(SV_PROFILE_CHECK_TIMEOUTS);
 	Sv_CheckTimeouts();
+	Sv_ProfileEnd(SV_PROFILE_CHECK_TIMEOUTS);
 
 	// get packets from clients
+	Sv_ProfileBegin(SV_PROFILE_READ_PACKETS);
 	Sv_ReadPackets();
+	Sv_ProfileEnd(SV_PROFILE_READ_PACKETS);
 
 	const uint32_t frame_millis = 1000 / svs.frame_rate;
 
@@ -813,24 +825,44 @@ void Sv_Frame(const uint32_t msec) {
 		}
 	}
 
+	Sv_ProfileBegin(SV_PROFILE_FRAME);
+
 	// update ping based on the last known frame from all clients
+	Sv_ProfileBegin(SV_PROFILE_UPDATE_PINGS);
 	Sv_UpdatePings();
+	Sv_ProfileEnd(SV_PROFILE_UPDATE_PINGS);
 
 	// give the clients some timeslices
+	Sv_ProfileBegin(SV_PROFILE_CHECK_COMMAND_TIMES);
 	Sv_CheckCommandTimes();
+	Sv_ProfileEnd(SV_PROFILE_CHECK_COMMAND_TIMES);
 
 	// let everything in the world think and move
 	Sv_RunGameFrame();
 
+	// resolve what each client can now see and hear
+	Sv_ProfileBegin(SV_PROFILE_UPDATE_CLIENT_VIEWS);
+	Sv_UpdateClientViews();
+	Sv_ProfileEnd(SV_PROFILE_UPDATE_CLIENT_VIEWS);
+
 	// send messages back to the clients that had packets read this frame
+	Sv_ProfileBegin(SV_PROFILE_SEND_CLIENT_MESSAGES);
 	Sv_SendClientMessages();
+	Sv_ProfileEnd(SV_PROFILE_SEND_CLIENT_MESSAGES);
 
 	// send a heartbeat to the master if needed
+	Sv_ProfileBegin(SV_PROFILE_HEARTBEAT_MASTERS);
 	Sv_HeartbeatMasters();
+	Sv_ProfileEnd(SV_PROFILE_HEARTBEAT_MASTERS);
 
 	// clear entity flags, etc for next frame
 	Sv_ResetEntities();
 
+	Sv_ProfileEnd(SV_PROFILE_FRAME);
+
+	// commit this frame's timings
+	Sv_ProfileFrame();
+
 #ifdef HAVE_CURSES
 	Curses_Frame(msec);
 #endif
@@ -849,6 +881,8 @@ static void Sv_InitLocal(void) {
 	sv_hostname = Cvar_Get("sv_hostname", "Quake2World", CVAR_SERVER_INFO | CVAR_ARCHIVE, NULL);
 	sv_hz = Cvar_Get("sv_hz", va("%d", SV_HZ), CVAR_SERVER_INFO | CVAR_LATCH, NULL);
 
+	sv_max_rewind = Cvar_Get("sv_max_rewind", "200", CVAR_SERVER_INFO,
+			"Maximum milliseconds to rewind clients for lag compensation, 0 disables\n");
 	sv_no_areas = Cvar_Get("sv_no_areas", "0", CVAR_LATCH, "Disable server-side area management\n");
 
 	sv_public = Cvar_Get("sv_public", "0", 0, "Set to 1 to to advertise to the master server\n");
@@ -876,6 +910,8 @@ void Sv_Init(void) {
 
 	Sv_InitCommands();
 
+	Sv_InitProfile();
+
 	Sv_InitMasters();
 
 	Mem_InitBuffer(&net_message, net_message_buffer, sizeof(net_message_buffer));
@@ -892,6 +928,8 @@ void Sv_Shutdown(const char *msg) {
 
 	Sv_ShutdownMasters();
 
+	Sv_ShutdownProfile();
+
 	Net_Config(NS_UDP_SERVER, false);
 
 	Mem_InitBuffer(&net_message, net_message_buffer, sizeof(net_message_buffer));
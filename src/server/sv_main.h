@@ -35,6 +35,7 @@ extern cvar_t *sv_enforce_time;
 extern cvar_t *sv_hostname;
 extern cvar_t *sv_hz;
 extern cvar_t *sv_max_clients;
+extern cvar_t *sv_max_rewind;
 extern cvar_t *sv_no_areas;
 extern cvar_t *sv_public;
 extern cvar_t *sv_rcon_password;
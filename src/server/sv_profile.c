@@ -0,0 +1,422 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "sv_local.h"
+
+#define SV_PROFILE_PANEL_INTERVAL 500
+
+/*
+ * @brief The profiler state is retained across levels, so that samples may be
+ * accumulated over a map rotation.
+ */
+typedef struct {
+	_Bool enabled;
+	_Bool panel;
+
+	sv_profile_scope_t scopes[SV_PROFILE_MAX_SCOPES];
+	uint16_t num_scopes;
+
+	uint32_t frame_num; // frames sampled
+	uint32_t panel_time;
+
+	sv_profile_event_t *events; // allocated while tracing
+	uint32_t num_events;
+	uint32_t trace_frames; // remaining frames to trace
+	uint64_t trace_time;
+	char trace_file[MAX_QPATH];
+} sv_profile_state_t;
+
+static sv_profile_state_t sv_profile;
+
+static const char *sv_profile_scope_names[] = {
+	"",
+	"Sv_Frame",
+	"Sv_CheckTimeouts",
+	"Sv_ReadPackets",
+	"Sv_UpdatePings",
+	"Sv_CheckCommandTimes",
+	"G_Frame",
+	"Sv_SendClientMessages",
+	"Sv_HeartbeatMasters",
+	"G_ClientThink",
+	"Sv_Trace",
+	"Sv_UpdateClientViews",
+	"Sv_ClientView",
+	"Sv_ClientView (cached)",
+	"Cm_PointLeafnum",
+	"Cm_PointLeafnum (cached)",
+	"Cm_ClusterPVS",
+	"Cm_ClusterPVS (cached)"
+};
+
+/*
+ * @brief Resolves the profiling scope by the given name, registering it if it
+ * is new. SV_PROFILE_NONE is returned if there are no scopes left.
+ */
+uint16_t Sv_ProfileScope(const char *name) {
+	uint16_t i;
+
+	for (i = 1; i < sv_profile.num_scopes; i++) {
+		if (!g_strcmp0(sv_profile.scopes[i].name, name))
+			return i;
+	}
+
+	if (sv_profile.num_scopes == SV_PROFILE_MAX_SCOPES) {
+		Com_Warn("SV_PROFILE_MAX_SCOPES reached for %s\n", name);
+		return SV_PROFILE_NONE;
+	}
+
+	g_strlcpy(sv_profile.scopes[i].name, name, sizeof(sv_profile.scopes[i].name));
+
+	return sv_profile.num_scopes++;
+}
+
+/*
+ * @brief Opens the specified scope. Scopes may nest and recurse, and are only
+ * timed while profiling is enabled.
+ */
+void Sv_ProfileBegin(const uint16_t scope) {
+
+	if (!sv_profile.enabled || !scope)
+		return;
+
+	sv_profile_scope_t *s = &sv_profile.scopes[scope];
+
+	if (s->depth++ == 0)
+		s->begin = Sys_Microseconds();
+}
+
+/*
+ * @brief Closes the specified scope, accumulating its time for this frame.
+ */
+void Sv_ProfileEnd(const uint16_t scope) {
+
+	if (!sv_profile.enabled || !scope)
+		return;
+
+	sv_profile_scope_t *s = &sv_profile.scopes[scope];
+
+	if (!s->depth) // profiling was enabled within the scope
+		return;
+
+	if (--s->depth)
+		return;
+
+	const uint32_t duration = Sys_Microseconds() - s->begin;
+
+	s->time += duration;
+	s->count++;
+
+	if (sv_profile.events && sv_profile.num_events < SV_PROFILE_MAX_EVENTS) {
+		sv_profile_event_t *e = &sv_profile.events[sv_profile.num_events++];
+
+		e->scope = scope;
+		e->begin = s->begin;
+		e->duration = duration;
+	}
+}
+
+/*
+ * @brief Counts an untimed invocation of the specified scope. This is used for
+ * hot paths such as cache lookups, for which timing would dominate the cost.
+ */
+void Sv_ProfileCount(const uint16_t scope) {
+
+	if (!sv_profile.enabled || !scope)
+		return;
+
+	sv_profile.scopes[scope].count++;
+}
+
+/*
+ * @brief qsort comparator for Sv_ProfileStats.
+ */
+static int32_t Sv_ProfileStats_Compare(const void *a, const void *b) {
+	const uint32_t ta = *(const uint32_t *) a;
+	const uint32_t tb = *(const uint32_t *) b;
+
+	return ta < tb ? -1 : ta > tb ? 1 : 0;
+}
+
+/*
+ * @brief Resolves the median, 99th percentile and maximum frame times (in
+ * milliseconds) of the given scope over the sampled frames. Returns the
+ * average number of invocations per frame.
+ */
+static vec_t Sv_ProfileStats(const sv_profile_scope_t *s, vec_t *p50, vec_t *p99, vec_t *max) {
+	uint32_t times[SV_PROFILE_FRAMES];
+	uint32_t i, count = 0;
+
+	const uint32_t n = MIN(sv_profile.frame_num, SV_PROFILE_FRAMES);
+
+	for (i = 0; i < n; i++) {
+		times[i] = s->times[i];
+		count += s->counts[i];
+	}
+
+	qsort(times, n, sizeof(uint32_t), Sv_ProfileStats_Compare);
+
+	*p50 = times[n / 2] / 1000.0;
+	*p99 = times[MIN(n * 99 / 100, n - 1)] / 1000.0;
+	*max = times[n - 1] / 1000.0;
+
+	return count / (vec_t) n;
+}
+
+/*
+ * @brief Formats the statistics of all scopes that have been invoked.
+ */
+static void Sv_ProfileTable(char *table, size_t len) {
+	uint16_t i;
+
+	g_snprintf(table, len, "%-28s %8s %8s %8s %8s\n", "scope (ms)", "p50", "p99", "max",
+			"calls");
+
+	if (!sv_profile.frame_num)
+		return;
+
+	for (i = 1; i < sv_profile.num_scopes; i++) {
+		const sv_profile_scope_t *s = &sv_profile.scopes[i];
+		vec_t p50, p99, max;
+
+		const vec_t calls = Sv_ProfileStats(s, &p50, &p99, &max);
+
+		if (!calls)
+			continue;
+
+		g_strlcat(table, va("%-28s %8.3f %8.3f %8.3f %8.1f\n", s->name, p50, p99, max, calls),
+				len);
+	}
+}
+
+/*
+ * @brief Refreshes the curses panel, or removes it if the panel was disabled.
+ */
+static void Sv_ProfileUpdatePanel(void) {
+#ifdef HAVE_CURSES
+	char table[SV_PROFILE_MAX_SCOPES * 64];
+
+	if (sv_profile.panel) {
+		Sv_ProfileTable(table, sizeof(table));
+		Curses_SetPanel(table);
+	} else {
+		Curses_SetPanel(NULL);
+	}
+#endif
+
+	sv_profile.panel_time = quake2world.time;
+}
+
+/*
+ * @brief Writes the traced events to a Chrome trace event JSON file, which
+ * can be inspected with chrome://tracing.
+ */
+static void Sv_ProfileWriteTrace(void) {
+	file_t *file;
+	uint32_t i;
+
+	if ((file = Fs_OpenWrite(sv_profile.trace_file))) {
+
+		Fs_Print(file, "{\"traceEvents\":[\n");
+
+		for (i = 0; i < sv_profile.num_events; i++) {
+			const sv_profile_event_t *e = &sv_profile.events[i];
+
+			Fs_Print(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":1}%s\n",
+					sv_profile.scopes[e->scope].name, (uint32_t) (e->begin - sv_profile.trace_time),
+					e->duration, i < sv_profile.num_events - 1 ? "," : "");
+		}
+
+		Fs_Print(file, "]}\n");
+		Fs_Close(file);
+
+		Com_Print("Wrote %u events to %s/%s\n", sv_profile.num_events, Fs_WriteDir(),
+				sv_profile.trace_file);
+	} else {
+		Com_Warn("Failed to open %s\n", sv_profile.trace_file);
+	}
+
+	Mem_Free(sv_profile.events);
+	sv_profile.events = NULL;
+
+	sv_profile.num_events = 0;
+	sv_profile.trace_frames = 0;
+}
+
+/*
+ * @brief Commits the scope times accumulated this frame to the sample ring,
+ * and advances any trace in progress. Called at the end of each server frame.
+ */
+void Sv_ProfileFrame(void) {
+	uint16_t i;
+
+	if (!sv_profile.enabled)
+		return;
+
+	const uint32_t frame = sv_profile.frame_num & (SV_PROFILE_FRAMES - 1);
+
+	for (i = 1; i < sv_profile.num_scopes; i++) {
+		sv_profile_scope_t *s = &sv_profile.scopes[i];
+
+		s->times[frame] = s->time;
+		s->counts[frame] = s->count;
+
+		s->time = s->count = 0;
+	}
+
+	sv_profile.frame_num++;
+
+	if (sv_profile.events && --sv_profile.trace_frames == 0)
+		Sv_ProfileWriteTrace();
+
+	if (sv_profile.panel && quake2world.time - sv_profile.panel_time >= SV_PROFILE_PANEL_INTERVAL)
+		Sv_ProfileUpdatePanel();
+}
+
+/*
+ * @brief Discards all samples, retaining the registered scopes.
+ */
+static void Sv_ProfileReset(void) {
+	uint16_t i;
+
+	for (i = 1; i < sv_profile.num_scopes; i++) {
+		sv_profile_scope_t *s = &sv_profile.scopes[i];
+
+		memset(s->times, 0, sizeof(s->times));
+		memset(s->counts, 0, sizeof(s->counts));
+
+		s->time = s->count = 0;
+	}
+
+	sv_profile.frame_num = 0;
+}
+
+/*
+ * @brief Enables or disables profiling. The profiler may be controlled from
+ * within an open scope (e.g. over rcon, from Sv_ReadPackets), whose end would
+ * then be ignored or unmatched, so all scope depths are zeroed.
+ */
+static void Sv_ProfileEnable(_Bool enabled) {
+	uint16_t i;
+
+	for (i = 1; i < sv_profile.num_scopes; i++) {
+		sv_profile.scopes[i].depth = 0;
+	}
+
+	sv_profile.enabled = enabled;
+}
+
+/*
+ * @brief Controls the profiler, and prints the per-scope statistics.
+ */
+static void Sv_Profile_f(void) {
+	char table[SV_PROFILE_MAX_SCOPES * 64];
+
+	const char *c = Cmd_Argc() > 1 ? Cmd_Argv(1) : "print";
+
+	if (!g_strcmp0(c, "start")) {
+		Sv_ProfileEnable(true);
+	} else if (!g_strcmp0(c, "stop")) {
+		Sv_ProfileEnable(false);
+		sv_profile.panel = false;
+
+		if (sv_profile.events)
+			Sv_ProfileWriteTrace();
+
+		Sv_ProfileUpdatePanel();
+	} else if (!g_strcmp0(c, "reset")) {
+		Sv_ProfileReset();
+	} else if (!g_strcmp0(c, "print")) {
+		if (!sv_profile.frame_num) {
+			Com_Print("No frames sampled, try %s start\n", Cmd_Argv(0));
+			return;
+		}
+		Sv_ProfileTable(table, sizeof(table));
+		Com_Print("%u frames sampled\n%s", MIN(sv_profile.frame_num, SV_PROFILE_FRAMES), table);
+	} else if (!g_strcmp0(c, "panel")) {
+		sv_profile.panel = !sv_profile.panel;
+
+		if (sv_profile.panel && !sv_profile.enabled)
+			Sv_ProfileEnable(true);
+
+		Sv_ProfileUpdatePanel();
+	} else if (!g_strcmp0(c, "trace")) {
+		if (sv_profile.events) {
+			Com_Print("A trace is already in progress\n");
+			return;
+		}
+
+		sv_profile.trace_frames = Cmd_Argc() > 2 ? strtoul(Cmd_Argv(2), NULL, 0) : 0;
+
+		if (!sv_profile.trace_frames)
+			sv_profile.trace_frames = svs.frame_rate * 5;
+
+		if (Cmd_Argc() > 3)
+			g_strlcpy(sv_profile.trace_file, Cmd_Argv(3), sizeof(sv_profile.trace_file));
+		else
+			g_strlcpy(sv_profile.trace_file, "sv_profile.json", sizeof(sv_profile.trace_file));
+
+		sv_profile.events = Mem_Malloc(SV_PROFILE_MAX_EVENTS * sizeof(sv_profile_event_t));
+		sv_profile.trace_time = Sys_Microseconds();
+
+		if (!sv_profile.enabled)
+			Sv_ProfileEnable(true);
+
+		Com_Print("Tracing %u frames to %s\n", sv_profile.trace_frames, sv_profile.trace_file);
+	} else {
+		Com_Print("Usage: %s <start|stop|reset|print|panel|trace [frames] [file]>\n", Cmd_Argv(0));
+	}
+}
+
+/*
+ * @brief Registers the built-in scopes and the sv_profile command.
+ */
+void Sv_InitProfile(void) {
+	uint16_t i;
+
+	memset(&sv_profile, 0, sizeof(sv_profile));
+
+	sv_profile.num_scopes = 1; // SV_PROFILE_NONE
+
+	for (i = 1; i < SV_PROFILE_BUILTIN_SCOPES; i++) {
+		Sv_ProfileScope(sv_profile_scope_names[i]);
+	}
+
+	Cmd_Add("sv_profile", Sv_Profile_f, CMD_SERVER, "Profile the server frame, or trace it to "
+		"a Chrome trace event file");
+}
+
+/*
+ * @brief Discards any trace in progress and removes the curses panel.
+ */
+void Sv_ShutdownProfile(void) {
+
+	if (sv_profile.events) {
+		Mem_Free(sv_profile.events);
+	}
+
+	if (sv_profile.panel) {
+		sv_profile.panel = false;
+		Sv_ProfileUpdatePanel();
+	}
+
+	memset(&sv_profile, 0, sizeof(sv_profile));
+}
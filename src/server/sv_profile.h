@@ -0,0 +1,37 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef __SV_PROFILE_H__
+#define __SV_PROFILE_H__
+
+#include "sv_types.h"
+
+#ifdef __SV_LOCAL_H__
+uint16_t Sv_ProfileScope(const char *name);
+void Sv_ProfileBegin(const uint16_t scope);
+void Sv_ProfileEnd(const uint16_t scope);
+void Sv_ProfileCount(const uint16_t scope);
+void Sv_ProfileFrame(void);
+void Sv_InitProfile(void);
+void Sv_ShutdownProfile(void);
+#endif /* __SV_LOCAL_H__ */
+
+#endif /* __SV_PROFILE_H__ */
@@ -191,44 +191,40 @@ void Sv_Unicast(const g_edict_t *ent, const _Bool reliable) {
  */
 void Sv_Multicast(const vec3_t origin, multicast_t to) {
 	sv_client_t *client;
-	byte *mask;
+	const byte *(*mask)(const int32_t cluster);
 	int32_t leaf_num, cluster;
 	int32_t j;
 	_Bool reliable;
-	int32_t area1, area2;
+	int32_t area;
 
 	reliable = false;
 
 	if (to != MULTICAST_ALL_R && to != MULTICAST_ALL) {
-		leaf_num = Cm_PointLeafnum(origin);
-		area1 = Cm_LeafArea(leaf_num);
+		leaf_num = Sv_PointLeafnum(origin);
+		cluster = Cm_LeafCluster(leaf_num);
+		area = Cm_LeafArea(leaf_num);
 	} else {
-		leaf_num = 0; // just to avoid compiler warnings
-		area1 = 0;
+		cluster = 0; // just to avoid compiler warnings
+		area = 0;
 	}
 
 	switch (to) {
 		case MULTICAST_ALL_R:
 			reliable = true; // intentional fallthrough
 		case MULTICAST_ALL:
-			leaf_num = 0;
 			mask = NULL;
 			break;
 
 		case MULTICAST_PHS_R:
 			reliable = true; // intentional fallthrough
 		case MULTICAST_PHS:
-			leaf_num = Cm_PointLeafnum(origin);
-			cluster = Cm_LeafCluster(leaf_num);
-			mask = Cm_ClusterPHS(cluster);
+			mask = Sv_ClusterPHS;
 			break;
 
 		case MULTICAST_PVS_R:
 			reliable = true; // intentional fallthrough
 		case MULTICAST_PVS:
-			leaf_num = Cm_PointLeafnum(origin);
-			cluster = Cm_LeafCluster(leaf_num);
-			mask = Cm_ClusterPVS(cluster);
+			mask = Sv_ClusterPVS;
 			break;
 
 		default:
@@ -249,19 +245,14 @@ void Sv_Multicast(const vec3_t origin, multicast_t to) {
 			continue;
 
 		if (mask) {
-			pm_state_t *pm = &client->edict->client->ps.pm_state;
-			vec3_t org;
+			const sv_client_view_t *view = Sv_ClientView(client);
 
-			VectorCopy(pm->origin, org);
-			VectorAdd(org, pm->view_offset, org);
-			VectorScale(org, 0.125, org);
-
-			leaf_num = Cm_PointLeafnum(org);
-			cluster = Cm_LeafCluster(leaf_num);
-			area2 = Cm_LeafArea(leaf_num);
-			if (!Cm_AreasConnected(area1, area2))
+			if (!Cm_AreasConnected(area, view->area))
 				continue;
-			if (mask && (!(mask[cluster >> 3] & (1 << (cluster & 7)))))
+
+			// resolving the view may have displaced the row, so fetch it each time
+			const byte *row = mask(cluster);
+			if (!(row[view->cluster >> 3] & (1 << (view->cluster & 7))))
 				continue;
 		}
 
@@ -436,34 +427,10 @@ static _Bool Sv_RateDrop(sv_client_t *c) {
  * returning the size of the frame in bytes.
  */
 static size_t Sv_GetDemoMessage(byte *buffer) {
-	int32_t size;
-	size_t r;
 
-	r = Fs_Read(sv.demo_file, &size, sizeof(size), 1);
+	const int32_t size = Demo_ReadMessage(sv.demo_file, buffer, MAX_MSG_SIZE);
 
-	if (r != 1) { // improperly terminated demo file
-		Com_Warn("Failed to read demo file\n");
-		Sv_DemoCompleted();
-		return 0;
-	}
-
-	size = LittleLong(size);
-
-	if (size == -1) { // properly terminated demo file
-		Sv_DemoCompleted();
-		return 0;
-	}
-
-	if (size > MAX_MSG_SIZE) { // corrupt demo file
-		Com_Warn("%d > MAX_MSG_SIZE\n", size);
-		Sv_DemoCompleted();
-		return 0;
-	}
-
-	r = Fs_Read(sv.demo_file, buffer, size, 1);
-
-	if (r != 1) {
-		Com_Warn("Incomplete or corrupt demo file\n");
+	if (size == -1) { // end of demo, or corrupt demo file
 		Sv_DemoCompleted();
 		return 0;
 	}
@@ -511,6 +478,9 @@ void Sv_SendClientMessages(void) {
 			if (c->net_chan.message.size || quake2world.time - c->net_chan.last_sent > 1000)
 				Netchan_Transmit(&c->net_chan, NULL, 0);
 		}
+
+		// and stream any download in progress
+		Sv_SendDownload(c);
 	}
 }
 
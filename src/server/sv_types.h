@@ -52,7 +52,7 @@ typedef struct {
 	byte multicast_buffer[MAX_MSG_SIZE];
 
 	// demo server information
-	file_t *demo_file;
+	demo_t *demo_file;
 } sv_server_t;
 
 typedef enum {
@@ -82,10 +82,44 @@ typedef struct {
 #define CMD_MSEC_ALLOWABLE_DRIFT CMD_MSEC_CHECK_INTERVAL + 150
 #define CMD_MSEC_MAX_DRIFT_ERRORS 10
 
+/*
+ * @brief A file being downloaded by one or more clients. Concurrent downloads
+ * of the same file share a single copy, which is freed with the last of them.
+ */
 typedef struct {
+	char name[MAX_QPATH];
 	byte *buffer;
 	int32_t size;
-	int32_t count;
+	uint16_t ref_count;
+} sv_download_file_t;
+
+/*
+ * @brief Clients which have not acknowledged any download chunks in this long
+ * are assumed to have abandoned the download.
+ */
+#define SV_DOWNLOAD_TIMEOUT 10000
+
+/*
+ * @brief UDP file download state. PROTOCOL_LEGACY clients request each chunk
+ * in turn, while PROTOCOL clients are streamed a window of DOWNLOAD_WINDOW
+ * chunks, paced to their rate and acknowledged selectively.
+ */
+typedef struct {
+	sv_download_file_t *file;
+	uint8_t id; // distinguishes stale chunks and acknowledgements
+
+	int32_t start; // the offset at which the download began or resumed
+	int32_t offset; // acknowledged contiguously by the client (or sent, for PROTOCOL_LEGACY)
+
+	uint32_t acked; // chunks beyond offset acknowledged by the client, by window position
+	uint32_t resent; // chunks beyond offset which have been retransmitted
+	uint32_t sent_time[DOWNLOAD_WINDOW]; // quake2world.time, by chunk number, or 0
+
+	uint32_t rtt; // smoothed round trip time in milliseconds
+	uint8_t backoff; // retransmission timeout exponent, while chunks are lost
+	uint32_t acked_time; // the latest send time of any acknowledged chunk
+	uint32_t credit; // bytes which may be sent without exceeding the client's rate
+	uint32_t last_ack; // quake2world.time of the last acknowledgement
 } sv_download_t;
 
 /*
@@ -110,12 +144,28 @@ typedef struct {
 	GList *messages; // message segmentation
 } sv_client_datagram_t;
 
+/*
+ * @brief A client's view of the world, resolved once per frame after the game
+ * has run. Multicasts, sounds and Sv_BuildClientFrame all read from this rather
+ * than locating the client in the BSP for every message.
+ */
+typedef struct {
+	int32_t frame_num; // sv.frame_num at which this view was resolved, or -1
+	vec3_t origin; // the view origin
+	int32_t leaf_num, cluster, area;
+	int32_t area_bytes;
+	byte area_bits[MAX_BSP_AREAS >> 3]; // portal area visibility bits
+	byte pvs[MAX_BSP_LEAFS >> 3]; // merged from all clusters about the view origin
+	byte phs[MAX_BSP_LEAFS >> 3];
+} sv_client_view_t;
+
 /*
  * @brief Per-client accounting for protocol flow control and low-level
  * connection state management.
  */
 typedef struct {
 	sv_client_state_t state;
+	int32_t protocol; // PROTOCOL or PROTOCOL_LEGACY, negotiated at connect
 
 	char user_info[MAX_USER_INFO_STRING]; // name, skin, etc
 
@@ -142,6 +192,11 @@ typedef struct {
 
 	sv_frame_t frames[PACKET_BACKUP]; // updates can be delta'd from here
 
+	sv_client_view_t view; // visibility for the current frame
+
+	net_baseline_t baseline; // acknowledged by the client
+	net_baseline_t pending_baseline; // awaiting acknowledgement from the client
+
 	sv_download_t download; // UDP file downloads
 
 	uint32_t last_message; // svs.real_time when packet was last received
@@ -212,6 +267,67 @@ typedef struct {
 	g_export_t *game;
 } sv_static_t;
 
+/*
+ * @brief Built-in profiling scopes. The game module may register additional
+ * scopes at runtime, which are appended after these.
+ */
+typedef enum {
+	SV_PROFILE_NONE,
+	SV_PROFILE_FRAME,
+	SV_PROFILE_CHECK_TIMEOUTS,
+	SV_PROFILE_READ_PACKETS,
+	SV_PROFILE_UPDATE_PINGS,
+	SV_PROFILE_CHECK_COMMAND_TIMES,
+	SV_PROFILE_GAME_FRAME,
+	SV_PROFILE_SEND_CLIENT_MESSAGES,
+	SV_PROFILE_HEARTBEAT_MASTERS,
+	SV_PROFILE_CLIENT_THINK,
+	SV_PROFILE_TRACE,
+	SV_PROFILE_UPDATE_CLIENT_VIEWS,
+	SV_PROFILE_CLIENT_VIEW,
+	SV_PROFILE_CLIENT_VIEW_CACHED,
+	SV_PROFILE_POINT_LEAFNUM,
+	SV_PROFILE_POINT_LEAFNUM_CACHED,
+	SV_PROFILE_CLUSTER_VIS,
+	SV_PROFILE_CLUSTER_VIS_CACHED,
+	SV_PROFILE_BUILTIN_SCOPES
+} sv_profile_scope_id_t;
+
+#define SV_PROFILE_MAX_SCOPES 64
+
+/*
+ * @brief Per-frame samples are retained in a ring buffer, from which the
+ * percentiles are resolved on demand. This must be a power of two.
+ */
+#define SV_PROFILE_FRAMES 512
+
+/*
+ * @brief A timed scope, e.g. a phase of Sv_Frame or a game module function.
+ */
+typedef struct {
+	char name[32];
+
+	uint16_t depth; // of the current invocation, for recursion
+	uint64_t begin; // of the outermost current invocation
+
+	uint32_t time; // microseconds accumulated this frame
+	uint32_t count; // invocations this frame
+
+	uint32_t times[SV_PROFILE_FRAMES];
+	uint32_t counts[SV_PROFILE_FRAMES];
+} sv_profile_scope_t;
+
+/*
+ * @brief A single invocation of a scope, for Chrome trace event output.
+ */
+typedef struct {
+	uint16_t scope;
+	uint64_t begin;
+	uint32_t duration;
+} sv_profile_event_t;
+
+#define SV_PROFILE_MAX_EVENTS 0x40000
+
 // macros for resolving game entities on the server
 #define EDICT_FOR_NUM(n)( (g_edict_t *)((char *) svs.game->edicts + svs.game->edict_size * (n)) )
 #define NUM_FOR_EDICT(e)( ((char *)(e) - (char *) svs.game->edicts) / svs.game->edict_size )
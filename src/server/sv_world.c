@@ -41,6 +41,47 @@ typedef struct sv_area_node_s {
 #define AREA_DEPTH	4
 #define AREA_NODES	32
 
+/*
+ * @brief Memoizes the leaf containing a point. The BSP is static for the
+ * level, so entries remain valid until they are displaced. Must be a power of
+ * two.
+ */
+#define LEAF_CACHE_SIZE 1024
+
+typedef struct {
+	_Bool valid;
+	vec3_t point;
+	int32_t leaf_num;
+} sv_leaf_cache_t;
+
+/*
+ * @brief Memoizes decompressed PVS and PHS rows by cluster. Even slots hold
+ * PVS rows, and odd slots PHS rows. Must be a power of two.
+ */
+#define VIS_CACHE_SIZE 32
+
+typedef struct {
+	_Bool valid;
+	int32_t cluster;
+	byte row[MAX_BSP_LEAFS >> 3];
+} sv_vis_cache_t;
+
+/*
+ * @brief The bounds of linked, solid clients at the end of a game frame, kept
+ * so that traces may be clipped against clients where a lagged shooter saw
+ * them. Must be a power of two.
+ */
+#define REWIND_FRAMES 32
+
+typedef struct {
+	int32_t frame_num;
+	uint16_t num_clients;
+	byte solid[MAX_CLIENTS];
+	vec3_t origins[MAX_CLIENTS];
+	vec3_t mins[MAX_CLIENTS];
+	vec3_t maxs[MAX_CLIENTS];
+} sv_rewind_frame_t;
+
 // the server's view of the world, by areas
 typedef struct sv_world_s {
 
@@ -53,6 +94,11 @@ typedef struct sv_world_s {
 
 	int32_t num_area_edicts, max_area_edicts;
 	int32_t area_type;
+
+	sv_leaf_cache_t leaf_cache[LEAF_CACHE_SIZE];
+	sv_vis_cache_t vis_cache[VIS_CACHE_SIZE];
+
+	sv_rewind_frame_t rewind_frames[REWIND_FRAMES];
 } sv_world_t;
 
 sv_world_t sv_world;
@@ -365,6 +411,64 @@ int32_t Sv_AreaEdicts(const vec3_t mins, const vec3_t maxs, g_edict_t **area_edi
 	return sv_world.num_area_edicts;
 }
 
+/*
+ * @brief qsort comparator for Sv_RadiusEdicts, ordering edicts by number.
+ */
+static int32_t Sv_RadiusEdicts_Compare(const void *a, const void *b) {
+
+	const g_edict_t *e1 = *(const g_edict_t **) a;
+	const g_edict_t *e2 = *(const g_edict_t **) b;
+
+	return (e1 > e2) - (e1 < e2);
+}
+
+/*
+ * @brief Fills in a table of edict pointers with those whose bounding box
+ * centers are within radius of the given origin. The candidates are gathered
+ * from the area nodes with the bounding box of the sphere, and are returned in
+ * entity number order, so that results do not depend on how edicts are linked.
+ * Unlike Sv_AreaEdicts, area_type is a mask, so that both solid and trigger
+ * edicts may be found at once.
+ *
+ * Returns the number of entities found.
+ */
+int32_t Sv_RadiusEdicts(const vec3_t origin, const vec_t radius, g_edict_t **area_edicts,
+		const int32_t max_area_edicts, const int32_t area_type) {
+	vec3_t mins, maxs;
+	int32_t i, j, count;
+	int32_t num = 0;
+
+	for (i = 0; i < 3; i++) {
+		mins[i] = origin[i] - radius;
+		maxs[i] = origin[i] + radius;
+	}
+
+	if (area_type & AREA_SOLID)
+		num += Sv_AreaEdicts(mins, maxs, area_edicts, max_area_edicts, AREA_SOLID);
+
+	if (area_type & AREA_TRIGGERS)
+		num += Sv_AreaEdicts(mins, maxs, area_edicts + num, max_area_edicts - num, AREA_TRIGGERS);
+
+	const vec_t radius_squared = radius * radius;
+
+	for (i = count = 0; i < num; i++) {
+		g_edict_t *ent = area_edicts[i];
+		vec3_t delta;
+
+		for (j = 0; j < 3; j++)
+			delta[j] = origin[j] - (ent->s.origin[j] + (ent->mins[j] + ent->maxs[j]) * 0.5);
+
+		if (DotProduct(delta, delta) > radius_squared)
+			continue;
+
+		area_edicts[count++] = ent;
+	}
+
+	qsort(area_edicts, count, sizeof(g_edict_t *), Sv_RadiusEdicts_Compare);
+
+	return count;
+}
+
 /*
  * @brief Returns a head_node that can be used for testing or clipping an
  * object of mins/maxs size.
@@ -430,8 +534,96 @@ typedef struct {
 	c_trace_t trace;
 	const g_edict_t *skip;
 	int32_t contents;
+	const sv_rewind_frame_t *rewind; // clip clients from here, rather than their edicts
 } sv_trace_t;
 
+/*
+ * @brief Returns true if the specified entity may be skipped by the trace.
+ */
+static _Bool Sv_SkipTraceEntity(const sv_trace_t *trace, const g_edict_t *ent) {
+
+	if (ent->solid == SOLID_NOT) // can't actually touch us
+		return true;
+
+	if (trace->skip) { // see if we can skip it
+
+		if (ent == trace->skip)
+			return true; // explicitly (ourselves)
+
+		if (ent->owner == trace->skip)
+			return true; // or via ownership (we own it)
+
+		if (trace->skip->owner) {
+
+			if (ent == trace->skip->owner)
+				return true; // which is bi-directional (inverse of previous case)
+
+			if (ent->owner == trace->skip->owner)
+				return true; // and communitive (we are both owned by the same)
+		}
+	}
+
+	return false;
+}
+
+/*
+ * @brief Returns true if the specified entity is a client, whose bounds are
+ * taken from the rewind frame for rewound traces.
+ */
+static _Bool Sv_IsRewound(const sv_trace_t *trace, const g_edict_t *ent) {
+
+	if (!trace->rewind)
+		return false;
+
+	const ptrdiff_t num = NUM_FOR_EDICT(ent);
+	return num > 0 && num <= trace->rewind->num_clients;
+}
+
+/*
+ * @brief Clips the specified trace to clients as they were in its rewind frame.
+ * The recorded bounds are their own broadphase, so only clients whose rewound
+ * bounds intersect the trace are clipped.
+ */
+static void Sv_ClipTraceToRewind(sv_trace_t *trace) {
+	const sv_rewind_frame_t *frame = trace->rewind;
+	vec3_t abs_mins, abs_maxs;
+	c_trace_t tr;
+	uint16_t i;
+
+	for (i = 0; i < frame->num_clients; i++) {
+
+		if (!frame->solid[i])
+			continue;
+
+		VectorAdd(frame->origins[i], frame->mins[i], abs_mins);
+		VectorAdd(frame->origins[i], frame->maxs[i], abs_maxs);
+
+		if (abs_mins[0] > trace->box_maxs[0] || abs_mins[1] > trace->box_maxs[1]
+				|| abs_mins[2] > trace->box_maxs[2] || abs_maxs[0] < trace->box_mins[0]
+				|| abs_maxs[1] < trace->box_mins[1] || abs_maxs[2] < trace->box_mins[2])
+			continue;
+
+		g_edict_t *ent = EDICT_FOR_NUM(i + 1);
+
+		if (!ent->in_use || Sv_SkipTraceEntity(trace, ent))
+			continue;
+
+		const int32_t head_node = Cm_HeadnodeForBox(frame->mins[i], frame->maxs[i]);
+
+		tr = Cm_TransformedBoxTrace(trace->start, trace->end, trace->mins, trace->maxs, head_node,
+				trace->contents, frame->origins[i], vec3_origin);
+
+		if (tr.all_solid || tr.start_solid || tr.fraction < trace->trace.fraction) {
+
+			trace->trace = tr;
+			trace->trace.ent = ent;
+
+			if (trace->trace.all_solid)
+				return;
+		}
+	}
+}
+
 /*
  * @brief Clips the specified trace to other entities in its area. This is the basis
  * of ALL collision and interaction for the server. Tread carefully.
@@ -450,26 +642,11 @@ static void Sv_ClipTraceToEntities(sv_trace_t *trace) {
 
 		g_edict_t *ent = area_edicts[i];
 
-		if (ent->solid == SOLID_NOT) // can't actually touch us
+		if (Sv_SkipTraceEntity(trace, ent))
 			continue;
 
-		if (trace->skip) { // see if we can skip it
-
-			if (ent == trace->skip)
-				continue; // explicitly (ourselves)
-
-			if (ent->owner == trace->skip)
-				continue; // or via ownership (we own it)
-
-			if (trace->skip->owner) {
-
-				if (ent == trace->skip->owner)
-					continue; // which is bi-directional (inverse of previous case)
-
-				if (ent->owner == trace->skip->owner)
-					continue; // and communitive (we are both owned by the same)
-			}
-		}
+		if (Sv_IsRewound(trace, ent)) // clipped where they were, below
+			continue;
 
 		// we couldn't skip it, so trace to it and see if we hit
 		head_node = Sv_HullForEntity(ent);
@@ -493,6 +670,9 @@ static void Sv_ClipTraceToEntities(sv_trace_t *trace) {
 				return;
 		}
 	}
+
+	if (trace->rewind)
+		Sv_ClipTraceToRewind(trace);
 }
 
 /*
@@ -513,13 +693,12 @@ static void Sv_TraceBounds(sv_trace_t *trace) {
 }
 
 /*
- * @brief Moves the given box volume through the world from start to end.
- *
- * The skipped edict, and edicts owned by him, are explicitly not checked.
- * This prevents players from clipping against their own projectiles, etc.
+ * @brief Moves the given box volume through the world from start to end,
+ * clipping clients to the specified rewind frame, if any.
  */
-c_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs,
-		const g_edict_t *skip, const int32_t contents) {
+static c_trace_t Sv_Trace_(const vec3_t start, const vec3_t end, const vec3_t mins,
+		const vec3_t maxs, const g_edict_t *skip, const int32_t contents,
+		const sv_rewind_frame_t *rewind) {
 
 	sv_trace_t trace;
 
@@ -530,13 +709,17 @@ c_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, cons
 	if (!maxs)
 		maxs = vec3_origin;
 
+	Sv_ProfileBegin(SV_PROFILE_TRACE);
+
 	// clip to world
 	trace.trace = Cm_BoxTrace(start, end, mins, maxs, 0, contents);
 	if (trace.trace.fraction < 1.0) {
 		trace.trace.ent = svs.game->edicts;
 
-		if (trace.trace.start_solid) // blocked entirely
+		if (trace.trace.start_solid) { // blocked entirely
+			Sv_ProfileEnd(SV_PROFILE_TRACE);
 			return trace.trace;
+		}
 	}
 
 	trace.start = start;
@@ -545,6 +728,7 @@ c_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, cons
 	trace.maxs = maxs;
 	trace.skip = skip;
 	trace.contents = contents;
+	trace.rewind = rewind;
 
 	// create the bounding box of the entire move
 	Sv_TraceBounds(&trace);
@@ -552,5 +736,171 @@ c_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, cons
 	// clip to other solid entities
 	Sv_ClipTraceToEntities(&trace);
 
+	Sv_ProfileEnd(SV_PROFILE_TRACE);
+
 	return trace.trace;
 }
+
+/*
+ * @brief Moves the given box volume through the world from start to end.
+ *
+ * The skipped edict, and edicts owned by him, are explicitly not checked.
+ * This prevents players from clipping against their own projectiles, etc.
+ */
+c_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs,
+		const g_edict_t *skip, const int32_t contents) {
+
+	return Sv_Trace_(start, end, mins, maxs, skip, contents, NULL);
+}
+
+/*
+ * @brief Records the bounds of all clients for the frame that was just run.
+ */
+void Sv_RecordRewindFrame(void) {
+	uint16_t i;
+
+	sv_rewind_frame_t *frame = &sv_world.rewind_frames[sv.frame_num & (REWIND_FRAMES - 1)];
+
+	frame->frame_num = sv.frame_num;
+	frame->num_clients = MIN(sv_max_clients->integer, MAX_CLIENTS);
+
+	for (i = 0; i < frame->num_clients; i++) {
+		const g_edict_t *ent = EDICT_FOR_NUM(i + 1);
+
+		frame->solid[i] = ent->in_use && ent->area.prev && ent->solid != SOLID_NOT;
+
+		if (frame->solid[i]) {
+			VectorCopy(ent->s.origin, frame->origins[i]);
+			VectorCopy(ent->mins, frame->mins[i]);
+			VectorCopy(ent->maxs, frame->maxs[i]);
+		}
+	}
+}
+
+/*
+ * @brief Resolves the frame the specified client last acknowledged, limited to
+ * sv_max_rewind milliseconds ago. NULL is returned if no rewind is needed.
+ */
+static const sv_rewind_frame_t *Sv_RewindFrame(const g_edict_t *shooter) {
+
+	if (!shooter || sv_max_rewind->value <= 0.0)
+		return NULL;
+
+	const ptrdiff_t num = NUM_FOR_EDICT(shooter);
+
+	if (num < 1 || num > sv_max_clients->integer)
+		return NULL;
+
+	const sv_client_t *cl = &svs.clients[num - 1];
+
+	if (cl->state != SV_CLIENT_ACTIVE || cl->last_frame <= 0)
+		return NULL;
+
+	const int32_t max_frames = MIN(sv_max_rewind->value * svs.frame_rate / 1000.0,
+			REWIND_FRAMES - 1);
+
+	const int32_t frames = MIN(sv.frame_num - cl->last_frame, max_frames);
+
+	if (frames <= 0)
+		return NULL;
+
+	const sv_rewind_frame_t *frame = &sv_world.rewind_frames[(sv.frame_num - frames)
+			& (REWIND_FRAMES - 1)];
+
+	if (frame->frame_num != sv.frame_num - frames)
+		return NULL;
+
+	return frame;
+}
+
+/*
+ * @brief Like Sv_Trace, but clients are clipped where they were in the frame
+ * the shooter last acknowledged, compensating for the shooter's latency.
+ */
+c_trace_t Sv_RewindTrace(const vec3_t start, const vec3_t end, const vec3_t mins,
+		const vec3_t maxs, const g_edict_t *skip, const int32_t contents,
+		const g_edict_t *shooter) {
+
+	return Sv_Trace_(start, end, mins, maxs, skip, contents, Sv_RewindFrame(shooter));
+}
+
+/*
+ * VISIBILITY CACHING
+ *
+ * Multicasts and the game's visibility queries repeatedly locate the same
+ * points in the BSP, and decompress the same visibility rows. Both are static
+ * for the level, so they are memoized here.
+ */
+
+/*
+ * @brief Hashes the specified point to its slot in the leaf cache.
+ */
+static uint32_t Sv_HashPoint(const vec3_t point) {
+	uint32_t i[3];
+
+	memcpy(i, point, sizeof(i));
+
+	return ((i[0] * 73856093) ^ (i[1] * 19349663) ^ (i[2] * 83492791)) & (LEAF_CACHE_SIZE - 1);
+}
+
+/*
+ * @brief Returns the leaf containing the specified point.
+ */
+int32_t Sv_PointLeafnum(const vec3_t point) {
+
+	sv_leaf_cache_t *c = &sv_world.leaf_cache[Sv_HashPoint(point)];
+
+	if (c->valid && VectorCompare(c->point, point)) {
+		Sv_ProfileCount(SV_PROFILE_POINT_LEAFNUM_CACHED);
+		return c->leaf_num;
+	}
+
+	Sv_ProfileCount(SV_PROFILE_POINT_LEAFNUM);
+
+	VectorCopy(point, c->point);
+	c->leaf_num = Cm_PointLeafnum(point);
+	c->valid = true;
+
+	return c->leaf_num;
+}
+
+/*
+ * @brief Returns the decompressed visibility row of the specified type for the
+ * given cluster. The row is valid until the next call.
+ */
+static const byte *Sv_ClusterVis(const int32_t cluster, const int32_t vis) {
+
+	if (cluster == -1) // solid or outside of the world, nothing is visible
+		return vis == DVIS_PVS ? Cm_ClusterPVS(cluster) : Cm_ClusterPHS(cluster);
+
+	sv_vis_cache_t *c = &sv_world.vis_cache[((cluster << 1) | vis) & (VIS_CACHE_SIZE - 1)];
+
+	if (c->valid && c->cluster == cluster) {
+		Sv_ProfileCount(SV_PROFILE_CLUSTER_VIS_CACHED);
+		return c->row;
+	}
+
+	Sv_ProfileCount(SV_PROFILE_CLUSTER_VIS);
+
+	const byte *row = vis == DVIS_PVS ? Cm_ClusterPVS(cluster) : Cm_ClusterPHS(cluster);
+	memcpy(c->row, row, ((Cm_NumClusters() + 31) >> 5) << 2);
+
+	c->cluster = cluster;
+	c->valid = true;
+
+	return c->row;
+}
+
+/*
+ * @brief Returns the decompressed PVS row for the given cluster.
+ */
+const byte *Sv_ClusterPVS(const int32_t cluster) {
+	return Sv_ClusterVis(cluster, DVIS_PVS);
+}
+
+/*
+ * @brief Returns the decompressed PHS row for the given cluster.
+ */
+const byte *Sv_ClusterPHS(const int32_t cluster) {
+	return Sv_ClusterVis(cluster, DVIS_PHS);
+}
@@ -30,9 +30,18 @@ void Sv_LinkEdict(g_edict_t *ent);
 void Sv_UnlinkEdict(g_edict_t *ent);
 int32_t Sv_AreaEdicts(const vec3_t mins, const vec3_t maxs, g_edict_t **area_edicts,
 		int32_t max_area_edicts, int32_t area_type);
+int32_t Sv_RadiusEdicts(const vec3_t origin, const vec_t radius, g_edict_t **area_edicts,
+		const int32_t max_area_edicts, const int32_t area_type);
 int32_t Sv_PointContents(const vec3_t p);
 c_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs,
 		const g_edict_t *skip, const int32_t contents);
+void Sv_RecordRewindFrame(void);
+c_trace_t Sv_RewindTrace(const vec3_t start, const vec3_t end, const vec3_t mins,
+		const vec3_t maxs, const g_edict_t *skip, const int32_t contents,
+		const g_edict_t *shooter);
+int32_t Sv_PointLeafnum(const vec3_t point);
+const byte *Sv_ClusterPVS(const int32_t cluster);
+const byte *Sv_ClusterPHS(const int32_t cluster);
 
 #endif /* __SV_LOCAL_H__ */
 
@@ -60,6 +60,21 @@ uint32_t Sys_Milliseconds(void) {
 	return (time.tv_sec - base) * 1000 + time.tv_usec / 1000;
 }
 
+/*
+ * @return Microseconds since Quake execution began, for high resolution timing.
+ */
+uint64_t Sys_Microseconds(void) {
+	static uint64_t base;
+	GTimeVal time;
+
+	g_get_current_time(&time);
+
+	if (!base)
+		base = time.tv_sec;
+
+	return (time.tv_sec - base) * 1000000ull + time.tv_usec;
+}
+
 /*
  * @return The current executable path (argv[0]).
  */
@@ -25,6 +25,7 @@
 #include "quake2world.h"
 
 uint32_t Sys_Milliseconds(void);
+uint64_t Sys_Microseconds(void);
 
 const char *Sys_ExecutablePath(void);
 const char *Sys_Username(void);
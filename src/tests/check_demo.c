@@ -0,0 +1,222 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "tests.h"
+#include "demo.h"
+
+#define NUM_FRAMES 2000
+#define KEYFRAME_INTERVAL 100
+#define MESSAGE_SIZE 2048
+
+/*
+ * @brief Setup fixture.
+ */
+void setup(void) {
+
+	Mem_Init();
+
+	Fs_Init(true);
+}
+
+/*
+ * @brief Teardown fixture.
+ */
+void teardown(void) {
+
+	Fs_Shutdown();
+
+	Mem_Shutdown();
+}
+
+/*
+ * @brief Fills the message for the specified frame with a recognizable pattern,
+ * returning its size.
+ */
+static size_t Message(int32_t frame_num, byte *data) {
+	const size_t size = 64 + (frame_num * 31) % 1024;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		data[i] = (frame_num + i) & 0xff;
+	}
+
+	return size;
+}
+
+/*
+ * @brief Writes a demo of NUM_FRAMES frames, with a header and keyframes.
+ */
+static void WriteDemo(const char *filename, uint32_t flags) {
+	byte data[MESSAGE_SIZE];
+	int32_t i;
+
+	demo_t *demo = Demo_OpenWrite(filename, 40, flags);
+	ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+
+	Demo_WriteMessage(demo, 0, "header", 6);
+
+	for (i = 1; i <= NUM_FRAMES; i++) {
+
+		if (i % KEYFRAME_INTERVAL == 1) {
+			Demo_BeginKeyframe(demo, i);
+			Demo_WriteMessage(demo, i, "keyframe", 8);
+		}
+
+		Demo_WriteMessage(demo, i, data, Message(i, data));
+	}
+
+	Demo_Close(demo);
+}
+
+/*
+ * @brief Reads the next message and asserts that it is that of the frame.
+ */
+static void ReadFrame(demo_t *demo, int32_t frame_num) {
+	byte expected[MESSAGE_SIZE], data[MESSAGE_SIZE];
+
+	if (frame_num % KEYFRAME_INTERVAL == 1) {
+		ck_assert_int_eq(Demo_ReadMessage(demo, data, sizeof(data)), 8);
+		ck_assert(!memcmp(data, "keyframe", 8));
+	}
+
+	const int32_t size = Demo_ReadMessage(demo, data, sizeof(data));
+
+	ck_assert_int_eq(size, Message(frame_num, expected));
+	ck_assert_int_eq(demo->frame_num, frame_num);
+	ck_assert(!memcmp(data, expected, size));
+}
+
+START_TEST(check_Demo_ReadMessage)
+	{
+		const uint32_t flags[] = { 0, DEMO_COMPRESS };
+		byte data[MESSAGE_SIZE];
+		uint32_t i;
+		int32_t j;
+
+		for (i = 0; i < lengthof(flags); i++) {
+			WriteDemo(__func__, flags[i]);
+
+			demo_t *demo = Demo_OpenRead(__func__);
+			ck_assert_msg(demo != NULL, "Failed to open %s", __func__);
+
+			ck_assert_int_eq(demo->hz, 40);
+			ck_assert_int_eq(Demo_FirstFrame(demo), 1);
+			ck_assert_int_eq(Demo_LastFrame(demo), NUM_FRAMES);
+
+			ck_assert_int_eq(Demo_ReadMessage(demo, data, sizeof(data)), 6);
+
+			for (j = 1; j <= NUM_FRAMES; j++) {
+				ReadFrame(demo, j);
+			}
+
+			ck_assert_int_eq(Demo_ReadMessage(demo, data, sizeof(data)), -1);
+
+			Demo_Close(demo);
+		}
+	}END_TEST
+
+START_TEST(check_Demo_Seek)
+	{
+		WriteDemo(__func__, DEMO_COMPRESS);
+
+		demo_t *demo = Demo_OpenRead(__func__);
+		ck_assert_msg(demo != NULL, "Failed to open %s", __func__);
+
+		ck_assert_int_eq(Demo_FindKeyframe(demo, 0), 1);
+		ck_assert_int_eq(Demo_FindKeyframe(demo, 250), 201);
+		ck_assert_int_eq(Demo_FindKeyframe(demo, NUM_FRAMES * 2), NUM_FRAMES - 99);
+
+		const int32_t frames[] = { 1555, 250, 1, NUM_FRAMES };
+		uint32_t i;
+
+		for (i = 0; i < lengthof(frames); i++) {
+			const int32_t keyframe = Demo_Seek(demo, frames[i]);
+
+			ck_assert_int_eq(keyframe, Demo_FindKeyframe(demo, frames[i]));
+			ck_assert_msg(keyframe <= frames[i], "Seeked past %d to %d", frames[i], keyframe);
+
+			ReadFrame(demo, keyframe);
+			ReadFrame(demo, keyframe + 1);
+		}
+
+		Demo_Close(demo);
+	}END_TEST
+
+START_TEST(check_Demo_ReadFlat)
+	{
+		byte data[MESSAGE_SIZE], expected[MESSAGE_SIZE];
+		int32_t i, len;
+
+		file_t *f = Fs_OpenWrite(__func__);
+		ck_assert_msg(f != NULL, "Failed to open %s", __func__);
+
+		for (i = 1; i <= 10; i++) {
+			const size_t size = Message(i, data);
+
+			len = LittleLong(size);
+			Fs_Write(f, &len, sizeof(len), 1);
+			Fs_Write(f, data, size, 1);
+		}
+
+		len = -1;
+		Fs_Write(f, &len, sizeof(len), 1);
+		Fs_Close(f);
+
+		demo_t *demo = Demo_OpenRead(__func__);
+		ck_assert_msg(demo != NULL, "Failed to open %s", __func__);
+
+		ck_assert_int_eq(Demo_FirstFrame(demo), -1);
+		ck_assert_int_eq(Demo_Seek(demo, 5), -1);
+
+		for (i = 1; i <= 10; i++) {
+			const int32_t size = Demo_ReadMessage(demo, data, sizeof(data));
+
+			ck_assert_int_eq(size, Message(i, expected));
+			ck_assert(!memcmp(data, expected, size));
+		}
+
+		ck_assert_int_eq(Demo_ReadMessage(demo, data, sizeof(data)), -1);
+
+		Demo_Close(demo);
+	}END_TEST
+
+/*
+ * @brief Test entry point.
+ */
+int32_t main(int32_t argc, char **argv) {
+
+	Test_Init(argc, argv);
+
+	TCase *tcase = tcase_create("check_demo");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, check_Demo_ReadMessage);
+	tcase_add_test(tcase, check_Demo_Seek);
+	tcase_add_test(tcase, check_Demo_ReadFlat);
+
+	Suite *suite = suite_create("check_demo");
+	suite_add_tcase(suite, tcase);
+
+	int32_t failed = Test_Run(suite);
+
+	Test_Shutdown();
+	return failed;
+}
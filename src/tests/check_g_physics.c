@@ -0,0 +1,485 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "tests.h"
+#include "cmd.h"
+#include "cvar.h"
+#include "game/default/g_local.h"
+
+/*
+ * The game is run against an empty world: traces never hit, and entities are
+ * found in an area by their bounds alone. This is enough to drive movers from
+ * their triggers, which is what these tests exercise.
+ */
+
+#define CHECK_FRAME_RATE 40
+
+static const char *check_entities = ""
+	"{\n"
+	"\"classname\" \"worldspawn\"\n"
+	"}\n"
+	"{\n"
+	"\"classname\" \"func_door\"\n"
+	"\"model\" \"*1\"\n"
+	"\"angle\" \"-1\"\n"
+	"}\n"
+	"{\n"
+	"\"classname\" \"func_plat\"\n"
+	"\"model\" \"*2\"\n"
+	"}\n";
+
+/*
+ * @brief Inline models are sized by their number, and positioned away from
+ * one another, so that their triggers do not overlap.
+ */
+static void check_SetModel(g_edict_t *ent, const char *name) {
+	const int32_t i = atoi(name + 1);
+
+	ent->s.model1 = i;
+
+	VectorSet(ent->mins, -64.0 + i * 512.0, -64.0, 0.0);
+	VectorSet(ent->maxs, 64.0 + i * 512.0, 64.0, 128.0 / i);
+
+	gi.LinkEdict(ent);
+}
+
+static void check_LinkEdict(g_edict_t *ent) {
+
+	VectorAdd(ent->s.origin, ent->mins, ent->abs_mins);
+	VectorAdd(ent->s.origin, ent->maxs, ent->abs_maxs);
+
+	VectorSubtract(ent->maxs, ent->mins, ent->size);
+
+	ent->link_count++;
+}
+
+static void check_UnlinkEdict(g_edict_t *ent __attribute__((unused))) {
+}
+
+static int32_t check_AreaEdicts(const vec3_t mins, const vec3_t maxs, g_edict_t **area_edicts,
+		const int32_t max_area_edicts, const int32_t area_type) {
+	int32_t i, j, count = 0;
+
+	for (i = 1; i < (int32_t) ge.num_edicts && count < max_area_edicts; i++) {
+		g_edict_t *ent = &g_game.edicts[i];
+
+		if (!ent->in_use || ent->solid == SOLID_NOT)
+			continue;
+
+		if ((ent->solid == SOLID_TRIGGER) != (area_type == AREA_TRIGGERS))
+			continue;
+
+		for (j = 0; j < 3; j++) {
+			if (ent->abs_mins[j] > maxs[j] || ent->abs_maxs[j] < mins[j])
+				break;
+		}
+
+		if (j == 3)
+			area_edicts[count++] = ent;
+	}
+
+	return count;
+}
+
+static int32_t check_RadiusEdicts(const vec3_t origin __attribute__((unused)),
+		const vec_t radius __attribute__((unused)), g_edict_t **area_edicts __attribute__((unused)),
+		const int32_t max_area_edicts __attribute__((unused)),
+		const int32_t area_type __attribute__((unused))) {
+	return 0;
+}
+
+static c_trace_t check_Trace(const vec3_t start __attribute__((unused)), const vec3_t end,
+		const vec3_t mins __attribute__((unused)), const vec3_t maxs __attribute__((unused)),
+		const g_edict_t *skip __attribute__((unused)), const int32_t contents __attribute__((unused))) {
+	c_trace_t trace;
+
+	memset(&trace, 0, sizeof(trace));
+
+	trace.fraction = 1.0;
+	VectorCopy(end, trace.end);
+
+	return trace;
+}
+
+static c_trace_t check_RewindTrace(const vec3_t start, const vec3_t end, const vec3_t mins,
+		const vec3_t maxs, const g_edict_t *skip, const int32_t contents,
+		const g_edict_t *shooter __attribute__((unused))) {
+	return check_Trace(start, end, mins, maxs, skip, contents);
+}
+
+static int32_t check_PointContents(const vec3_t point __attribute__((unused))) {
+	return 0;
+}
+
+static _Bool check_InVis(const vec3_t p1 __attribute__((unused)),
+		const vec3_t p2 __attribute__((unused))) {
+	return true;
+}
+
+static void check_SetAreaPortalState(int32_t portal_num __attribute__((unused)),
+		_Bool open __attribute__((unused))) {
+}
+
+static _Bool check_AreasConnected(int32_t area1 __attribute__((unused)),
+		int32_t area2 __attribute__((unused))) {
+	return true;
+}
+
+static void check_Error(const char *func, const char *fmt, ...) __attribute__((noreturn));
+
+static void check_Error(const char *func, const char *fmt, ...) {
+	char msg[MAX_STRING_CHARS];
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(msg, sizeof(msg), fmt, args);
+	va_end(args);
+
+	ck_assert_msg(false, "%s: %s", func, msg);
+	abort();
+}
+
+static int64_t check_LoadFile(const char *file_name __attribute__((unused)),
+		void **buffer __attribute__((unused))) {
+	return -1;
+}
+
+static void check_FreeFile(void *buffer __attribute__((unused))) {
+}
+
+static void check_AddCommandString(const char *text __attribute__((unused))) {
+}
+
+static void check_ConfigString(const uint16_t index __attribute__((unused)),
+		const char *string __attribute__((unused))) {
+}
+
+static uint16_t check_Index(const char *name __attribute__((unused))) {
+	return 1;
+}
+
+static void check_Sound(const g_edict_t *ent __attribute__((unused)),
+		const uint16_t index __attribute__((unused)), const uint16_t atten __attribute__((unused))) {
+}
+
+static void check_PositionedSound(const vec3_t origin __attribute__((unused)),
+		const g_edict_t *ent __attribute__((unused)), const uint16_t index __attribute__((unused)),
+		const uint16_t atten __attribute__((unused))) {
+}
+
+static void check_Multicast(const vec3_t origin __attribute__((unused)),
+		multicast_t to __attribute__((unused))) {
+}
+
+static void check_Unicast(const g_edict_t *ent __attribute__((unused)),
+		const _Bool reliable __attribute__((unused))) {
+}
+
+static void check_WriteData(const void *data __attribute__((unused)),
+		size_t len __attribute__((unused))) {
+}
+
+static void check_WriteInt(const int32_t c __attribute__((unused))) {
+}
+
+static void check_WriteString(const char *s __attribute__((unused))) {
+}
+
+static void check_WriteFloat(const vec_t v __attribute__((unused))) {
+}
+
+static void check_WriteVec3(const vec3_t v __attribute__((unused))) {
+}
+
+static void check_BroadcastPrint(const int32_t level __attribute__((unused)),
+		const char *fmt __attribute__((unused)), ...) {
+}
+
+static void check_ClientPrint(const g_edict_t *ent __attribute__((unused)),
+		const int32_t level __attribute__((unused)), const char *fmt __attribute__((unused)), ...) {
+}
+
+static uint16_t check_ProfileScope(const char *name __attribute__((unused))) {
+	return 0;
+}
+
+static void check_Profile(const uint16_t scope __attribute__((unused))) {
+}
+
+/*
+ * @brief Setup fixture.
+ */
+void setup(void) {
+	static g_import_t import;
+
+	memset(&import, 0, sizeof(import));
+
+	import.frame_rate = CHECK_FRAME_RATE;
+	import.frame_millis = 1000 / CHECK_FRAME_RATE;
+	import.frame_seconds = 1.0 / CHECK_FRAME_RATE;
+
+	import.Print = Com_Print;
+	import.Debug_ = Com_Debug_;
+	import.Warn_ = Com_Warn_;
+	import.Error_ = check_Error;
+
+	import.Malloc = Mem_TagMalloc;
+	import.LinkMalloc = Mem_LinkMalloc;
+	import.Free = Mem_Free;
+	import.FreeTag = Mem_FreeTag;
+
+	import.LoadFile = check_LoadFile;
+	import.FreeFile = check_FreeFile;
+
+	import.Cvar = Cvar_Get;
+	import.Cmd = Cmd_Add;
+	import.Argc = Cmd_Argc;
+	import.Argv = Cmd_Argv;
+	import.Args = Cmd_Args;
+
+	import.AddCommandString = check_AddCommandString;
+
+	import.ConfigString = check_ConfigString;
+
+	import.ModelIndex = check_Index;
+	import.SoundIndex = check_Index;
+	import.ImageIndex = check_Index;
+
+	import.SetModel = check_SetModel;
+	import.Sound = check_Sound;
+	import.PositionedSound = check_PositionedSound;
+
+	import.Trace = check_Trace;
+	import.RewindTrace = check_RewindTrace;
+	import.PointContents = check_PointContents;
+	import.inPVS = check_InVis;
+	import.inPHS = check_InVis;
+	import.SetAreaPortalState = check_SetAreaPortalState;
+	import.AreasConnected = check_AreasConnected;
+
+	import.LinkEdict = check_LinkEdict;
+	import.UnlinkEdict = check_UnlinkEdict;
+	import.AreaEdicts = check_AreaEdicts;
+	import.RadiusEdicts = check_RadiusEdicts;
+
+	import.Multicast = check_Multicast;
+	import.Unicast = check_Unicast;
+	import.WriteData = check_WriteData;
+	import.WriteChar = check_WriteInt;
+	import.WriteByte = check_WriteInt;
+	import.WriteShort = check_WriteInt;
+	import.WriteLong = check_WriteInt;
+	import.WriteString = check_WriteString;
+	import.WriteVector = check_WriteFloat;
+	import.WritePosition = check_WriteVec3;
+	import.WriteDir = check_WriteVec3;
+	import.WriteAngle = check_WriteFloat;
+	import.WriteAngles = check_WriteVec3;
+
+	import.BroadcastPrint = check_BroadcastPrint;
+	import.ClientPrint = check_ClientPrint;
+
+	import.ProfileScope = check_ProfileScope;
+	import.ProfileBegin = check_Profile;
+	import.ProfileEnd = check_Profile;
+
+	G_LoadGame(&import);
+
+	ge.Init();
+}
+
+/*
+ * @brief Teardown fixture.
+ */
+void teardown(void) {
+
+	ge.Shutdown();
+}
+
+/*
+ * @brief Spawns the test entities with entity sleep set as specified.
+ */
+static void check_SpawnEntities(const char *sleep) {
+
+	Cvar_Set("g_entity_sleep", sleep);
+
+	ge.SpawnEntities("check", check_entities);
+}
+
+/*
+ * @brief Returns the first entity of the specified class.
+ */
+static g_edict_t *check_Find(const char *class_name) {
+	return G_Find(NULL, EOFS(class_name), class_name);
+}
+
+/*
+ * @brief Returns true if the specified entity is awake.
+ */
+static _Bool check_Awake(const g_edict_t *ent) {
+	g_edict_t *e;
+
+	for (e = G_NextEntity(NULL); e; e = G_NextEntity(e)) {
+		if (e == ent)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * @brief Places a live player within the trigger of the specified mover, and
+ * touches its triggers as the player's movement would.
+ */
+static void check_Touch(g_edict_t *player, const g_edict_t *mover) {
+
+	player->locals.health = 100;
+
+	VectorAdd(mover->abs_mins, mover->abs_maxs, player->s.origin);
+	VectorScale(player->s.origin, 0.5, player->s.origin);
+
+	VectorSet(player->mins, -16.0, -16.0, -24.0);
+	VectorSet(player->maxs, 16.0, 16.0, 32.0);
+
+	gi.LinkEdict(player);
+
+	G_TouchTriggers(player);
+}
+
+/*
+ * @brief Runs the specified number of frames, returning the number of them
+ * in which the mover was away from the specified resting position.
+ */
+static uint32_t check_RunFrames(const g_edict_t *mover, const vec3_t rest, uint32_t frames) {
+	uint32_t moved = 0;
+
+	while (frames--) {
+		ge.Frame();
+
+		if (!VectorCompare(mover->s.origin, rest))
+			moved++;
+	}
+
+	return moved;
+}
+
+START_TEST(check_G_func_door_Sleep)
+	{
+		check_SpawnEntities("1");
+
+		g_edict_t *door = check_Find("func_door");
+		ck_assert_msg(door != NULL, "Failed to spawn func_door");
+
+		check_RunFrames(door, door->s.origin, CHECK_FRAME_RATE);
+
+		ck_assert_msg(!check_Awake(door), "func_door did not fall asleep");
+		ck_assert_msg(door->locals.move_info.state == MOVE_STATE_BOTTOM, "func_door is not closed");
+
+		vec3_t rest;
+		VectorCopy(door->s.origin, rest);
+
+		check_Touch(&g_game.edicts[1], door);
+
+		const uint32_t moved = check_RunFrames(door, rest, CHECK_FRAME_RATE * 10);
+
+		ck_assert_msg(moved > 0, "func_door did not open when its trigger was touched");
+		ck_assert_msg(door->locals.move_info.state == MOVE_STATE_BOTTOM,
+				"func_door is not closed again");
+		ck_assert_msg(VectorCompare(door->s.origin, rest), "func_door did not come to rest");
+		ck_assert_msg(!check_Awake(door), "func_door did not fall asleep again");
+
+	}END_TEST
+
+START_TEST(check_G_func_plat_Sleep)
+	{
+		check_SpawnEntities("1");
+
+		g_edict_t *plat = check_Find("func_plat");
+		ck_assert_msg(plat != NULL, "Failed to spawn func_plat");
+
+		check_RunFrames(plat, plat->s.origin, CHECK_FRAME_RATE);
+
+		ck_assert_msg(!check_Awake(plat), "func_plat did not fall asleep");
+		ck_assert_msg(plat->locals.move_info.state == MOVE_STATE_BOTTOM, "func_plat is not lowered");
+
+		vec3_t rest;
+		VectorCopy(plat->s.origin, rest);
+
+		check_Touch(&g_game.edicts[1], plat);
+
+		const uint32_t moved = check_RunFrames(plat, rest, CHECK_FRAME_RATE * 10);
+
+		ck_assert_msg(moved > 0, "func_plat did not rise when its trigger was touched");
+		ck_assert_msg(plat->locals.move_info.state == MOVE_STATE_BOTTOM,
+				"func_plat is not lowered again");
+		ck_assert_msg(VectorCompare(plat->s.origin, rest), "func_plat did not come to rest");
+		ck_assert_msg(!check_Awake(plat), "func_plat did not fall asleep again");
+
+	}END_TEST
+
+START_TEST(check_G_func_door_Trajectory)
+	{
+		vec3_t origins[2][CHECK_FRAME_RATE * 10];
+		uint32_t i, j;
+
+		for (i = 0; i < 2; i++) {
+			check_SpawnEntities(i ? "1" : "0");
+
+			g_edict_t *door = check_Find("func_door");
+
+			check_RunFrames(door, door->s.origin, CHECK_FRAME_RATE);
+			check_Touch(&g_game.edicts[1], door);
+
+			for (j = 0; j < lengthof(origins[i]); j++) {
+				ge.Frame();
+				VectorCopy(door->s.origin, origins[i][j]);
+			}
+		}
+
+		for (j = 0; j < lengthof(origins[0]); j++) {
+			ck_assert_msg(VectorCompare(origins[0][j], origins[1][j]),
+					"func_door moved differently with entity sleep on frame %u", j);
+		}
+
+	}END_TEST
+
+/*
+ * @brief Test entry point.
+ */
+int32_t main(int32_t argc, char **argv) {
+
+	Test_Init(argc, argv);
+
+	TCase *tcase = tcase_create("check_g_physics");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, check_G_func_door_Sleep);
+	tcase_add_test(tcase, check_G_func_plat_Sleep);
+	tcase_add_test(tcase, check_G_func_door_Trajectory);
+
+	Suite *suite = suite_create("check_g_physics");
+	suite_add_tcase(suite, tcase);
+
+	int32_t failed = Test_Run(suite);
+
+	Test_Shutdown();
+	return failed;
+}
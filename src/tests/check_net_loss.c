@@ -0,0 +1,381 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "tests.h"
+#include "cmd.h"
+#include "net_frame.h"
+#include "net_udp.h"
+
+/*
+ * This harness streams a synthetic scene from a server to a client over the
+ * loopback, with net_loss dropping datagrams in both directions. Both ends use
+ * the baseline and entity delta code of net_frame.c, exactly as Sv_WriteFrame
+ * and Cl_ParseFrame do, and the client verifies every frame it receives. The
+ * average frame size is reported for each loss rate, with and without the
+ * acknowledged baselines.
+ */
+
+#define NUM_ENTITIES MAX_PACKET_ENTITIES
+#define NUM_FRAMES 1200
+#define ENTITY_STATES (PACKET_BACKUP * MAX_PACKET_ENTITIES)
+
+typedef struct {
+	_Bool valid;
+	int32_t frame_num;
+	net_entities_t entities;
+	player_state_t ps;
+} loss_frame_t;
+
+typedef struct {
+	loss_frame_t frames[PACKET_BACKUP];
+
+	entity_state_t entity_states[ENTITY_STATES];
+	uint32_t entity_state;
+
+	net_baseline_t baseline, pending_baseline;
+	int32_t last_frame;
+} loss_peer_t;
+
+static entity_state_t map_baselines[MAX_EDICTS];
+static loss_peer_t server, client;
+
+static net_addr_t loop_addr;
+static uint32_t num_errors;
+
+/*
+ * @brief Setup fixture.
+ */
+void setup(void) {
+
+	Mem_Init();
+
+	Fs_Init(false);
+
+	Cmd_Init();
+
+	Cvar_Init();
+
+	Net_Init();
+}
+
+/*
+ * @brief Teardown fixture.
+ */
+void teardown(void) {
+
+	Net_Shutdown();
+
+	Cvar_Shutdown();
+
+	Cmd_Shutdown();
+
+	Fs_Shutdown();
+
+	Mem_Shutdown();
+}
+
+/*
+ * @brief Populates the scene for the specified frame, as Sv_BuildClientFrame
+ * would. Half of the entities move, and every entity periodically leaves and
+ * re-enters the view.
+ */
+static loss_frame_t *BuildFrame(int32_t frame_num) {
+	int32_t i;
+
+	loss_frame_t *frame = &server.frames[frame_num & PACKET_MASK];
+	memset(frame, 0, sizeof(*frame));
+
+	frame->valid = true;
+	frame->frame_num = frame_num;
+
+	frame->entities.states = server.entity_states;
+	frame->entities.num_states = ENTITY_STATES;
+	frame->entities.first = server.entity_state;
+
+	for (i = 0; i < NUM_ENTITIES; i++) {
+
+		if ((i * 7 + frame_num / 25) % 5 == 0)
+			continue;
+
+		entity_state_t *s = &server.entity_states[server.entity_state++ % ENTITY_STATES];
+		memset(s, 0, sizeof(*s));
+
+		s->number = 1 + i * 3;
+		VectorSet(s->origin, -2048.0 + i * 64.0, 1024.0 - i * 32.0, (i % 4) * 64.0);
+
+		if (i & 1) {
+			const vec_t speed = (i % 7 - 3) * 2.5;
+
+			s->origin[0] += speed * frame_num;
+			s->origin[1] += speed * 0.5 * frame_num;
+			s->angles[1] = (frame_num * 4) % 360;
+			s->animation1 = (frame_num / 10) & 0xff;
+		}
+
+		VectorCopy(s->origin, s->old_origin);
+		s->model1 = 1 + (i % 5);
+		s->solid = SOLID_BOX;
+
+		frame->entities.num_entities++;
+	}
+
+	return frame;
+}
+
+/*
+ * @brief Writes the frame as Sv_WriteFrame would, returning its size in bytes.
+ */
+static size_t SendFrame(const loss_frame_t *frame, _Bool baselines) {
+	byte buffer[MAX_MSG_SIZE];
+	mem_buf_t msg;
+
+	const loss_frame_t *from = NULL;
+
+	if (server.last_frame > 0 && frame->frame_num - server.last_frame < PACKET_BACKUP - 3)
+		from = &server.frames[server.last_frame & PACKET_MASK];
+
+	if (baselines) {
+		const loss_frame_t *last = &server.frames[server.last_frame & PACKET_MASK];
+
+		Net_UpdateBaseline(&server.pending_baseline, &server.baseline, map_baselines,
+				frame->frame_num, server.last_frame, &last->entities, server.entity_state,
+				&last->ps);
+	}
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	Net_WriteLong(&msg, frame->frame_num);
+	Net_WriteLong(&msg, from ? from->frame_num : -1);
+
+	Net_WriteBaselines(&msg, &server.baseline, &server.pending_baseline);
+
+	const entity_state_t *base = Net_Baselines(&server.baseline, map_baselines);
+
+	Net_WriteEntities(&msg, from ? &from->entities : NULL, &frame->entities, base, 0, PROTOCOL);
+
+	Net_SendDatagram(NS_UDP_SERVER, &loop_addr, msg.data, msg.size);
+
+	return msg.size;
+}
+
+/*
+ * @brief Compares a decoded entity to the one the server sent.
+ */
+static void VerifyEntity(const entity_state_t *s, const entity_state_t *truth) {
+	int32_t i;
+
+	for (i = 0; i < 3; i++) {
+		if (s->origin[i] != (int16_t) (truth->origin[i] * 8.0) * 0.125)
+			num_errors++;
+	}
+
+	if (s->number != truth->number || s->model1 != truth->model1 || s->solid != truth->solid)
+		num_errors++;
+}
+
+/*
+ * @brief Folds the frame the server asks for, as Cl_ParseBaselines does.
+ */
+static void ReceiveBaselines(mem_buf_t *msg) {
+
+	const int32_t pending = Net_ReadBaselines(msg, &client.baseline, &client.pending_baseline);
+
+	if (pending == 0)
+		return;
+
+	const loss_frame_t *frame = &client.frames[pending & PACKET_MASK];
+
+	if (!frame->valid || frame->frame_num != pending)
+		return;
+
+	Net_FoldBaseline(&client.pending_baseline, &client.baseline, map_baselines, &frame->entities,
+			client.entity_state, &frame->ps, pending);
+}
+
+/*
+ * @brief Parses frames as Cl_ParseFrame would, verifying them against the
+ * server's, and acknowledges the latest one as Cl_SendCmd would.
+ */
+static void ReceiveFrames(void) {
+	byte buffer[MAX_MSG_SIZE];
+	mem_buf_t msg;
+	net_addr_t addr;
+	uint32_t i;
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	while (Net_ReceiveDatagram(NS_UDP_CLIENT, &addr, &msg)) {
+		loss_frame_t frame;
+
+		memset(&frame, 0, sizeof(frame));
+
+		frame.frame_num = Net_ReadLong(&msg);
+		const int32_t delta_frame_num = Net_ReadLong(&msg);
+
+		ReceiveBaselines(&msg);
+
+		const loss_frame_t *delta_frame = NULL;
+
+		if (delta_frame_num > 0) {
+			delta_frame = &client.frames[delta_frame_num & PACKET_MASK];
+
+			if (!delta_frame->valid || delta_frame->frame_num != delta_frame_num) {
+				num_errors++;
+				continue;
+			}
+		}
+
+		frame.entities.states = client.entity_states;
+		frame.entities.num_states = ENTITY_STATES;
+		frame.entities.first = client.entity_state;
+
+		const entity_state_t *base = Net_Baselines(&client.baseline, map_baselines);
+
+		Net_ReadEntities(&msg, delta_frame ? &delta_frame->entities : NULL, &frame.entities, base,
+				PROTOCOL, false);
+
+		client.entity_state += frame.entities.num_entities;
+
+		const loss_frame_t *truth = &server.frames[frame.frame_num & PACKET_MASK];
+
+		if (msg.read > msg.size || frame.entities.num_entities != truth->entities.num_entities) {
+			num_errors++;
+			continue;
+		}
+
+		for (i = 0; i < frame.entities.num_entities; i++) {
+			VerifyEntity(Net_EntityState(&frame.entities, i), Net_EntityState(&truth->entities, i));
+		}
+
+		frame.valid = true;
+
+		client.frames[frame.frame_num & PACKET_MASK] = frame;
+		client.last_frame = frame.frame_num;
+	}
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	Net_WriteLong(&msg, client.last_frame);
+	Net_WriteLong(&msg, client.pending_baseline.frame_num);
+
+	Net_SendDatagram(NS_UDP_CLIENT, &loop_addr, msg.data, msg.size);
+}
+
+/*
+ * @brief Receives acknowledgements as Sv_ParseClientMessage would.
+ */
+static void ReceiveAcks(void) {
+	byte buffer[MAX_MSG_SIZE];
+	mem_buf_t msg;
+	net_addr_t addr;
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	while (Net_ReceiveDatagram(NS_UDP_SERVER, &addr, &msg)) {
+
+		server.last_frame = Net_ReadLong(&msg);
+
+		const int32_t baseline = Net_ReadLong(&msg);
+
+		Net_AcknowledgeBaseline(&server.baseline, &server.pending_baseline, baseline);
+	}
+}
+
+/*
+ * @brief Runs the scene at the given loss percentage, returning the average
+ * number of bytes per frame.
+ */
+static vec_t Run(int32_t loss, _Bool baselines) {
+	size_t bytes = 0;
+	int32_t i;
+
+	ReceiveAcks(); // discard anything left over from the previous run
+
+	memset(&server, 0, sizeof(server));
+	memset(&client, 0, sizeof(client));
+
+	num_errors = 0;
+
+	Cvar_Set("net_loss", va("%d", loss));
+
+	for (i = 1; i <= NUM_FRAMES; i++) {
+
+		ReceiveAcks();
+
+		bytes += SendFrame(BuildFrame(i), baselines);
+
+		ReceiveFrames();
+	}
+
+	const vec_t average = bytes / (vec_t) NUM_FRAMES;
+
+	printf("%2d%% loss, %s baselines: %6.1f bytes per frame\n", loss,
+			baselines ? "acknowledged" : "map", average);
+
+	return average;
+}
+
+START_TEST(check_Net_Loss)
+	{
+		const int32_t loss[] = { 0, 5, 20 };
+		uint32_t i;
+
+		memset(&loop_addr, 0, sizeof(loop_addr));
+		loop_addr.type = NA_LOOP;
+
+		for (i = 0; i < MAX_EDICTS; i++) {
+			map_baselines[i].number = i;
+		}
+
+		for (i = 0; i < lengthof(loss); i++) {
+
+			const vec_t map = Run(loss[i], false);
+			ck_assert_msg(num_errors == 0, "%u errors at %d%% loss", num_errors, loss[i]);
+
+			const vec_t acknowledged = Run(loss[i], true);
+			ck_assert_msg(num_errors == 0, "%u errors at %d%% loss", num_errors, loss[i]);
+
+			ck_assert_msg(acknowledged <= map, "%.1f > %.1f at %d%% loss", acknowledged, map,
+					loss[i]);
+		}
+
+	}END_TEST
+
+/*
+ * @brief Test entry point.
+ */
+int32_t main(int32_t argc, char **argv) {
+
+	Test_Init(argc, argv);
+
+	TCase *tcase = tcase_create("check_net_loss");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, check_Net_Loss);
+
+	Suite *suite = suite_create("check_net_loss");
+	suite_add_tcase(suite, tcase);
+
+	int32_t failed = Test_Run(suite);
+
+	Test_Shutdown();
+	return failed;
+}
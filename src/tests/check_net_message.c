@@ -0,0 +1,153 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "tests.h"
+#include "net_message.h"
+
+static byte data[256];
+static mem_buf_t buf;
+
+/*
+ * @brief Setup fixture.
+ */
+void setup(void) {
+	Mem_InitBuffer(&buf, data, sizeof(data));
+}
+
+/*
+ * @brief Teardown fixture.
+ */
+void teardown(void) {
+}
+
+START_TEST(check_Net_WriteBits)
+	{
+		// check that bit fields of various widths and byte writes interleave correctly
+		Net_WriteBits(&buf, 1, 1);
+		Net_WriteBits(&buf, 0x5a5, 11);
+		Net_WriteBits(&buf, 0xdeadbeef, 32);
+		Net_WriteByte(&buf, 0x7f);
+		Net_WriteBits(&buf, 3, 2);
+		Net_WriteShort(&buf, -2);
+
+		ck_assert_msg(buf.size == 10, "buf.size was %u", (uint32_t) buf.size);
+
+		Net_BeginReading(&buf);
+
+		ck_assert(Net_ReadBits(&buf, 1) == 1);
+		ck_assert(Net_ReadBits(&buf, 11) == 0x5a5);
+		ck_assert(Net_ReadBits(&buf, 32) == 0xdeadbeef);
+		ck_assert(Net_ReadByte(&buf) == 0x7f);
+		ck_assert(Net_ReadBits(&buf, 2) == 3);
+		ck_assert(Net_ReadShort(&buf) == -2);
+
+		ck_assert(buf.read == buf.size);
+
+		// reading beyond the end of the buffer must be detectable
+		Net_ReadBits(&buf, 1);
+		ck_assert(buf.read > buf.size);
+
+	}END_TEST
+
+START_TEST(check_Net_WritePackedDeltaEntity)
+	{
+		entity_state_t from[3], to[3], out;
+		uint16_t last_number = 0, number, bits;
+		int32_t i;
+
+		memset(from, 0, sizeof(from));
+
+		from[0].number = 1;
+		VectorSet(from[0].origin, 100.0, -200.0, 32.0);
+
+		from[1].number = 9;
+		VectorSet(from[1].origin, 1024.0, 1024.0, 0.0);
+		VectorSet(from[1].angles, 0.0, 90.0, 0.0);
+		from[1].model1 = 3;
+
+		from[2].number = 600;
+		VectorSet(from[2].origin, -4000.0, 3000.0, 128.0);
+
+		memcpy(to, from, sizeof(to));
+
+		// a small, a medium and a large move, with a few other changes thrown in
+		VectorSet(to[0].origin, 101.5, -199.25, 32.0);
+		VectorSet(to[1].origin, 1100.0, 900.0, 0.125);
+		VectorSet(to[1].angles, 0.0, 180.0, 10.0);
+		to[1].model2 = 7;
+		to[1].effects = 0xf00d;
+		to[1].event = 1;
+		VectorSet(to[2].origin, 4000.0, -3000.0, 128.0);
+		VectorSet(to[2].old_origin, 3990.0, -3001.0, 120.0);
+		to[2].solid = 0x1234;
+
+		for (i = 0; i < 3; i++) {
+			Net_WritePackedDeltaEntity(&buf, &from[i], &to[i], false, i == 2, &last_number);
+		}
+		Net_WritePackedEntityHeader(&buf, &last_number, 601, U_REMOVE);
+		Net_WritePackedEntityEnd(&buf);
+
+		Net_BeginReading(&buf);
+		last_number = 0;
+
+		for (i = 0; i < 3; i++) {
+			number = Net_ReadPackedEntityHeader(&buf, &last_number, &bits);
+			ck_assert_msg(number == to[i].number, "number was %u", number);
+
+			Net_ReadPackedDeltaEntity(&buf, &from[i], &out, number, bits);
+
+			ck_assert(VectorCompare(out.origin, to[i].origin));
+			ck_assert(VectorCompare(out.old_origin, to[i].old_origin));
+			ck_assert(out.effects == to[i].effects);
+			ck_assert(out.event == to[i].event);
+			ck_assert(out.model1 == to[i].model1 && out.model2 == to[i].model2);
+			ck_assert(out.solid == to[i].solid);
+		}
+
+		number = Net_ReadPackedEntityHeader(&buf, &last_number, &bits);
+		ck_assert(number == 601 && bits == U_REMOVE);
+
+		ck_assert(Net_ReadPackedEntityHeader(&buf, &last_number, &bits) == 0);
+		ck_assert(buf.read == buf.size);
+
+	}END_TEST
+
+/*
+ * @brief Test entry point.
+ */
+int32_t main(int32_t argc, char **argv) {
+
+	Test_Init(argc, argv);
+
+	TCase *tcase = tcase_create("check_net_message");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, check_Net_WriteBits);
+	tcase_add_test(tcase, check_Net_WritePackedDeltaEntity);
+
+	Suite *suite = suite_create("check_net_message");
+	suite_add_tcase(suite, tcase);
+
+	int32_t failed = Test_Run(suite);
+
+	Test_Shutdown();
+	return failed;
+}
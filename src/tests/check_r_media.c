@@ -81,6 +81,53 @@ START_TEST(check_R_RegisterMedia)
 
 	}END_TEST
 
+static int32_t decoded, uploaded, freed;
+
+static void check_Decode(r_media_load_t *load __attribute__((unused))) {
+	decoded++;
+}
+
+static void check_Upload(r_media_load_t *load __attribute__((unused))) {
+	uploaded++;
+}
+
+static void check_Free(r_media_load_t *load __attribute__((unused))) {
+	freed++;
+}
+
+START_TEST(check_R_LoadMediaAsync)
+	{
+		decoded = uploaded = freed = 0;
+
+		R_BeginLoading();
+
+		r_media_t *media1 = R_AllocMedia("media1", sizeof(r_media_t));
+		R_RegisterMedia(media1);
+
+		R_LoadMediaAsync(media1, "check", check_Decode, check_Upload, check_Free, NULL);
+
+		ck_assert_msg(media1->load != NULL, "media1 is not pending");
+
+		R_WaitMedia(media1);
+
+		ck_assert_msg(media1->load == NULL, "media1 is still pending");
+		ck_assert_msg(decoded == 1 && uploaded == 1 && freed == 1, "media1 was not loaded");
+
+		r_media_t *media2 = R_AllocMedia("media2", sizeof(r_media_t));
+		R_RegisterMedia(media2);
+
+		R_LoadMediaAsync(media2, "check", check_Decode, check_Upload, check_Free, NULL);
+
+		R_BeginLoading();
+		R_FreeMedia();
+
+		ck_assert_msg(uploaded == 1, "Erroneously uploaded media2");
+		ck_assert_msg(freed == 2, "Pending load for media2 not freed");
+
+		ck_assert_msg(Mem_Size() == 0, "Not all memory freed: %u", (uint32_t) Mem_Size());
+
+	}END_TEST
+
 /*
  * @brief Test entry point.
  */
@@ -92,6 +139,7 @@ int32_t main(int32_t argc, char **argv) {
 	tcase_add_checked_fixture(tcase, setup, teardown);
 
 	tcase_add_test(tcase, check_R_RegisterMedia);
+	tcase_add_test(tcase, check_R_LoadMediaAsync);
 
 	Suite *suite = suite_create("check_r_media");
 	suite_add_tcase(suite, tcase);
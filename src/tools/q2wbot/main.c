@@ -0,0 +1,882 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <signal.h>
+#include <unistd.h>
+
+#include "cmd.h"
+#include "files.h"
+#include "filesystem.h"
+#include "net_chan.h"
+#include "sys.h"
+
+quake2world_t quake2world;
+
+#define BOT_CONNECT_INTERVAL 100 // stagger connections to spread the load
+#define BOT_REPORT_INTERVAL 5000
+
+/*
+ * @brief Connection states, a subset of those of the client.
+ */
+typedef enum {
+	BOT_CHALLENGING,
+	BOT_CONNECTED, // net_chan established, loading the level
+	BOT_ACTIVE // spawned, sending movement
+} bot_state_t;
+
+/*
+ * @brief Traffic and timing statistics, accumulated per bot.
+ */
+typedef struct {
+	uint32_t packets_in, bytes_in;
+	uint32_t packets_out;
+	uint32_t dropped;
+	uint32_t frames;
+	uint32_t frame_intervals; // sum of the time between consecutive frames
+	uint32_t max_frame_interval;
+	uint32_t connects;
+} bot_stats_t;
+
+/*
+ * @brief A headless client, speaking the real protocol on its own socket.
+ */
+typedef struct {
+	uint16_t index;
+	char name[16];
+
+	int32_t sock;
+	uint8_t qport;
+
+	bot_state_t state;
+	uint32_t connect_time; // for retransmits
+	int32_t challenge;
+
+	int32_t protocol;
+	int32_t spawn_count;
+	net_chan_t net_chan;
+
+	int32_t frame_num; // latest frame received, or -1
+	int32_t pending_baseline; // acknowledged as soon as it is advertised
+	uint32_t frame_time; // arrival of the latest frame
+
+	uint32_t cmd_time; // when the latest command was sent
+	user_cmd_t cmds[3]; // the latest three commands, oldest first
+	vec3_t angles;
+
+	bot_stats_t stats;
+} bot_t;
+
+/*
+ * @brief Movement scripts, populating each command the bots send.
+ */
+typedef struct {
+	const char *name;
+	void (*Think)(bot_t *bot, user_cmd_t *cmd);
+} bot_script_t;
+
+static struct {
+	net_addr_t server;
+
+	bot_t *bots;
+	uint16_t num_bots;
+
+	uint32_t cmd_interval; // milliseconds between commands
+	const bot_script_t *script;
+
+	uint32_t start_time, report_time;
+	int32_t frame_rate; // advertised by the server
+} bots;
+
+static volatile _Bool quit;
+
+static _Bool verbose;
+static _Bool debug;
+
+/*
+ * @brief Stands in place, slowly looking around.
+ */
+static void Bot_ScriptIdle(bot_t *bot, user_cmd_t *cmd) {
+
+	bot->angles[YAW] += 0.01 * cmd->msec;
+}
+
+/*
+ * @brief Runs forward, veering and jumping periodically.
+ */
+static void Bot_ScriptRun(bot_t *bot, user_cmd_t *cmd) {
+	const uint32_t t = quake2world.time + bot->index * 733;
+
+	bot->angles[YAW] += ((t / 2000) & 1 ? 0.05 : -0.05) * cmd->msec;
+
+	cmd->forward = 100 * cmd->msec;
+
+	if (t % 1500 < 100)
+		cmd->up = 100 * cmd->msec;
+}
+
+/*
+ * @brief Strafes from side to side while firing.
+ */
+static void Bot_ScriptStrafe(bot_t *bot, user_cmd_t *cmd) {
+	const uint32_t t = quake2world.time + bot->index * 733;
+
+	bot->angles[YAW] += 0.02 * cmd->msec;
+
+	cmd->right = ((t / 1000) & 1 ? 100 : -100) * cmd->msec;
+
+	if (t % 1000 < 500)
+		cmd->buttons |= BUTTON_ATTACK;
+}
+
+/*
+ * @brief Runs in circles while firing continuously.
+ */
+static void Bot_ScriptCircle(bot_t *bot, user_cmd_t *cmd) {
+
+	bot->angles[YAW] += 0.2 * cmd->msec;
+
+	cmd->forward = 100 * cmd->msec;
+	cmd->buttons |= BUTTON_ATTACK;
+}
+
+static const bot_script_t bot_scripts[] = {
+	{ "idle", Bot_ScriptIdle },
+	{ "run", Bot_ScriptRun },
+	{ "strafe", Bot_ScriptStrafe },
+	{ "circle", Bot_ScriptCircle },
+	{ NULL, NULL }
+};
+
+/*
+ * @brief Issues a string command to the server over the reliable channel.
+ */
+static void Bot_WriteString(bot_t *bot, const char *s) {
+
+	Net_WriteByte(&bot->net_chan.message, CL_CMD_STRING);
+	Net_WriteString(&bot->net_chan.message, s);
+}
+
+/*
+ * @brief Executes text stuffed into our command buffer by the server. Only the
+ * commands which drive the connection sequence are handled.
+ */
+static void Bot_ExecuteText(bot_t *bot, const char *text) {
+
+	Cmd_TokenizeString(text);
+
+	const char *c = Cmd_Argv(0);
+
+	if (!g_strcmp0(c, "config_strings") || !g_strcmp0(c, "baselines")) {
+		Bot_WriteString(bot, va("%s %s", c, Cmd_Args()));
+	} else if (!g_strcmp0(c, "precache")) {
+		Bot_WriteString(bot, va("begin %i\n", bot->spawn_count));
+		bot->state = BOT_ACTIVE;
+	} else {
+		Com_Debug("%s: Ignoring %s\n", bot->name, c);
+	}
+}
+
+/*
+ * @brief Parses the entities of a frame, mirroring Cl_ParseEntities. The
+ * states themselves are discarded, so every delta is read against a null state.
+ */
+static void Bot_ParseEntities(bot_t *bot, mem_buf_t *msg) {
+	static entity_state_t null_state;
+	entity_state_t state;
+	uint16_t last_number = 0;
+
+	while (true) {
+		uint16_t number, bits;
+
+		if (bot->protocol == PROTOCOL) {
+			number = Net_ReadPackedEntityHeader(msg, &last_number, &bits);
+		} else {
+			number = Net_ReadShort(msg);
+			bits = number ? Net_ReadShort(msg) : 0;
+		}
+
+		if (number >= MAX_EDICTS || msg->read > msg->size) {
+			Com_Error(ERR_DROP, "%s: Corrupt frame\n", bot->name);
+		}
+
+		if (!number)
+			break;
+
+		if (bits & U_REMOVE)
+			continue;
+
+		if (bot->protocol == PROTOCOL)
+			Net_ReadPackedDeltaEntity(msg, &null_state, &state, number, bits);
+		else
+			Net_ReadDeltaEntity(msg, &null_state, &state, number, bits);
+	}
+}
+
+/*
+ * @brief Parses a frame, recording the interval since the previous one.
+ */
+static void Bot_ParseFrame(bot_t *bot, mem_buf_t *msg) {
+	static player_state_t null_state;
+	player_state_t ps;
+	byte area_bits[MAX_BSP_AREAS >> 3];
+
+	const int32_t frame_num = Net_ReadLong(msg);
+	Net_ReadLong(msg); // delta frame
+
+	if (bot->protocol == PROTOCOL) {
+		Net_ReadLong(msg); // committed baseline
+		bot->pending_baseline = Net_ReadLong(msg);
+	}
+
+	Net_ReadByte(msg); // rate suppression count
+
+	const size_t len = Net_ReadByte(msg);
+	if (len > sizeof(area_bits)) {
+		Com_Error(ERR_DROP, "%s: Bad area bits\n", bot->name);
+	}
+	Net_ReadData(msg, area_bits, len);
+
+	Net_ReadDeltaPlayerState(msg, &null_state, &ps);
+
+	Bot_ParseEntities(bot, msg);
+
+	if (bot->frame_num > 0) {
+		const uint32_t interval = quake2world.time - bot->frame_time;
+
+		bot->stats.frame_intervals += interval;
+
+		if (interval > bot->stats.max_frame_interval)
+			bot->stats.max_frame_interval = interval;
+	}
+
+	bot->frame_num = frame_num;
+	bot->frame_time = quake2world.time;
+
+	bot->stats.frames++;
+}
+
+/*
+ * @brief Parses a sequenced message from the server. Game-specific commands
+ * can not be parsed here, so the remainder of any message containing one is
+ * skipped. These follow the frame, so no frames are lost.
+ */
+static void Bot_ParseMessage(bot_t *bot, mem_buf_t *msg) {
+	static entity_state_t null_state;
+	entity_state_t state;
+
+	while (true) {
+
+		if (msg->read > msg->size) {
+			Com_Error(ERR_DROP, "%s: Bad server message\n", bot->name);
+		}
+
+		const int32_t cmd = Net_ReadByte(msg);
+
+		if (cmd == -1)
+			break;
+
+		switch (cmd) {
+
+			case SV_CMD_BASELINE: {
+				const uint16_t number = Net_ReadShort(msg);
+				const uint16_t bits = Net_ReadShort(msg);
+
+				Net_ReadDeltaEntity(msg, &null_state, &state, number, bits);
+			}
+				break;
+
+			case SV_CMD_CBUF_TEXT:
+				Bot_ExecuteText(bot, Net_ReadString(msg));
+				break;
+
+			case SV_CMD_CONFIG_STRING:
+				Net_ReadShort(msg);
+				Net_ReadString(msg);
+				break;
+
+			case SV_CMD_DISCONNECT:
+				Com_Print("%s: Disconnected\n", bot->name);
+				bot->state = BOT_CHALLENGING;
+				bot->connect_time = 0;
+				return;
+
+			case SV_CMD_RECONNECT:
+				Com_Verbose("%s: Reconnecting\n", bot->name);
+				bot->state = BOT_CONNECTED;
+				bot->frame_num = -1;
+				Bot_WriteString(bot, "new");
+				break;
+
+			case SV_CMD_DOWNLOAD: {
+				int32_t size;
+				if (bot->protocol == PROTOCOL) {
+					Net_ReadByte(msg);
+					Net_ReadLong(msg);
+					Net_ReadLong(msg);
+					size = Net_ReadShort(msg);
+				} else {
+					size = Net_ReadShort(msg);
+					Net_ReadByte(msg);
+				}
+				if (size > 0)
+					msg->read += size;
+			}
+				break;
+
+			case SV_CMD_FRAME:
+				Bot_ParseFrame(bot, msg);
+				break;
+
+			case SV_CMD_PRINT:
+				Net_ReadByte(msg);
+				Com_Debug("%s: %s", bot->name, Net_ReadString(msg));
+				break;
+
+			case SV_CMD_SERVER_DATA:
+				bot->protocol = Net_ReadLong(msg);
+				bot->spawn_count = Net_ReadLong(msg);
+				bots.frame_rate = Net_ReadLong(msg);
+				Net_ReadByte(msg); // demo server
+				Net_ReadString(msg); // game
+				Net_ReadShort(msg); // entity number
+				Com_Verbose("%s: Loading %s\n", bot->name, Net_ReadString(msg));
+
+				bot->state = BOT_CONNECTED;
+				bot->frame_num = -1;
+				bot->pending_baseline = 0;
+				break;
+
+			case SV_CMD_SOUND: {
+				const int32_t flags = Net_ReadByte(msg);
+				Net_ReadByte(msg);
+				if (flags & S_ATTEN)
+					Net_ReadByte(msg);
+				if (flags & S_ENTNUM)
+					Net_ReadShort(msg);
+				if (flags & S_ORIGIN) {
+					vec3_t origin;
+					Net_ReadPosition(msg, origin);
+				}
+			}
+				break;
+
+			default:
+				return;
+		}
+	}
+}
+
+/*
+ * @brief Sends the connect request, once the server has challenged us.
+ */
+static void Bot_SendConnect(bot_t *bot) {
+
+	const char *user_info = va("\\name\\%s\\skin\\qforcer/enforcer\\rate\\%d\\active\\1", bot->name,
+			CLIENT_RATE);
+
+	Netchan_OutOfBandPrint(NS_UDP_CLIENT, &bots.server, "connect %i %i %i \"%s\"\n",
+			bot->protocol, bot->qport, bot->challenge, user_info);
+}
+
+/*
+ * @brief Handles connectionless packets, mirroring Cl_ConnectionlessPacket.
+ */
+static void Bot_ConnectionlessPacket(bot_t *bot) {
+
+	Net_BeginReading(&net_message);
+	Net_ReadLong(&net_message); // skip the -1
+
+	Cmd_TokenizeString(Net_ReadStringLine(&net_message));
+
+	const char *c = Cmd_Argv(0);
+
+	if (!g_strcmp0(c, "challenge")) {
+		if (bot->state != BOT_CHALLENGING)
+			return;
+
+		if (atoi(Cmd_Argv(2)) == PROTOCOL)
+			bot->protocol = PROTOCOL;
+		else
+			bot->protocol = PROTOCOL_LEGACY;
+
+		bot->challenge = atoi(Cmd_Argv(1));
+		Bot_SendConnect(bot);
+		return;
+	}
+
+	if (!g_strcmp0(c, "client_connect")) {
+		if (bot->state != BOT_CHALLENGING)
+			return;
+
+		Netchan_Setup(NS_UDP_CLIENT, &bot->net_chan, &net_from, bot->qport);
+		Bot_WriteString(bot, "new");
+
+		bot->state = BOT_CONNECTED;
+		bot->frame_num = -1;
+		bot->stats.connects++;
+		return;
+	}
+
+	if (!g_strcmp0(c, "print")) {
+		Com_Print("%s: %s", bot->name, Net_ReadString(&net_message));
+		return;
+	}
+
+	Com_Debug("%s: Unknown command %s\n", bot->name, c);
+}
+
+/*
+ * @brief Reads all pending packets from the bot's socket.
+ */
+static void Bot_ReadPackets(bot_t *bot) {
+
+	while (Net_ReceiveDatagram(NS_UDP_CLIENT, &net_from, &net_message)) {
+
+		if (*(int32_t *) net_message.data == -1) {
+			Bot_ConnectionlessPacket(bot);
+			continue;
+		}
+
+		if (bot->state == BOT_CHALLENGING)
+			continue;
+
+		if (net_message.size < 8)
+			continue;
+
+		if (!Net_CompareNetaddr(&net_from, &bot->net_chan.remote_address))
+			continue;
+
+		bot->stats.packets_in++;
+		bot->stats.bytes_in += net_message.size;
+
+		if (!Netchan_Process(&bot->net_chan, &net_message))
+			continue;
+
+		bot->stats.dropped += bot->net_chan.dropped;
+
+		Bot_ParseMessage(bot, &net_message);
+	}
+}
+
+/*
+ * @brief Sends the next movement command, mirroring Cl_SendCmd.
+ */
+static void Bot_SendCmd(bot_t *bot) {
+	static user_cmd_t null_cmd;
+	mem_buf_t buf;
+	byte data[128];
+
+	if (bot->state == BOT_CONNECTED) {
+		// send any reliable messages and / or don't timeout
+		if (bot->net_chan.message.size || quake2world.time - bot->net_chan.last_sent > 1000) {
+			Netchan_Transmit(&bot->net_chan, NULL, 0);
+			bot->stats.packets_out++;
+		}
+		return;
+	}
+
+	const uint32_t msec = quake2world.time - bot->cmd_time;
+
+	if (msec < bots.cmd_interval)
+		return;
+
+	bot->cmd_time = quake2world.time;
+
+	bot->cmds[0] = bot->cmds[1];
+	bot->cmds[1] = bot->cmds[2];
+
+	user_cmd_t *cmd = &bot->cmds[2];
+	memset(cmd, 0, sizeof(*cmd));
+
+	cmd->msec = MIN(msec, 250);
+
+	bots.script->Think(bot, cmd);
+
+	PackAngles(bot->angles, cmd->angles);
+
+	Mem_InitBuffer(&buf, data, sizeof(data));
+
+	Net_WriteByte(&buf, CL_CMD_MOVE);
+	Net_WriteLong(&buf, bot->frame_num);
+
+	if (bot->protocol == PROTOCOL)
+		Net_WriteLong(&buf, bot->pending_baseline);
+
+	Net_WriteDeltaUserCmd(&buf, &null_cmd, &bot->cmds[0]);
+	Net_WriteDeltaUserCmd(&buf, &bot->cmds[0], &bot->cmds[1]);
+	Net_WriteDeltaUserCmd(&buf, &bot->cmds[1], &bot->cmds[2]);
+
+	Netchan_Transmit(&bot->net_chan, buf.data, buf.size);
+	bot->stats.packets_out++;
+}
+
+/*
+ * @brief Runs a single bot: services its socket, and then connects or moves.
+ */
+static void Bot_Frame(bot_t *bot) {
+
+	Net_SetSocket(NS_UDP_CLIENT, bot->sock);
+
+	Bot_ReadPackets(bot);
+
+	if (bot->state == BOT_CHALLENGING) {
+		if (quake2world.time - bots.start_time < bot->index * BOT_CONNECT_INTERVAL)
+			return;
+
+		if (!bot->connect_time || quake2world.time - bot->connect_time > 3000) {
+			Netchan_OutOfBandPrint(NS_UDP_CLIENT, &bots.server, "get_challenge\n");
+			bot->connect_time = quake2world.time;
+		}
+		return;
+	}
+
+	Bot_SendCmd(bot);
+}
+
+/*
+ * @brief Disconnects the bot from the server, mirroring Cl_Disconnect.
+ */
+static void Bot_Disconnect(bot_t *bot) {
+	byte final[32];
+
+	Net_SetSocket(NS_UDP_CLIENT, bot->sock);
+
+	if (bot->state != BOT_CHALLENGING) {
+		final[0] = CL_CMD_STRING;
+		strcpy((char *) final + 1, "disconnect");
+
+		Netchan_Transmit(&bot->net_chan, final, strlen((char *) final));
+		Netchan_Transmit(&bot->net_chan, final, strlen((char *) final));
+		Netchan_Transmit(&bot->net_chan, final, strlen((char *) final));
+	}
+
+	Net_SetSocket(NS_UDP_CLIENT, 0);
+	Net_CloseSocket(bot->sock);
+}
+
+/*
+ * @brief Prints the aggregate statistics accumulated since the last report.
+ */
+static void Bot_Report(void) {
+	static bot_stats_t last;
+	bot_stats_t total;
+	uint16_t i, active = 0;
+
+	memset(&total, 0, sizeof(total));
+
+	for (i = 0; i < bots.num_bots; i++) {
+		const bot_stats_t *s = &bots.bots[i].stats;
+
+		total.packets_in += s->packets_in;
+		total.bytes_in += s->bytes_in;
+		total.packets_out += s->packets_out;
+		total.frames += s->frames;
+		total.frame_intervals += s->frame_intervals;
+		total.max_frame_interval = MAX(total.max_frame_interval, s->max_frame_interval);
+
+		if (bots.bots[i].state == BOT_ACTIVE)
+			active++;
+	}
+
+	const vec_t seconds = (quake2world.time - bots.report_time) / 1000.0;
+	const uint32_t frames = total.frames - last.frames;
+
+	Com_Print("%3u/%u active: %6.1f packets/s, %8.1f bytes/s in, %6.1f packets/s out, "
+		"%5.1fms frame time\n", active, bots.num_bots, (total.packets_in - last.packets_in)
+			/ seconds, (total.bytes_in - last.bytes_in) / seconds, (total.packets_out
+			- last.packets_out) / seconds, frames ? (total.frame_intervals - last.frame_intervals)
+			/ (vec_t) frames : 0.0);
+
+	last = total;
+	bots.report_time = quake2world.time;
+}
+
+/*
+ * @brief Prints the statistics of each bot over the entire run.
+ */
+static void Bot_Summary(void) {
+	uint16_t i;
+
+	const vec_t seconds = (quake2world.time - bots.start_time) / 1000.0;
+
+	if (seconds <= 0.0)
+		return;
+
+	if (bots.frame_rate)
+		Com_Print("\nServer frame rate %d (%.1fms)\n", bots.frame_rate, 1000.0 / bots.frame_rate);
+
+	Com_Print("\nbot      connects frames  packets/s   bytes/s  dropped  frame time  max\n");
+
+	for (i = 0; i < bots.num_bots; i++) {
+		const bot_t *bot = &bots.bots[i];
+		const bot_stats_t *s = &bot->stats;
+
+		Com_Print("%-8s %8u %6u %10.1f %9.1f %8u %9.1fms %3ums\n", bot->name, s->connects,
+				s->frames, s->packets_in / seconds, s->bytes_in / seconds, s->dropped,
+				s->frames > 1 ? s->frame_intervals / (vec_t) (s->frames - 1) : 0.0,
+				s->max_frame_interval);
+	}
+}
+
+/*
+ * @brief Runs the bots until the time limit expires or we are interrupted.
+ */
+static void Bot_Run(uint32_t seconds) {
+	uint16_t i;
+
+	quake2world.time = Sys_Milliseconds();
+
+	bots.start_time = bots.report_time = quake2world.time;
+
+	for (i = 0; i < bots.num_bots; i++) {
+		bot_t *bot = &bots.bots[i];
+
+		bot->index = i;
+		g_snprintf(bot->name, sizeof(bot->name), "bot%03u", i);
+
+		bot->sock = Net_Socket(NA_DATAGRAM, NULL, 0);
+		bot->qport = (Sys_Milliseconds() + i) & 255;
+		bot->state = BOT_CHALLENGING;
+		bot->frame_num = -1;
+	}
+
+	Com_Print("Connecting %u bots to %s...\n", bots.num_bots, Net_NetaddrToString(&bots.server));
+
+	while (!quit) {
+
+		quake2world.time = Sys_Milliseconds();
+
+		if (seconds && quake2world.time - bots.start_time >= seconds * 1000)
+			break;
+
+		for (i = 0; i < bots.num_bots; i++) {
+			Bot_Frame(&bots.bots[i]);
+		}
+
+		if (quake2world.time - bots.report_time >= BOT_REPORT_INTERVAL)
+			Bot_Report();
+
+		usleep(1000);
+	}
+
+	Bot_Summary();
+
+	for (i = 0; i < bots.num_bots; i++) {
+		Bot_Disconnect(&bots.bots[i]);
+	}
+}
+
+/*
+ * @brief Stops the bots at the end of the current frame, so that they may
+ * disconnect gracefully and report.
+ */
+static void Bot_Signal(int32_t s __attribute__((unused))) {
+	quit = true;
+}
+
+/*
+ * @brief Com_Debug implementation.
+ */
+static void Debug(const char *msg) {
+
+	if (debug) {
+		fputs(msg, stdout);
+	}
+}
+
+/*
+ * @brief Com_Error implementation.
+ */
+static void Error(err_t err __attribute__((unused)), const char *msg) __attribute__((noreturn));
+static void Error(err_t err __attribute__((unused)), const char *msg) {
+
+	fputs(msg, stderr);
+
+	Com_Shutdown(NULL);
+
+	exit(1);
+}
+
+/*
+ * @brief Com_Print implementation.
+ */
+static void Print(const char *msg) {
+	fputs(msg, stdout);
+}
+
+/*
+ * @brief Com_Verbose implementation.
+ */
+static void Verbose(const char *msg) {
+
+	if (verbose) {
+		fputs(msg, stdout);
+	}
+}
+
+/*
+ * @brief Com_Init implementation.
+ */
+static void Init(void) {
+
+	Mem_Init();
+
+	Fs_Init(false);
+
+	Cmd_Init();
+
+	Cvar_Init();
+
+	Netchan_Init();
+}
+
+/*
+ * @brief Com_Shutdown implementation.
+ */
+static void Shutdown(const char *msg) {
+
+	if (msg) {
+		fputs(msg, stdout);
+	}
+
+	Netchan_Shutdown();
+
+	Cvar_Shutdown();
+
+	Cmd_Shutdown();
+
+	Fs_Shutdown();
+
+	Mem_Shutdown();
+}
+
+/*
+ * @brief Connects a number of headless clients to a server, driving them with
+ * scripted movement, and reports the traffic and frame timing they observe.
+ * Network conditions may be simulated with e.g. +set net_latency 100.
+ */
+int32_t main(int32_t argc, char **argv) {
+	const char *server = NULL;
+	uint32_t seconds = 60;
+
+	printf("Quake2World Bot Tool %s %s %s\n", VERSION, __DATE__, BUILD_HOST);
+
+	memset(&quake2world, 0, sizeof(quake2world));
+
+	quake2world.Debug = Debug;
+	quake2world.Error = Error;
+	quake2world.Print = Print;
+	quake2world.Verbose = Verbose;
+
+	quake2world.Init = Init;
+	quake2world.Shutdown = Shutdown;
+
+	signal(SIGINT, Bot_Signal);
+	signal(SIGQUIT, Sys_Signal);
+	signal(SIGSEGV, Sys_Signal);
+	signal(SIGTERM, Bot_Signal);
+
+	Com_Init(argc, argv);
+
+	bots.num_bots = 8;
+	bots.cmd_interval = 1000 / 60;
+	bots.script = &bot_scripts[1];
+
+	int32_t i;
+	for (i = 1; i < Com_Argc(); i++) {
+
+		if (!g_strcmp0(Com_Argv(i), "-v") || !g_strcmp0(Com_Argv(i), "-verbose")) {
+			verbose = true;
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-d") || !g_strcmp0(Com_Argv(i), "-debug")) {
+			debug = true;
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-n") && i + 1 < Com_Argc()) {
+			const uint32_t n = strtoul(Com_Argv(++i), NULL, 0);
+			bots.num_bots = Clamp(n, 1, MAX_CLIENTS);
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-t") && i + 1 < Com_Argc()) {
+			seconds = strtoul(Com_Argv(++i), NULL, 0);
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-fps") && i + 1 < Com_Argc()) {
+			const uint32_t fps = strtoul(Com_Argv(++i), NULL, 0);
+			bots.cmd_interval = 1000 / Clamp(fps, 1, 1000);
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-script") && i + 1 < Com_Argc()) {
+			const char *name = Com_Argv(++i);
+
+			for (bots.script = bot_scripts; bots.script->name; bots.script++) {
+				if (!g_strcmp0(bots.script->name, name))
+					break;
+			}
+
+			if (!bots.script->name) {
+				Com_Print("Unknown script %s\n", name);
+				Com_Shutdown(NULL);
+				return 1;
+			}
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "+set") && i + 2 < Com_Argc()) {
+			Cvar_Set(Com_Argv(i + 1), Com_Argv(i + 2));
+			i += 2;
+			continue;
+		}
+
+		server = Com_Argv(i);
+	}
+
+	if (!server) {
+		Com_Print("Usage: %s [-v] [-d] [-n bots] [-t seconds] [-fps rate] "
+			"[-script idle|run|strafe|circle] [+set net_latency 100 ...] host[:port]\n", argv[0]);
+		Com_Shutdown(NULL);
+		return 1;
+	}
+
+	if (!Net_StringToNetaddr(server, &bots.server)) {
+		Com_Print("Bad server address %s\n", server);
+		Com_Shutdown(NULL);
+		return 1;
+	}
+
+	if (bots.server.port == 0)
+		bots.server.port = htons(PORT_SERVER);
+
+	bots.bots = Mem_Malloc(bots.num_bots * sizeof(bot_t));
+
+	Bot_Run(seconds);
+
+	Mem_Free(bots.bots);
+
+	Com_Shutdown(NULL);
+	return 0;
+}
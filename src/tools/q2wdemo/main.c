@@ -0,0 +1,784 @@
+/*
+ * Copyright(c) 1997-2001 Id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quake2World.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <signal.h>
+
+#include "demo.h"
+#include "files.h"
+#include "filesystem.h"
+#include "net.h"
+#include "net_frame.h"
+#include "sys.h"
+
+quake2world_t quake2world;
+
+#define DEMO_ENTITY_STATES (PACKET_BACKUP * MAX_PACKET_ENTITIES)
+
+/*
+ * @brief A parsed frame, holding a window of the accumulated entity states.
+ */
+typedef struct {
+	_Bool valid;
+	int32_t frame_num;
+	uint32_t entity_state; // index into entity_states
+	uint16_t num_entities;
+	uint8_t area_bytes;
+	byte area_bits[MAX_BSP_AREAS >> 3];
+	player_state_t ps;
+} demo_frame_t;
+
+/*
+ * @brief Encoder statistics, accumulated over all parsed frames.
+ */
+typedef struct {
+	uint32_t bytes;
+	uint32_t max_bytes;
+} demo_encoder_t;
+
+static struct {
+	int32_t protocol;
+	uint32_t hz;
+
+	char config_strings[MAX_CONFIG_STRINGS][MAX_STRING_CHARS];
+
+	entity_state_t baselines[MAX_EDICTS];
+	net_baseline_t baseline, pending_baseline;
+
+	entity_state_t entity_states[DEMO_ENTITY_STATES];
+	uint32_t entity_state;
+
+	demo_frame_t frames[PACKET_BACKUP];
+	demo_frame_t *frame; // the frame parsed from the current message, if any
+	size_t frame_start, frame_end; // and its extent within the message
+	int32_t frame_num; // the most recently parsed frame
+
+	uint32_t num_frames; // frames re-encoded
+	uint32_t num_skipped; // game-specific commands skipped
+	uint32_t num_dropped; // frames which could not be parsed
+
+	demo_encoder_t legacy, packed;
+} demo;
+
+/*
+ * @brief Converter state. Frames are re-encoded against the map baselines and
+ * the previously written frame, so that keyframes may be placed anywhere.
+ */
+static struct {
+	const char *filename;
+	demo_t *file;
+
+	uint32_t interval; // keyframe interval in seconds
+	int32_t keyframe; // the most recent keyframe
+	uint32_t num_keyframes;
+
+	demo_frame_t frame; // the most recently written frame
+} convert;
+
+#define DEMO_MAX_MESSAGE (MAX_MSG_SIZE - 16)
+
+static _Bool verbose;
+static _Bool debug;
+
+/*
+ * @brief Resolves the entity states of the specified frame.
+ */
+static void Demo_FrameEntities(const demo_frame_t *frame, net_entities_t *entities) {
+
+	entities->states = demo.entity_states;
+	entities->num_states = DEMO_ENTITY_STATES;
+	entities->first = frame->entity_state;
+	entities->num_entities = frame->num_entities;
+}
+
+/*
+ * @brief Writes the entity deltas from one frame to another, exactly as the
+ * server would for a client of the given protocol holding the given baselines.
+ * The server forces the old origin for clients, which we can not know here, so
+ * both encoders are given the same, more conservative, hint.
+ */
+static void Demo_WriteEntities(mem_buf_t *msg, const demo_frame_t *from,
+		const demo_frame_t *to, int32_t protocol, const entity_state_t *baselines) {
+	net_entities_t from_entities, to_entities;
+
+	if (from) {
+		Demo_FrameEntities(from, &from_entities);
+	}
+
+	Demo_FrameEntities(to, &to_entities);
+
+	Net_WriteEntities(msg, from ? &from_entities : NULL, &to_entities, baselines, 0, protocol);
+}
+
+/*
+ * @brief Encodes the entity deltas from one frame to another with the recorded
+ * baselines, returning the size in bytes.
+ */
+static size_t Demo_EncodeEntities(const demo_frame_t *from, const demo_frame_t *to,
+		int32_t protocol) {
+	static byte buffer[MAX_MSG_SIZE * 8];
+	mem_buf_t msg;
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	const entity_state_t *baselines = Net_Baselines(&demo.baseline, demo.baselines);
+
+	Demo_WriteEntities(&msg, from, to, protocol, baselines);
+
+	return msg.size;
+}
+
+/*
+ * @brief Accumulates the size of an encoded frame.
+ */
+static void Demo_Accumulate(demo_encoder_t *encoder, size_t bytes) {
+
+	encoder->bytes += bytes;
+
+	if (bytes > encoder->max_bytes)
+		encoder->max_bytes = bytes;
+}
+
+/*
+ * @brief Parses the entities of the current frame, as Cl_ParseEntities does.
+ */
+static void Demo_ParseEntities(mem_buf_t *msg, const demo_frame_t *delta_frame,
+		demo_frame_t *frame) {
+	net_entities_t from, to;
+
+	if (delta_frame) {
+		Demo_FrameEntities(delta_frame, &from);
+	}
+
+	frame->entity_state = demo.entity_state;
+	Demo_FrameEntities(frame, &to);
+
+	const entity_state_t *baselines = Net_Baselines(&demo.baseline, demo.baselines);
+
+	Net_ReadEntities(msg, delta_frame ? &from : NULL, &to, baselines, demo.protocol, false);
+
+	frame->num_entities = to.num_entities;
+	demo.entity_state += to.num_entities;
+}
+
+/*
+ * @brief Promotes or folds the baselines as recorded, as Cl_ParseBaselines does.
+ */
+static void Demo_ParseBaselines(mem_buf_t *msg) {
+	net_entities_t entities;
+
+	const int32_t pending = Net_ReadBaselines(msg, &demo.baseline, &demo.pending_baseline);
+
+	if (pending == 0)
+		return;
+
+	const demo_frame_t *frame = &demo.frames[pending & PACKET_MASK];
+
+	if (!frame->valid || frame->frame_num != pending)
+		return;
+
+	Demo_FrameEntities(frame, &entities);
+
+	Net_FoldBaseline(&demo.pending_baseline, &demo.baseline, demo.baselines, &entities,
+			demo.entity_state, &frame->ps, pending);
+}
+
+/*
+ * @return True if the specified frame has been parsed and is still held.
+ */
+static _Bool Demo_HasFrame(int32_t frame_num) {
+	const demo_frame_t *frame = &demo.frames[frame_num & PACKET_MASK];
+
+	return frame->valid && frame->frame_num == frame_num;
+}
+
+/*
+ * @brief Parses a frame and re-encodes its entities with both encoders.
+ *
+ * @return False if the frame deltas from one we do not hold, in which case it
+ * can not be parsed.
+ */
+static _Bool Demo_ParseFrame(mem_buf_t *msg) {
+	demo_frame_t *delta_frame = NULL, frame;
+	player_state_t null_state;
+
+	memset(&frame, 0, sizeof(frame));
+
+	frame.frame_num = Net_ReadLong(msg);
+	const int32_t delta_frame_num = Net_ReadLong(msg);
+
+	if (delta_frame_num > 0) {
+		if (!Demo_HasFrame(delta_frame_num)) {
+			Com_Warn("Frame %d deltas from missing frame %d\n", frame.frame_num, delta_frame_num);
+			return false;
+		}
+
+		delta_frame = &demo.frames[delta_frame_num & PACKET_MASK];
+	}
+
+	if (demo.protocol == PROTOCOL)
+		Demo_ParseBaselines(msg);
+
+	Net_ReadByte(msg); // rate suppression count
+
+	frame.area_bytes = Net_ReadByte(msg);
+
+	if (frame.area_bytes > sizeof(frame.area_bits)) {
+		Com_Error(ERR_DROP, "Corrupt frame %d\n", frame.frame_num);
+	}
+
+	Net_ReadData(msg, frame.area_bits, frame.area_bytes);
+
+	memset(&null_state, 0, sizeof(null_state));
+
+	if (delta_frame)
+		Net_ReadDeltaPlayerState(msg, &delta_frame->ps, &frame.ps);
+	else if (demo.baseline.frame_num)
+		Net_ReadDeltaPlayerState(msg, &demo.baseline.ps, &frame.ps);
+	else
+		Net_ReadDeltaPlayerState(msg, &null_state, &frame.ps);
+
+	const size_t start = msg->read;
+
+	Demo_ParseEntities(msg, delta_frame, &frame);
+
+	frame.valid = true;
+	demo.frames[frame.frame_num & PACKET_MASK] = frame;
+
+	demo.frame = &demo.frames[frame.frame_num & PACKET_MASK];
+	demo.frame_num = frame.frame_num;
+
+	const size_t legacy = Demo_EncodeEntities(delta_frame, &frame, PROTOCOL_LEGACY);
+	const size_t packed = Demo_EncodeEntities(delta_frame, &frame, PROTOCOL);
+
+	Demo_Accumulate(&demo.legacy, legacy);
+	Demo_Accumulate(&demo.packed, packed);
+
+	demo.num_frames++;
+
+	Com_Verbose("frame %6d: %3u entities, %4u recorded, %4u legacy, %4u packed bytes\n",
+			frame.frame_num, frame.num_entities, (uint32_t) (msg->read - start),
+			(uint32_t) legacy, (uint32_t) packed);
+
+	return true;
+}
+
+/*
+ * @return True if the message, read from just past an SV_CMD_FRAME byte, holds
+ * a frame which continues the recorded stream. Its delta frame, and the
+ * baselines it refers to, must be ones we hold.
+ */
+static _Bool Demo_IsFrame(mem_buf_t *msg) {
+
+	const int32_t frame_num = Net_ReadLong(msg);
+	const int32_t delta_frame_num = Net_ReadLong(msg);
+
+	if (frame_num <= demo.frame_num)
+		return false;
+
+	if (delta_frame_num > 0) {
+		if (delta_frame_num >= frame_num || !Demo_HasFrame(delta_frame_num))
+			return false;
+	} else if (delta_frame_num != -1) {
+		return false;
+	}
+
+	if (demo.protocol == PROTOCOL) {
+		const int32_t baseline = Net_ReadLong(msg);
+		const int32_t pending = Net_ReadLong(msg);
+
+		if (baseline && baseline != demo.baseline.frame_num
+				&& baseline != demo.pending_baseline.frame_num)
+			return false;
+
+		if (pending && pending != demo.pending_baseline.frame_num && !Demo_HasFrame(pending))
+			return false;
+	}
+
+	return msg->read <= msg->size;
+}
+
+/*
+ * @brief Game-specific commands can not be parsed here, and carry no length, so
+ * the remainder of the message is scanned for the frame instead.
+ *
+ * @return True if the frame was found, in which case it is read next.
+ */
+static _Bool Demo_FindFrame(mem_buf_t *msg) {
+	size_t i;
+
+	for (i = msg->read; i < msg->size; i++) {
+
+		if (msg->data[i] != SV_CMD_FRAME)
+			continue;
+
+		msg->read = i + 1;
+
+		if (Demo_IsFrame(msg)) {
+			msg->read = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * @brief Parses a single demo message. Game-specific commands can not be
+ * parsed here, so they are skipped, along with anything else up to the frame.
+ * Once the frame is parsed, the remainder of the message is left as recorded.
+ */
+static void Demo_ParseMessage(mem_buf_t *msg) {
+	static entity_state_t null_state;
+
+	demo.frame = NULL;
+	demo.frame_start = demo.frame_end = msg->size;
+
+	while (true) {
+
+		if (msg->read > msg->size) {
+			Com_Error(ERR_DROP, "Bad demo message\n");
+		}
+
+		const int32_t cmd = Net_ReadByte(msg);
+
+		if (cmd == -1)
+			break;
+
+		switch (cmd) {
+
+			case SV_CMD_BASELINE: {
+				const uint16_t number = Net_ReadShort(msg);
+				const uint16_t bits = Net_ReadShort(msg);
+
+				if (number >= MAX_EDICTS) {
+					Com_Error(ERR_DROP, "Bad baseline %d\n", number);
+				}
+
+				Net_ReadDeltaEntity(msg, &null_state, &demo.baselines[number], number, bits);
+			}
+				break;
+
+			case SV_CMD_CBUF_TEXT:
+				Net_ReadString(msg);
+				break;
+
+			case SV_CMD_CONFIG_STRING: {
+				const uint16_t index = Net_ReadShort(msg);
+				const char *s = Net_ReadString(msg);
+
+				if (index < MAX_CONFIG_STRINGS) {
+					g_strlcpy(demo.config_strings[index], s, MAX_STRING_CHARS);
+				}
+			}
+				break;
+
+			case SV_CMD_DISCONNECT:
+			case SV_CMD_RECONNECT:
+				break;
+
+			case SV_CMD_DOWNLOAD: {
+				int32_t size;
+				if (demo.protocol == PROTOCOL) {
+					Net_ReadByte(msg);
+					Net_ReadLong(msg);
+					Net_ReadLong(msg);
+					size = Net_ReadShort(msg);
+				} else {
+					size = Net_ReadShort(msg);
+					Net_ReadByte(msg);
+				}
+				if (size > 0)
+					msg->read += size;
+			}
+				break;
+
+			case SV_CMD_FRAME:
+				demo.frame_start = msg->read - 1;
+
+				if (!Demo_ParseFrame(msg)) {
+					demo.num_dropped++;
+					return;
+				}
+
+				demo.frame_end = msg->read;
+				break;
+
+			case SV_CMD_PRINT:
+				Net_ReadByte(msg);
+				Net_ReadString(msg);
+				break;
+
+			case SV_CMD_SERVER_DATA:
+				demo.protocol = Net_ReadLong(msg);
+
+				if (demo.protocol != PROTOCOL && demo.protocol != PROTOCOL_LEGACY) {
+					Com_Error(ERR_DROP, "Unknown protocol %d\n", demo.protocol);
+				}
+
+				Net_ReadLong(msg); // spawn count
+				demo.hz = Net_ReadLong(msg);
+				Net_ReadByte(msg); // demo server
+				Net_ReadString(msg); // game
+				Net_ReadShort(msg); // entity number
+				Com_Print("Protocol %d: %s\n", demo.protocol, Net_ReadString(msg));
+				break;
+
+			case SV_CMD_SOUND: {
+				const int32_t flags = Net_ReadByte(msg);
+				Net_ReadByte(msg);
+				if (flags & S_ATTEN)
+					Net_ReadByte(msg);
+				if (flags & S_ENTNUM)
+					Net_ReadShort(msg);
+				if (flags & S_ORIGIN) {
+					vec3_t origin;
+					Net_ReadPosition(msg, origin);
+				}
+			}
+				break;
+
+			default:
+				Com_Debug("Skipping game command %d\n", cmd);
+				demo.num_skipped++;
+
+				if (demo.frame || !Demo_FindFrame(msg))
+					return;
+				break;
+		}
+	}
+}
+
+/*
+ * @brief Writes a frame delta compressed from the given frame, or uncompressed,
+ * against the map baselines. Clients fold no baselines from converted demos.
+ */
+static void Demo_WriteFrame(mem_buf_t *msg, const demo_frame_t *from, const demo_frame_t *to) {
+	static player_state_t null_state;
+
+	Net_WriteByte(msg, SV_CMD_FRAME);
+	Net_WriteLong(msg, to->frame_num);
+	Net_WriteLong(msg, from ? from->frame_num : -1);
+
+	if (demo.protocol == PROTOCOL) {
+		Net_WriteLong(msg, 0);
+		Net_WriteLong(msg, 0);
+	}
+
+	Net_WriteByte(msg, 0); // rate suppression count
+
+	Net_WriteByte(msg, to->area_bytes);
+	Net_WriteData(msg, to->area_bits, to->area_bytes);
+
+	Net_WriteDeltaPlayerState(msg, from ? &from->ps : &null_state, &to->ps);
+
+	Demo_WriteEntities(msg, from, to, demo.protocol, demo.baselines);
+}
+
+/*
+ * @brief Writes the config strings that begin each keyframe.
+ */
+static void Demo_WriteConfigStrings(int32_t frame_num) {
+	byte buffer[MAX_MSG_SIZE];
+	mem_buf_t msg;
+	uint16_t i;
+
+	Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+	for (i = 0; i < MAX_CONFIG_STRINGS; i++) {
+		if (*demo.config_strings[i] != '\0') {
+			if (msg.size + strlen(demo.config_strings[i]) + 32 > msg.max_size) {
+				Demo_WriteMessage(convert.file, frame_num, msg.data, msg.size);
+				Mem_ClearBuffer(&msg);
+			}
+
+			Net_WriteByte(&msg, SV_CMD_CONFIG_STRING);
+			Net_WriteShort(&msg, i);
+			Net_WriteString(&msg, demo.config_strings[i]);
+		}
+	}
+
+	if (msg.size) {
+		Demo_WriteMessage(convert.file, frame_num, msg.data, msg.size);
+	}
+}
+
+/*
+ * @brief Writes the current message to the converted demo, re-encoding its
+ * frame. Everything else in the message is copied as it was recorded.
+ */
+static void Demo_ConvertMessage(const mem_buf_t *msg) {
+	static byte buffer[MAX_MSG_SIZE * 8];
+	mem_buf_t frame_msg;
+
+	if (!convert.file) {
+		if (!(convert.file = Demo_OpenWrite(convert.filename, demo.hz, DEMO_COMPRESS))) {
+			Com_Error(ERR_FATAL, "Failed to open %s\n", convert.filename);
+		}
+	}
+
+	const demo_frame_t *frame = demo.frame;
+
+	if (!frame) { // the recorded frame, if any, can not be written
+		if (demo.frame_start) {
+			Demo_WriteMessage(convert.file, convert.frame.frame_num, msg->data, demo.frame_start);
+		}
+		return;
+	}
+
+	const int32_t interval = convert.interval * demo.hz;
+	_Bool keyframe = convert.keyframe == -1 || frame->frame_num - convert.keyframe >= interval;
+
+	Mem_InitBuffer(&frame_msg, buffer, sizeof(buffer));
+	Demo_WriteFrame(&frame_msg, keyframe ? NULL : &convert.frame, frame);
+
+	if (frame_msg.size > DEMO_MAX_MESSAGE && keyframe && convert.keyframe != -1) {
+		Com_Debug("Frame %d is too large for a keyframe\n", frame->frame_num);
+
+		keyframe = false; // try again next frame
+
+		Mem_ClearBuffer(&frame_msg);
+		Demo_WriteFrame(&frame_msg, &convert.frame, frame);
+	}
+
+	if (frame_msg.size > DEMO_MAX_MESSAGE) {
+		Com_Error(ERR_DROP, "Frame %d is too large to convert\n", frame->frame_num);
+	}
+
+	if (keyframe) {
+		Demo_BeginKeyframe(convert.file, frame->frame_num);
+		Demo_WriteConfigStrings(frame->frame_num);
+
+		convert.keyframe = frame->frame_num;
+		convert.num_keyframes++;
+	}
+
+	const size_t prefix = demo.frame_start;
+	const size_t suffix = msg->size - demo.frame_end;
+
+	if (prefix + frame_msg.size + suffix <= DEMO_MAX_MESSAGE) {
+		byte data[MAX_MSG_SIZE];
+
+		memcpy(data, msg->data, prefix);
+		memcpy(data + prefix, frame_msg.data, frame_msg.size);
+		memcpy(data + prefix + frame_msg.size, msg->data + demo.frame_end, suffix);
+
+		Demo_WriteMessage(convert.file, frame->frame_num, data, prefix + frame_msg.size + suffix);
+	} else { // split the message at the frame
+		if (prefix) {
+			Demo_WriteMessage(convert.file, frame->frame_num, msg->data, prefix);
+		}
+
+		Demo_WriteMessage(convert.file, frame->frame_num, frame_msg.data, frame_msg.size);
+
+		if (suffix) {
+			Demo_WriteMessage(convert.file, frame->frame_num, msg->data + demo.frame_end, suffix);
+		}
+	}
+
+	convert.frame = *frame;
+}
+
+/*
+ * @brief Replays the specified demo through both entity encoders, converting
+ * it to an indexed demo if requested.
+ */
+static void Demo_Run(const char *filename) {
+	byte buffer[MAX_MSG_SIZE];
+	mem_buf_t msg;
+	int32_t size;
+
+	demo_t *file = Demo_OpenRead(filename);
+	if (!file) {
+		Com_Error(ERR_FATAL, "Failed to open %s\n", filename);
+	}
+
+	while ((size = Demo_ReadMessage(file, buffer, sizeof(buffer))) != -1) {
+
+		Mem_InitBuffer(&msg, buffer, sizeof(buffer));
+
+		msg.size = size;
+		Net_BeginReading(&msg);
+
+		Demo_ParseMessage(&msg);
+
+		if (convert.filename) {
+			Demo_ConvertMessage(&msg);
+		}
+	}
+
+	Demo_Close(file);
+
+	if (convert.file) {
+		Demo_Close(convert.file);
+
+		Com_Print("Converted to %s with %u keyframes\n", convert.filename,
+				convert.num_keyframes);
+	}
+
+	if (!demo.num_frames) {
+		Com_Print("No frames parsed\n");
+		return;
+	}
+
+	const vec_t legacy = demo.legacy.bytes / (vec_t) demo.num_frames;
+	const vec_t packed = demo.packed.bytes / (vec_t) demo.num_frames;
+
+	Com_Print("%u frames, %u dropped, %u game commands skipped\n", demo.num_frames,
+			demo.num_dropped, demo.num_skipped);
+	Com_Print("  legacy (%d): %7.1f bytes per frame, %5u max\n", PROTOCOL_LEGACY, legacy,
+			demo.legacy.max_bytes);
+	Com_Print("  packed (%d): %7.1f bytes per frame, %5u max (%.1f%%)\n", PROTOCOL, packed,
+			demo.packed.max_bytes, legacy ? 100.0 * packed / legacy : 0.0);
+}
+
+/*
+ * @brief Com_Debug implementation.
+ */
+static void Debug(const char *msg) {
+
+	if (debug) {
+		fputs(msg, stdout);
+	}
+}
+
+/*
+ * @brief Com_Error implementation.
+ */
+static void Error(err_t err __attribute__((unused)), const char *msg) __attribute__((noreturn));
+static void Error(err_t err __attribute__((unused)), const char *msg) {
+
+	fputs(msg, stderr);
+
+	Com_Shutdown(NULL);
+
+	exit(1);
+}
+
+/*
+ * @brief Com_Print implementation.
+ */
+static void Print(const char *msg) {
+	fputs(msg, stdout);
+}
+
+/*
+ * @brief Com_Verbose implementation.
+ */
+static void Verbose(const char *msg) {
+
+	if (verbose) {
+		fputs(msg, stdout);
+	}
+}
+
+/*
+ * @brief Com_Init implementation.
+ */
+static void Init(void) {
+
+	Mem_Init();
+
+	Fs_Init(false);
+}
+
+/*
+ * @brief Com_Shutdown implementation.
+ */
+static void Shutdown(const char *msg) {
+
+	if (msg) {
+		fputs(msg, stdout);
+	}
+
+	Fs_Shutdown();
+
+	Mem_Shutdown();
+}
+
+/*
+ * @brief Replays recorded demos through the legacy and bit-packed entity
+ * encoders, reporting the bytes each would spend per frame. With -convert,
+ * the demo is also rewritten as an indexed demo with keyframes for seeking.
+ */
+int32_t main(int32_t argc, char **argv) {
+	const char *filename = NULL;
+
+	printf("Quake2World Demo Tool %s %s %s\n", VERSION, __DATE__, BUILD_HOST);
+
+	memset(&quake2world, 0, sizeof(quake2world));
+
+	quake2world.Debug = Debug;
+	quake2world.Error = Error;
+	quake2world.Print = Print;
+	quake2world.Verbose = Verbose;
+
+	quake2world.Init = Init;
+	quake2world.Shutdown = Shutdown;
+
+	signal(SIGINT, Sys_Signal);
+	signal(SIGQUIT, Sys_Signal);
+	signal(SIGSEGV, Sys_Signal);
+	signal(SIGTERM, Sys_Signal);
+
+	Com_Init(argc, argv);
+
+	convert.interval = 10;
+	convert.keyframe = -1;
+	convert.frame.frame_num = -1;
+
+	int32_t i;
+	for (i = 1; i < Com_Argc(); i++) {
+
+		if (!g_strcmp0(Com_Argv(i), "-convert") && i + 1 < Com_Argc()) {
+			convert.filename = Com_Argv(++i);
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-keyframe") && i + 1 < Com_Argc()) {
+			convert.interval = MAX(1, atoi(Com_Argv(++i)));
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-v") || !g_strcmp0(Com_Argv(i), "-verbose")) {
+			verbose = true;
+			continue;
+		}
+
+		if (!g_strcmp0(Com_Argv(i), "-d") || !g_strcmp0(Com_Argv(i), "-debug")) {
+			debug = true;
+			continue;
+		}
+
+		filename = Com_Argv(i);
+	}
+
+	if (!filename) {
+		Com_Print("Usage: %s [-v] [-d] [-convert demos/out.dem [-keyframe seconds]] "
+				"demos/name.dem\n", argv[0]);
+		Com_Shutdown(NULL);
+		return 1;
+	}
+
+	Demo_Run(filename);
+
+	Com_Shutdown(NULL);
+	return 0;
+}